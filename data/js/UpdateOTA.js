@@ -93,66 +93,109 @@ document.addEventListener("DOMContentLoaded", function () {
   }
 
   // --- Upload Logic ---
+  // Image dikirim mentah (bukan FormData) supaya bisa dilanjutkan:
+  // jika koneksi putus, posisi terakhir dibaca dari /updateStatus lalu
+  // sisa file dikirim ke /update?offset=N&size=N.
 
-  uploadBtn.addEventListener('click', async () => {
-    if (!selectedFile) return;
+  const maxResume = 3;
+  let statusTimer = null;
 
-    uploadBtn.disabled = true;
-    if (progressBar) progressBar.style.display = 'flex'; // Tampilkan progress bar
-
-    showAlert('Uploading firmware... Please do not close this page.', 'warning');
+  function showProgress(sent, total, bytesPerSec) {
+    const percent = Math.round((sent / total) * 100);
+    progressBarInner.style.width = percent + '%';
+    progressBarInner.textContent = bytesPerSec ? `${percent}% · ${formatBytes(bytesPerSec)}/s` : percent + '%';
+  }
 
-    const formData = new FormData();
-    formData.append('update', selectedFile);
+  function otaStatus() {
+    return fetch('/updateStatus').then(response => response.json()).then(data => data.ota);
+  }
 
-    try {
-      const xhr = new XMLHttpRequest();
+  function uploadFailed(message) {
+    clearInterval(statusTimer);
+    progressBarInner.classList.remove('progress-bar-animated');
+    progressBarInner.classList.add('bg-danger');
+    showAlert('❌ ' + message, 'danger');
+    uploadBtn.disabled = false;
+  }
 
-      xhr.upload.addEventListener('progress', (e) => {
-        if (e.lengthComputable) {
-          const percentComplete = Math.round((e.loaded / e.total) * 100);
-          progressBarInner.style.width = percentComplete + '%';
-          progressBarInner.textContent = percentComplete + '%';
-        }
-      });
+  function uploadDone() {
+    clearInterval(statusTimer);
+    progressBarInner.classList.remove('progress-bar-animated');
+    progressBarInner.classList.add('bg-success');
+    showAlert('✅ Update successful! Device is rebooting...', 'success');
+
+    // Countdown and redirect logic
+    let countdown = 10;
+    const countdownInterval = setInterval(() => {
+      countdown--;
+      if (countdown <= 0) {
+        clearInterval(countdownInterval);
+        window.location.href = '/';
+      } else {
+        showAlert(`✅ Update successful! Redirecting in ${countdown} seconds...`, 'success');
+      }
+    }, 1000);
+  }
 
-      xhr.addEventListener('load', () => {
-        if (xhr.status === 200) {
-          progressBarInner.classList.remove('progress-bar-animated');
-          progressBarInner.classList.add('bg-success');
-          showAlert('✅ Update successful! Device is rebooting...', 'success');
-
-          // Countdown and redirect logic
-          let countdown = 10;
-          const countdownInterval = setInterval(() => {
-            countdown--;
-            if (countdown <= 0) {
-              clearInterval(countdownInterval);
-              window.location.href = '/';
+  function sendFrom(offset, attempt) {
+    const total = selectedFile.size;
+    const xhr = new XMLHttpRequest();
+    let lastSpeed = 0;
+
+    xhr.upload.addEventListener('progress', (e) => {
+      if (e.lengthComputable) showProgress(offset + e.loaded, total, lastSpeed);
+    });
+
+    xhr.addEventListener('load', () => {
+      if (xhr.status === 200) {
+        uploadDone();
+      } else {
+        uploadFailed('Upload failed: ' + xhr.responseText);
+      }
+    });
+
+    xhr.addEventListener('error', () => {
+      if (attempt >= maxResume) {
+        uploadFailed('Upload failed! Connection error.');
+        return;
+      }
+      // Lanjutkan dari byte terakhir yang diterima perangkat
+      setTimeout(() => {
+        otaStatus()
+          .then(ota => {
+            if (ota.state === 'paused' && ota.size === total) {
+              showAlert(`Connection lost, resuming at ${formatBytes(ota.received)}...`, 'warning');
+              sendFrom(ota.received, attempt + 1);
             } else {
-              showAlert(`✅ Update successful! Redirecting in ${countdown} seconds...`, 'success');
+              uploadFailed('Upload failed! Connection error.');
             }
-          }, 1000);
-        } else {
-          throw new Error('Upload failed');
-        }
-      });
+          })
+          .catch(() => uploadFailed('Upload failed! Device not reachable.'));
+      }, 1000);
+    });
+
+    // Kecepatan tulis dari perangkat (termasuk waktu flash)
+    clearInterval(statusTimer);
+    statusTimer = setInterval(() => {
+      otaStatus().then(ota => { lastSpeed = ota.bytesPerSec; }).catch(() => {});
+    }, 1000);
+
+    const query = offset > 0 ? `?offset=${offset}&size=${total}` : `?size=${total}`;
+    xhr.open('POST', '/update' + query);
+    xhr.setRequestHeader('Content-Type', 'application/octet-stream');
+    xhr.send(offset > 0 ? selectedFile.slice(offset) : selectedFile);
+  }
 
-      xhr.addEventListener('error', () => {
-        progressBarInner.classList.remove('progress-bar-animated');
-        progressBarInner.classList.add('bg-danger');
-        showAlert('❌ Upload failed! Connection error.', 'danger');
-        uploadBtn.disabled = false;
-      });
+  uploadBtn.addEventListener('click', () => {
+    if (!selectedFile) return;
 
-      xhr.open('POST', '/update');
-      xhr.send(formData);
+    uploadBtn.disabled = true;
+    if (progressBar) progressBar.style.display = 'flex'; // Tampilkan progress bar
+    progressBarInner.classList.remove('bg-success', 'bg-danger');
+    progressBarInner.classList.add('progress-bar-animated');
 
-    } catch (error) {
-      console.error('Upload error:', error);
-      showAlert('❌ Upload failed: ' + error.message, 'danger');
-      uploadBtn.disabled = false;
-    }
+    showAlert('Uploading firmware... Please do not close this page.', 'warning');
+    sendFrom(0, 0);
   });
 
   // Init
@@ -6,6 +6,7 @@ document.addEventListener("DOMContentLoaded", function () {
 
     var filter = document.getElementById('filter');
     var filterPeriod = document.getElementById('filterPeriod');
+    var filterType = document.getElementById('filterType');
 
     var scaling = document.getElementById('scaling');
     var lowLimit = document.getElementById('lowLimit');
@@ -29,6 +30,7 @@ document.addEventListener("DOMContentLoaded", function () {
 
     filter.addEventListener('change', function () {
         filterPeriod.disabled = !this.checked;
+        filterType.disabled = !this.checked;
     });
 
     scaling.addEventListener('change', function () {
@@ -107,6 +109,8 @@ document.addEventListener("DOMContentLoaded", function () {
                 filter.checked = data.filter;
                 filterPeriod.value = data.filterPeriod;
                 filterPeriod.disabled = !data.filter;
+                filterType.value = data.filterType || 'EMA';
+                filterType.disabled = !data.filter;
 
                 scaling.checked = data.scaling;
                 lowLimit.value = data.lowLimit;
@@ -102,24 +102,26 @@ document.addEventListener("DOMContentLoaded", function () {
     function getSensorReading() {
         fetch('/getValue', { method: "GET" })
             .then(response => response.json())
-            .then(data => {
-                // Cari data sensor berdasarkan Nama Sensor (Sensor Code)
-                const sensor = data.find(s => s.KodeSensor === elements.nameDI.value);
-                elements.currentValue.value = sensor ? sensor.Value : '-';
-
-                // Update Unit Satuan secara dinamis
-                switch (elements.taskMode.value) {
-                    case "Normal": elements.unit.innerHTML = "."; break;
-                    case "Cycle Time": elements.unit.innerHTML = "sec"; break;
-                    case "Run Time": elements.unit.innerHTML = "min"; break;
-                    case "Counting": elements.unit.innerHTML = "pcs"; break;
-                    case "Pulse Mode": elements.unit.innerHTML = "Hz"; break;
-                    default: elements.unit.innerHTML = "-";
-                }
-            })
+            .then(showSensorReading)
             .catch(error => console.error("Polling error:", error));
     }
 
+    function showSensorReading(data) {
+        // Cari data sensor berdasarkan Nama Sensor (Sensor Code)
+        const sensor = data.find(s => s.KodeSensor === elements.nameDI.value);
+        elements.currentValue.value = sensor ? sensor.Value : '-';
+
+        // Update Unit Satuan secara dinamis
+        switch (elements.taskMode.value) {
+            case "Normal": elements.unit.innerHTML = "."; break;
+            case "Cycle Time": elements.unit.innerHTML = "sec"; break;
+            case "Run Time": elements.unit.innerHTML = "min"; break;
+            case "Counting": elements.unit.innerHTML = "pcs"; break;
+            case "Pulse Mode": elements.unit.innerHTML = "Hz"; break;
+            default: elements.unit.innerHTML = "-";
+        }
+    }
+
     function submitForm(formData) {
         fetch('/', {
             method: 'POST',
@@ -153,6 +155,11 @@ document.addEventListener("DOMContentLoaded", function () {
         fetchData(elements.inputPin.value[2]);
     }
 
-    // Mulai Polling
-    setInterval(getSensorReading, 2000);
+    // Nilai realtime: push dari server (SSE), polling hanya jika tidak didukung
+    if (window.EventSource) {
+        const stream = new EventSource('/events');
+        stream.addEventListener('values', e => showSensorReading(JSON.parse(e.data)));
+    } else {
+        setInterval(getSensorReading, 2000);
+    }
 });
\ No newline at end of file
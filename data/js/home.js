@@ -39,14 +39,29 @@ document.addEventListener("DOMContentLoaded", () => {
     document.getElementById('di4Unit'),
   ];
 
-  // --- 2. FUNGSI FETCH DATA (Polling) ---
-  // Fungsi ini jalan TERPISAH dari loading Highcharts
-  // Agar text data muncul duluan meskipun grafik belum siap.
-  function getSensorData() {
-    fetch('/homeLoad', { method: 'GET' })
+  // --- 2. FUNGSI FETCH DATA ---
+  // Info statis (/info) diambil sekali; polling hanya ke /live yang berisi
+  // nilai yang berubah. Fungsi ini jalan TERPISAH dari loading Highcharts
+  // agar text data muncul duluan meskipun grafik belum siap.
+  let lastSeq = 0;
+
+  // Grafik scaled: "Live" = titik /live tiap 2 detik; window lain diambil
+  // dari /rollup (bucket min/max/mean di device, maks. beberapa ratus titik)
+  const trendWindowSelect = document.getElementById('trendWindow');
+  let trendWindow = 0;
+  let trendTimer = null;
+
+  function unitFor(mode) {
+    return mode === 'Counting' ? 'pcs' :
+      mode === 'Cycle Time' ? 'sec' :
+        mode === 'Run Time' ? 'min' :
+          mode === 'Pulse Mode' ? 'Hz' : '.';
+  }
+
+  function loadInfo() {
+    fetch('/info', { method: 'GET' })
       .then(r => r.ok ? r.json() : Promise.reject(new Error(`HTTP ${r.status}`)))
       .then(data => {
-        // A. Update Network Info
         if (networkMode) networkMode.value = data.networkMode || '-';
         if (ssid) ssid.value = data.ssid || '-';
         if (ipAddres) ipAddres.value = data.ipAddress || '-';
@@ -54,35 +69,60 @@ document.addEventListener("DOMContentLoaded", () => {
         if (protocolMode) protocolMode.value = data.protocolMode || '-';
         if (endpoint) endpoint.value = data.endpoint || '-';
         if (macAddress) macAddress.value = data.macAddress || '-';
-        if (connStatus) connStatus.value = data.connStatus || '-';
         if (jobNumber) jobNumber.value = data.jobNumber || '-';
 
-        // B. Parse Sensor Data
-        const DI_values = (data.DI && data.DI.value) || [0, 0, 0, 0];
-        const DI_taskmode = (data.DI && data.DI.taskMode) || ['Normal', 'Counting', 'Cycle Time', 'Run Time'];
-        const AI_rawValues = (data.AI && data.AI.rawValue) || [0, 0, 0, 0];
-        const AI_scaledValues = (data.AI && data.AI.scaledValue) || [0, 0, 0, 0];
-        const enabled_AI = Array.isArray(data.enAI) ? data.enAI : [1, 1, 1, 1];
-
-        // C. Update Digital Input UI
+        const DI_taskmode = data.taskMode || ['Normal', 'Counting', 'Cycle Time', 'Run Time'];
         for (let i = 0; i < 4; i++) {
-          if (diValues[i]) diValues[i].value = DI_values[i] ?? '0';
           if (diTexts[i]) diTexts[i].textContent = DI_taskmode[i] ?? '-';
-          if (diUnits[i]) {
-            const mode = DI_taskmode[i];
-            diUnits[i].textContent =
-              mode === 'Counting' ? 'pcs' :
-                mode === 'Cycle Time' ? 'sec' :
-                  mode === 'Run Time' ? 'min' :
-                    mode === 'Pulse Mode' ? 'Hz' : '.';
-          }
+          if (diUnits[i]) diUnits[i].textContent = unitFor(DI_taskmode[i]);
+        }
+      })
+      .catch(err => console.error('Info fetch error:', err));
+  }
+
+  // Format biner /live?fmt=bin (little-endian, lihat LiveData.h)
+  function decodeLive(buf) {
+    const v = new DataView(buf);
+    if (buf.byteLength < 60 || v.getUint8(0) !== 1) throw new Error('Bad live frame');
+    const live = {
+      link: (v.getUint8(1) & 1) === 1,
+      aiMask: v.getUint8(2),
+      seq: v.getUint32(4, true),
+      di: [], raw: [], val: [],
+    };
+    for (let i = 0; i < 4; i++) {
+      live.di.push(v.getInt32(12 + i * 4, true));
+      live.raw.push(v.getFloat32(28 + i * 4, true));
+      live.val.push(v.getFloat32(44 + i * 4, true));
+    }
+    return live;
+  }
+
+  function getSensorData() {
+    fetch(`/live?since=${lastSeq}&fmt=bin`, { method: 'GET' })
+      .then(r => {
+        if (r.status === 204) return null; // tidak ada data baru
+        return r.ok ? r.arrayBuffer() : Promise.reject(new Error(`HTTP ${r.status}`));
+      })
+      .then(buf => {
+        if (!buf) return;
+        const data = decodeLive(buf);
+        lastSeq = data.seq;
+
+        if (connStatus) connStatus.value = data.link ? 'Connected' : 'Disconnected';
+
+        // Update Digital Input UI
+        for (let i = 0; i < 4; i++) {
+          if (diValues[i]) diValues[i].value = data.di[i] ?? '0';
         }
 
-        // D. Update Grafik (HANYA JIKA HIGHCHARTS SUDAH LOAD)
+        const enabled_AI = [0, 1, 2, 3].map(i => (data.aiMask >> i) & 1);
+
+        // Update Grafik (HANYA JIKA HIGHCHARTS SUDAH LOAD)
         if (chartT && chartS) {
           // 1. Atur Visibilitas (Sekali saja)
           if (firstRun) {
-            for (let i = 0; i < enabled_AI.length && i < 4; i++) {
+            for (let i = 0; i < 4; i++) {
               const isVisible = enabled_AI[i] === 1;
               if (chartT.series[i]) chartT.series[i].setVisible(isVisible, false);
               if (chartS.series[i]) chartS.series[i].setVisible(isVisible, false);
@@ -92,33 +132,23 @@ document.addEventListener("DOMContentLoaded", () => {
             firstRun = false;
           }
 
-          // 2. Tentukan Waktu X-Axis
-          let x;
-          if (data.datetime && typeof data.datetime === 'string' && data.datetime.includes(' ')) {
-            const [dStr, tStr] = data.datetime.split(' ');
-            const [y, m, d] = dStr.split('-').map(v => parseInt(v, 10));
-            const [H, M, S] = tStr.split(':').map(v => parseInt(v, 10));
-            x = new Date(y, (m - 1), d, H, M, S).getTime() + (7 * 3600 * 1000);
-          } else {
-            x = Date.now();
-          }
+          // 2. Waktu X-Axis (jam browser)
+          const x = Date.now();
 
           // 3. Plot Data Raw
-          const sensorRawValues = AI_rawValues.map(v => Math.round((v || 0) * 100) / 100);
-          sensorRawValues.forEach((y, i) => {
+          data.raw.forEach((v, i) => {
             if (enabled_AI[i] === 1 && chartT.series[i]) {
               const shift = chartT.series[i].data.length > 40;
-              chartT.series[i].addPoint([x, y], false, shift, true);
+              chartT.series[i].addPoint([x, Math.round(v)], false, shift, true);
             }
           });
           chartT.redraw();
 
-          // 4. Plot Data Scaled
-          const sensorScaledValues = AI_scaledValues.map(v => Math.round((v || 0) * 100) / 100);
-          sensorScaledValues.forEach((y, i) => {
+          // 4. Plot Data Scaled (hanya mode Live)
+          if (trendWindow === 0) data.val.forEach((v, i) => {
             if (enabled_AI[i] === 1 && chartS.series[i]) {
               const shift = chartS.series[i].data.length > 40;
-              chartS.series[i].addPoint([x, y], false, shift, true);
+              chartS.series[i].addPoint([x, Math.round(v * 100) / 100], false, shift, true);
             }
           });
           chartS.redraw();
@@ -127,6 +157,33 @@ document.addEventListener("DOMContentLoaded", () => {
       .catch(err => console.error('Data fetch error:', err));
   }
 
+  // Waktu bucket = jam log device (belum tentu epoch): geser relatif ke "now"
+  function loadTrend() {
+    const seconds = trendWindow || 80; // Live: isi awal 80 detik terakhir
+    fetch(`/rollup?from=-${seconds}&points=300`, { method: 'GET' })
+      .then(r => r.ok ? r.json() : Promise.reject(new Error(`HTTP ${r.status}`)))
+      .then(trend => {
+        if (!chartS) return;
+        const offset = Date.now() - trend.now * 1000;
+        trend.series.forEach(s => {
+          const series = chartS.series[s.ch];
+          if (!series) return;
+          series.setData(s.data.map(d => [offset + d[0] * 1000, Math.round(d[3] * 100) / 100]), false);
+        });
+        chartS.redraw();
+      })
+      .catch(err => console.error('Trend fetch error:', err));
+  }
+
+  if (trendWindowSelect) {
+    trendWindowSelect.addEventListener('change', () => {
+      trendWindow = parseInt(trendWindowSelect.value, 10) || 0;
+      if (trendTimer) clearInterval(trendTimer);
+      trendTimer = trendWindow ? setInterval(loadTrend, 30000) : null;
+      loadTrend();
+    });
+  }
+
   // --- 3. FUNGSI LAZY LOAD HIGHCHARTS ---
   function loadHighcharts(callback) {
     if (typeof Highcharts !== 'undefined') {
@@ -153,6 +210,7 @@ document.addEventListener("DOMContentLoaded", () => {
   // --- 4. MAIN EXECUTION ---
 
   // A. Mulai Polling Data Text SEKARANG (Agar dashboard terasa cepat)
+  loadInfo();
   getSensorData();
   setInterval(getSensorData, 2000);
 
@@ -203,6 +261,9 @@ document.addEventListener("DOMContentLoaded", () => {
         }
       }
     });
+
+    // Isi awal dari rollup device, tidak menunggu polling
+    loadTrend();
   });
 
 });
\ No newline at end of file
@@ -207,19 +207,21 @@ document.addEventListener("DOMContentLoaded", function () {
     function getModbusReading() {
         fetch('/getValue', { method: "GET" })
             .then(response => response.json())
-            .then(data => {
-                let found = false;
-                for (let i = 0; i < data.length; i++) {
-                    if (data[i].KodeSensor === parameterList.value) {
-                        realtimeValue.innerHTML = Math.round(data[i].Value * 100) / 100;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) realtimeValue.innerHTML = "-";
-            })
+            .then(showModbusReading)
             .catch(error => console.error("Polling error:", error));
     }
+
+    function showModbusReading(data) {
+        let found = false;
+        for (let i = 0; i < data.length; i++) {
+            if (data[i].KodeSensor === parameterList.value) {
+                realtimeValue.innerHTML = Math.round(data[i].Value * 100) / 100;
+                found = true;
+                break;
+            }
+        }
+        if (!found) realtimeValue.innerHTML = "-";
+    }
     
     // Tombol Close Popup (meskipun ada di common.js, di sini ada logic display: none spesifik)
     if(buttonPopupInt) {
@@ -228,6 +230,11 @@ document.addEventListener("DOMContentLoaded", function () {
         });
     }
 
-    // Polling setiap 2 detik
-    setInterval(getModbusReading, 2000);
+    // Nilai realtime: push dari server (SSE), polling 2 detik hanya jika tidak didukung
+    if (window.EventSource) {
+        const stream = new EventSource('/events');
+        stream.addEventListener('modbus', e => showModbusReading(JSON.parse(e.data)));
+    } else {
+        setInterval(getModbusReading, 2000);
+    }
 });
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "Adafruit_ADS1X15.h"
+#include "SimOptions.h"
+#include "SimWaveform.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <thread>
+
+typedef std::chrono::steady_clock SimClock;
+
+struct SimAdsCore
+{
+    std::mutex lock;
+    std::condition_variable changed; // config ditulis ulang / thread berhenti
+    std::thread thread;
+    bool quit = false;
+    uint32_t generation = 0;
+    uint16_t mux = ADS1X15_REG_CONFIG_MUX_SINGLE_0;
+    bool continuous = false;
+    bool converting = false;
+    bool ready = false;
+    int16_t result = 0;
+    float fsRange = 6.144f;
+    uint16_t sps = 128;
+    SimWaveform inputs[SIM_AI_CHANNELS];
+    std::mt19937 rng;
+    SimClock::time_point boot = SimClock::now();
+
+    void run();
+    int16_t convert(SimClock::time_point at);
+};
+
+static uint16_t rateSps(uint16_t bits)
+{
+    static const uint16_t sps[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+    return sps[(bits >> 5) & 7];
+}
+
+static float gainRange(adsGain_t gain)
+{
+    switch (gain)
+    {
+    case GAIN_ONE:
+        return 4.096f;
+    case GAIN_TWO:
+        return 2.048f;
+    case GAIN_FOUR:
+        return 1.024f;
+    case GAIN_EIGHT:
+        return 0.512f;
+    case GAIN_SIXTEEN:
+        return 0.256f;
+    default:
+        return 6.144f;
+    }
+}
+
+int16_t SimAdsCore::convert(SimClock::time_point at)
+{
+    double t = std::chrono::duration<double>(at - boot).count();
+    float v;
+    uint8_t sel = mux >> 12;
+    if (sel >= 4)
+        v = inputs[sel - 4].volts(t);
+    else
+    {
+        // Differential: 0-1, 0-3, 1-3, 2-3
+        static const uint8_t pos[4] = {0, 0, 1, 2};
+        static const uint8_t neg[4] = {1, 3, 3, 3};
+        v = inputs[pos[sel]].volts(t) - inputs[neg[sel]].volts(t);
+    }
+    if (simOptions.noise > 0)
+    {
+        std::normal_distribution<float> noise(0.0f, simOptions.noise);
+        v += noise(rng);
+    }
+    long code = lroundf(v / fsRange * 32768.0f);
+    return (int16_t)constrain(code, -32768L, 32767L);
+}
+
+void SimAdsCore::run()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (!quit)
+    {
+        if (!converting)
+        {
+            changed.wait(guard);
+            continue;
+        }
+        // Konversi pertama selesai 1/SPS setelah config ditulis
+        uint32_t gen = generation;
+        SimClock::duration period = std::chrono::nanoseconds(1000000000ULL / sps);
+        SimClock::time_point due = SimClock::now() + period;
+        while (!quit && generation == gen)
+        {
+            if (changed.wait_until(guard, due, [&] { return quit || generation != gen; }))
+                break;
+            result = convert(due);
+            ready = true;
+            if (!continuous)
+            {
+                converting = false;
+                break;
+            }
+            due += period;
+            // Host sempat tertahan (debugger/suspend): jangan kejar ketinggalan
+            if (SimClock::now() - due > std::chrono::milliseconds(100))
+                due = SimClock::now() + period;
+            guard.unlock();
+            simRaiseInterrupt(simOptions.adsAlertPin);
+            guard.lock();
+        }
+    }
+}
+
+Adafruit_ADS1X15::Adafruit_ADS1X15()
+    : _gain(GAIN_TWOTHIRDS), _dataRate(RATE_ADS1115_128SPS), _core(nullptr) {}
+
+Adafruit_ADS1X15::~Adafruit_ADS1X15()
+{
+    if (!_core)
+        return;
+    {
+        std::lock_guard<std::mutex> guard(_core->lock);
+        _core->quit = true;
+    }
+    _core->changed.notify_all();
+    _core->thread.join();
+    delete _core;
+}
+
+bool Adafruit_ADS1X15::begin(uint8_t i2cAddress, TwoWire *wire)
+{
+    (void)i2cAddress;
+    (void)wire;
+    if (_core)
+        return true;
+    _core = new SimAdsCore();
+    _core->rng.seed(0xAD51115);
+    for (uint8_t ch = 0; ch < SIM_AI_CHANNELS; ch++)
+    {
+        if (!_core->inputs[ch].parse(simOptions.waveform[ch]))
+            fprintf(stderr, "sim: waveform AIN%u tidak valid: %s\n", ch, simOptions.waveform[ch]);
+    }
+    _core->fsRange = gainRange(_gain);
+    _core->sps = rateSps(_dataRate);
+    _core->thread = std::thread(&SimAdsCore::run, _core);
+    return true;
+}
+
+void Adafruit_ADS1X15::setGain(adsGain_t gain)
+{
+    _gain = gain;
+    if (!_core)
+        return;
+    std::lock_guard<std::mutex> guard(_core->lock);
+    _core->fsRange = gainRange(gain);
+}
+
+void Adafruit_ADS1X15::setDataRate(uint16_t rate)
+{
+    // Seperti library asli: baru berlaku pada startADCReading() berikutnya
+    _dataRate = rate;
+}
+
+void Adafruit_ADS1X15::startADCReading(uint16_t mux, bool continuous)
+{
+    if (!_core)
+        return;
+    {
+        std::lock_guard<std::mutex> guard(_core->lock);
+        _core->mux = mux;
+        _core->continuous = continuous;
+        _core->sps = rateSps(_dataRate);
+        _core->fsRange = gainRange(_gain);
+        _core->converting = true;
+        _core->ready = false;
+        _core->generation++;
+    }
+    _core->changed.notify_all();
+}
+
+bool Adafruit_ADS1X15::conversionComplete()
+{
+    if (!_core)
+        return false;
+    std::lock_guard<std::mutex> guard(_core->lock);
+    return _core->ready;
+}
+
+int16_t Adafruit_ADS1X15::getLastConversionResults()
+{
+    if (!_core)
+        return 0;
+    std::lock_guard<std::mutex> guard(_core->lock);
+    return _core->result;
+}
+
+int16_t Adafruit_ADS1X15::readADC_SingleEnded(uint8_t channel)
+{
+    if (!_core || channel > 3)
+        return 0;
+    startADCReading(ADS1X15_REG_CONFIG_MUX_SINGLE_0 + channel * 0x1000, false);
+    while (!conversionComplete())
+        delay(1);
+    return getLastConversionResults();
+}
+
+float Adafruit_ADS1X15::computeVolts(int16_t counts)
+{
+    return counts * (gainRange(_gain) / 32768.0f);
+}
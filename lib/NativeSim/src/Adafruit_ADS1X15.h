@@ -0,0 +1,76 @@
+#ifndef ADAFRUIT_ADS1X15_H
+#define ADAFRUIT_ADS1X15_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// ---------------------------------------------------------
+// ADS1115 simulasi (API Adafruit_ADS1X15)
+// ---------------------------------------------------------
+// AIN0..AIN3 membaca SimWaveform dari SimOptions::waveform (+ derau).
+// Konversi berjalan di thread sendiri dengan periode 1/SPS; dalam mode
+// continuous setiap hasil memberi pulsa ALERT/RDY ke
+// SimOptions::adsAlertPin (ISR dipanggil lewat simRaiseInterrupt),
+// persis seperti comparator yang diset startADCReading().
+
+#define ADS1X15_ADDRESS (0x48)
+
+#define ADS1X15_REG_CONFIG_MUX_DIFF_0_1 (0x0000)
+#define ADS1X15_REG_CONFIG_MUX_DIFF_0_3 (0x1000)
+#define ADS1X15_REG_CONFIG_MUX_DIFF_1_3 (0x2000)
+#define ADS1X15_REG_CONFIG_MUX_DIFF_2_3 (0x3000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_0 (0x4000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_1 (0x5000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_2 (0x6000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_3 (0x7000)
+
+#define RATE_ADS1115_8SPS (0x0000)
+#define RATE_ADS1115_16SPS (0x0020)
+#define RATE_ADS1115_32SPS (0x0040)
+#define RATE_ADS1115_64SPS (0x0060)
+#define RATE_ADS1115_128SPS (0x0080)
+#define RATE_ADS1115_250SPS (0x00A0)
+#define RATE_ADS1115_475SPS (0x00C0)
+#define RATE_ADS1115_860SPS (0x00E0)
+
+typedef enum
+{
+    GAIN_TWOTHIRDS = 0x0000,
+    GAIN_ONE = 0x0200,
+    GAIN_TWO = 0x0400,
+    GAIN_FOUR = 0x0600,
+    GAIN_EIGHT = 0x0800,
+    GAIN_SIXTEEN = 0x0A00
+} adsGain_t;
+
+struct SimAdsCore;
+
+class Adafruit_ADS1X15
+{
+public:
+    Adafruit_ADS1X15();
+    ~Adafruit_ADS1X15();
+
+    bool begin(uint8_t i2cAddress = ADS1X15_ADDRESS, TwoWire *wire = &Wire);
+    void setGain(adsGain_t gain);
+    adsGain_t getGain() { return _gain; }
+    void setDataRate(uint16_t rate);
+    uint16_t getDataRate() { return _dataRate; }
+
+    int16_t readADC_SingleEnded(uint8_t channel);
+    void startADCReading(uint16_t mux, bool continuous);
+    bool conversionComplete();
+    int16_t getLastConversionResults();
+    float computeVolts(int16_t counts);
+
+protected:
+    adsGain_t _gain;
+    uint16_t _dataRate;
+    SimAdsCore *_core;
+};
+
+class Adafruit_ADS1115 : public Adafruit_ADS1X15
+{
+};
+
+#endif // ADAFRUIT_ADS1X15_H
@@ -0,0 +1,120 @@
+#include "Arduino.h"
+#include "SimOptions.h"
+#include "SPI.h"
+#include "Wire.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+#define SIM_PINS 40
+
+EspClass ESP;
+TwoWire Wire;
+SPIClass SPI;
+
+typedef std::chrono::steady_clock SimClock;
+static const SimClock::time_point bootTime = SimClock::now();
+
+uint32_t millis()
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(SimClock::now() - bootTime).count();
+}
+
+uint32_t micros()
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(SimClock::now() - bootTime).count();
+}
+
+void delay(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+// ---------------------------------------------------------
+// GPIO & interrupt
+// ---------------------------------------------------------
+static std::recursive_mutex interruptLock;
+static void (*isrTable[SIM_PINS])() = {};
+static uint8_t pinLevel[SIM_PINS] = {};
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < SIM_PINS && mode == INPUT_PULLUP)
+        pinLevel[pin] = HIGH;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < SIM_PINS ? pinLevel[pin] : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < SIM_PINS)
+        pinLevel[pin] = value ? HIGH : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode)
+{
+    (void)mode;
+    if (pin >= SIM_PINS)
+        return;
+    std::lock_guard<std::recursive_mutex> guard(interruptLock);
+    isrTable[pin] = isr;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin >= SIM_PINS)
+        return;
+    std::lock_guard<std::recursive_mutex> guard(interruptLock);
+    isrTable[pin] = nullptr;
+}
+
+void noInterrupts()
+{
+    interruptLock.lock();
+}
+
+void interrupts()
+{
+    interruptLock.unlock();
+}
+
+void simRaiseInterrupt(uint8_t pin)
+{
+    if (pin >= SIM_PINS)
+        return;
+    std::lock_guard<std::recursive_mutex> guard(interruptLock);
+    if (isrTable[pin])
+        isrTable[pin]();
+}
+
+// ---------------------------------------------------------
+// ESP
+// ---------------------------------------------------------
+uint32_t EspClass::getCycleCount()
+{
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(SimClock::now() - bootTime).count();
+    return (uint32_t)(ns * 240 / 1000);
+}
+
+void EspClass::restart()
+{
+    fflush(stdout);
+    execv("/proc/self/exe", simOptions.argv);
+    execvp(simOptions.argv[0], simOptions.argv); // tanpa /proc
+    perror("restart");
+    exit(1);
+}
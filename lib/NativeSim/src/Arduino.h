@@ -0,0 +1,72 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// ---------------------------------------------------------
+// Pengganti core Arduino-ESP32 untuk build native (Linux)
+// ---------------------------------------------------------
+// Hanya API yang dipakai firmware di src/. Waktu dari steady_clock,
+// interrupt GPIO disimulasikan (lihat simRaiseInterrupt), task FreeRTOS
+// = std::thread (SimRtos.h). Opsi runtime ada di SimOptions.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(s) (s)
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::max;
+using std::min;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+// Satu lock global menggantikan "interrupt off": ISR simulasi
+// (simRaiseInterrupt) juga mengambil lock ini
+void noInterrupts();
+void interrupts();
+
+// Dipanggil perangkat simulasi (mis. ALERT/RDY ADS1115): jalankan ISR
+// yang terpasang pada pin, dari thread pemanggil
+void simRaiseInterrupt(uint8_t pin);
+
+inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+#include "SimRtos.h"
+
+#endif // ARDUINO_H
@@ -0,0 +1,25 @@
+#ifndef ESP_H
+#define ESP_H
+
+#include <stdint.h>
+
+// Nilai heap/flash tetap (perkiraan ESP32 4 MB, partisi default),
+// kecuali siklus CPU yang diturunkan dari jam host pada 240 MHz
+class EspClass
+{
+public:
+    uint32_t getFreeHeap() { return 180000; }
+    uint32_t getMinFreeHeap() { return 150000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+    uint32_t getHeapSize() { return 320000; }
+    uint32_t getSketchSize() { return 1050000; }
+    uint32_t getFreeSketchSpace() { return 1310720; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getCycleCount();
+    // Proses dijalankan ulang (exec) dengan argumen yang sama
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // ESP_H
@@ -0,0 +1,338 @@
+#include "EthernetESP32.h"
+#include "SimOptions.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define SIM_LISTEN_BACKLOG 8
+
+EthernetClass Ethernet;
+
+// ---------------------------------------------------------
+// IPAddress
+// ---------------------------------------------------------
+IPAddress::IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+    uint8_t *p = (uint8_t *)&_addr;
+    p[0] = a;
+    p[1] = b;
+    p[2] = c;
+    p[3] = d;
+}
+
+bool IPAddress::fromString(const char *s)
+{
+    struct in_addr a;
+    if (!s || inet_pton(AF_INET, s, &a) != 1)
+        return false;
+    _addr = a.s_addr;
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+}
+
+// ---------------------------------------------------------
+// Socket
+// ---------------------------------------------------------
+struct SimSocket
+{
+    int fd;
+    explicit SimSocket(int f) : fd(f) {}
+    ~SimSocket() { close(); }
+    void close()
+    {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+};
+
+static void configureSocket(int fd)
+{
+    int one = 1;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    // Respons dikirim dalam potongan kecil (ChunkedPrint), jangan ditahan Nagle
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+EthernetClient::EthernetClient(int fd) : _sock(std::make_shared<SimSocket>(fd)), _timeoutMs(3000)
+{
+    configureSocket(fd);
+}
+
+int EthernetClient::connect(IPAddress ip, uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+int EthernetClient::connect(const char *host, uint16_t port)
+{
+    stop();
+    if (!simOptions.linkUp)
+        return 0;
+    struct addrinfo hints, *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &res) != 0 || !res)
+        return 0;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        freeaddrinfo(res);
+        return 0;
+    }
+    configureSocket(fd);
+    int rc = ::connect(fd, res->ai_addr, res->ai_addrlen);
+    freeaddrinfo(res);
+    if (rc != 0 && errno == EINPROGRESS)
+    {
+        struct pollfd p = {fd, POLLOUT, 0};
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (poll(&p, 1, _timeoutMs) == 1 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0)
+            rc = 0;
+    }
+    if (rc != 0)
+    {
+        ::close(fd);
+        return 0;
+    }
+    _sock = std::make_shared<SimSocket>(fd);
+    return 1;
+}
+
+size_t EthernetClient::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t EthernetClient::write(const uint8_t *buffer, size_t size)
+{
+    if (!_sock || _sock->fd < 0)
+        return 0;
+    // Seperti W5500: tunggu ruang buffer TX, batas waktu = timeout koneksi
+    size_t sent = 0;
+    while (sent < size)
+    {
+        ssize_t n = send(_sock->fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            sent += n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            struct pollfd p = {_sock->fd, POLLOUT, 0};
+            if (poll(&p, 1, _timeoutMs) == 1)
+                continue;
+        }
+        break;
+    }
+    return sent;
+}
+
+// Seperti W5500 (ruang bebas buffer TX socket): SO_SNDBUF dikurangi
+// byte yang masih antre di kernel
+int EthernetClient::availableForWrite()
+{
+    if (!_sock || _sock->fd < 0)
+        return 0;
+    int size = 0, queued = 0;
+    socklen_t len = sizeof(size);
+    if (getsockopt(_sock->fd, SOL_SOCKET, SO_SNDBUF, &size, &len) < 0 ||
+        ioctl(_sock->fd, TIOCOUTQ, &queued) < 0)
+        return 0;
+    return size > queued ? size - queued : 0;
+}
+
+int EthernetClient::available()
+{
+    if (!_sock || _sock->fd < 0)
+        return 0;
+    int n = 0;
+    if (ioctl(_sock->fd, FIONREAD, &n) < 0)
+        return 0;
+    return n;
+}
+
+int EthernetClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int EthernetClient::read(uint8_t *buffer, size_t size)
+{
+    if (!_sock || _sock->fd < 0)
+        return -1;
+    ssize_t n = recv(_sock->fd, buffer, size, MSG_DONTWAIT);
+    return n > 0 ? (int)n : -1;
+}
+
+int EthernetClient::peek()
+{
+    if (!_sock || _sock->fd < 0)
+        return -1;
+    uint8_t c;
+    return recv(_sock->fd, &c, 1, MSG_DONTWAIT | MSG_PEEK) == 1 ? c : -1;
+}
+
+uint8_t EthernetClient::connected()
+{
+    if (!_sock || _sock->fd < 0)
+        return 0;
+    // Data yang belum dibaca tetap dihitung "connected" (sama seperti W5500)
+    uint8_t c;
+    ssize_t n = recv(_sock->fd, &c, 1, MSG_DONTWAIT | MSG_PEEK);
+    if (n > 0)
+        return 1;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return 1;
+    return 0;
+}
+
+void EthernetClient::stop()
+{
+    if (_sock)
+        _sock->close();
+    _sock.reset();
+}
+
+static bool sockName(int fd, bool peer, struct sockaddr_in &out)
+{
+    socklen_t len = sizeof(out);
+    memset(&out, 0, sizeof(out));
+    if (fd < 0)
+        return false;
+    return (peer ? getpeername(fd, (struct sockaddr *)&out, &len) : getsockname(fd, (struct sockaddr *)&out, &len)) == 0;
+}
+
+IPAddress EthernetClient::remoteIP()
+{
+    struct sockaddr_in a;
+    return sockName(_sock ? _sock->fd : -1, true, a) ? IPAddress(a.sin_addr.s_addr) : IPAddress();
+}
+
+uint16_t EthernetClient::remotePort()
+{
+    struct sockaddr_in a;
+    return sockName(_sock ? _sock->fd : -1, true, a) ? ntohs(a.sin_port) : 0;
+}
+
+IPAddress EthernetClient::localIP()
+{
+    struct sockaddr_in a;
+    return sockName(_sock ? _sock->fd : -1, false, a) ? IPAddress(a.sin_addr.s_addr) : IPAddress();
+}
+
+uint16_t EthernetClient::localPort()
+{
+    struct sockaddr_in a;
+    return sockName(_sock ? _sock->fd : -1, false, a) ? ntohs(a.sin_port) : 0;
+}
+
+EthernetClient::operator bool()
+{
+    return _sock && _sock->fd >= 0;
+}
+
+// ---------------------------------------------------------
+// Server
+// ---------------------------------------------------------
+void EthernetServer::begin(uint16_t port)
+{
+    if (port)
+        _port = port;
+    end();
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(_port + simOptions.portOffset);
+    inet_pton(AF_INET, simOptions.bindAddress, &addr.sin_addr);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SIM_LISTEN_BACKLOG) != 0)
+    {
+        fprintf(stderr, "sim: bind %s:%u gagal: %s\n", simOptions.bindAddress,
+                _port + simOptions.portOffset, strerror(errno));
+        ::close(fd);
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    _fd = fd;
+}
+
+void EthernetServer::end()
+{
+    if (_fd >= 0)
+        ::close(_fd);
+    _fd = -1;
+}
+
+EthernetClient EthernetServer::accept()
+{
+    if (_fd < 0)
+        return EthernetClient();
+    int fd = accept4(_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0)
+        return EthernetClient();
+    if (!simOptions.linkUp)
+    {
+        // Kabel dicabut: koneksi tidak pernah sampai ke W5500
+        ::close(fd);
+        return EthernetClient();
+    }
+    return EthernetClient(fd);
+}
+
+// ---------------------------------------------------------
+// Ethernet
+// ---------------------------------------------------------
+EthernetClass::EthernetClass()
+{
+    memset(_mac, 0, sizeof(_mac));
+}
+
+int EthernetClass::begin(uint8_t *mac, unsigned long timeoutMs)
+{
+    (void)timeoutMs;
+    memcpy(_mac, mac, 6);
+    _ip.fromString(simOptions.bindAddress);
+    _subnet = IPAddress(255, 255, 255, 0);
+    _gateway = _dns = IPAddress(_ip[0], _ip[1], _ip[2], 1);
+    return 1;
+}
+
+void EthernetClass::begin(uint8_t *mac, IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet)
+{
+    // Alamat statis hanya dicatat; socket tetap bind ke bindAddress
+    memcpy(_mac, mac, 6);
+    _ip = ip;
+    _dns = dns;
+    _gateway = gateway;
+    _subnet = subnet;
+}
+
+EthernetLinkStatus EthernetClass::linkStatus()
+{
+    return simOptions.linkUp ? LinkON : LinkOFF;
+}
@@ -0,0 +1,143 @@
+#ifndef ETHERNETESP32_H
+#define ETHERNETESP32_H
+
+#include <Arduino.h>
+#include <memory>
+
+// ---------------------------------------------------------
+// Pengganti EthernetESP32 (W5500) di atas socket TCP Linux
+// ---------------------------------------------------------
+// Server bind ke SimOptions::bindAddress dengan port + portOffset;
+// semua socket non-blocking seperti socket W5500. Status link
+// mengikuti SimOptions::linkUp (dibalik dengan SIGUSR1).
+
+enum EthernetLinkStatus
+{
+    Unknown,
+    LinkON,
+    LinkOFF
+};
+
+class IPAddress
+{
+public:
+    IPAddress() : _addr(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+    explicit IPAddress(uint32_t networkOrder) : _addr(networkOrder) {}
+
+    bool fromString(const char *s);
+    bool fromString(const String &s) { return fromString(s.c_str()); }
+    String toString() const;
+    uint8_t operator[](int i) const { return ((const uint8_t *)&_addr)[i]; }
+    operator uint32_t() const { return _addr; }
+    bool operator==(const IPAddress &o) const { return _addr == o._addr; }
+
+private:
+    uint32_t _addr; // network byte order
+};
+
+class Client : public Stream
+{
+public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char *host, uint16_t port) = 0;
+    virtual int read(uint8_t *buffer, size_t size) = 0;
+    virtual uint8_t connected() = 0;
+    virtual void stop() = 0;
+    using Stream::read;
+};
+
+struct SimSocket;
+
+class EthernetClient : public Client
+{
+public:
+    EthernetClient() : _timeoutMs(3000) {}
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    void setConnectionTimeout(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite();
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    uint8_t connected() override;
+    void stop() override;
+
+    IPAddress remoteIP();
+    uint16_t remotePort();
+    IPAddress localIP();
+    uint16_t localPort();
+
+    explicit operator bool();
+    bool operator==(const EthernetClient &o) const { return _sock == o._sock; }
+    bool operator!=(const EthernetClient &o) const { return _sock != o._sock; }
+
+private:
+    friend class EthernetServer;
+    explicit EthernetClient(int fd);
+
+    std::shared_ptr<SimSocket> _sock; // salinan berbagi socket yang sama
+    uint16_t _timeoutMs;
+};
+
+class EthernetServer
+{
+public:
+    explicit EthernetServer(uint16_t port = 80) : _port(port), _fd(-1) {}
+    ~EthernetServer() { end(); }
+
+    void begin(uint16_t port = 0);
+    void end();
+    // Koneksi baru berikutnya (klien tidak valid jika tidak ada)
+    EthernetClient accept();
+    explicit operator bool() const { return _fd >= 0; }
+
+private:
+    uint16_t _port;
+    int _fd;
+};
+
+class W5500Driver
+{
+public:
+    W5500Driver(int8_t cs = 5, int8_t irq = -1, int8_t rst = -1)
+    {
+        (void)cs;
+        (void)irq;
+        (void)rst;
+    }
+};
+
+class EthernetClass
+{
+public:
+    EthernetClass();
+
+    void init(W5500Driver &driver) { (void)driver; }
+    // DHCP selalu "berhasil": alamat = SimOptions::bindAddress
+    int begin(uint8_t *mac, unsigned long timeoutMs = 60000);
+    void begin(uint8_t *mac, IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet);
+    void setHostname(const char *name) { (void)name; }
+
+    EthernetLinkStatus linkStatus();
+    IPAddress localIP() { return _ip; }
+    IPAddress subnetMask() { return _subnet; }
+    IPAddress gatewayIP() { return _gateway; }
+    IPAddress dnsServerIP() { return _dns; }
+    void macAddress(uint8_t *mac) { memcpy(mac, _mac, 6); }
+
+private:
+    uint8_t _mac[6];
+    IPAddress _ip, _dns, _gateway, _subnet;
+};
+
+extern EthernetClass Ethernet;
+
+#endif // ETHERNETESP32_H
@@ -0,0 +1,294 @@
+#include "FS.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs
+{
+
+struct FileImpl
+{
+    FILE *file;
+    DIR *dir;
+    bool isDir;
+    std::string path; // path di dalam filesystem ("/log/0.seg")
+    std::string host; // path di host
+
+    FileImpl() : file(nullptr), dir(nullptr), isDir(false) {}
+    ~FileImpl() { close(); }
+
+    void close()
+    {
+        if (file)
+            fclose(file);
+        if (dir)
+            closedir(dir);
+        file = nullptr;
+        dir = nullptr;
+        isDir = false;
+    }
+};
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    if (!_p || !_p->file)
+        return 0;
+    return fwrite(buffer, 1, size, _p->file);
+}
+
+int File::available()
+{
+    if (!_p || !_p->file)
+        return 0;
+    return (int)(size() - position());
+}
+
+int File::read()
+{
+    if (!_p || !_p->file)
+        return -1;
+    int c = fgetc(_p->file);
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    if (!_p || !_p->file)
+        return 0;
+    return fread(buffer, 1, size, _p->file);
+}
+
+int File::peek()
+{
+    if (!_p || !_p->file)
+        return -1;
+    int c = fgetc(_p->file);
+    if (c == EOF)
+        return -1;
+    ungetc(c, _p->file);
+    return c;
+}
+
+void File::flush()
+{
+    if (_p && _p->file)
+        fflush(_p->file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    if (!_p || !_p->file)
+        return false;
+    int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+    return fseek(_p->file, pos, whence) == 0;
+}
+
+size_t File::position() const
+{
+    if (!_p || !_p->file)
+        return 0;
+    long p = ftell(_p->file);
+    return p < 0 ? 0 : (size_t)p;
+}
+
+size_t File::size() const
+{
+    if (!_p || !_p->file)
+        return 0;
+    // Termasuk data yang masih di buffer stdio
+    fflush(_p->file);
+    struct stat st;
+    if (fstat(fileno(_p->file), &st) != 0)
+        return 0;
+    return st.st_size;
+}
+
+void File::close()
+{
+    if (_p)
+        _p->close();
+    _p.reset();
+}
+
+time_t File::getLastWrite()
+{
+    struct stat st;
+    if (!_p || stat(_p->host.c_str(), &st) != 0)
+        return 0;
+    return st.st_mtime;
+}
+
+const char *File::path() const
+{
+    return _p ? _p->path.c_str() : nullptr;
+}
+
+const char *File::name() const
+{
+    if (!_p)
+        return nullptr;
+    size_t slash = _p->path.rfind('/');
+    return _p->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+bool File::isDirectory() const
+{
+    return _p && _p->isDir;
+}
+
+File File::openNextFile(const char *mode)
+{
+    if (!_p || !_p->isDir)
+        return File();
+    if (!_p->dir)
+        _p->dir = opendir(_p->host.c_str());
+    if (!_p->dir)
+        return File();
+    struct dirent *e;
+    while ((e = readdir(_p->dir)))
+    {
+        if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+            continue;
+        FileImplPtr child = std::make_shared<FileImpl>();
+        child->path = (_p->path == "/" ? "" : _p->path) + "/" + e->d_name;
+        child->host = _p->host + "/" + e->d_name;
+        struct stat st;
+        if (stat(child->host.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            child->isDir = true;
+        else if (!(child->file = fopen(child->host.c_str(), strcmp(mode, "r") == 0 ? "rbe" : "r+be")))
+            continue;
+        return File(child);
+    }
+    return File();
+}
+
+void File::rewindDirectory()
+{
+    if (_p && _p->dir)
+        rewinddir(_p->dir);
+}
+
+String File::readString()
+{
+    std::string s;
+    int c;
+    while ((c = read()) >= 0)
+        s += (char)c;
+    return String(s);
+}
+
+String File::readStringUntil(char terminator)
+{
+    std::string s;
+    int c;
+    while ((c = read()) >= 0 && c != terminator)
+        s += (char)c;
+    return String(s);
+}
+
+File::operator bool() const
+{
+    return _p && (_p->file || _p->isDir);
+}
+
+std::string FS::hostPath(const char *path) const
+{
+    if (_root.empty() || !path || path[0] != '/')
+        return std::string();
+    return _root + path;
+}
+
+static bool makeParents(const std::string &host)
+{
+    for (size_t p = host.find('/', 1); p != std::string::npos; p = host.find('/', p + 1))
+    {
+        if (::mkdir(host.substr(0, p).c_str(), 0755) != 0 && errno != EEXIST)
+            return false;
+    }
+    return true;
+}
+
+File FS::open(const char *path, const char *mode, const bool create)
+{
+    std::string host = hostPath(path);
+    if (host.empty())
+        return File();
+    FileImplPtr p = std::make_shared<FileImpl>();
+    p->path = path;
+    p->host = host;
+
+    struct stat st;
+    bool found = stat(host.c_str(), &st) == 0;
+    if (found && S_ISDIR(st.st_mode))
+    {
+        p->isDir = true;
+        return File(p);
+    }
+
+    const char *hostMode;
+    if (strcmp(mode, "r") == 0)
+        hostMode = "rbe";
+    else if (strcmp(mode, "r+") == 0)
+        hostMode = "r+be";
+    else if (strcmp(mode, "w") == 0)
+        hostMode = "wbe";
+    else if (strcmp(mode, "w+") == 0)
+        hostMode = "w+be";
+    else if (strcmp(mode, "a") == 0)
+        hostMode = "abe";
+    else if (strcmp(mode, "a+") == 0)
+        hostMode = "a+be";
+    else
+        return File();
+
+    if (!found && mode[0] == 'r')
+        return File();
+    if (create && !makeParents(host))
+        return File();
+    p->file = fopen(host.c_str(), hostMode);
+    if (!p->file)
+        return File();
+    return File(p);
+}
+
+bool FS::exists(const char *path)
+{
+    std::string host = hostPath(path);
+    struct stat st;
+    return !host.empty() && stat(host.c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    std::string host = hostPath(path);
+    return !host.empty() && ::unlink(host.c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    std::string a = hostPath(from);
+    std::string b = hostPath(to);
+    return !a.empty() && !b.empty() && ::rename(a.c_str(), b.c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+    std::string host = hostPath(path);
+    return !host.empty() && (::mkdir(host.c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool FS::rmdir(const char *path)
+{
+    std::string host = hostPath(path);
+    return !host.empty() && ::rmdir(host.c_str()) == 0;
+}
+
+} // namespace fs
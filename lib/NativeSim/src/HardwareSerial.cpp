@@ -0,0 +1,75 @@
+#include "Arduino.h"
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin)
+{
+    (void)rxPin;
+    (void)txPin;
+    _baud = baud;
+    _config = config;
+}
+
+uint8_t HardwareSerial::bitsPerChar() const
+{
+    // Format SERIAL_xyz core ESP32: bit 2..3 = data bit - 5, bit 1 = parity, bit 5 = 2 stop bit
+    uint8_t bits = 1 + 5 + ((_config >> 2) & 3);
+    if (_config & 0x2)
+        bits++;
+    bits += (_config & 0x20) ? 2 : 1;
+    return bits;
+}
+
+int HardwareSerial::available()
+{
+    if (_uart != 0)
+        return 0;
+    int n = 0;
+    // stdin bukan terminal/pipe (mis. /dev/null) -> tidak ada data
+    if (ioctl(STDIN_FILENO, FIONREAD, &n) < 0)
+        n = 0;
+    return n + (_peeked >= 0 ? 1 : 0);
+}
+
+int HardwareSerial::read()
+{
+    if (_peeked >= 0)
+    {
+        int c = _peeked;
+        _peeked = -1;
+        return c;
+    }
+    if (_uart != 0 || available() <= 0)
+        return -1;
+    uint8_t c;
+    return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+}
+
+int HardwareSerial::peek()
+{
+    if (_peeked < 0)
+        _peeked = read();
+    return _peeked;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (_uart != 0)
+        return size;
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush()
+{
+    if (_uart == 0)
+        fflush(stdout);
+}
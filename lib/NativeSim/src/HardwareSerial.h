@@ -0,0 +1,57 @@
+#ifndef HARDWARESERIAL_H
+#define HARDWARESERIAL_H
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8N2 0x800003c
+#define SERIAL_8E1 0x800001e
+#define SERIAL_8E2 0x800003e
+#define SERIAL_8O1 0x800001f
+#define SERIAL_8O2 0x800003f
+#define SERIAL_7N1 0x8000018
+#define SERIAL_7N2 0x8000038
+#define SERIAL_7E1 0x800001a
+#define SERIAL_7E2 0x800003a
+#define SERIAL_7O1 0x800001b
+#define SERIAL_7O2 0x800003b
+
+// UART0 = stdin/stdout proses (console), UART lain tidak tersambung:
+// baudrate & format tetap dicatat supaya ModbusMaster simulasi bisa
+// menghitung waktu frame RTU.
+class HardwareSerial : public Stream
+{
+public:
+    explicit HardwareSerial(int uart) : _uart(uart), _baud(0), _config(SERIAL_8N1) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() { _baud = 0; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    // Ruang FIFO TX; stdout tidak dibatasi
+    int availableForWrite() { return _uart == 0 ? 4096 : 0; }
+
+    unsigned long baudRate() const { return _baud; }
+    // Jumlah bit per karakter (start + data + parity + stop)
+    uint8_t bitsPerChar() const;
+
+    explicit operator bool() const { return true; }
+
+private:
+    int _uart;
+    unsigned long _baud;
+    uint32_t _config;
+    int _peeked = -1;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // HARDWARESERIAL_H
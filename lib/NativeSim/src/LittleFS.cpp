@@ -0,0 +1,114 @@
+#include "LittleFS.h"
+#include "SimOptions.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LITTLEFS_BLOCK_SIZE 4096
+
+fs::LittleFSFS LittleFS;
+
+// Salin isi direktori image (rekursif), setara "pio run -t uploadfs"
+static bool copyTree(const std::string &from, const std::string &to)
+{
+    if (::mkdir(to.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+    DIR *d = opendir(from.c_str());
+    if (!d)
+        return false;
+    bool ok = true;
+    struct dirent *e;
+    while (ok && (e = readdir(d)))
+    {
+        if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+            continue;
+        std::string src = from + "/" + e->d_name;
+        std::string dst = to + "/" + e->d_name;
+        struct stat st;
+        if (stat(src.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+        {
+            ok = copyTree(src, dst);
+            continue;
+        }
+        FILE *in = fopen(src.c_str(), "rb");
+        FILE *out = in ? fopen(dst.c_str(), "wb") : nullptr;
+        char buf[4096];
+        size_t n;
+        while (in && out && (n = fread(buf, 1, sizeof(buf), in)) > 0)
+            ok = fwrite(buf, 1, n, out) == n && ok;
+        ok = ok && in && out;
+        if (in)
+            fclose(in);
+        if (out)
+            fclose(out);
+    }
+    closedir(d);
+    return ok;
+}
+
+static size_t treeBytes(const std::string &dir)
+{
+    size_t used = LITTLEFS_BLOCK_SIZE; // metadata direktori
+    DIR *d = opendir(dir.c_str());
+    if (!d)
+        return 0;
+    struct dirent *e;
+    while ((e = readdir(d)))
+    {
+        if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+            continue;
+        std::string path = dir + "/" + e->d_name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            used += treeBytes(path);
+        else
+            used += (st.st_size + LITTLEFS_BLOCK_SIZE - 1) / LITTLEFS_BLOCK_SIZE * LITTLEFS_BLOCK_SIZE;
+    }
+    closedir(d);
+    return used;
+}
+
+namespace fs
+{
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+{
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    if (!_root.empty())
+        return true;
+    struct stat st;
+    if (stat(simOptions.fsRoot, &st) != 0)
+    {
+        if (!formatOnFail && !simOptions.fsImage)
+            return false;
+        bool ok = simOptions.fsImage ? copyTree(simOptions.fsImage, simOptions.fsRoot)
+                                     : ::mkdir(simOptions.fsRoot, 0755) == 0;
+        if (!ok)
+            return false;
+    }
+    else if (!S_ISDIR(st.st_mode))
+    {
+        return false;
+    }
+    _root = simOptions.fsRoot;
+    return true;
+}
+
+size_t LittleFSFS::totalBytes()
+{
+    return simOptions.fsSize;
+}
+
+size_t LittleFSFS::usedBytes()
+{
+    return _root.empty() ? 0 : treeBytes(_root);
+}
+
+} // namespace fs
@@ -0,0 +1,26 @@
+#ifndef LITTLEFS_H
+#define LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs
+{
+
+// Partisi LittleFS = direktori SimOptions::fsRoot. Mount pertama pada
+// direktori yang belum ada menyalin SimOptions::fsImage (folder data/),
+// sama seperti flash yang sudah di-uploadfs.
+class LittleFSFS : public FS
+{
+public:
+    bool begin(bool formatOnFail = false, const char *basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char *partitionLabel = "spiffs");
+    void end() { _root.clear(); }
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // LITTLEFS_H
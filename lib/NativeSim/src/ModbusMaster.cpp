@@ -0,0 +1,112 @@
+#include "ModbusMaster.h"
+#include "SimOptions.h"
+
+#define SIM_SLAVE_TURNAROUND_MS 5
+
+ModbusMaster::ModbusMaster()
+    : _slave(0), _serial(nullptr), _preTransmission(nullptr), _postTransmission(nullptr)
+{
+    clearResponseBuffer();
+}
+
+void ModbusMaster::begin(uint8_t slave, Stream &serial)
+{
+    _slave = slave;
+    _serial = &serial;
+}
+
+uint8_t ModbusMaster::readCoils(uint16_t address, uint16_t quantity)
+{
+    return transaction(0x01, address, quantity);
+}
+
+uint8_t ModbusMaster::readDiscreteInputs(uint16_t address, uint16_t quantity)
+{
+    return transaction(0x02, address, quantity);
+}
+
+uint8_t ModbusMaster::readHoldingRegisters(uint16_t address, uint16_t quantity)
+{
+    return transaction(0x03, address, quantity);
+}
+
+uint8_t ModbusMaster::readInputRegisters(uint16_t address, uint16_t quantity)
+{
+    return transaction(0x04, address, quantity);
+}
+
+uint16_t ModbusMaster::getResponseBuffer(uint8_t index)
+{
+    return index < ku8MaxBufferSize ? _response[index] : 0xFFFF;
+}
+
+void ModbusMaster::clearResponseBuffer()
+{
+    memset(_response, 0, sizeof(_response));
+}
+
+// Nilai sintetis: register ~ 1000 + 10*alamat dengan sinus periode 2 menit,
+// bit berganti setiap 5 detik
+static uint16_t simRegister(uint8_t slave, uint16_t address, double t)
+{
+    return (uint16_t)(1000 + (address % 100) * 10 + lround(50 * sin(2 * M_PI * t / 120 + slave + address)));
+}
+
+static bool simBit(uint8_t slave, uint16_t address, double t)
+{
+    return (((uint32_t)(t / 5)) + slave + address) & 1;
+}
+
+uint8_t ModbusMaster::transaction(uint8_t function, uint16_t address, uint16_t quantity)
+{
+    bool bits = function <= 0x02;
+    uint16_t limit = bits ? 2000 : 125;
+
+    // Waktu kirim request (8 byte) + jeda 3.5 karakter
+    const HardwareSerial *uart = dynamic_cast<const HardwareSerial *>(_serial);
+    unsigned long baud = uart && uart->baudRate() ? uart->baudRate() : 9600;
+    uint8_t charBits = uart ? uart->bitsPerChar() : 10;
+    double charMs = 1000.0 * charBits / baud;
+
+    if (_preTransmission)
+        _preTransmission();
+    delayMicroseconds((uint32_t)(8 * charMs * 1000));
+    if (_postTransmission)
+        _postTransmission();
+
+    if (_slave == 0 || _slave >= SIM_MODBUS_SLAVES || !simOptions.modbusSlave[_slave])
+    {
+        delay(ku16MBResponseTimeout);
+        return ku8MBResponseTimedOut;
+    }
+    if (quantity == 0 || quantity > limit)
+    {
+        delay((uint32_t)(SIM_SLAVE_TURNAROUND_MS + 5 * charMs));
+        return ku8MBIllegalDataValue;
+    }
+
+    uint16_t bytes = bits ? (quantity + 7) / 8 : quantity * 2;
+    delay((uint32_t)(SIM_SLAVE_TURNAROUND_MS + (5 + bytes + 3.5) * charMs));
+
+    if (simOptions.modbusRequest)
+        simOptions.modbusRequest(_slave, function, address, quantity);
+    double t = millis() / 1000.0;
+    clearResponseBuffer();
+    if (bits)
+    {
+        for (uint16_t i = 0; i < quantity && i / 16 < ku8MaxBufferSize; i++)
+        {
+            bool on = simOptions.modbusValue ? simOptions.modbusValue(_slave, function, address + i) != 0
+                                             : simBit(_slave, address + i, t);
+            if (on)
+                _response[i / 16] |= 1 << (i % 16);
+        }
+    }
+    else
+    {
+        for (uint16_t i = 0; i < quantity && i < ku8MaxBufferSize; i++)
+            _response[i] = simOptions.modbusValue ? simOptions.modbusValue(_slave, function, address + i)
+                                                  : simRegister(_slave, address + i, t);
+    }
+    return ku8MBSuccess;
+}
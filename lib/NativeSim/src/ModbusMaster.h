@@ -0,0 +1,55 @@
+#ifndef MODBUSMASTER_H
+#define MODBUSMASTER_H
+
+#include <Arduino.h>
+
+// ---------------------------------------------------------
+// ModbusMaster simulasi (API library 4-20ma/ModbusMaster)
+// ---------------------------------------------------------
+// Tidak ada bus RS485: slave yang diaktifkan di SimOptions::modbusSlave
+// menjawab dengan nilai sintetis yang berubah pelan terhadap waktu
+// (atau SimOptions::modbusValue di unit test), slave lain timeout.
+// Durasi transaksi dihitung dari panjang frame RTU dan baudrate/format
+// Serial yang diberikan ke begin(), jadi waktu scan ModbusPoller tetap
+// realistis.
+class ModbusMaster
+{
+public:
+    static const uint8_t ku8MBIllegalFunction = 0x01;
+    static const uint8_t ku8MBIllegalDataAddress = 0x02;
+    static const uint8_t ku8MBIllegalDataValue = 0x03;
+    static const uint8_t ku8MBSlaveDeviceFailure = 0x04;
+    static const uint8_t ku8MBSuccess = 0x00;
+    static const uint8_t ku8MBInvalidSlaveID = 0xE0;
+    static const uint8_t ku8MBInvalidFunction = 0xE1;
+    static const uint8_t ku8MBResponseTimedOut = 0xE2;
+    static const uint8_t ku8MBInvalidCRC = 0xE3;
+
+    ModbusMaster();
+
+    void begin(uint8_t slave, Stream &serial);
+    void preTransmission(void (*action)()) { _preTransmission = action; }
+    void postTransmission(void (*action)()) { _postTransmission = action; }
+
+    uint8_t readCoils(uint16_t address, uint16_t quantity);
+    uint8_t readDiscreteInputs(uint16_t address, uint16_t quantity);
+    uint8_t readHoldingRegisters(uint16_t address, uint16_t quantity);
+    uint8_t readInputRegisters(uint16_t address, uint16_t quantity);
+
+    uint16_t getResponseBuffer(uint8_t index);
+    void clearResponseBuffer();
+
+private:
+    static const uint8_t ku8MaxBufferSize = 64;
+    static const uint16_t ku16MBResponseTimeout = 2000; // ms
+
+    uint8_t transaction(uint8_t function, uint16_t address, uint16_t quantity);
+
+    uint8_t _slave;
+    Stream *_serial;
+    uint16_t _response[ku8MaxBufferSize];
+    void (*_preTransmission)();
+    void (*_postTransmission)();
+};
+
+#endif // MODBUSMASTER_H
@@ -0,0 +1,33 @@
+#include "Arduino.h"
+#include <stdarg.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+        n += write(*buffer++);
+    return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char small[128];
+    va_list ap;
+    va_start(ap, format);
+    int len = vsnprintf(small, sizeof(small), format, ap);
+    va_end(ap);
+    if (len < 0)
+        return 0;
+    if ((size_t)len < sizeof(small))
+        return write((const uint8_t *)small, len);
+    // Sama seperti core ESP32: buffer heap jika tidak muat
+    char *big = (char *)malloc(len + 1);
+    if (!big)
+        return 0;
+    va_start(ap, format);
+    vsnprintf(big, len + 1, format, ap);
+    va_end(ap);
+    size_t n = write((const uint8_t *)big, len);
+    free(big);
+    return n;
+}
@@ -0,0 +1,22 @@
+#ifndef SPI_H
+#define SPI_H
+
+#include <Arduino.h>
+
+// W5500 disimulasikan di level socket (EthernetESP32.h), SPI tidak dipakai
+class SPIClass
+{
+public:
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1)
+    {
+        (void)sck;
+        (void)miso;
+        (void)mosi;
+        (void)ss;
+    }
+    void end() {}
+};
+
+extern SPIClass SPI;
+
+#endif // SPI_H
@@ -0,0 +1,129 @@
+#include "Arduino.h"
+#include "SimDigital.h"
+#include "SimOptions.h"
+#include "driver/pcnt.h"
+#include <chrono>
+#include <thread>
+
+typedef std::chrono::steady_clock SimClock;
+
+static bool loadEdges(const char *path, std::vector<SimPulseSource::Edge> &out);
+
+bool SimPulseSource::parse(const char *spec)
+{
+    int level;
+    double hz, duty = 0.5;
+    if (sscanf(spec, "dc:%d", &level) == 1)
+    {
+        _type = LEVEL;
+        _level = level != 0;
+    }
+    else if (sscanf(spec, "pulse:%lf,%lf", &hz, &duty) >= 1 && hz > 0 && duty > 0 && duty < 1)
+    {
+        _type = PULSE;
+        _hz = hz;
+        _duty = duty;
+    }
+    else if (strncmp(spec, "file:", 5) == 0)
+    {
+        _edges.clear();
+        if (!loadEdges(spec + 5, _edges))
+            return false;
+        _type = REPLAY;
+    }
+    else
+        return false;
+    return true;
+}
+
+static bool loadEdges(const char *path, std::vector<SimPulseSource::Edge> &out)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+    char line[128];
+    bool level = false;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+            continue;
+        char *end;
+        unsigned long long us = strtoull(line, &end, 10);
+        if (end == line)
+            continue;
+        level = *end == ',' ? strtol(end + 1, nullptr, 10) != 0 : !level;
+        if (!out.empty() && us < out.back().us)
+            break; // timestamp harus naik
+        out.push_back({us, level});
+    }
+    fclose(f);
+    return !out.empty() && out.back().us > 0;
+}
+
+static void applyEdge(uint8_t pin, bool level)
+{
+    if ((digitalRead(pin) == HIGH) == level)
+        return;
+    digitalWrite(pin, level ? HIGH : LOW);
+    simPcntEdge(pin, level);
+    simRaiseInterrupt(pin);
+}
+
+void SimPulseSource::run(uint8_t pin)
+{
+    if (_type == LEVEL)
+    {
+        applyEdge(pin, _level);
+        return;
+    }
+    SimClock::time_point start = SimClock::now();
+    uint64_t cycle = 0;
+    size_t next = 0;
+    for (;;)
+    {
+        uint64_t atNs;
+        bool level;
+        if (_type == PULSE)
+        {
+            // Edge genap = naik di awal periode, ganjil = turun setelah DUTY
+            double period = 1e9 / _hz;
+            atNs = (uint64_t)((cycle / 2) * period + ((cycle & 1) ? _duty * period : 0));
+            level = !(cycle & 1);
+            cycle++;
+        }
+        else
+        {
+            uint64_t length = _edges.back().us;
+            atNs = (cycle * length + _edges[next].us) * 1000ULL;
+            level = _edges[next].level;
+            if (++next == _edges.size())
+            {
+                next = 0;
+                cycle++;
+            }
+        }
+        SimClock::time_point due = start + std::chrono::nanoseconds(atNs);
+        // Host sempat tertahan (debugger/suspend): jangan kejar ketinggalan
+        if (SimClock::now() - due > std::chrono::milliseconds(100))
+        {
+            start += SimClock::now() - due;
+            due = SimClock::now();
+        }
+        std::this_thread::sleep_until(due);
+        applyEdge(pin, level);
+    }
+}
+
+void simDigitalBegin()
+{
+    static SimPulseSource sources[SIM_DI_CHANNELS];
+    for (uint8_t ch = 0; ch < SIM_DI_CHANNELS; ch++)
+    {
+        if (!sources[ch].parse(simOptions.digital[ch]))
+        {
+            fprintf(stderr, "sim: sinyal DI%u tidak valid: %s\n", ch + 1, simOptions.digital[ch]);
+            continue;
+        }
+        std::thread(&SimPulseSource::run, &sources[ch], simOptions.diPin[ch]).detach();
+    }
+}
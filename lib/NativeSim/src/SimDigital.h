@@ -0,0 +1,56 @@
+#ifndef SIMDIGITAL_H
+#define SIMDIGITAL_H
+
+#include <stdint.h>
+#include <vector>
+
+// ---------------------------------------------------------
+// Sumber sinyal simulasi untuk satu input digital
+// ---------------------------------------------------------
+// Spesifikasi (argumen --di1..--di4):
+//   dc:0 / dc:1               level tetap
+//   pulse:HZ[,DUTY]           kotak, fase HIGH = DUTY (default 0.5)
+//   file:PATH                 rekaman timestamp edge, satu per baris:
+//                             "us[,level]" (us sejak awal rekaman,
+//                             level 0/1; tanpa level = toggle). Baris
+//                             '#' diabaikan, diputar ulang setelah edge
+//                             terakhir.
+// Setiap edge mengubah level pin, diteruskan ke unit PCNT yang memakai
+// pin tersebut (simPcntEdge) lalu ke ISR yang terpasang
+// (simRaiseInterrupt). Edge dijadwalkan pada waktu absolut; jika thread
+// tertinggal (pulsa > ~10 kHz), edge dikejar beruntun sehingga jumlah
+// pulsa tetap benar meski timestamp ISR menjadi kasar.
+class SimPulseSource
+{
+public:
+    SimPulseSource() : _type(LEVEL), _level(false), _hz(0), _duty(0.5) {}
+
+    struct Edge
+    {
+        uint64_t us;
+        bool level;
+    };
+
+    bool parse(const char *spec);
+    // Thread generator untuk pin; tidak kembali
+    void run(uint8_t pin);
+
+private:
+    enum Type : uint8_t
+    {
+        LEVEL,
+        PULSE,
+        REPLAY
+    };
+
+    Type _type;
+    bool _level;
+    double _hz;
+    double _duty;
+    std::vector<Edge> _edges; // REPLAY
+};
+
+// Mulai generator --di1..--di4 (dipanggil SimMain sebelum setup())
+void simDigitalBegin();
+
+#endif // SIMDIGITAL_H
@@ -0,0 +1,225 @@
+#include "Arduino.h"
+#include "SimDigital.h"
+#include "SimOptions.h"
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <sys/stat.h>
+
+// Sketch (src/main.cpp)
+void setup();
+void loop();
+
+SimOptions simOptions;
+
+// pio test -e native: test (test/test_*) membawa main() Unity sendiri,
+// simOptions diisi langsung oleh test
+#ifndef PIO_UNIT_TESTING
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Pemakaian: %s [opsi]\n"
+            "  --fs DIR             direktori partisi LittleFS (default .pio/sim/littlefs)\n"
+            "  --image DIR|none     isi awal partisi baru (default data)\n"
+            "  --fs-size BYTES      kapasitas partisi (default 1441792)\n"
+            "  --bind ADDR          alamat server (default 127.0.0.1)\n"
+            "  --port-offset N      port server + N (default 8000: web 8080, Modbus TCP 8502)\n"
+            "  --ota FILE           tujuan image OTA (default .pio/sim/firmware.bin)\n"
+            "  --ai1..--ai4 SPEC    sumber tegangan AIN0..AIN3 (dc:, sine:, square:, ramp:, file:)\n"
+            "  --noise VOLT         derau rms pada input ADC (default 0.0005)\n"
+            "  --alert-pin N        pin ALERT/RDY ADS1115 (default 4)\n"
+            "  --di1..--di4 SPEC    sinyal DI pada pin 34, 35, 36, 39 (dc:, pulse:, file:)\n"
+            "  --modbus-slaves A-B  slave RTU yang menjawab, mis. 1,2,10-20 atau none (default 1-247)\n"
+            "  --link-down          mulai dengan kabel Ethernet tercabut\n"
+            "SIGUSR1 membalik status link Ethernet.\n",
+            prog);
+}
+
+static bool parseSlaves(const char *list)
+{
+    memset(simOptions.modbusSlave, 0, sizeof(simOptions.modbusSlave));
+    if (strcmp(list, "none") == 0)
+        return true;
+    const char *p = list;
+    while (*p)
+    {
+        char *end;
+        long from = strtol(p, &end, 10);
+        long to = from;
+        if (end == p)
+            return false;
+        if (*end == '-')
+        {
+            p = end + 1;
+            to = strtol(p, &end, 10);
+            if (end == p)
+                return false;
+        }
+        for (long id = from; id <= to; id++)
+        {
+            if (id < 1 || id >= SIM_MODBUS_SLAVES)
+                return false;
+            simOptions.modbusSlave[id] = true;
+        }
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',')
+            return false;
+    }
+    return true;
+}
+
+// mkdir -p untuk direktori induk path
+static void makeParents(const char *path)
+{
+    std::string s(path);
+    for (size_t p = s.find('/', 1); p != std::string::npos; p = s.find('/', p + 1))
+        ::mkdir(s.substr(0, p).c_str(), 0755);
+}
+
+static void onLinkToggle(int)
+{
+    simOptions.linkUp = !simOptions.linkUp;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *const defaultWaves[SIM_AI_CHANNELS] = {
+        "sine:3,1,0.05",    // 12 mA +- 4 mA, periode 20 s
+        "ramp:1,5,120",     // 4..20 mA dalam 2 menit
+        "square:2,4,0.1",   // 8 / 16 mA
+        "dc:1"};            // 4 mA
+    static const char *const defaultDigital[SIM_DI_CHANNELS] = {
+        "pulse:2,0.25",     // siklus mesin 0.5 s
+        "pulse:0.05,0.6",   // run/stop 20 s
+        "pulse:50",
+        "pulse:20000"};     // flow meter 20 kHz
+    static const uint8_t diPins[SIM_DI_CHANNELS] = {34, 35, 36, 39};
+    simOptions.fsRoot = ".pio/sim/littlefs";
+    simOptions.fsImage = "data";
+    simOptions.fsSize = 0x160000; // partisi spiffs default.csv
+    simOptions.bindAddress = "127.0.0.1";
+    simOptions.portOffset = 8000;
+    simOptions.otaPath = ".pio/sim/firmware.bin";
+    for (uint8_t i = 0; i < SIM_AI_CHANNELS; i++)
+        simOptions.waveform[i] = defaultWaves[i];
+    simOptions.noise = 0.0005f;
+    simOptions.adsAlertPin = 4;
+    for (uint8_t i = 0; i < SIM_DI_CHANNELS; i++)
+    {
+        simOptions.digital[i] = defaultDigital[i];
+        simOptions.diPin[i] = diPins[i];
+    }
+    parseSlaves("1-247");
+    simOptions.linkUp = true;
+    simOptions.argc = argc;
+    simOptions.argv = argv;
+
+    enum
+    {
+        OPT_FS = 256,
+        OPT_IMAGE,
+        OPT_FS_SIZE,
+        OPT_BIND,
+        OPT_PORT_OFFSET,
+        OPT_OTA,
+        OPT_AI1,
+        OPT_AI4 = OPT_AI1 + SIM_AI_CHANNELS - 1,
+        OPT_NOISE,
+        OPT_ALERT_PIN,
+        OPT_DI1,
+        OPT_DI4 = OPT_DI1 + SIM_DI_CHANNELS - 1,
+        OPT_MODBUS_SLAVES,
+        OPT_LINK_DOWN
+    };
+    static const struct option longOptions[] = {
+        {"fs", required_argument, nullptr, OPT_FS},
+        {"image", required_argument, nullptr, OPT_IMAGE},
+        {"fs-size", required_argument, nullptr, OPT_FS_SIZE},
+        {"bind", required_argument, nullptr, OPT_BIND},
+        {"port-offset", required_argument, nullptr, OPT_PORT_OFFSET},
+        {"ota", required_argument, nullptr, OPT_OTA},
+        {"ai1", required_argument, nullptr, OPT_AI1},
+        {"ai2", required_argument, nullptr, OPT_AI1 + 1},
+        {"ai3", required_argument, nullptr, OPT_AI1 + 2},
+        {"ai4", required_argument, nullptr, OPT_AI4},
+        {"noise", required_argument, nullptr, OPT_NOISE},
+        {"alert-pin", required_argument, nullptr, OPT_ALERT_PIN},
+        {"di1", required_argument, nullptr, OPT_DI1},
+        {"di2", required_argument, nullptr, OPT_DI1 + 1},
+        {"di3", required_argument, nullptr, OPT_DI1 + 2},
+        {"di4", required_argument, nullptr, OPT_DI4},
+        {"modbus-slaves", required_argument, nullptr, OPT_MODBUS_SLAVES},
+        {"link-down", no_argument, nullptr, OPT_LINK_DOWN},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}};
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", longOptions, nullptr)) != -1)
+    {
+        switch (opt)
+        {
+        case OPT_FS:
+            simOptions.fsRoot = optarg;
+            break;
+        case OPT_IMAGE:
+            simOptions.fsImage = strcmp(optarg, "none") == 0 ? nullptr : optarg;
+            break;
+        case OPT_FS_SIZE:
+            simOptions.fsSize = strtoul(optarg, nullptr, 0);
+            break;
+        case OPT_BIND:
+            simOptions.bindAddress = optarg;
+            break;
+        case OPT_PORT_OFFSET:
+            simOptions.portOffset = (uint16_t)atoi(optarg);
+            break;
+        case OPT_OTA:
+            simOptions.otaPath = optarg;
+            break;
+        case OPT_NOISE:
+            simOptions.noise = strtof(optarg, nullptr);
+            break;
+        case OPT_ALERT_PIN:
+            simOptions.adsAlertPin = (uint8_t)atoi(optarg);
+            break;
+        case OPT_MODBUS_SLAVES:
+            if (!parseSlaves(optarg))
+            {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case OPT_LINK_DOWN:
+            simOptions.linkUp = false;
+            break;
+        default:
+            if (opt >= OPT_AI1 && opt <= OPT_AI4)
+            {
+                simOptions.waveform[opt - OPT_AI1] = optarg;
+                break;
+            }
+            if (opt >= OPT_DI1 && opt <= OPT_DI4)
+            {
+                simOptions.digital[opt - OPT_DI1] = optarg;
+                break;
+            }
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    makeParents(simOptions.fsRoot);
+    makeParents(simOptions.otaPath);
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGUSR1, onLinkToggle);
+
+    simDigitalBegin();
+    // Seperti loopTask Arduino-ESP32
+    setup();
+    for (;;)
+        loop();
+}
+
+#endif // PIO_UNIT_TESTING
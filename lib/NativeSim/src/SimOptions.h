@@ -0,0 +1,39 @@
+#ifndef SIMOPTIONS_H
+#define SIMOPTIONS_H
+
+#include <stdint.h>
+#include <atomic>
+
+#define SIM_AI_CHANNELS 4
+#define SIM_DI_CHANNELS 4
+#define SIM_MODBUS_SLAVES 248
+
+// ---------------------------------------------------------
+// Opsi runtime build native (argumen command line, lihat SimMain.cpp)
+// ---------------------------------------------------------
+struct SimOptions
+{
+    const char *fsRoot;   // direktori pengganti partisi LittleFS
+    const char *fsImage;  // isi awal partisi (setara uploadfs) jika fsRoot belum ada
+    uint32_t fsSize;      // kapasitas yang dilaporkan LittleFS.totalBytes()
+    const char *bindAddress;
+    uint16_t portOffset;  // port server + offset (port < 1024 butuh root)
+    const char *otaPath;  // image hasil OTA ditulis ke sini
+    const char *waveform[SIM_AI_CHANNELS]; // sumber tegangan AIN0..AIN3, lihat SimAds.h
+    float noise;          // derau gaussian tambahan (volt rms)
+    uint8_t adsAlertPin;  // pin tujuan pulsa ALERT/RDY
+    const char *digital[SIM_DI_CHANNELS]; // sinyal DI1..DI4, lihat SimDigital.h
+    uint8_t diPin[SIM_DI_CHANNELS];       // sama dengan DI1_PIN..DI4_PIN firmware
+    bool modbusSlave[SIM_MODBUS_SLAVES]; // slave RTU yang menjawab
+    // Hook test native (nullptr = nilai sintetis): isi register / bit slave
+    // dan pengamat setiap request yang dijawab
+    uint16_t (*modbusValue)(uint8_t slave, uint8_t function, uint16_t address);
+    void (*modbusRequest)(uint8_t slave, uint8_t function, uint16_t address, uint16_t quantity);
+    std::atomic<bool> linkUp; // SIGUSR1 membalik status link Ethernet
+    int argc;
+    char **argv;
+};
+
+extern SimOptions simOptions;
+
+#endif // SIMOPTIONS_H
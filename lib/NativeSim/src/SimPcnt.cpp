@@ -0,0 +1,185 @@
+#include "Arduino.h"
+#include "driver/pcnt.h"
+
+struct SimPcntChannel
+{
+    int pin = PCNT_PIN_NOT_USED;
+    pcnt_count_mode_t pos = PCNT_COUNT_DIS;
+    pcnt_count_mode_t neg = PCNT_COUNT_DIS;
+};
+
+struct SimPcntUnit
+{
+    SimPcntChannel channels[PCNT_CHANNEL_MAX];
+    int16_t high = 0;
+    int16_t low = 0;
+    int16_t count = 0;
+    bool running = false;
+    uint16_t filter = 0;
+    uint32_t events = 0; // pcnt_evt_type_t yang aktif
+    void (*isr)(void *) = nullptr;
+    void *arg = nullptr;
+};
+
+static SimPcntUnit units[PCNT_UNIT_MAX];
+static bool serviceInstalled = false;
+
+// Register unit diakses di bawah lock interrupt (lihat noInterrupts())
+struct SimPcntLock
+{
+    SimPcntLock() { noInterrupts(); }
+    ~SimPcntLock() { interrupts(); }
+};
+
+static bool validUnit(pcnt_unit_t unit)
+{
+    return unit >= PCNT_UNIT_0 && unit < PCNT_UNIT_MAX;
+}
+
+esp_err_t pcnt_unit_config(const pcnt_config_t *config)
+{
+    if (!config || !validUnit(config->unit) || config->channel >= PCNT_CHANNEL_MAX)
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    SimPcntUnit &u = units[config->unit];
+    SimPcntChannel &c = u.channels[config->channel];
+    c.pin = config->pulse_gpio_num;
+    c.pos = config->pos_mode;
+    c.neg = config->neg_mode;
+    u.high = config->counter_h_lim;
+    u.low = config->counter_l_lim;
+    u.count = 0;
+    u.running = true;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_get_counter_value(pcnt_unit_t unit, int16_t *count)
+{
+    if (!validUnit(unit) || !count)
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    *count = units[unit].count;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_pause(pcnt_unit_t unit)
+{
+    if (!validUnit(unit))
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    units[unit].running = false;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_resume(pcnt_unit_t unit)
+{
+    if (!validUnit(unit))
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    units[unit].running = true;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_clear(pcnt_unit_t unit)
+{
+    if (!validUnit(unit))
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    units[unit].count = 0;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_set_filter_value(pcnt_unit_t unit, uint16_t value)
+{
+    if (!validUnit(unit) || value > 1023)
+        return ESP_ERR_INVALID_ARG;
+    units[unit].filter = value;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_filter_enable(pcnt_unit_t unit)
+{
+    return validUnit(unit) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t pcnt_filter_disable(pcnt_unit_t unit)
+{
+    return validUnit(unit) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t pcnt_event_enable(pcnt_unit_t unit, pcnt_evt_type_t evt)
+{
+    if (!validUnit(unit))
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    units[unit].events |= evt;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_event_disable(pcnt_unit_t unit, pcnt_evt_type_t evt)
+{
+    if (!validUnit(unit))
+        return ESP_ERR_INVALID_ARG;
+    SimPcntLock lock;
+    units[unit].events &= ~(uint32_t)evt;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_isr_service_install(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    if (serviceInstalled)
+        return ESP_ERR_INVALID_STATE;
+    serviceInstalled = true;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_isr_handler_add(pcnt_unit_t unit, void (*isr_handler)(void *), void *args)
+{
+    if (!validUnit(unit))
+        return ESP_ERR_INVALID_ARG;
+    if (!serviceInstalled)
+        return ESP_ERR_INVALID_STATE;
+    SimPcntLock lock;
+    units[unit].isr = isr_handler;
+    units[unit].arg = args;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_isr_handler_remove(pcnt_unit_t unit)
+{
+    return pcnt_isr_handler_add(unit, nullptr, nullptr);
+}
+
+// Counter kembali ke 0 saat mencapai batas, seperti hardware
+static void count(SimPcntUnit &u, pcnt_count_mode_t mode)
+{
+    if (mode == PCNT_COUNT_DIS)
+        return;
+    u.count += mode == PCNT_COUNT_INC ? 1 : -1;
+    uint32_t evt = 0;
+    if (u.high > 0 && u.count >= u.high)
+        evt = PCNT_EVT_H_LIM;
+    else if (u.low < 0 && u.count <= u.low)
+        evt = PCNT_EVT_L_LIM;
+    if (!evt)
+        return;
+    u.count = 0;
+    if ((u.events & evt) && u.isr)
+        u.isr(u.arg);
+}
+
+void simPcntEdge(uint8_t pin, bool rising)
+{
+    SimPcntLock lock;
+    for (SimPcntUnit &u : units)
+    {
+        if (!u.running)
+            continue;
+        for (const SimPcntChannel &c : u.channels)
+        {
+            if (c.pin == pin)
+                count(u, rising ? c.pos : c.neg);
+        }
+    }
+}
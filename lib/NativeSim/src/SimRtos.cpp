@@ -0,0 +1,127 @@
+#include "Arduino.h"
+#include <condition_variable>
+#include <pthread.h>
+#include <thread>
+
+struct SimTask
+{
+    char name[16];
+    uint32_t stackDepth;
+    UBaseType_t priority;
+    BaseType_t core;
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications;
+};
+
+// Task pertama yang menyentuh API ini tanpa dibuat lewat
+// xTaskCreate* adalah thread main (loopTask Arduino, core 1)
+static thread_local SimTask *currentTask = nullptr;
+
+static SimTask *newTask(const char *name, uint32_t stackDepth, UBaseType_t priority, BaseType_t core)
+{
+    SimTask *t = new SimTask();
+    strncpy(t->name, name ? name : "", sizeof(t->name) - 1);
+    t->stackDepth = stackDepth;
+    t->priority = priority;
+    t->core = core == tskNO_AFFINITY ? 0 : core;
+    t->notifications = 0;
+    return t;
+}
+
+static SimTask *self()
+{
+    if (!currentTask)
+        currentTask = newTask("loopTask", 8192, 1, 1);
+    return currentTask;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *created, BaseType_t core)
+{
+    SimTask *t = newTask(name, stackDepth, priority, core);
+    if (created)
+        *created = t;
+    std::thread([t, code, param]() {
+        currentTask = t;
+        pthread_setname_np(pthread_self(), t->name);
+        code(param);
+        // Task FreeRTOS tidak boleh return; anggap vTaskDelete(nullptr)
+        vTaskDelete(nullptr);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                       void *param, UBaseType_t priority, TaskHandle_t *created)
+{
+    return xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task && task != currentTask)
+        return; // menghentikan thread lain tidak didukung
+    pthread_exit(nullptr);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks);
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return self();
+}
+
+const char *pcTaskGetName(TaskHandle_t task)
+{
+    return (task ? task : self())->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    return (task ? task : self())->stackDepth;
+}
+
+BaseType_t xPortGetCoreID()
+{
+    return self()->core;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait)
+{
+    SimTask *t = self();
+    std::unique_lock<std::mutex> guard(t->lock);
+    if (ticksToWait == portMAX_DELAY)
+        t->wake.wait(guard, [t] { return t->notifications > 0; });
+    else
+        t->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait), [t] { return t->notifications > 0; });
+    uint32_t value = t->notifications;
+    if (value)
+        t->notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken)
+        *higherPriorityTaskWoken = pdFALSE;
+}
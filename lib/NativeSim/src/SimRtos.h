@@ -0,0 +1,67 @@
+#ifndef SIMRTOS_H
+#define SIMRTOS_H
+
+// ---------------------------------------------------------
+// Subset FreeRTOS (ESP-IDF) di atas std::thread
+// ---------------------------------------------------------
+// Satu tick = 1 ms seperti konfigurasi Arduino-ESP32. Prioritas dan
+// core hanya dicatat (xPortGetCoreID mengembalikan core yang diminta),
+// penjadwalan diserahkan ke kernel host. Task notification memakai
+// counter + condition variable, jadi ulTaskNotifyTake benar-benar tidur.
+
+#include <stdint.h>
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void *);
+
+struct SimTask;
+typedef SimTask *TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define pdFAIL 0
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *created, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                       void *param, UBaseType_t priority, TaskHandle_t *created);
+// nullptr = task pemanggil (thread berhenti, thread lain jalan terus)
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+const char *pcTaskGetName(TaskHandle_t task);
+// Tidak bisa diukur di host: mengembalikan ukuran stack yang diminta
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken);
+#define portYIELD_FROM_ISR() \
+    do                       \
+    {                        \
+    } while (0)
+
+// Spinlock critical section -> mutex (rekursif seperti portMUX ESP32)
+struct portMUX_TYPE
+{
+    std::recursive_mutex lock;
+};
+#define portMUX_INITIALIZER_UNLOCKED \
+    {                                \
+    }
+#define portENTER_CRITICAL(mux) (mux)->lock.lock()
+#define portEXIT_CRITICAL(mux) (mux)->lock.unlock()
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+
+#endif // SIMRTOS_H
@@ -0,0 +1,85 @@
+#include "SimWaveform.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool loadSamples(const char *path, std::vector<float> &out)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+            continue;
+        const char *value = strrchr(line, ',');
+        value = value ? value + 1 : line;
+        char *end;
+        float v = strtof(value, &end);
+        if (end != value)
+            out.push_back(v);
+    }
+    fclose(f);
+    return !out.empty();
+}
+
+bool SimWaveform::parse(const char *spec)
+{
+    float a = 0, b = 0, c = 0;
+    if (sscanf(spec, "dc:%f", &a) == 1)
+        _type = DC;
+    else if (sscanf(spec, "sine:%f,%f,%f", &a, &b, &c) == 3)
+        _type = SINE;
+    else if (sscanf(spec, "square:%f,%f,%f", &a, &b, &c) == 3 && c > 0)
+        _type = SQUARE;
+    else if (sscanf(spec, "ramp:%f,%f,%f", &a, &b, &c) == 3 && c > 0)
+        _type = RAMP;
+    else if (strncmp(spec, "file:", 5) == 0)
+    {
+        char path[256];
+        strncpy(path, spec + 5, sizeof(path) - 1);
+        path[sizeof(path) - 1] = '\0';
+        c = 10;
+        char *at = strrchr(path, '@');
+        if (at)
+        {
+            *at = '\0';
+            c = strtof(at + 1, nullptr);
+        }
+        _samples.clear();
+        if (c <= 0 || !loadSamples(path, _samples))
+            return false;
+        _type = REPLAY;
+    }
+    else
+        return false;
+    _a = a;
+    _b = b;
+    _c = c;
+    return true;
+}
+
+float SimWaveform::volts(double t) const
+{
+    switch (_type)
+    {
+    case SINE:
+        return _a + _b * (float)sin(2 * M_PI * _c * t);
+    case SQUARE:
+        return fmod(t * _c, 1.0) < 0.5 ? _a : _b;
+    case RAMP:
+        return _a + (_b - _a) * (float)(fmod(t, _c) / _c);
+    case REPLAY:
+    {
+        double pos = fmod(t * _c, (double)_samples.size());
+        size_t i = (size_t)pos;
+        float frac = (float)(pos - i);
+        float next = _samples[(i + 1) % _samples.size()];
+        return _samples[i] + (next - _samples[i]) * frac;
+    }
+    default:
+        return _a;
+    }
+}
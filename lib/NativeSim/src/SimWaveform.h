@@ -0,0 +1,43 @@
+#ifndef SIMWAVEFORM_H
+#define SIMWAVEFORM_H
+
+#include <stdint.h>
+#include <vector>
+
+// ---------------------------------------------------------
+// Sumber tegangan simulasi untuk satu input analog
+// ---------------------------------------------------------
+// Spesifikasi (argumen --ai1..--ai4):
+//   dc:V                      tegangan tetap
+//   sine:OFFSET,AMPL,HZ       sinus
+//   square:LOW,HIGH,HZ        kotak, duty 50%
+//   ramp:FROM,TO,SECONDS      gigi gergaji
+//   file:PATH[@HZ]            rekaman, satu nilai volt per baris (kolom
+//                             terakhir jika CSV, baris '#' diabaikan),
+//                             diputar ulang pada HZ (default 10) dengan
+//                             interpolasi linear
+class SimWaveform
+{
+public:
+    SimWaveform() : _type(DC), _a(0), _b(0), _c(0) {}
+
+    bool parse(const char *spec);
+    // Tegangan pada waktu t (detik sejak boot)
+    float volts(double t) const;
+
+private:
+    enum Type : uint8_t
+    {
+        DC,
+        SINE,
+        SQUARE,
+        RAMP,
+        REPLAY
+    };
+
+    Type _type;
+    float _a, _b, _c;
+    std::vector<float> _samples; // REPLAY, _c = Hz
+};
+
+#endif // SIMWAVEFORM_H
@@ -0,0 +1,45 @@
+#include "Arduino.h"
+
+int Stream::timedRead()
+{
+    uint32_t start = millis();
+    do
+    {
+        int c = read();
+        if (c >= 0)
+            return c;
+        delay(1);
+    } while (millis() - start < _timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t n = 0;
+    while (n < length)
+    {
+        int c = timedRead();
+        if (c < 0)
+            break;
+        buffer[n++] = (uint8_t)c;
+    }
+    return n;
+}
+
+String Stream::readString()
+{
+    std::string s;
+    int c;
+    while ((c = timedRead()) >= 0)
+        s += (char)c;
+    return String(s);
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    std::string s;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator)
+        s += (char)c;
+    return String(s);
+}
@@ -0,0 +1,246 @@
+#include "Update.h"
+#include "SimOptions.h"
+#include <strings.h>
+
+UpdateClass Update;
+
+// ---------------------------------------------------------
+// MD5 (RFC 1321), pengganti MD5Builder
+// ---------------------------------------------------------
+static const uint32_t md5K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+static const uint8_t md5R[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+static void md5Block(uint32_t *h, const uint8_t *block)
+{
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++)
+        w[i] = block[i * 4] | (block[i * 4 + 1] << 8) | (block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t f;
+        int g;
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+        uint32_t t = d;
+        d = c;
+        c = b;
+        uint32_t x = a + f + md5K[i] + w[g];
+        b = b + ((x << md5R[i]) | (x >> (32 - md5R[i])));
+        a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+}
+
+UpdateClass::UpdateClass() : _file(nullptr), _error(UPDATE_ERROR_OK)
+{
+    memset(_digest, 0, sizeof(_digest));
+    reset();
+}
+
+void UpdateClass::reset()
+{
+    if (_file)
+        fclose(_file);
+    _file = nullptr;
+    _size = 0;
+    _progress = 0;
+    _checkMD5 = false;
+    _md5State[0] = 0x67452301;
+    _md5State[1] = 0xefcdab89;
+    _md5State[2] = 0x98badcfe;
+    _md5State[3] = 0x10325476;
+    _md5Bytes = 0;
+}
+
+void UpdateClass::fail(uint8_t error)
+{
+    _error = error;
+    reset();
+}
+
+bool UpdateClass::begin(size_t size, int command)
+{
+    if (_size > 0 || size == 0)
+        return false;
+    _error = UPDATE_ERROR_OK;
+    if (command != U_FLASH)
+    {
+        _error = UPDATE_ERROR_BAD_ARGUMENT;
+        return false;
+    }
+    if (size == UPDATE_SIZE_UNKNOWN)
+        size = ESP.getFreeSketchSpace();
+    if (size > ESP.getFreeSketchSpace())
+    {
+        _error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    reset();
+    std::string part = std::string(simOptions.otaPath) + ".part";
+    _file = fopen(part.c_str(), "wbe");
+    if (!_file)
+    {
+        _error = UPDATE_ERROR_NO_PARTITION;
+        return false;
+    }
+    _size = size;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t *data, size_t len)
+{
+    if (hasError() || !isRunning())
+        return 0;
+    if (len > remaining())
+    {
+        fail(UPDATE_ERROR_SPACE);
+        return 0;
+    }
+    if (_progress == 0 && len > 0 && data[0] != ESP_IMAGE_HEADER_MAGIC)
+    {
+        fail(UPDATE_ERROR_MAGIC_BYTE);
+        return 0;
+    }
+    if (fwrite(data, 1, len, _file) != len)
+    {
+        fail(UPDATE_ERROR_WRITE);
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++)
+    {
+        _md5Block[_md5Bytes % 64] = data[i];
+        if (++_md5Bytes % 64 == 0)
+            md5Block(_md5State, _md5Block);
+    }
+    _progress += len;
+    return len;
+}
+
+size_t UpdateClass::writeStream(Stream &data)
+{
+    uint8_t buf[1024];
+    size_t total = 0;
+    while (isRunning() && remaining() > 0)
+    {
+        size_t want = remaining() < sizeof(buf) ? remaining() : sizeof(buf);
+        size_t n = data.readBytes(buf, want);
+        if (n == 0)
+        {
+            fail(UPDATE_ERROR_STREAM);
+            break;
+        }
+        if (write(buf, n) != n)
+            break;
+        total += n;
+    }
+    return total;
+}
+
+bool UpdateClass::end(bool evenIfRemaining)
+{
+    if (hasError() || _size == 0)
+        return false;
+    if (!isFinished() && !evenIfRemaining)
+    {
+        fail(UPDATE_ERROR_ABORT);
+        return false;
+    }
+
+    // Penutup MD5: 0x80, nol, panjang bit (little-endian)
+    uint64_t bits = _md5Bytes * 8;
+    uint8_t pad = 0x80;
+    do
+    {
+        _md5Block[_md5Bytes % 64] = pad;
+        pad = 0;
+        if (++_md5Bytes % 64 == 0)
+            md5Block(_md5State, _md5Block);
+    } while (_md5Bytes % 64 != 56);
+    for (int i = 0; i < 8; i++)
+        _md5Block[56 + i] = (uint8_t)(bits >> (8 * i));
+    md5Block(_md5State, _md5Block);
+    for (int i = 0; i < 16; i++)
+        _digest[i] = (uint8_t)(_md5State[i / 4] >> (8 * (i % 4)));
+
+    if (_checkMD5 && strcasecmp(md5String().c_str(), _expectedMD5) != 0)
+    {
+        fail(UPDATE_ERROR_MD5);
+        return false;
+    }
+    fclose(_file);
+    _file = nullptr;
+    std::string part = std::string(simOptions.otaPath) + ".part";
+    if (rename(part.c_str(), simOptions.otaPath) != 0)
+    {
+        fail(UPDATE_ERROR_ACTIVATE);
+        return false;
+    }
+    _size = 0;
+    return true;
+}
+
+void UpdateClass::abort()
+{
+    fail(UPDATE_ERROR_ABORT);
+}
+
+bool UpdateClass::setMD5(const char *expectedMD5)
+{
+    if (strlen(expectedMD5) != 32)
+        return false;
+    memcpy(_expectedMD5, expectedMD5, 33);
+    _checkMD5 = true;
+    return true;
+}
+
+String UpdateClass::md5String()
+{
+    char hex[33];
+    for (int i = 0; i < 16; i++)
+        snprintf(hex + i * 2, 3, "%02x", _digest[i]);
+    return String(hex);
+}
+
+const char *UpdateClass::errorString()
+{
+    static const char *const messages[] = {
+        "No Error", "Flash Write Failed", "Flash Erase Failed", "Flash Read Failed",
+        "Not Enough Space", "Bad Size Given", "Stream Read Timeout", "MD5 Check Failed",
+        "Wrong Magic Byte", "Could Not Activate The Firmware", "Partition Could Not be Found",
+        "Bad Argument", "Aborted"};
+    return _error <= UPDATE_ERROR_ABORT ? messages[_error] : "UNKNOWN";
+}
@@ -0,0 +1,75 @@
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include <Arduino.h>
+
+#define UPDATE_ERROR_OK (0)
+#define UPDATE_ERROR_WRITE (1)
+#define UPDATE_ERROR_ERASE (2)
+#define UPDATE_ERROR_READ (3)
+#define UPDATE_ERROR_SPACE (4)
+#define UPDATE_ERROR_SIZE (5)
+#define UPDATE_ERROR_STREAM (6)
+#define UPDATE_ERROR_MD5 (7)
+#define UPDATE_ERROR_MAGIC_BYTE (8)
+#define UPDATE_ERROR_ACTIVATE (9)
+#define UPDATE_ERROR_NO_PARTITION (10)
+#define UPDATE_ERROR_BAD_ARGUMENT (11)
+#define UPDATE_ERROR_ABORT (12)
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+#define U_FLASH 0
+#define U_SPIFFS 100
+
+#define ESP_IMAGE_HEADER_MAGIC 0xE9
+
+// ---------------------------------------------------------
+// Updater simulasi: partisi OTA = file SimOptions::otaPath
+// ---------------------------------------------------------
+// Pemeriksaan sama dengan UpdateClass ESP32 (ukuran vs ruang sketch,
+// magic byte 0xE9, MD5 bila setMD5() dipakai). Image ditulis ke
+// otaPath + ".part" lalu di-rename saat end() berhasil.
+class UpdateClass
+{
+public:
+    UpdateClass();
+
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH);
+    size_t write(uint8_t *data, size_t len);
+    size_t writeStream(Stream &data);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+
+    bool setMD5(const char *expectedMD5);
+    String md5String();
+
+    const char *errorString();
+    void printError(Print &out) { out.println(errorString()); }
+    uint8_t getError() { return _error; }
+    bool hasError() { return _error != UPDATE_ERROR_OK; }
+    bool isRunning() { return _size > 0; }
+    bool isFinished() { return _progress == _size; }
+    size_t size() { return _size; }
+    size_t progress() { return _progress; }
+    size_t remaining() { return _size - _progress; }
+
+private:
+    void reset();
+    void fail(uint8_t error);
+
+    FILE *_file;
+    size_t _size;
+    size_t _progress;
+    uint8_t _error;
+    bool _checkMD5;
+    char _expectedMD5[33];
+    uint8_t _digest[16];
+    uint32_t _md5State[4];
+    uint64_t _md5Bytes;
+    uint8_t _md5Block[64];
+};
+
+extern UpdateClass Update;
+
+#endif // UPDATE_H
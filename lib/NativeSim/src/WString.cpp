@@ -0,0 +1,132 @@
+#include "Arduino.h"
+#include <ctype.h>
+#include <strings.h>
+
+static std::string formatInt(const char *decFmt, const char *hexFmt, unsigned char base, unsigned long long bits, long long value)
+{
+    char buf[34];
+    if (base == 16)
+        snprintf(buf, sizeof(buf), hexFmt, bits);
+    else
+        snprintf(buf, sizeof(buf), decFmt, value);
+    return buf;
+}
+
+String::String(int value, unsigned char base)
+    : _s(formatInt("%lld", "%llx", base, (unsigned int)value, value)) {}
+
+String::String(unsigned int value, unsigned char base)
+    : _s(formatInt("%lld", "%llx", base, value, value)) {}
+
+String::String(long value, unsigned char base)
+    : _s(formatInt("%lld", "%llx", base, (unsigned long)value, value)) {}
+
+String::String(unsigned long value, unsigned char base)
+    : _s(formatInt("%llu", "%llx", base, value, value)) {}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals)
+{
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    _s = buf;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t p = _s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::indexOf(const String &s, unsigned int from) const
+{
+    size_t p = _s.find(s._s, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::lastIndexOf(char c) const
+{
+    size_t p = _s.rfind(c);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+String String::substring(unsigned int from) const
+{
+    if (from >= _s.size())
+        return String();
+    return String(_s.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to)
+        std::swap(from, to);
+    if (from >= _s.size())
+        return String();
+    return String(_s.substr(from, to - from));
+}
+
+bool String::startsWith(const String &prefix) const
+{
+    return _s.compare(0, prefix._s.size(), prefix._s) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return _s.size() >= suffix._s.size() &&
+           _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+}
+
+bool String::equalsIgnoreCase(const String &other) const
+{
+    return strcasecmp(_s.c_str(), other._s.c_str()) == 0;
+}
+
+void String::replace(const String &find, const String &with)
+{
+    if (find._s.empty())
+        return;
+    size_t p = 0;
+    while ((p = _s.find(find._s, p)) != std::string::npos)
+    {
+        _s.replace(p, find._s.size(), with._s);
+        p += with._s.size();
+    }
+}
+
+void String::remove(unsigned int index)
+{
+    if (index < _s.size())
+        _s.erase(index);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < _s.size())
+        _s.erase(index, count);
+}
+
+void String::trim()
+{
+    size_t a = _s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos)
+    {
+        _s.clear();
+        return;
+    }
+    size_t b = _s.find_last_not_of(" \t\r\n");
+    _s = _s.substr(a, b - a + 1);
+}
+
+void String::toLowerCase()
+{
+    for (size_t i = 0; i < _s.size(); i++)
+        _s[i] = (char)tolower((unsigned char)_s[i]);
+}
+
+void String::toUpperCase()
+{
+    for (size_t i = 0; i < _s.size(); i++)
+        _s[i] = (char)toupper((unsigned char)_s[i]);
+}
@@ -0,0 +1,98 @@
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <string>
+
+// String Arduino di atas std::string (semantik sama untuk API yang dipakai)
+class String
+{
+public:
+    String() {}
+    String(const char *s) : _s(s ? s : "") {}
+    String(const std::string &s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    String(int value, unsigned char base = 10);
+    String(unsigned int value, unsigned char base = 10);
+    String(long value, unsigned char base = 10);
+    String(unsigned long value, unsigned char base = 10);
+    String(float value, unsigned int decimals = 2);
+    String(double value, unsigned int decimals = 2);
+
+    unsigned int length() const { return _s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char *c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size)
+    {
+        _s.reserve(size);
+        return true;
+    }
+
+    char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &s, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    bool startsWith(const String &prefix) const;
+    bool endsWith(const String &suffix) const;
+    bool equals(const String &other) const { return _s == other._s; }
+    bool equalsIgnoreCase(const String &other) const;
+
+    void replace(const String &find, const String &with);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return (float)atof(_s.c_str()); }
+    double toDouble() const { return atof(_s.c_str()); }
+
+    bool concat(const String &other)
+    {
+        _s += other._s;
+        return true;
+    }
+    bool concat(char c)
+    {
+        _s += c;
+        return true;
+    }
+    String &operator+=(const String &other)
+    {
+        _s += other._s;
+        return *this;
+    }
+    String &operator+=(const char *s)
+    {
+        _s += s;
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        _s += c;
+        return *this;
+    }
+    String &operator+=(int v) { return *this += String(v); }
+    String &operator+=(unsigned int v) { return *this += String(v); }
+    String &operator+=(long v) { return *this += String(v); }
+    String &operator+=(unsigned long v) { return *this += String(v); }
+
+    friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+    friend String operator+(const String &a, const char *b) { return String(a._s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b._s); }
+    friend String operator+(const String &a, char b) { return String(a._s + b); }
+
+    bool operator==(const String &other) const { return _s == other._s; }
+    bool operator==(const char *other) const { return _s == other; }
+    bool operator!=(const String &other) const { return _s != other._s; }
+    bool operator!=(const char *other) const { return _s != other; }
+    bool operator<(const String &other) const { return _s < other._s; }
+
+private:
+    std::string _s;
+};
+
+#endif // WSTRING_H
@@ -0,0 +1,31 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <Arduino.h>
+
+// Bus I2C tidak ada di host; perangkat simulasi (ADS1115) tidak lewat sini
+class TwoWire
+{
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0)
+    {
+        (void)sda;
+        (void)scl;
+        if (frequency)
+            _clock = frequency;
+        return true;
+    }
+    bool setClock(uint32_t frequency)
+    {
+        _clock = frequency;
+        return true;
+    }
+    uint32_t getClock() const { return _clock; }
+
+private:
+    uint32_t _clock = 100000;
+};
+
+extern TwoWire Wire;
+
+#endif // WIRE_H
@@ -0,0 +1,100 @@
+#ifndef DRIVER_PCNT_H
+#define DRIVER_PCNT_H
+
+#include <stdint.h>
+
+// ---------------------------------------------------------
+// Pengganti driver PCNT ESP-IDF 4.x (driver/pcnt.h)
+// ---------------------------------------------------------
+// Unit dihitung oleh simPcntEdge() yang dipanggil generator pulsa DI
+// (SimDigital.h). Event batas atas/bawah memanggil handler dari
+// pcnt_isr_handler_add() di bawah lock interrupt, seperti ISR. Filter
+// glitch hanya disimpan (sinyal simulasi tidak ber-glitch).
+
+#ifndef ESP_OK
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#endif
+
+#define PCNT_PIN_NOT_USED (-1)
+
+typedef enum
+{
+    PCNT_UNIT_0,
+    PCNT_UNIT_1,
+    PCNT_UNIT_2,
+    PCNT_UNIT_3,
+    PCNT_UNIT_4,
+    PCNT_UNIT_5,
+    PCNT_UNIT_6,
+    PCNT_UNIT_7,
+    PCNT_UNIT_MAX
+} pcnt_unit_t;
+
+typedef enum
+{
+    PCNT_CHANNEL_0,
+    PCNT_CHANNEL_1,
+    PCNT_CHANNEL_MAX
+} pcnt_channel_t;
+
+typedef enum
+{
+    PCNT_COUNT_DIS = 0,
+    PCNT_COUNT_INC,
+    PCNT_COUNT_DEC,
+    PCNT_COUNT_MAX
+} pcnt_count_mode_t;
+
+typedef enum
+{
+    PCNT_MODE_KEEP = 0,
+    PCNT_MODE_REVERSE,
+    PCNT_MODE_DISABLE,
+    PCNT_MODE_MAX
+} pcnt_ctrl_mode_t;
+
+typedef enum
+{
+    PCNT_EVT_THRES_1 = 1 << 2,
+    PCNT_EVT_THRES_0 = 1 << 3,
+    PCNT_EVT_L_LIM = 1 << 4,
+    PCNT_EVT_H_LIM = 1 << 5,
+    PCNT_EVT_ZERO = 1 << 6
+} pcnt_evt_type_t;
+
+typedef struct
+{
+    int pulse_gpio_num;
+    int ctrl_gpio_num;
+    pcnt_ctrl_mode_t lctrl_mode;
+    pcnt_ctrl_mode_t hctrl_mode;
+    pcnt_count_mode_t pos_mode;
+    pcnt_count_mode_t neg_mode;
+    int16_t counter_h_lim;
+    int16_t counter_l_lim;
+    pcnt_unit_t unit;
+    pcnt_channel_t channel;
+} pcnt_config_t;
+
+esp_err_t pcnt_unit_config(const pcnt_config_t *config);
+esp_err_t pcnt_get_counter_value(pcnt_unit_t unit, int16_t *count);
+esp_err_t pcnt_counter_pause(pcnt_unit_t unit);
+esp_err_t pcnt_counter_resume(pcnt_unit_t unit);
+esp_err_t pcnt_counter_clear(pcnt_unit_t unit);
+esp_err_t pcnt_set_filter_value(pcnt_unit_t unit, uint16_t value);
+esp_err_t pcnt_filter_enable(pcnt_unit_t unit);
+esp_err_t pcnt_filter_disable(pcnt_unit_t unit);
+esp_err_t pcnt_event_enable(pcnt_unit_t unit, pcnt_evt_type_t evt);
+esp_err_t pcnt_event_disable(pcnt_unit_t unit, pcnt_evt_type_t evt);
+esp_err_t pcnt_isr_service_install(int intr_alloc_flags);
+esp_err_t pcnt_isr_handler_add(pcnt_unit_t unit, void (*isr_handler)(void *), void *args);
+esp_err_t pcnt_isr_handler_remove(pcnt_unit_t unit);
+
+// Satu edge pada pin (dari generator pulsa simulasi)
+void simPcntEdge(uint8_t pin, bool rising);
+
+#endif // DRIVER_PCNT_H
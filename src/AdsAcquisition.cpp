@@ -0,0 +1,174 @@
+#include "AdsAcquisition.h"
+#include "Metrics.h"
+#include <Wire.h>
+
+AdsAcquisition *AdsAcquisition::_instance = nullptr;
+volatile uint32_t AdsAcquisition::_readyCount = 0;
+volatile uint32_t AdsAcquisition::_readyAt = 0;
+TaskHandle_t AdsAcquisition::_notifyTask = nullptr;
+
+static const uint16_t MUX_SINGLE[ADC_CHANNELS] = {
+    ADS1X15_REG_CONFIG_MUX_SINGLE_0,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_1,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_2,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_3};
+
+AdsAcquisition::AdsAcquisition(Adafruit_ADS1115 &ads, uint8_t alertPin)
+    : _ads(ads), _alertPin(alertPin) {}
+
+void IRAM_ATTR AdsAcquisition::onReady()
+{
+    _readyAt = micros();
+    _readyCount = _readyCount + 1;
+    if (_notifyTask)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(_notifyTask, &woken);
+        if (woken)
+            portYIELD_FROM_ISR();
+    }
+}
+
+bool AdsAcquisition::begin(uint16_t samplesPerSecond, uint8_t channelMask)
+{
+    _instance = this;
+    // 400 kHz supaya baca hasil + ganti MUX jauh di bawah 1.16 ms (860 SPS)
+    Wire.setClock(400000);
+    setDataRate(samplesPerSecond);
+    _mask = channelMask & 0x0F;
+    if (_mask == 0)
+        return false;
+
+    pinMode(_alertPin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(_alertPin), onReady, FALLING);
+
+    _handled = _readyCount;
+    _running = true;
+    selectChannel(nextChannel(ADC_CHANNELS - 1));
+    return true;
+}
+
+void AdsAcquisition::stop()
+{
+    detachInterrupt(digitalPinToInterrupt(_alertPin));
+    _running = false;
+}
+
+void AdsAcquisition::setDataRate(uint16_t samplesPerSecond)
+{
+    struct RateEntry
+    {
+        uint16_t sps;
+        uint16_t bits;
+    };
+    static const RateEntry rates[] = {
+        {8, RATE_ADS1115_8SPS},
+        {16, RATE_ADS1115_16SPS},
+        {32, RATE_ADS1115_32SPS},
+        {64, RATE_ADS1115_64SPS},
+        {128, RATE_ADS1115_128SPS},
+        {250, RATE_ADS1115_250SPS},
+        {475, RATE_ADS1115_475SPS},
+        {860, RATE_ADS1115_860SPS}};
+
+    const RateEntry *pick = &rates[7];
+    for (const RateEntry &r : rates)
+    {
+        if (r.sps >= samplesPerSecond)
+        {
+            pick = &r;
+            break;
+        }
+    }
+    _sps = pick->sps;
+    _ads.setDataRate(pick->bits);
+    if (_running)
+        selectChannel(_current);
+}
+
+void AdsAcquisition::setGain(adsGain_t gain)
+{
+    _ads.setGain(gain);
+    if (_running)
+        selectChannel(_current);
+}
+
+void AdsAcquisition::setChannelMask(uint8_t mask)
+{
+    mask &= 0x0F;
+    if (mask == 0)
+        return;
+    _mask = mask;
+    if (_running && !(_mask & (1 << _current)))
+        selectChannel(nextChannel(_current));
+}
+
+float AdsAcquisition::channelRate() const
+{
+    uint8_t active = 0;
+    for (uint8_t ch = 0; ch < ADC_CHANNELS; ch++)
+        if (_mask & (1 << ch))
+            active++;
+    if (active <= 1)
+        return _sps;
+    // Satu konversi dibuang setiap pindah MUX
+    return (float)_sps / (2.0f * active);
+}
+
+uint8_t AdsAcquisition::nextChannel(uint8_t from) const
+{
+    for (uint8_t i = 1; i <= ADC_CHANNELS; i++)
+    {
+        uint8_t ch = (from + i) % ADC_CHANNELS;
+        if (_mask & (1 << ch))
+            return ch;
+    }
+    return from;
+}
+
+void AdsAcquisition::selectChannel(uint8_t channel)
+{
+    _current = channel;
+    // startADCReading juga men-set register threshold supaya ALERT/RDY
+    // berfungsi sebagai conversion-ready pin
+    _ads.startADCReading(MUX_SINGLE[channel], /*continuous=*/true);
+    _discardNext = true;
+}
+
+uint16_t AdsAcquisition::service()
+{
+    if (!_running)
+        return 0;
+
+    noInterrupts();
+    uint32_t ready = _readyCount;
+    uint32_t stamp = _readyAt;
+    interrupts();
+
+    uint32_t pending = ready - _handled;
+    if (pending == 0)
+        return 0;
+    // Lebih dari satu RDY sejak terakhir dilayani = konversi terlewat
+    if (pending > 1)
+        _overruns += pending - 1;
+    _handled = ready;
+
+    if (_discardNext)
+    {
+        _discardNext = false;
+        return 0;
+    }
+
+    METRIC_SPAN(METRIC_ADC_READ);
+    AdcSample s;
+    s.timestampUs = stamp;
+    s.code = _ads.getLastConversionResults();
+    s.channel = _current;
+    _ring.push(s);
+    _sampleCount++;
+
+    uint8_t next = nextChannel(_current);
+    if (next != _current)
+        selectChannel(next);
+    return 1;
+}
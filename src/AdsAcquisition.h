@@ -0,0 +1,95 @@
+#ifndef ADSACQUISITION_H
+#define ADSACQUISITION_H
+
+#include <Arduino.h>
+#include <Adafruit_ADS1X15.h>
+#include "SampleRing.h"
+
+// Pin ALERT/RDY ADS1115 (bisa di-override lewat build_flags)
+#ifndef ADS_ALERT_PIN
+#define ADS_ALERT_PIN 4
+#endif
+
+#define ADC_CHANNELS 4
+#define ADC_RING_SIZE 1024
+
+struct AdcSample
+{
+    uint32_t timestampUs; // micros() saat RDY
+    int16_t code;         // hasil konversi mentah (signed 16-bit)
+    uint8_t channel;      // 0..3 (AI1..AI4)
+};
+
+typedef SampleRing<AdcSample, ADC_RING_SIZE> AdcRing;
+
+// ---------------------------------------------------------
+// Akuisisi kontinu ADS1115 (4 channel round-robin)
+// ---------------------------------------------------------
+// ADS1115 berjalan dalam continuous-conversion mode dan pin ALERT/RDY
+// memberi pulsa setiap konversi selesai. ISR hanya mencatat waktu dan
+// menaikkan counter; pembacaan I2C dilakukan di service() supaya loop
+// tidak lagi menunggu konversi selesai.
+//
+// Saat lebih dari satu channel aktif, MUX dipindah setelah setiap hasil.
+// Konversi pertama setelah MUX berubah dibuang karena bisa masih memakai
+// input sebelumnya, jadi laju per channel = SPS / (2 * jumlah channel).
+class AdsAcquisition
+{
+public:
+    AdsAcquisition(Adafruit_ADS1115 &ads, uint8_t alertPin = ADS_ALERT_PIN);
+
+    bool begin(uint16_t samplesPerSecond = 860, uint8_t channelMask = 0x0F);
+    void stop();
+
+    // Set data rate (8..860 SPS, dibulatkan ke atas ke rate ADS1115 terdekat)
+    void setDataRate(uint16_t samplesPerSecond);
+    uint16_t dataRate() const { return _sps; }
+
+    // PGA; konversi berjalan diulang dengan gain baru
+    void setGain(adsGain_t gain);
+    adsGain_t gain() const { return _ads.getGain(); }
+
+    // Bit 0..3 = AI1..AI4
+    void setChannelMask(uint8_t mask);
+    uint8_t channelMask() const { return _mask; }
+
+    // Laju sampel efektif per channel (Hz), dipakai untuk filter
+    float channelRate() const;
+
+    // Dipanggil sesering mungkin; mengembalikan jumlah sampel baru
+    uint16_t service();
+
+    // Task yang dibangunkan (task notification) setiap RDY, supaya task
+    // akuisisi bisa tidur tanpa polling. nullptr = tanpa notifikasi.
+    void setNotifyTask(TaskHandle_t task) { _notifyTask = task; }
+    // micros() RDY terakhir (untuk mengukur latensi bangun task)
+    uint32_t lastReadyUs() const { return _readyAt; }
+
+    AdcRing &samples() { return _ring; }
+    uint32_t overruns() const { return _overruns; }
+    uint32_t sampleCount() const { return _sampleCount; }
+
+private:
+    static void IRAM_ATTR onReady();
+    void selectChannel(uint8_t channel);
+    uint8_t nextChannel(uint8_t from) const;
+
+    Adafruit_ADS1115 &_ads;
+    uint8_t _alertPin;
+    uint16_t _sps = 860;
+    uint8_t _mask = 0x0F;
+    uint8_t _current = 0;
+    bool _running = false;
+    bool _discardNext = false;
+    uint32_t _handled = 0;
+    uint32_t _overruns = 0;
+    uint32_t _sampleCount = 0;
+    AdcRing _ring;
+
+    static AdsAcquisition *_instance;
+    static volatile uint32_t _readyCount;
+    static volatile uint32_t _readyAt;
+    static TaskHandle_t _notifyTask;
+};
+
+#endif // ADSACQUISITION_H
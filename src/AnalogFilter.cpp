@@ -0,0 +1,232 @@
+#include "AnalogFilter.h"
+
+void AnalogFilterBank::configure(uint8_t channel, FilterType type, float periodSec, float sampleRateHz)
+{
+    if (channel >= FILTER_CHANNELS)
+        return;
+
+    State &s = _st[channel];
+    s.type = type;
+    s.limited = false;
+    s.decimate = 1;
+    if (sampleRateHz <= 0)
+        sampleRateHz = 1;
+    if (periodSec < 0)
+        periodSec = 0;
+
+    // Jumlah sampel yang tercakup oleh filterPeriod
+    float samples = periodSec * sampleRateHz;
+
+    switch (type)
+    {
+    case FILTER_EMA:
+    {
+        // alpha = 1 - exp(-dt / tau)
+        float alpha = (samples > 0) ? 1.0f - expf(-1.0f / samples) : 1.0f;
+        s.alpha = (int32_t)lroundf(alpha * 65536.0f);
+        if (s.alpha < 1)
+            s.alpha = 1;
+        if (s.alpha > 65536)
+            s.alpha = 65536;
+        s.window = 1;
+        break;
+    }
+    case FILTER_AVERAGE:
+    {
+        const float maxSpan = (float)FILTER_MAX_WINDOW * FILTER_MAX_DECIMATE;
+        if (samples > maxSpan)
+        {
+            s.limited = true;
+            samples = maxSpan;
+        }
+        long total = max(lroundf(samples), 1L);
+        // Blok sekecil mungkin supaya window muat di hist[]
+        long d = (total + FILTER_MAX_WINDOW - 1) / FILTER_MAX_WINDOW;
+        s.decimate = (uint16_t)d;
+        s.window = (uint16_t)constrain((total + d / 2) / d, 1L, (long)FILTER_MAX_WINDOW);
+        break;
+    }
+    case FILTER_MEDIAN:
+    {
+        long w = lroundf(samples);
+        w = constrain(w, 3L, (long)FILTER_MAX_MEDIAN);
+        s.window = (uint16_t)(w | 1); // selalu ganjil
+        if (s.window > FILTER_MAX_MEDIAN)
+            s.window = FILTER_MAX_MEDIAN;
+        break;
+    }
+    default:
+        s.window = 1;
+        break;
+    }
+    reset(channel);
+}
+
+void AnalogFilterBank::reset(uint8_t channel)
+{
+    if (channel >= FILTER_CHANNELS)
+        return;
+    State &s = _st[channel];
+    s.primed = false;
+    s.pos = 0;
+    s.fill = 0;
+    s.acc = 0;
+    s.blockFill = 0;
+    s.blockSum = 0;
+}
+
+FilterType AnalogFilterBank::type(uint8_t channel) const
+{
+    return channel < FILTER_CHANNELS ? _st[channel].type : FILTER_NONE;
+}
+
+uint16_t AnalogFilterBank::window(uint8_t channel) const
+{
+    return channel < FILTER_CHANNELS ? _st[channel].window : 0;
+}
+
+uint32_t AnalogFilterBank::span(uint8_t channel) const
+{
+    return channel < FILTER_CHANNELS ? (uint32_t)_st[channel].window * _st[channel].decimate : 0;
+}
+
+bool AnalogFilterBank::limited(uint8_t channel) const
+{
+    return channel < FILTER_CHANNELS && _st[channel].limited;
+}
+
+void AnalogFilterBank::process(uint8_t channel, int32_t *values, size_t count)
+{
+    if (channel >= FILTER_CHANNELS)
+        return;
+    State &s = _st[channel];
+
+    switch (s.type)
+    {
+    case FILTER_EMA:
+        for (size_t i = 0; i < count; i++)
+            values[i] = ema(s, values[i]);
+        break;
+    case FILTER_AVERAGE:
+        for (size_t i = 0; i < count; i++)
+            values[i] = average(s, values[i]);
+        break;
+    case FILTER_MEDIAN:
+        for (size_t i = 0; i < count; i++)
+            values[i] = median(s, values[i]);
+        break;
+    default:
+        break;
+    }
+}
+
+// ---------------------------------------------------------
+// Implementasi filter
+// ---------------------------------------------------------
+int32_t AnalogFilterBank::ema(State &s, int32_t x)
+{
+    // Batasi input supaya (xq - acc) * alpha tidak overflow int64
+    x = constrain(x, -(1L << 29), (1L << 29));
+    int64_t xq = (int64_t)x << 16;
+    if (!s.primed)
+    {
+        s.acc = xq;
+        s.primed = true;
+    }
+    else
+    {
+        s.acc += ((xq - s.acc) * s.alpha) >> 16;
+    }
+    return (int32_t)((s.acc + (1 << 15)) >> 16);
+}
+
+int32_t AnalogFilterBank::average(State &s, int32_t x)
+{
+    s.blockSum += x;
+    if (++s.blockFill == s.decimate)
+    {
+        // Blok lengkap -> satu entri window (decimate = 1: entri = sampel)
+        int32_t mean = (int32_t)(s.blockSum / s.decimate);
+        if (s.fill < s.window)
+        {
+            s.acc += mean;
+            s.fill++;
+        }
+        else
+        {
+            s.acc += (int64_t)mean - s.hist[s.pos];
+        }
+        s.hist[s.pos] = mean;
+        if (++s.pos >= s.window)
+            s.pos = 0;
+        s.blockFill = 0;
+        s.blockSum = 0;
+    }
+    // Blok yang sedang terisi ikut dihitung dengan bobot per sampel
+    int64_t n = (int64_t)s.fill * s.decimate + s.blockFill;
+    return (int32_t)((s.acc * s.decimate + s.blockSum) / n);
+}
+
+int32_t AnalogFilterBank::median(State &s, int32_t x)
+{
+    // hist = urutan waktu (circular), sorted = jendela yang sama terurut
+    uint16_t n = s.fill;
+    if (n == s.window)
+    {
+        // Buang sampel tertua dari array terurut
+        int32_t old = s.hist[s.pos];
+        uint16_t i = 0;
+        while (i < n && s.sorted[i] != old)
+            i++;
+        for (; i + 1 < n; i++)
+            s.sorted[i] = s.sorted[i + 1];
+        n--;
+    }
+    else
+    {
+        s.fill++;
+    }
+
+    // Sisipkan sampel baru (insertion, jendela <= 9)
+    uint16_t j = n;
+    while (j > 0 && s.sorted[j - 1] > x)
+    {
+        s.sorted[j] = s.sorted[j - 1];
+        j--;
+    }
+    s.sorted[j] = x;
+
+    s.hist[s.pos] = x;
+    if (++s.pos >= s.window)
+        s.pos = 0;
+    return s.sorted[s.fill / 2];
+}
+
+// ---------------------------------------------------------
+// Nama filter (configAnalog.json "filterType")
+// ---------------------------------------------------------
+FilterType AnalogFilterBank::parseType(const String &name)
+{
+    if (name == "EMA")
+        return FILTER_EMA;
+    if (name == "Moving Average")
+        return FILTER_AVERAGE;
+    if (name == "Median")
+        return FILTER_MEDIAN;
+    return FILTER_NONE;
+}
+
+const char *AnalogFilterBank::typeName(FilterType type)
+{
+    switch (type)
+    {
+    case FILTER_EMA:
+        return "EMA";
+    case FILTER_AVERAGE:
+        return "Moving Average";
+    case FILTER_MEDIAN:
+        return "Median";
+    default:
+        return "None";
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef ANALOGFILTER_H
+#define ANALOGFILTER_H
+
+#include <Arduino.h>
+
+#define FILTER_CHANNELS 4
+#define FILTER_MAX_WINDOW 128   // moving average (blok)
+#define FILTER_MAX_DECIMATE 256 // sampel per blok -> window maks. 32768 sampel
+#define FILTER_MAX_MEDIAN 9   // median (ganjil, kecil: untuk buang spike)
+
+enum FilterType : uint8_t
+{
+    FILTER_NONE = 0,
+    FILTER_EMA,     // first-order IIR, tau = filterPeriod
+    FILTER_AVERAGE, // moving average, window = filterPeriod (lewat blok rata-rata)
+    FILTER_MEDIAN   // median 3..9 sampel
+};
+
+// ---------------------------------------------------------
+// Filter digital per channel (setelah kalibrasi)
+// ---------------------------------------------------------
+// Semua state ada di array statis: tidak ada alokasi heap dan setiap
+// sampel O(1) (median: O(window) dengan window <= 9). Nilai yang
+// difilter adalah nilai engineering milli-unit dari CalibrationKernel.
+// Moving average yang lebih panjang dari FILTER_MAX_WINDOW sampel
+// dirata-rata dulu per blok `decimate` sampel; window berjalan atas
+// rata-rata blok plus blok yang sedang terisi, jadi output tetap per
+// sampel. Periode di atas FILTER_MAX_WINDOW x FILTER_MAX_DECIMATE sampel
+// dipotong dan ditandai limited().
+class AnalogFilterBank
+{
+public:
+    // periodSec = filterPeriod dari configAnalog.json,
+    // sampleRateHz = laju sampel efektif channel tersebut
+    void configure(uint8_t channel, FilterType type, float periodSec, float sampleRateHz);
+    void reset(uint8_t channel);
+
+    // Filter in-place satu blok sampel
+    void process(uint8_t channel, int32_t *values, size_t count);
+
+    FilterType type(uint8_t channel) const;
+    uint16_t window(uint8_t channel) const;
+    // Panjang window efektif dalam sampel (window x decimate)
+    uint32_t span(uint8_t channel) const;
+    // filterPeriod melebihi window maksimum dan dipotong
+    bool limited(uint8_t channel) const;
+
+    static FilterType parseType(const String &name);
+    static const char *typeName(FilterType type);
+
+private:
+    struct State
+    {
+        FilterType type;
+        bool primed;
+        bool limited;
+        uint16_t window;
+        uint16_t decimate; // average: sampel per blok
+        uint16_t blockFill;
+        int64_t blockSum;
+        uint16_t pos;
+        uint16_t fill;
+        int32_t alpha;  // EMA, Q16
+        int64_t acc;    // EMA: state Q16, average: running sum rata-rata blok
+        int32_t hist[FILTER_MAX_WINDOW];
+        int32_t sorted[FILTER_MAX_MEDIAN];
+    };
+
+    int32_t ema(State &s, int32_t x);
+    int32_t average(State &s, int32_t x);
+    int32_t median(State &s, int32_t x);
+
+    State _st[FILTER_CHANNELS] = {};
+};
+
+#endif // ANALOGFILTER_H
@@ -0,0 +1,258 @@
+#include "AssetCache.h"
+
+#define ASSET_STR_(x) #x
+#define ASSET_STR(x) ASSET_STR_(x)
+
+static bool endsWith(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+static bool isDelimiter(char c)
+{
+    return c == '.' || c == '-' || c == '_' || c == '@';
+}
+
+// Nama file membawa versi ("lib-5.3.2.min.js", "lib@v2.1.css") atau hash isi
+// ("app.3f9a12cd.js"): isi untuk nama itu tidak pernah berubah, aman di-cache
+// lama tanpa revalidasi. File lain cukup no-cache + ETag (304 murah).
+static bool isVersionedName(const char *path)
+{
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    bool prevNumeric = false;
+    for (const char *p = name; *p;)
+    {
+        const char *start = p;
+        while (*p && !isDelimiter(*p))
+            p++;
+        size_t len = p - start;
+        const char *digits = (len > 1 && (*start == 'v' || *start == 'V')) ? start + 1 : start;
+        bool numeric = digits < p;
+        bool hex = len >= 8;
+        for (const char *q = start; q < p; q++)
+        {
+            if (q >= digits && !isdigit((unsigned char)*q))
+                numeric = false;
+            if (!isxdigit((unsigned char)*q))
+                hex = false;
+        }
+        // Versi = minimal dua angka berurutan dipisah '.', mis. 5.3
+        if (hex || (numeric && prevNumeric && start[-1] == '.'))
+            return true;
+        prevNumeric = numeric;
+        if (*p)
+            p++;
+    }
+    return false;
+}
+
+const char *AssetCache::contentType(const char *filename)
+{
+    if (endsWith(filename, ".html"))
+        return "text/html";
+    else if (endsWith(filename, ".css"))
+        return "text/css";
+    else if (endsWith(filename, ".js"))
+        return "application/javascript";
+    else if (endsWith(filename, ".json"))
+        return "application/json";
+    else if (endsWith(filename, ".png"))
+        return "image/png";
+    else if (endsWith(filename, ".jpg"))
+        return "image/jpeg";
+    else if (endsWith(filename, ".ico"))
+        return "image/x-icon";
+    else if (endsWith(filename, ".gz"))
+        return "application/x-gzip";
+    return "text/plain";
+}
+
+size_t AssetCache::begin()
+{
+    _count = 0;
+    _segmentCount = 0;
+    scanDir("/", 0);
+
+    // Urutkan per path untuk binary search (insertion sort, n kecil)
+    for (uint8_t i = 1; i < _count; i++)
+    {
+        AssetInfo tmp = _items[i];
+        int j = i - 1;
+        while (j >= 0 && strcmp(_items[j].path, tmp.path) > 0)
+        {
+            _items[j + 1] = _items[j];
+            j--;
+        }
+        _items[j + 1] = tmp;
+    }
+
+    Serial.printf("AssetCache: %u file di-index\n", (unsigned)_count);
+    return _count;
+}
+
+void AssetCache::scanDir(const char *dir, uint8_t depth)
+{
+    File root = LittleFS.open(dir, "r");
+    if (!root || !root.isDirectory())
+        return;
+
+    File f = root.openNextFile();
+    while (f)
+    {
+        // Salin path: objek File ditutup sebelum rekursi
+        char fullPath[ASSET_MAX_PATH + 4];
+        strncpy(fullPath, f.path(), sizeof(fullPath) - 1);
+        fullPath[sizeof(fullPath) - 1] = '\0';
+
+        if (f.isDirectory())
+        {
+            f.close();
+            if (depth < 3)
+                scanDir(fullPath, depth + 1);
+        }
+        else
+        {
+            add(f, fullPath);
+            f.close();
+        }
+        f = root.openNextFile();
+    }
+    root.close();
+}
+
+void AssetCache::add(File &f, const char *fullPath)
+{
+    // Config runtime bisa berubah kapan saja -> jangan di-cache.
+    // Journal config (berisi password) tidak boleh bisa diunduh, isi /log
+    // (segmen data logger, cursor uplink) terus berubah.
+    if (endsWith(fullPath, ".json") || endsWith(fullPath, ".jnl") || endsWith(fullPath, ".tmp") ||
+        strncmp(fullPath, "/log/", 5) == 0)
+        return;
+
+    bool gz = endsWith(fullPath, ".gz");
+    size_t logicalLen = strlen(fullPath) - (gz ? 3 : 0);
+    if (logicalLen >= ASSET_MAX_PATH)
+    {
+        Serial.printf("AssetCache: path terlalu panjang, dilewati: %s\n", fullPath);
+        return;
+    }
+    char logical[ASSET_MAX_PATH];
+    memcpy(logical, fullPath, logicalLen);
+    logical[logicalLen] = '\0';
+
+    // Jika ada versi .gz dan biasa, pakai .gz (sama seperti serve lama)
+    AssetInfo *slot = nullptr;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (strcmp(_items[i].path, logical) == 0)
+        {
+            if (_items[i].gzip || !gz)
+                return;
+            slot = &_items[i];
+            break;
+        }
+    }
+    if (!slot && _count >= ASSET_MAX_FILES)
+    {
+        Serial.printf("AssetCache: penuh, dilewati: %s\n", fullPath);
+        return;
+    }
+
+    const char *type = contentType(logical);
+    bool isHtml = !gz && strcmp(type, "text/html") == 0;
+
+    // Hash FNV-1a seluruh isi + pindai placeholder {{ }} pada HTML
+    uint32_t hash = 2166136261UL;
+    TemplateScanner scanner(_segments + _segmentCount, TPL_MAX_SEGMENTS - _segmentCount);
+    uint8_t buf[512];
+    while (f.available())
+    {
+        int n = f.read(buf, sizeof(buf));
+        if (n <= 0)
+            break;
+        for (int i = 0; i < n; i++)
+            hash = (hash ^ buf[i]) * 16777619UL;
+        if (isHtml)
+            scanner.feed(buf, n);
+    }
+
+    int segments = isHtml ? scanner.finish() : 0;
+    if (segments < 0)
+    {
+        Serial.printf("AssetCache: pool template penuh, dilewati: %s\n", fullPath);
+        return;
+    }
+    bool templated = isHtml && scanner.templated();
+    if (!slot)
+        slot = &_items[_count++];
+    slot->firstSegment = _segmentCount;
+    slot->segmentCount = templated ? segments : 0;
+    // Segmen halaman tanpa placeholder tidak perlu disimpan
+    if (templated)
+        _segmentCount += segments;
+
+    memcpy(slot->path, logical, logicalLen + 1);
+    slot->size = f.size();
+    slot->hash = hash;
+    slot->contentType = type;
+    slot->gzip = gz;
+    slot->templated = templated;
+    slot->immutable = strcmp(type, "text/html") != 0 && isVersionedName(logical);
+}
+
+const AssetInfo *AssetCache::find(const char *path) const
+{
+    size_t lo = 0, hi = _count;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strcmp(_items[mid].path, path);
+        if (cmp == 0)
+            return &_items[mid];
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return nullptr;
+}
+
+void AssetCache::filePath(const AssetInfo &a, char *buf, size_t size)
+{
+    snprintf(buf, size, a.gzip ? "%s.gz" : "%s", a.path);
+}
+
+void AssetCache::formatEtag(const AssetInfo &a, char *buf, size_t size)
+{
+    snprintf(buf, size, "\"%08lx-%lx\"", (unsigned long)a.hash, (unsigned long)a.size);
+}
+
+bool AssetCache::etagMatches(const char *etag, const char *ifNoneMatch)
+{
+    if (!ifNoneMatch || !*ifNoneMatch)
+        return false;
+    if (strcmp(ifNoneMatch, "*") == 0)
+        return true;
+    // Perbandingan lemah (RFC 7232 3.2): "W/" diabaikan, cukup cari tag utuh
+    size_t len = strlen(etag);
+    for (const char *p = strstr(ifNoneMatch, etag); p; p = strstr(p + 1, etag))
+    {
+        char after = p[len];
+        if (after == '\0' || after == ',' || after == ' ')
+            return true;
+    }
+    return false;
+}
+
+const char *AssetCache::cacheControl(const AssetInfo &a)
+{
+    if (a.templated)
+        return "no-store";
+    if (a.immutable)
+        return "public, max-age=" ASSET_STR(ASSET_MAX_AGE_SEC);
+    // Nama tanpa versi/hash bisa diganti lewat upload LittleFS: selalu
+    // revalidasi (murah karena 304)
+    return "no-cache";
+}
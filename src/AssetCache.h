@@ -0,0 +1,68 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "HtmlTemplate.h"
+
+#define ASSET_MAX_FILES 48
+#define ASSET_MAX_PATH 40
+#define ASSET_ETAG_LEN 24           // "\"xxxxxxxx-xxxxxx\"" + '\0'
+#define ASSET_MAX_AGE_SEC 604800    // 7 hari untuk asset bernama versi/hash
+
+// Metadata satu file statis di LittleFS
+struct AssetInfo
+{
+    char path[ASSET_MAX_PATH]; // path logis (tanpa ".gz")
+    uint32_t size;             // ukuran file yang benar-benar dikirim
+    uint32_t hash;             // FNV-1a isi file -> ETag
+    const char *contentType;
+    bool gzip;                 // tersimpan sebagai path + ".gz"
+    bool templated;            // HTML berisi {{VAR}}: isi berubah, tanpa ETag
+    uint16_t firstSegment;     // segmen template di pool AssetCache
+    uint16_t segmentCount;
+    bool immutable;            // nama berversi/hash: Cache-Control max-age panjang
+};
+
+// ---------------------------------------------------------
+// Cache metadata asset statis
+// ---------------------------------------------------------
+// Dibangun sekali saat mount: seluruh LittleFS di-scan, tiap file di-hash
+// untuk ETag. Saat serve tidak perlu LittleFS.exists() lagi, dan request
+// dengan If-None-Match yang cocok dijawab 304 tanpa membuka file.
+// File *.json (config runtime) dan journal config sengaja tidak dimasukkan.
+// HTML biasa sekalian dipindai TemplateScanner; segmennya disimpan di pool
+// bersama (halaman yang tidak muat di pool tidak di-index, dilayani jalur
+// fallback serveFile).
+class AssetCache
+{
+public:
+    AssetCache() : _count(0), _segmentCount(0) {}
+
+    // Scan LittleFS (harus sudah di-mount). Mengembalikan jumlah asset.
+    size_t begin();
+
+    // Binary search berdasarkan path logis; nullptr jika tidak ada
+    const AssetInfo *find(const char *path) const;
+    size_t count() const { return _count; }
+    const TemplateSegment *segments(const AssetInfo &a) const { return _segments + a.firstSegment; }
+
+    // Path file di LittleFS (menambah ".gz" bila perlu)
+    static void filePath(const AssetInfo &a, char *buf, size_t size);
+    static void formatEtag(const AssetInfo &a, char *buf, size_t size);
+    // Cocokkan header If-None-Match (boleh daftar / prefix W/ / "*")
+    static bool etagMatches(const char *etag, const char *ifNoneMatch);
+    static const char *cacheControl(const AssetInfo &a);
+    static const char *contentType(const char *filename);
+
+private:
+    void scanDir(const char *dir, uint8_t depth);
+    void add(File &f, const char *fullPath);
+
+    AssetInfo _items[ASSET_MAX_FILES];
+    uint8_t _count;
+    TemplateSegment _segments[TPL_MAX_SEGMENTS];
+    uint16_t _segmentCount;
+};
+
+#endif // ASSETCACHE_H
@@ -0,0 +1,192 @@
+#include "Calibration.h"
+
+static inline int32_t saturate32(int64_t v)
+{
+    if (v > INT32_MAX)
+        return INT32_MAX;
+    if (v < INT32_MIN)
+        return INT32_MIN;
+    return (int32_t)v;
+}
+
+void CalibrationKernel::setGain(adsGain_t gain)
+{
+    switch (gain)
+    {
+    case GAIN_ONE:
+        _fsRange = 4.096f;
+        break;
+    case GAIN_TWO:
+        _fsRange = 2.048f;
+        break;
+    case GAIN_FOUR:
+        _fsRange = 1.024f;
+        break;
+    case GAIN_EIGHT:
+        _fsRange = 0.512f;
+        break;
+    case GAIN_SIXTEEN:
+        _fsRange = 0.256f;
+        break;
+    default:
+        _fsRange = 6.144f;
+        break;
+    }
+    // Gain berubah -> semua koefisien channel dihitung ulang
+    for (uint8_t i = 0; i < CAL_CHANNELS; i++)
+    {
+        configure(i, _ch[i].slope, _ch[i].intercept);
+        if (_ch[i].useLut)
+            compileCurve(i);
+    }
+}
+
+void CalibrationKernel::configure(uint8_t channel, float slope, float intercept)
+{
+    if (channel >= CAL_CHANNELS)
+        return;
+
+    // code -> scaled raw (dalam double supaya pembulatan hanya sekali)
+    double k = (double)_fsRange / 32768.0 / CAL_RAW_FULLSCALE_V * 65535.0;
+    _rawGain = (int32_t)lround(k * (double)(1UL << RAW_SHIFT));
+
+    Coeffs &c = _ch[channel];
+    c.slope = slope;
+    c.intercept = intercept;
+
+    // Pilih shift terbesar yang masih membuat engGain muat di int32,
+    // supaya presisi maksimum untuk slope kecil (mis. 0.004888)
+    double gain = (double)slope * k * CAL_ENG_SCALE;
+    uint8_t shift = 0;
+    double offset = (double)intercept * CAL_ENG_SCALE;
+    while (shift < 32 && fabs(gain * (double)(1ULL << (shift + 1))) < 2147483647.0 &&
+           fabs(offset * (double)(1ULL << (shift + 1))) < 4.0e18)
+        shift++;
+
+    c.engShift = shift;
+    // Slope absurd (> INT32_MAX milli-unit per kode) dijepit: hasil tetap
+    // jenuh di saturate32(), bukan wrap ke tanda sebaliknya
+    double scaled = gain * (double)(1ULL << shift);
+    c.engGain = (int32_t)llround(constrain(scaled, (double)INT32_MIN, (double)INT32_MAX));
+    c.engOffset = llround(offset * (double)(1ULL << shift));
+    // Pembulatan ke terdekat saat di-shift balik
+    if (shift > 0)
+        c.engOffset += (int64_t)1 << (shift - 1);
+}
+
+CalCurveType CalibrationKernel::parseCurveType(const char *name)
+{
+    if (strcmp(name, "pwl") == 0)
+        return CAL_CURVE_PWL;
+    if (strcmp(name, "poly") == 0)
+        return CAL_CURVE_POLY;
+    return CAL_CURVE_LINEAR;
+}
+
+void CalibrationKernel::setCurve(uint8_t channel, const CalCurve &curve)
+{
+    if (channel >= CAL_CHANNELS)
+        return;
+
+    Coeffs &c = _ch[channel];
+    c.curve = curve;
+    c.curve.count = min(curve.count, (uint8_t)CAL_MAX_POINTS);
+    c.useLut = curve.type != CAL_CURVE_LINEAR && c.curve.count >= (curve.type == CAL_CURVE_PWL ? 2 : 1);
+    if (!c.useLut)
+        return;
+
+    // Titik PWL diurutkan menurut x (insertion sort, maks. 8 titik)
+    if (c.curve.type == CAL_CURVE_PWL)
+    {
+        CalCurve &k = c.curve;
+        for (uint8_t i = 1; i < k.count; i++)
+        {
+            float x = k.x[i], y = k.y[i];
+            int8_t j = i - 1;
+            while (j >= 0 && k.x[j] > x)
+            {
+                k.x[j + 1] = k.x[j];
+                k.y[j + 1] = k.y[j];
+                j--;
+            }
+            k.x[j + 1] = x;
+            k.y[j + 1] = y;
+        }
+    }
+    compileCurve(channel);
+}
+
+double CalibrationKernel::evalCurve(const CalCurve &curve, double x)
+{
+    if (curve.type == CAL_CURVE_POLY)
+    {
+        // Horner, koefisien derajat tertinggi di akhir
+        double y = 0;
+        for (int8_t i = curve.count - 1; i >= 0; i--)
+            y = y * x + curve.y[i];
+        return y;
+    }
+
+    // Segmen pertama / terakhir dipakai juga untuk ekstrapolasi
+    uint8_t i = 0;
+    while (i + 2 < curve.count && x > curve.x[i + 1])
+        i++;
+    double dx = (double)curve.x[i + 1] - curve.x[i];
+    if (dx == 0)
+        return curve.y[i];
+    return curve.y[i] + (x - curve.x[i]) * ((double)curve.y[i + 1] - curve.y[i]) / dx;
+}
+
+// Kurva dievaluasi (double) di setiap batas segmen kode ADC
+void CalibrationKernel::compileCurve(uint8_t channel)
+{
+    const CalCurve &curve = _ch[channel].curve;
+    Segment *lut = _lut[channel];
+    double k = (double)_fsRange / 32768.0 / CAL_RAW_FULLSCALE_V * 65535.0;
+
+    int32_t prev = 0;
+    for (uint32_t s = 0; s <= CAL_LUT_SEGMENTS; s++)
+    {
+        int32_t code = (int32_t)(s << CAL_LUT_SHIFT) - 32768;
+        int32_t y = saturate32(llround(evalCurve(curve, code * k) * CAL_ENG_SCALE));
+        if (s > 0)
+        {
+            lut[s - 1].base = prev;
+            lut[s - 1].delta = saturate32((int64_t)y - prev);
+        }
+        prev = y;
+    }
+}
+
+void CalibrationKernel::process(uint8_t channel, const int16_t *codes, size_t count,
+                                int32_t *scaledRaw, int32_t *engMilli) const
+{
+    if (channel >= CAL_CHANNELS)
+        return;
+
+    const Coeffs &c = _ch[channel];
+    const int64_t rawRound = (int64_t)1 << (RAW_SHIFT - 1);
+
+    if (scaledRaw)
+    {
+        for (size_t i = 0; i < count; i++)
+            scaledRaw[i] = (int32_t)(((int64_t)codes[i] * _rawGain + rawRound) >> RAW_SHIFT);
+    }
+    if (engMilli && c.useLut)
+    {
+        const Segment *lut = _lut[channel];
+        const uint32_t mask = (1UL << CAL_LUT_SHIFT) - 1;
+        const int64_t round = (int64_t)1 << (CAL_LUT_SHIFT - 1);
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t u = (uint16_t)(codes[i] + 32768);
+            const Segment &s = lut[u >> CAL_LUT_SHIFT];
+            engMilli[i] = saturate32(s.base + (((int64_t)s.delta * (u & mask) + round) >> CAL_LUT_SHIFT));
+        }
+    }
+    else if (engMilli)
+    {
+        for (size_t i = 0; i < count; i++)
+            engMilli[i] = saturate32(((int64_t)codes[i] * c.engGain + c.engOffset) >> c.engShift);
+    }
+}
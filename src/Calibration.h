@@ -0,0 +1,111 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <Arduino.h>
+#include <Adafruit_ADS1X15.h>
+
+#define CAL_CHANNELS 4
+// Nilai engineering disimpan sebagai integer milli-unit (x1000)
+#define CAL_ENG_SCALE 1000
+// Scaled raw: 0..5V dipetakan ke 0..65535 (4mA=13107, 20mA=65535)
+#define CAL_RAW_FULLSCALE_V 5.0f
+// Titik kurva piecewise-linear / koefisien polinom per channel
+#define CAL_MAX_POINTS 8
+// LUT kurva: 2^CAL_LUT_BITS segmen dipilih dari bit atas kode ADC
+// (8 = 256 segmen x 256 kode, 2 KB per channel)
+#ifndef CAL_LUT_BITS
+#define CAL_LUT_BITS 8
+#endif
+#if CAL_LUT_BITS < 1 || CAL_LUT_BITS > 15
+#error "CAL_LUT_BITS harus 1..15"
+#endif
+#define CAL_LUT_SEGMENTS (1 << CAL_LUT_BITS)
+#define CAL_LUT_SHIFT (16 - CAL_LUT_BITS)
+
+enum CalCurveType : uint8_t
+{
+    CAL_CURVE_LINEAR, // y = m * x + c (slope/intercept)
+    CAL_CURVE_PWL,    // titik (x[i], y[i]), diekstrapolasi di luar ujung
+    CAL_CURVE_POLY    // y = y[0] + y[1]*x + ... + y[count-1]*x^(count-1)
+};
+
+// x selalu scaled raw (0..65535), sama dengan x di rumus m * x + c
+struct CalCurve
+{
+    CalCurveType type;
+    uint8_t count;
+    float x[CAL_MAX_POINTS];
+    float y[CAL_MAX_POINTS];
+};
+
+// ---------------------------------------------------------
+// Kalibrasi fixed-point per blok sampel
+// ---------------------------------------------------------
+// Rumus lama per sampel (float):
+//   voltage = computeVolts(code)
+//   x       = (voltage / 5.0) * 65535
+//   y       = m * x + c
+// Karena semuanya linear, koefisien digabung sekali di configure():
+//   x = (code * rawGain) >> RAW_SHIFT
+//   y = (code * engGain + engOffset) >> engShift   (milli-unit)
+// sehingga per sampel hanya ada 2 multiply-add integer.
+//
+// Kurva non-linear (piecewise-linear / polinom) dikompilasi di setCurve()
+// menjadi LUT per channel: kode ADC (offset ke 0..65535) dibagi menjadi
+// CAL_LUT_SEGMENTS segmen, tiap segmen menyimpan nilai di awal segmen dan
+// selisih ke segmen berikutnya. Per sampel: satu lookup + satu
+// multiply-add (interpolasi linear), berapa pun titik / derajat kurvanya.
+// Error interpolasi hanya ada di dalam segmen yang memuat lekukan kurva.
+class CalibrationKernel
+{
+public:
+    static const uint8_t RAW_SHIFT = 20;
+
+    // Full-scale range PGA (harus sama dengan ads.setGain)
+    void setGain(adsGain_t gain);
+
+    // slope/intercept = AnalogConfig.slope / intercept (mValue / cValue)
+    void configure(uint8_t channel, float slope, float intercept);
+
+    // Kurva non-linear menggantikan slope/intercept; CAL_CURVE_LINEAR
+    // (atau titik kurang dari 2) kembali ke jalur linear
+    void setCurve(uint8_t channel, const CalCurve &curve);
+
+    // "linear" / "pwl" / "poly" (configAnalog.json "calCurve")
+    static CalCurveType parseCurveType(const char *name);
+
+    // Satu pass untuk satu channel. scaledRaw / engMilli boleh nullptr
+    void process(uint8_t channel, const int16_t *codes, size_t count,
+                 int32_t *scaledRaw, int32_t *engMilli) const;
+
+    static float toUnits(int32_t engMilli) { return engMilli * (1.0f / CAL_ENG_SCALE); }
+
+private:
+    struct Coeffs
+    {
+        int32_t engGain;
+        int64_t engOffset;
+        uint8_t engShift;
+        float slope;
+        float intercept;
+        bool useLut;
+        CalCurve curve; // disimpan untuk kompilasi ulang saat gain berubah
+    };
+
+    // Nilai (milli-unit) di awal segmen + selisih ke awal segmen berikutnya
+    struct Segment
+    {
+        int32_t base;
+        int32_t delta;
+    };
+
+    void compileCurve(uint8_t channel);
+    static double evalCurve(const CalCurve &curve, double x);
+
+    float _fsRange = 6.144f;
+    int32_t _rawGain = 0;
+    Coeffs _ch[CAL_CHANNELS] = {};
+    Segment _lut[CAL_CHANNELS][CAL_LUT_SEGMENTS] = {};
+};
+
+#endif // CALIBRATION_H
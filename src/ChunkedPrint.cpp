@@ -0,0 +1,52 @@
+#include "ChunkedPrint.h"
+#include "Metrics.h"
+
+size_t ChunkedPrint::write(uint8_t c)
+{
+    if (_len >= sizeof(_buf))
+        flushChunk();
+    _buf[_len++] = c;
+    _total++;
+    return 1;
+}
+
+size_t ChunkedPrint::write(const uint8_t *buf, size_t size)
+{
+    size_t left = size;
+    while (left > 0)
+    {
+        if (_len >= sizeof(_buf))
+            flushChunk();
+        size_t n = min(left, (size_t)(sizeof(_buf) - _len));
+        memcpy(_buf + _len, buf, n);
+        _len += n;
+        buf += n;
+        left -= n;
+    }
+    _total += size;
+    return size;
+}
+
+void ChunkedPrint::flushChunk()
+{
+    if (_len == 0)
+        return;
+    if (_chunked)
+    {
+        char head[8];
+        snprintf(head, sizeof(head), "%X\r\n", (unsigned)_len);
+        _out.print(head);
+    }
+    _out.write(_buf, _len);
+    if (_chunked)
+        _out.print("\r\n");
+    _len = 0;
+}
+
+void ChunkedPrint::end()
+{
+    flushChunk();
+    if (_chunked)
+        _out.print("0\r\n\r\n");
+    METRIC_ADD(METRIC_HTTP_TX_BYTES, _total);
+}
@@ -0,0 +1,37 @@
+#ifndef CHUNKEDPRINT_H
+#define CHUNKEDPRINT_H
+
+#include <Arduino.h>
+
+#define HTTP_CHUNK_BUFFER 512
+
+// ---------------------------------------------------------
+// Print ber-buffer tetap dengan HTTP chunked transfer encoding
+// ---------------------------------------------------------
+// Byte dikumpulkan di buffer internal; setiap buffer penuh dikirim sebagai
+// satu chunk ("<hex>\r\n<data>\r\n"). end() mengirim sisa buffer dan chunk
+// penutup "0\r\n\r\n". Tanpa chunked (client HTTP/1.0) buffer dikirim apa
+// adanya dan akhir body ditandai dengan menutup koneksi.
+class ChunkedPrint : public Print
+{
+public:
+    ChunkedPrint(Print &out, bool chunked) : _out(out), _chunked(chunked), _len(0), _total(0) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+
+    void end();
+    uint32_t total() const { return _total; }
+
+private:
+    void flushChunk();
+
+    Print &_out;
+    bool _chunked;
+    uint16_t _len;
+    uint32_t _total;
+    uint8_t _buf[HTTP_CHUNK_BUFFER];
+};
+
+#endif // CHUNKEDPRINT_H
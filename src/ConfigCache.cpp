@@ -0,0 +1,661 @@
+#include "ConfigCache.h"
+#include "JsonHelper.h"
+#include "JsonWriter.h"
+
+ConfigCache config;
+
+// ---------------------------------------------------------
+// Helper output JSON
+// ---------------------------------------------------------
+// Escape & format angka memakai JsonWriter (satu implementasi)
+static void printJsonString(Print &out, const char *s)
+{
+    JsonWriter::printString(out, s);
+}
+
+static void printJsonNumber(Print &out, float v)
+{
+    JsonWriter::printNumber(out, v);
+}
+
+// "key":"value"
+static void kvStr(Print &out, const char *key, const char *value, bool comma = true)
+{
+    out.print('"');
+    out.print(key);
+    out.print("\":");
+    printJsonString(out, value);
+    if (comma)
+        out.print(',');
+}
+
+// "key":number
+static void kvNum(Print &out, const char *key, float value, bool comma = true)
+{
+    out.print('"');
+    out.print(key);
+    out.print("\":");
+    printJsonNumber(out, value);
+    if (comma)
+        out.print(',');
+}
+
+static void kvBool(Print &out, const char *key, bool value, bool comma = true)
+{
+    out.print('"');
+    out.print(key);
+    out.print(value ? "\":true" : "\":false");
+    if (comma)
+        out.print(',');
+}
+
+static bool parseBool(const String &v)
+{
+    return v == "1" || v == "true" || v == "on";
+}
+
+// ---------------------------------------------------------
+// Section
+// ---------------------------------------------------------
+// Versi layout struct per section: naikkan jika field struct berubah.
+// Record versi lama dimigrasi di migrateSection() jika ada konversinya,
+// selain itu diabaikan dan section diimpor ulang dari JSON.
+struct SectionInfo
+{
+    const char *jsonPath;
+    uint8_t version;
+};
+
+static const SectionInfo kSections[CFG_SECTION_COUNT] = {
+    {"/configNetwork.json", 1},
+    {"/configDigital.json", 1},
+    {"/configAnalog.json", 2},
+    {"/modbusSetup.json", 1},
+    {"/systemSettings.json", 1},
+};
+
+// configAnalog versi 1 (sebelum calCurve/calX/calY)
+struct AnalogChannelConfigV1
+{
+    char name[33];
+    char inputType[12];
+    bool filter;
+    char filterType[16];
+    float filterPeriod;
+    bool scaling;
+    float lowLimit;
+    float highLimit;
+    bool calibration;
+    float mValue;
+    float cValue;
+};
+
+struct AnalogInputsConfigV1
+{
+    AnalogChannelConfigV1 ai[CFG_AI_COUNT];
+};
+
+void *ConfigCache::sectionData(uint8_t section, size_t &size)
+{
+    switch (section)
+    {
+    case CFG_SECTION_NETWORK:
+        size = sizeof(_network);
+        return &_network;
+    case CFG_SECTION_DIGITAL:
+        size = sizeof(_digital);
+        return &_digital;
+    case CFG_SECTION_ANALOG:
+        size = sizeof(_analog);
+        return &_analog;
+    case CFG_SECTION_MODBUS:
+        size = sizeof(_modbus);
+        return &_modbus;
+    default:
+        size = sizeof(_system);
+        return &_system;
+    }
+}
+
+void ConfigCache::parseSection(uint8_t section, const String &json)
+{
+    switch (section)
+    {
+    case CFG_SECTION_NETWORK:
+        parseNetwork(json);
+        break;
+    case CFG_SECTION_DIGITAL:
+        parseDigital(json);
+        break;
+    case CFG_SECTION_ANALOG:
+        parseAnalog(json);
+        break;
+    case CFG_SECTION_MODBUS:
+        parseModbus(json);
+        break;
+    default:
+        parseSystem(json);
+        break;
+    }
+}
+
+// Record versi sebelumnya -> struct sekarang; field baru diisi default.
+// false jika tidak ada record lama yang bisa dikonversi.
+bool ConfigCache::migrateSection(uint8_t section)
+{
+    if (section != CFG_SECTION_ANALOG)
+        return false;
+    static AnalogInputsConfigV1 old;
+    if (!_journal.read(section, 1, &old, sizeof(old)))
+        return false;
+    memset(&_analog, 0, sizeof(_analog));
+    for (uint8_t i = 0; i < CFG_AI_COUNT; i++)
+    {
+        const AnalogChannelConfigV1 &o = old.ai[i];
+        AnalogChannelConfig &a = _analog.ai[i];
+        memcpy(a.name, o.name, sizeof(a.name));
+        memcpy(a.inputType, o.inputType, sizeof(a.inputType));
+        a.filter = o.filter;
+        memcpy(a.filterType, o.filterType, sizeof(a.filterType));
+        a.filterPeriod = o.filterPeriod;
+        a.scaling = o.scaling;
+        a.lowLimit = o.lowLimit;
+        a.highLimit = o.highLimit;
+        a.calibration = o.calibration;
+        a.mValue = o.mValue;
+        a.cValue = o.cValue;
+        copyField(a.calCurve, sizeof(a.calCurve), "linear");
+        a.calPoints = 0;
+    }
+    Serial.printf("Config: section %u dimigrasi dari versi 1.\n", section);
+    return true;
+}
+
+// ---------------------------------------------------------
+// Load
+// ---------------------------------------------------------
+bool ConfigCache::begin()
+{
+    if (!LittleFS.begin(true))
+    {
+        Serial.println("Config: LittleFS Mount Failed!");
+        return false;
+    }
+    if (!_journal.begin())
+        Serial.println("Config: journal tidak bisa dibaca, memakai file JSON.");
+
+    for (uint8_t s = 0; s < CFG_SECTION_COUNT; s++)
+    {
+        size_t size;
+        void *data = sectionData(s, size);
+        if (_journal.read(s, kSections[s].version, data, size))
+            continue;
+        // Record versi lama: konversi, lalu ditulis ulang dengan versi baru
+        if (migrateSection(s))
+        {
+            _dirty |= 1 << s;
+            continue;
+        }
+        // Belum ada record yang cocok: impor JSON lama lalu simpan ke journal
+        parseSection(s, readFile(kSections[s].jsonPath));
+        _dirty |= 1 << s;
+    }
+    flush();
+    _revision++;
+    Serial.printf("Config cache loaded (journal %u byte, %u record).\n",
+                  (unsigned)_journal.size(), (unsigned)_journal.records());
+    return true;
+}
+
+String ConfigCache::readFile(const char *path)
+{
+    String content = "{}";
+    if (LittleFS.exists(path))
+    {
+        File f = LittleFS.open(path, "r");
+        if (f)
+        {
+            content = f.readString();
+            f.close();
+        }
+    }
+    return content;
+}
+
+void ConfigCache::parseNetwork(const String &json)
+{
+    NetworkConfig &n = _network;
+    memset(&n, 0, sizeof(n));
+    copyField(n.networkMode, sizeof(n.networkMode), getJsonVal(json, "networkMode"));
+    copyField(n.ssid, sizeof(n.ssid), getJsonVal(json, "ssid"));
+    copyField(n.password, sizeof(n.password), getJsonVal(json, "password"));
+    copyField(n.apSsid, sizeof(n.apSsid), getJsonVal(json, "apSsid"));
+    copyField(n.apPassword, sizeof(n.apPassword), getJsonVal(json, "apPassword"));
+    copyField(n.dhcpMode, sizeof(n.dhcpMode), getJsonVal(json, "dhcpMode"));
+    copyField(n.ipAddress, sizeof(n.ipAddress), getJsonVal(json, "ipAddress"));
+    copyField(n.subnet, sizeof(n.subnet), getJsonVal(json, "subnet"));
+    copyField(n.ipGateway, sizeof(n.ipGateway), getJsonVal(json, "ipGateway"));
+    copyField(n.ipDNS, sizeof(n.ipDNS), getJsonVal(json, "ipDNS"));
+    copyField(n.sendTrig, sizeof(n.sendTrig), getJsonVal(json, "sendTrig"));
+    n.sendInterval = getJsonVal(json, "sendInterval").toInt();
+    copyField(n.protocolMode, sizeof(n.protocolMode), getJsonVal(json, "protocolMode"));
+    copyField(n.endpoint, sizeof(n.endpoint), getJsonVal(json, "endpoint"));
+    n.port = getJsonVal(json, "port").toInt();
+    copyField(n.pubTopic, sizeof(n.pubTopic), getJsonVal(json, "pubTopic"));
+    copyField(n.subTopic, sizeof(n.subTopic), getJsonVal(json, "subTopic"));
+    copyField(n.mqttUsername, sizeof(n.mqttUsername), getJsonVal(json, "mqttUsername"));
+    copyField(n.mqttPass, sizeof(n.mqttPass), getJsonVal(json, "mqttPass"));
+    n.loggerMode = parseBool(getJsonVal(json, "loggerMode"));
+    n.modbusMode = parseBool(getJsonVal(json, "modbusMode"));
+    copyField(n.protocolMode2, sizeof(n.protocolMode2), getJsonVal(json, "protocolMode2"));
+    n.modbusPort = getJsonVal(json, "modbusPort").toInt();
+    n.modbusSlaveID = getJsonVal(json, "modbusSlaveID").toInt();
+    copyField(n.erpUrl, sizeof(n.erpUrl), getJsonVal(json, "erpUrl"));
+    copyField(n.erpUsername, sizeof(n.erpUsername), getJsonVal(json, "erpUsername"));
+    copyField(n.erpPassword, sizeof(n.erpPassword), getJsonVal(json, "erpPassword"));
+    if (n.modbusPort == 0)
+        n.modbusPort = 502;
+}
+
+void ConfigCache::parseDigital(const String &json)
+{
+    memset(&_digital, 0, sizeof(_digital));
+    for (uint8_t i = 0; i < CFG_DI_COUNT; i++)
+    {
+        DigitalInputConfig &d = _digital.di[i];
+        String block = getJsonBlock(json, "DI" + String(i + 1));
+        copyField(d.name, sizeof(d.name), getJsonVal(block, "name"));
+        d.invers = parseBool(getJsonVal(block, "invers"));
+        String tm = getJsonVal(block, "taskMode");
+        copyField(d.taskMode, sizeof(d.taskMode), tm == "" ? String("Normal") : tm);
+        String st = getJsonVal(block, "inputState");
+        copyField(d.inputState, sizeof(d.inputState), st == "" ? String("High") : st);
+        d.intervalTime = getJsonVal(block, "intervalTime").toInt();
+        d.conversionFactor = getJsonVal(block, "conversionFactor").toFloat();
+    }
+    for (uint8_t i = 0; i < CFG_DO_COUNT; i++)
+    {
+        DigitalOutputConfig &d = _digital.dout[i];
+        String block = getJsonBlock(json, "DO" + String(i + 1));
+        copyField(d.name, sizeof(d.name), getJsonVal(block, "name"));
+        d.invers = parseBool(getJsonVal(block, "invers"));
+    }
+}
+
+void ConfigCache::parseAnalog(const String &json)
+{
+    memset(&_analog, 0, sizeof(_analog));
+    for (uint8_t i = 0; i < CFG_AI_COUNT; i++)
+    {
+        AnalogChannelConfig &a = _analog.ai[i];
+        String block = getJsonBlock(json, "AI" + String(i + 1));
+        copyField(a.name, sizeof(a.name), getJsonVal(block, "name"));
+        copyField(a.inputType, sizeof(a.inputType), getJsonVal(block, "inputType"));
+        a.filter = parseBool(getJsonVal(block, "filter"));
+        String ft = getJsonVal(block, "filterType");
+        copyField(a.filterType, sizeof(a.filterType), ft == "" ? String("EMA") : ft);
+        a.filterPeriod = getJsonVal(block, "filterPeriod").toFloat();
+        a.scaling = parseBool(getJsonVal(block, "scaling"));
+        a.lowLimit = getJsonVal(block, "lowLimit").toFloat();
+        a.highLimit = getJsonVal(block, "highLimit").toFloat();
+        // File lama memakai "callibration"
+        String cal = getJsonVal(block, "calibration");
+        if (cal == "")
+            cal = getJsonVal(block, "callibration");
+        a.calibration = parseBool(cal);
+        String m = getJsonVal(block, "mValue");
+        a.mValue = (m == "") ? 1.0f : m.toFloat();
+        a.cValue = getJsonVal(block, "cValue").toFloat();
+        parseCurve(a, block);
+    }
+}
+
+// "calCurve":"pwl","calX":[...],"calY":[...] atau "calCurve":"poly","calY":[c0, c1, ...]
+void ConfigCache::parseCurve(AnalogChannelConfig &a, const String &block)
+{
+    String curve = getJsonVal(block, "calCurve");
+    copyField(a.calCurve, sizeof(a.calCurve), curve == "" ? String("linear") : curve);
+    String xs[CFG_CAL_POINTS];
+    String ys[CFG_CAL_POINTS];
+    int ny = getJsonArray(block, "calY", ys, CFG_CAL_POINTS);
+    int nx = getJsonArray(block, "calX", xs, CFG_CAL_POINTS);
+    a.calPoints = strcmp(a.calCurve, "poly") == 0 ? ny : min(nx, ny);
+    for (uint8_t i = 0; i < a.calPoints; i++)
+    {
+        a.calX[i] = i < nx ? xs[i].toFloat() : 0;
+        a.calY[i] = ys[i].toFloat();
+    }
+}
+
+void ConfigCache::parseModbus(const String &json)
+{
+    ModbusConfig &m = _modbus;
+    memset(&m, 0, sizeof(m));
+    m.baudrate = getJsonVal(json, "baudrate").toInt();
+    copyField(m.parity, sizeof(m.parity), getJsonVal(json, "parity"));
+    m.stopBit = getJsonVal(json, "stopBit").toInt();
+    m.dataBit = getJsonVal(json, "dataBit").toInt();
+    m.scanRate = getJsonVal(json, "scanRate").toFloat();
+    if (m.baudrate == 0)
+        m.baudrate = 9600;
+    if (m.parity[0] == '\0')
+        copyField(m.parity, sizeof(m.parity), "None");
+    if (m.stopBit == 0)
+        m.stopBit = 1;
+    if (m.dataBit == 0)
+        m.dataBit = 8;
+    if (m.scanRate <= 0)
+        m.scanRate = 1;
+
+    // "nameData": [...], lalu "<nama>": [slave, fc, register, multiplier, offset]
+    String names[CFG_MODBUS_TAGS];
+    int count = getJsonArray(json, "nameData", names, CFG_MODBUS_TAGS);
+    for (int i = 0; i < count; i++)
+    {
+        String v[5];
+        if (names[i] == "" || getJsonArray(json, names[i], v, 5) < 5)
+            continue;
+        ModbusTag &t = m.tags[m.tagCount++];
+        copyField(t.name, sizeof(t.name), names[i]);
+        t.slave = v[0].toInt();
+        t.function = v[1].toInt();
+        t.reg = v[2].toInt();
+        t.multiplier = v[3].toFloat();
+        t.offset = v[4].toInt();
+    }
+}
+
+void ConfigCache::parseSystem(const String &json)
+{
+    SystemConfig &s = _system;
+    memset(&s, 0, sizeof(s));
+    String user = getJsonVal(json, "username");
+    String pass = getJsonVal(json, "password");
+    copyField(s.username, sizeof(s.username), user == "" ? String("admin") : user);
+    copyField(s.password, sizeof(s.password), pass == "" ? String("admin") : pass);
+    s.sdInterval = getJsonVal(json, "sdInterval").toInt();
+    if (s.sdInterval == 0)
+        s.sdInterval = 5;
+}
+
+// ---------------------------------------------------------
+// Export JSON
+// ---------------------------------------------------------
+void ConfigCache::writeNetworkJson(Print &out) const
+{
+    const NetworkConfig &n = _network;
+    out.print('{');
+    kvStr(out, "networkMode", n.networkMode);
+    kvStr(out, "ssid", n.ssid);
+    kvStr(out, "password", n.password);
+    kvStr(out, "apSsid", n.apSsid);
+    kvStr(out, "apPassword", n.apPassword);
+    kvStr(out, "dhcpMode", n.dhcpMode);
+    kvStr(out, "ipAddress", n.ipAddress);
+    kvStr(out, "subnet", n.subnet);
+    kvStr(out, "ipGateway", n.ipGateway);
+    kvStr(out, "ipDNS", n.ipDNS);
+    kvStr(out, "sendTrig", n.sendTrig);
+    kvNum(out, "sendInterval", n.sendInterval);
+    kvStr(out, "protocolMode", n.protocolMode);
+    kvStr(out, "endpoint", n.endpoint);
+    kvNum(out, "port", n.port);
+    kvStr(out, "pubTopic", n.pubTopic);
+    kvStr(out, "subTopic", n.subTopic);
+    kvStr(out, "mqttUsername", n.mqttUsername);
+    kvStr(out, "mqttPass", n.mqttPass);
+    kvBool(out, "loggerMode", n.loggerMode);
+    kvBool(out, "modbusMode", n.modbusMode);
+    kvStr(out, "protocolMode2", n.protocolMode2);
+    kvNum(out, "modbusPort", n.modbusPort);
+    kvNum(out, "modbusSlaveID", n.modbusSlaveID);
+    kvStr(out, "erpUrl", n.erpUrl);
+    kvStr(out, "erpUsername", n.erpUsername);
+    kvStr(out, "erpPassword", n.erpPassword, false);
+    out.print('}');
+}
+
+void ConfigCache::writeDigitalInputJson(Print &out, uint8_t index) const
+{
+    const DigitalInputConfig &d = _digital.di[index];
+    out.print('{');
+    kvStr(out, "name", d.name);
+    kvNum(out, "invers", d.invers ? 1 : 0);
+    kvStr(out, "taskMode", d.taskMode);
+    kvStr(out, "inputState", d.inputState);
+    kvNum(out, "intervalTime", d.intervalTime);
+    kvNum(out, "conversionFactor", d.conversionFactor, false);
+    out.print('}');
+}
+
+void ConfigCache::writeDigitalJson(Print &out) const
+{
+    out.print('{');
+    for (uint8_t i = 0; i < CFG_DI_COUNT; i++)
+    {
+        out.print("\"DI");
+        out.print(i + 1);
+        out.print("\":");
+        writeDigitalInputJson(out, i);
+        out.print(',');
+    }
+    for (uint8_t i = 0; i < CFG_DO_COUNT; i++)
+    {
+        out.print("\"DO");
+        out.print(i + 1);
+        out.print("\":{");
+        kvStr(out, "name", _digital.dout[i].name);
+        kvNum(out, "invers", _digital.dout[i].invers ? 1 : 0, false);
+        out.print('}');
+        if (i + 1 < CFG_DO_COUNT)
+            out.print(',');
+    }
+    out.print('}');
+}
+
+void ConfigCache::writeAnalogChannelJson(Print &out, uint8_t index) const
+{
+    const AnalogChannelConfig &a = _analog.ai[index];
+    out.print('{');
+    kvStr(out, "name", a.name);
+    kvStr(out, "inputType", a.inputType);
+    kvNum(out, "filter", a.filter ? 1 : 0);
+    kvStr(out, "filterType", a.filterType);
+    kvNum(out, "filterPeriod", a.filterPeriod);
+    kvNum(out, "scaling", a.scaling ? 1 : 0);
+    kvNum(out, "lowLimit", a.lowLimit);
+    kvNum(out, "highLimit", a.highLimit);
+    kvNum(out, "calibration", a.calibration ? 1 : 0);
+    kvNum(out, "mValue", a.mValue);
+    kvNum(out, "cValue", a.cValue);
+    kvStr(out, "calCurve", a.calCurve);
+    out.print("\"calX\":[");
+    for (uint8_t i = 0; i < a.calPoints; i++)
+    {
+        if (i)
+            out.print(',');
+        printJsonNumber(out, a.calX[i]);
+    }
+    out.print("],\"calY\":[");
+    for (uint8_t i = 0; i < a.calPoints; i++)
+    {
+        if (i)
+            out.print(',');
+        printJsonNumber(out, a.calY[i]);
+    }
+    out.print("]}");
+}
+
+void ConfigCache::writeAnalogJson(Print &out) const
+{
+    out.print('{');
+    for (uint8_t i = 0; i < CFG_AI_COUNT; i++)
+    {
+        out.print("\"AI");
+        out.print(i + 1);
+        out.print("\":");
+        writeAnalogChannelJson(out, i);
+        if (i + 1 < CFG_AI_COUNT)
+            out.print(',');
+    }
+    out.print('}');
+}
+
+void ConfigCache::writeModbusJson(Print &out) const
+{
+    const ModbusConfig &m = _modbus;
+    out.print('{');
+    kvNum(out, "baudrate", m.baudrate);
+    kvStr(out, "parity", m.parity);
+    kvNum(out, "stopBit", m.stopBit);
+    kvNum(out, "dataBit", m.dataBit);
+    kvNum(out, "scanRate", m.scanRate);
+    out.print("\"nameData\":[");
+    for (uint8_t i = 0; i < m.tagCount; i++)
+    {
+        if (i)
+            out.print(',');
+        printJsonString(out, m.tags[i].name);
+    }
+    out.print(']');
+    for (uint8_t i = 0; i < m.tagCount; i++)
+    {
+        const ModbusTag &t = m.tags[i];
+        out.print(',');
+        printJsonString(out, t.name);
+        out.print(":[");
+        out.print(t.slave);
+        out.print(',');
+        out.print(t.function);
+        out.print(',');
+        out.print(t.reg);
+        out.print(',');
+        printJsonNumber(out, t.multiplier);
+        out.print(',');
+        out.print(t.offset);
+        out.print(']');
+    }
+    out.print('}');
+}
+
+void ConfigCache::writeSystemJson(Print &out) const
+{
+    out.print('{');
+    kvStr(out, "username", _system.username);
+    kvStr(out, "password", _system.password);
+    kvNum(out, "sdInterval", _system.sdInterval, false);
+    out.print('}');
+}
+
+// Info statis dashboard (/info): hanya berubah saat config disimpan
+void ConfigCache::writeInfoJson(Print &out) const
+{
+    out.print('{');
+    kvStr(out, "networkMode", _network.networkMode);
+    kvStr(out, "ssid", _network.ssid);
+    kvStr(out, "ipAddress", _network.ipAddress);
+    kvStr(out, "macAddress", "02:00:00:00:00:01"); // Hardcode (sesuai main.cpp)
+    kvStr(out, "jobNumber", "JOB-001");
+    kvNum(out, "sendInterval", _network.sendInterval);
+    kvStr(out, "protocolMode", _network.protocolMode);
+    kvStr(out, "endpoint", _network.endpoint);
+    out.print("\"taskMode\":[");
+    for (int i = 0; i < CFG_DI_COUNT; i++)
+    {
+        if (i)
+            out.print(',');
+        printJsonString(out, _digital.di[i].taskMode);
+    }
+    out.print("],\"aiName\":[");
+    for (int i = 0; i < CFG_AI_COUNT; i++)
+    {
+        if (i)
+            out.print(',');
+        printJsonString(out, _analog.ai[i].name);
+    }
+    out.print("]}");
+}
+
+// ---------------------------------------------------------
+// Save (debounce -> append record ke journal)
+// ---------------------------------------------------------
+void ConfigCache::markDirty(uint8_t section)
+{
+    uint32_t now = millis();
+    if (_dirty == 0)
+        _firstDirtyMs = now;
+    _dirty |= 1 << section;
+    _lastDirtyMs = now;
+    _revision++;
+}
+
+bool ConfigCache::flush()
+{
+    // Ekor journal rusak (append gagal / terputus): record yang ditambah
+    // setelahnya tidak terbaca saat boot, jadi padatkan dulu
+    if (_journal.needsCompact() && !_journal.compact())
+    {
+        Serial.println("Config: compact journal gagal");
+        retryLater();
+        return false;
+    }
+
+    bool ok = true;
+    for (uint8_t s = 0; s < CFG_SECTION_COUNT; s++)
+    {
+        if (!(_dirty & (1 << s)))
+            continue;
+        size_t size;
+        const void *data = sectionData(s, size);
+        if (_journal.append(s, kSections[s].version, data, size))
+        {
+            _dirty &= ~(1 << s);
+        }
+        else
+        {
+            Serial.printf("Config: gagal menyimpan section %u\n", s);
+            ok = false;
+        }
+    }
+    if (ok)
+        _saveFailures = 0;
+    else
+        retryLater();
+    return ok;
+}
+
+// Gagal: kedua timer diulang dan jeda dilipatgandakan sampai
+// CFG_SAVE_MAX_BACKOFF_MS, supaya flash & Serial tidak dibanjiri tiap tick
+void ConfigCache::retryLater()
+{
+    uint32_t now = millis();
+    _firstDirtyMs = now;
+    _lastDirtyMs = now;
+    if (_saveFailures < 8)
+        _saveFailures++;
+}
+
+uint32_t ConfigCache::retryDelay() const
+{
+    uint32_t delayMs = (uint32_t)CFG_SAVE_DEBOUNCE_MS << _saveFailures;
+    return delayMs < CFG_SAVE_MAX_BACKOFF_MS ? delayMs : CFG_SAVE_MAX_BACKOFF_MS;
+}
+
+void ConfigCache::service()
+{
+    if (_dirty)
+    {
+        uint32_t now = millis();
+        if (_saveFailures)
+        {
+            if (now - _lastDirtyMs >= retryDelay())
+                flush();
+        }
+        else if (now - _lastDirtyMs >= CFG_SAVE_DEBOUNCE_MS || now - _firstDirtyMs >= CFG_SAVE_MAX_DELAY_MS)
+            flush();
+        return;
+    }
+    // Compact hanya saat tidak ada perubahan yang menunggu
+    if (_journal.needsCompact())
+        _journal.compact();
+}
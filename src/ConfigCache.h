@@ -0,0 +1,228 @@
+#ifndef CONFIGCACHE_H
+#define CONFIGCACHE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "ConfigJournal.h"
+
+#define CFG_DI_COUNT 4
+#define CFG_DO_COUNT 4
+#define CFG_AI_COUNT 4
+#define CFG_MODBUS_TAGS 16
+#define CFG_CAL_POINTS 8  // titik kurva / koefisien polinom per AI
+#define CFG_SAVE_DEBOUNCE_MS 2000   // tunggu sampai operator berhenti klik save
+#define CFG_SAVE_MAX_DELAY_MS 10000 // batas tunda jika save terus berulang
+#define CFG_SAVE_MAX_BACKOFF_MS 60000 // jeda coba ulang maks. setelah simpan gagal
+
+// ID section = ID record di journal (jangan diubah urutannya)
+enum ConfigSection
+{
+    CFG_SECTION_NETWORK = 0,
+    CFG_SECTION_DIGITAL,
+    CFG_SECTION_ANALOG,
+    CFG_SECTION_MODBUS,
+    CFG_SECTION_SYSTEM,
+    CFG_SECTION_COUNT
+};
+
+// ---------------------------------------------------------
+// Struct config (layout tetap, tanpa String)
+// ---------------------------------------------------------
+struct NetworkConfig
+{
+    char networkMode[16];
+    char ssid[33];
+    char password[65];
+    char apSsid[33];
+    char apPassword[65];
+    char dhcpMode[8];
+    char ipAddress[16];
+    char subnet[16];
+    char ipGateway[16];
+    char ipDNS[16];
+    char sendTrig[24];
+    uint32_t sendInterval;
+    char protocolMode[8];
+    char endpoint[160];
+    uint16_t port;
+    char pubTopic[64];
+    char subTopic[64];
+    char mqttUsername[33];
+    char mqttPass[65];
+    bool loggerMode;
+    bool modbusMode;
+    char protocolMode2[24];
+    uint16_t modbusPort;
+    uint8_t modbusSlaveID;
+    char erpUrl[160];
+    char erpUsername[33];
+    char erpPassword[65];
+};
+
+struct DigitalInputConfig
+{
+    char name[33];
+    bool invers;
+    char taskMode[16];  // Normal / Counting / Cycle Time / Run Time / Pulse Mode
+    char inputState[8]; // High / Low
+    uint32_t intervalTime;
+    float conversionFactor;
+};
+
+struct DigitalOutputConfig
+{
+    char name[33];
+    bool invers;
+};
+
+struct DigitalConfig
+{
+    DigitalInputConfig di[CFG_DI_COUNT];
+    DigitalOutputConfig dout[CFG_DO_COUNT];
+};
+
+struct AnalogChannelConfig
+{
+    char name[33];
+    char inputType[12];
+    bool filter;
+    char filterType[16];
+    float filterPeriod;
+    bool scaling;
+    float lowLimit;
+    float highLimit;
+    bool calibration;
+    float mValue;
+    float cValue;
+    // Kurva kalibrasi (x = scaled raw 0..65535, y = nilai teknik):
+    // "linear" = mValue/cValue, "pwl" = titik (calX, calY),
+    // "poly" = koefisien calY[0] + calY[1]*x + ... (calX tidak dipakai)
+    char calCurve[8];
+    uint8_t calPoints;
+    float calX[CFG_CAL_POINTS];
+    float calY[CFG_CAL_POINTS];
+};
+
+struct AnalogInputsConfig
+{
+    AnalogChannelConfig ai[CFG_AI_COUNT];
+};
+
+struct ModbusTag
+{
+    char name[33];
+    uint8_t slave;
+    uint8_t function;
+    uint16_t reg;
+    float multiplier;
+    uint16_t offset;
+};
+
+struct ModbusConfig
+{
+    uint32_t baudrate;
+    char parity[8];
+    uint8_t stopBit;
+    uint8_t dataBit;
+    float scanRate;
+    uint8_t tagCount;
+    ModbusTag tags[CFG_MODBUS_TAGS];
+};
+
+struct SystemConfig
+{
+    char username[33];
+    char password[33];
+    uint32_t sdInterval;
+};
+
+// ---------------------------------------------------------
+// Cache config di RAM
+// ---------------------------------------------------------
+// Struct disimpan apa adanya sebagai record biner di ConfigJournal. Saat
+// boot record terbaru tiap section dibaca langsung ke struct; section yang
+// belum ada di journal (boot pertama / versi layout berubah) diimpor dari
+// file JSON lama. Handler GET membaca dari struct (tanpa akses flash).
+// save*() hanya menandai section kotor: service() menulisnya ke journal
+// setelah CFG_SAVE_DEBOUNCE_MS tanpa perubahan baru, jadi beberapa klik
+// save berturut-turut menjadi satu record. revision() naik setiap ada
+// perubahan supaya modul lain (mis. pipeline analog) tahu kapan harus
+// konfigurasi ulang.
+class ConfigCache
+{
+public:
+    bool begin();
+
+    const NetworkConfig &network() const { return _network; }
+    const DigitalConfig &digital() const { return _digital; }
+    const AnalogInputsConfig &analog() const { return _analog; }
+    const ModbusConfig &modbus() const { return _modbus; }
+    const SystemConfig &system() const { return _system; }
+
+    // Ubah lewat edit*(), lalu panggil save*() untuk commit ke flash
+    NetworkConfig &editNetwork() { return _network; }
+    DigitalConfig &editDigital() { return _digital; }
+    AnalogInputsConfig &editAnalog() { return _analog; }
+    ModbusConfig &editModbus() { return _modbus; }
+    SystemConfig &editSystem() { return _system; }
+
+    void saveNetwork() { markDirty(CFG_SECTION_NETWORK); }
+    void saveDigital() { markDirty(CFG_SECTION_DIGITAL); }
+    void saveAnalog() { markDirty(CFG_SECTION_ANALOG); }
+    void saveModbus() { markDirty(CFG_SECTION_MODBUS); }
+    void saveSystem() { markDirty(CFG_SECTION_SYSTEM); }
+
+    // Panggil dari loop(): tulis section kotor setelah debounce, lalu
+    // compact journal di sela waktu idle.
+    void service();
+    // Tulis semua perubahan sekarang (mis. sebelum ESP.restart())
+    bool flush();
+    bool pending() const { return _dirty != 0; }
+    const ConfigJournal &journal() const { return _journal; }
+
+    // Export JSON (format sama dengan file di /data)
+    void writeNetworkJson(Print &out) const;
+    void writeDigitalJson(Print &out) const;
+    void writeDigitalInputJson(Print &out, uint8_t index) const;
+    void writeAnalogJson(Print &out) const;
+    void writeAnalogChannelJson(Print &out, uint8_t index) const;
+    void writeModbusJson(Print &out) const;
+    void writeSystemJson(Print &out) const;
+    void writeInfoJson(Print &out) const;
+
+    // Import dari teks JSON (migrasi file lama & POST JSON modbus_setup)
+    void parseNetwork(const String &json);
+    void parseDigital(const String &json);
+    void parseCurve(AnalogChannelConfig &a, const String &block);
+    void parseAnalog(const String &json);
+    void parseModbus(const String &json);
+    void parseSystem(const String &json);
+
+    uint32_t revision() const { return _revision; }
+    void touch() { _revision++; }
+
+private:
+    String readFile(const char *path);
+    void markDirty(uint8_t section);
+    void *sectionData(uint8_t section, size_t &size);
+    void parseSection(uint8_t section, const String &json);
+    bool migrateSection(uint8_t section);
+    void retryLater();
+    uint32_t retryDelay() const;
+
+    NetworkConfig _network;
+    DigitalConfig _digital;
+    AnalogInputsConfig _analog;
+    ModbusConfig _modbus;
+    SystemConfig _system;
+    uint32_t _revision = 0;
+    ConfigJournal _journal;
+    uint8_t _dirty = 0; // bit per ConfigSection
+    uint32_t _firstDirtyMs = 0;
+    uint32_t _lastDirtyMs = 0;
+    uint8_t _saveFailures = 0; // gagal berturut-turut (backoff)
+};
+
+extern ConfigCache config;
+
+#endif // CONFIGCACHE_H
@@ -0,0 +1,253 @@
+#include "ConfigJournal.h"
+#include "Metrics.h"
+
+#define JOURNAL_NO_RECORD 0xFFFFFFFFUL
+#define JOURNAL_COPY_CHUNK 64
+
+ConfigJournal::ConfigJournal()
+    : _size(0), _seq(0), _records(0), _compactions(0), _needsCompact(false)
+{
+    for (uint8_t i = 0; i < JOURNAL_MAX_SECTIONS; i++)
+        _index[i].offset = JOURNAL_NO_RECORD;
+}
+
+// CRC-32 (IEEE, reflected) dengan tabel 16 entri per nibble
+uint32_t ConfigJournal::crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+uint32_t ConfigJournal::headerCrc(const JournalHeader &h)
+{
+    JournalHeader copy = h;
+    copy.crc = 0;
+    return crc32(0, (const uint8_t *)&copy, sizeof(copy));
+}
+
+// ---------------------------------------------------------
+// Boot: pulihkan compact yang terputus, lalu scan
+// ---------------------------------------------------------
+bool ConfigJournal::begin()
+{
+    // compact() menghapus journal lama sebelum rename: jika mati di antara
+    // keduanya, file .tmp sudah lengkap. Jika journal masih ada, .tmp
+    // adalah sisa compact yang belum selesai.
+    if (LittleFS.exists(JOURNAL_TMP_PATH))
+    {
+        if (LittleFS.exists(JOURNAL_PATH))
+            LittleFS.remove(JOURNAL_TMP_PATH);
+        else
+            LittleFS.rename(JOURNAL_TMP_PATH, JOURNAL_PATH);
+    }
+    if (!scan())
+        return false;
+    if (_needsCompact)
+        compact();
+    return true;
+}
+
+// Baca satu record di posisi file saat ini dan validasi CRC-nya.
+// payloadCrc diisi CRC payload saja (untuk deteksi isi yang sama).
+bool ConfigJournal::readRecord(File &f, JournalHeader &h, uint32_t &payloadCrc)
+{
+    if (f.read((uint8_t *)&h, sizeof(h)) != sizeof(h))
+        return false;
+    if (h.magic != JOURNAL_MAGIC || h.length > JOURNAL_MAX_RECORD)
+        return false;
+    uint32_t crc = headerCrc(h);
+    payloadCrc = 0;
+    uint8_t buf[JOURNAL_COPY_CHUNK];
+    uint16_t left = h.length;
+    while (left > 0)
+    {
+        size_t n = left < sizeof(buf) ? left : sizeof(buf);
+        if (f.read(buf, n) != n)
+            return false;
+        crc = crc32(crc, buf, n);
+        payloadCrc = crc32(payloadCrc, buf, n);
+        left -= n;
+    }
+    return crc == h.crc;
+}
+
+bool ConfigJournal::scan()
+{
+    for (uint8_t i = 0; i < JOURNAL_MAX_SECTIONS; i++)
+        _index[i].offset = JOURNAL_NO_RECORD;
+    _size = 0;
+    _seq = 0;
+    _records = 0;
+    _needsCompact = false;
+
+    if (!LittleFS.exists(JOURNAL_PATH))
+        return true;
+    File f = LittleFS.open(JOURNAL_PATH, "r");
+    if (!f)
+        return false;
+
+    uint32_t fileSize = f.size();
+    uint32_t pos = 0;
+    JournalHeader h;
+    uint32_t payloadCrc;
+    while (pos + sizeof(h) <= fileSize && readRecord(f, h, payloadCrc))
+    {
+        if (h.section < JOURNAL_MAX_SECTIONS)
+        {
+            Entry &e = _index[h.section];
+            e.offset = pos;
+            e.crc = payloadCrc;
+            e.length = h.length;
+            e.version = h.version;
+        }
+        if (h.seq > _seq)
+            _seq = h.seq;
+        _records++;
+        pos += sizeof(h) + h.length;
+    }
+    f.close();
+    _size = fileSize;
+
+    // Ekor rusak (append terputus): record baru tidak boleh ditulis
+    // setelahnya karena scan berikutnya berhenti di situ.
+    if (pos < fileSize)
+    {
+        Serial.printf("Config: journal rusak di offset %u dari %u, dipadatkan.\n",
+                      (unsigned)pos, (unsigned)fileSize);
+        _needsCompact = true;
+    }
+    return true;
+}
+
+bool ConfigJournal::read(uint8_t section, uint8_t version, void *data, size_t size)
+{
+    if (section >= JOURNAL_MAX_SECTIONS)
+        return false;
+    const Entry &e = _index[section];
+    if (e.offset == JOURNAL_NO_RECORD || e.version != version || e.length != size)
+        return false;
+
+    File f = LittleFS.open(JOURNAL_PATH, "r");
+    if (!f)
+        return false;
+    JournalHeader h;
+    bool ok = f.seek(e.offset) &&
+              f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+              f.read((uint8_t *)data, size) == size;
+    f.close();
+    return ok && crc32(headerCrc(h), (const uint8_t *)data, size) == h.crc;
+}
+
+bool ConfigJournal::append(uint8_t section, uint8_t version, const void *data, size_t size)
+{
+    if (section >= JOURNAL_MAX_SECTIONS || size > JOURNAL_MAX_RECORD)
+        return false;
+
+    // Simpan berulang tanpa perubahan isi tidak memakan flash
+    uint32_t payloadCrc = crc32(0, (const uint8_t *)data, size);
+    Entry &e = _index[section];
+    if (e.offset != JOURNAL_NO_RECORD && e.version == version && e.length == size && e.crc == payloadCrc)
+        return true;
+
+    JournalHeader h;
+    h.magic = JOURNAL_MAGIC;
+    h.section = section;
+    h.version = version;
+    h.length = size;
+    h.reserved = 0;
+    h.seq = ++_seq;
+    h.crc = crc32(headerCrc(h), (const uint8_t *)data, size);
+
+    METRIC_SPAN(METRIC_FLASH_WRITE);
+    File f = LittleFS.open(JOURNAL_PATH, "a");
+    if (!f)
+        return false;
+    size_t written = f.write((const uint8_t *)&h, sizeof(h));
+    written += f.write((const uint8_t *)data, size);
+    f.close();
+    if (written != sizeof(h) + size)
+    {
+        // Record setengah jadi di akhir file: bersihkan lewat compact
+        _size += written;
+        _needsCompact = true;
+        return false;
+    }
+
+    e.offset = _size;
+    e.crc = payloadCrc;
+    e.length = size;
+    e.version = version;
+    _size += written;
+    _records++;
+    return true;
+}
+
+// ---------------------------------------------------------
+// Compact: salin record terbaru tiap section ke file baru
+// ---------------------------------------------------------
+bool ConfigJournal::compact()
+{
+    METRIC_SPAN(METRIC_FLASH_WRITE);
+    File src = LittleFS.open(JOURNAL_PATH, "r");
+    File dst = LittleFS.open(JOURNAL_TMP_PATH, "w");
+    if (!dst)
+    {
+        if (src)
+            src.close();
+        return false;
+    }
+
+    Entry next[JOURNAL_MAX_SECTIONS];
+    uint32_t pos = 0;
+    uint32_t count = 0;
+    bool ok = true;
+    uint8_t buf[JOURNAL_COPY_CHUNK];
+    for (uint8_t i = 0; i < JOURNAL_MAX_SECTIONS; i++)
+    {
+        next[i] = _index[i];
+        if (_index[i].offset == JOURNAL_NO_RECORD)
+            continue;
+        // Record disalin utuh: seq & CRC tetap berlaku
+        uint32_t left = sizeof(JournalHeader) + _index[i].length;
+        ok = src && src.seek(_index[i].offset);
+        while (ok && left > 0)
+        {
+            size_t n = left < sizeof(buf) ? left : sizeof(buf);
+            ok = src.read(buf, n) == n && dst.write(buf, n) == n;
+            left -= n;
+        }
+        if (!ok)
+            break;
+        next[i].offset = pos;
+        pos += sizeof(JournalHeader) + _index[i].length;
+        count++;
+    }
+    dst.close();
+    if (src)
+        src.close();
+
+    if (!ok)
+    {
+        LittleFS.remove(JOURNAL_TMP_PATH);
+        return false;
+    }
+    // Lihat begin() untuk pemulihan jika mati di antara remove & rename
+    LittleFS.remove(JOURNAL_PATH);
+    if (!LittleFS.rename(JOURNAL_TMP_PATH, JOURNAL_PATH))
+        return false;
+
+    memcpy(_index, next, sizeof(_index));
+    _size = pos;
+    _records = count;
+    _needsCompact = false;
+    _compactions++;
+    return true;
+}
@@ -0,0 +1,79 @@
+#ifndef CONFIGJOURNAL_H
+#define CONFIGJOURNAL_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define JOURNAL_PATH "/config.jnl"
+#define JOURNAL_TMP_PATH "/config.jnl.tmp"
+#define JOURNAL_MAGIC 0xC0F1
+#define JOURNAL_MAX_SECTIONS 8
+#define JOURNAL_MAX_RECORD 2048   // payload terbesar yang diterima saat replay
+#define JOURNAL_COMPACT_SIZE 16384 // di atas ini journal dipadatkan
+
+// Header tiap record (16 byte, little-endian), diikuti payload
+struct JournalHeader
+{
+    uint16_t magic;
+    uint8_t section;
+    uint8_t version;  // versi layout struct; beda versi -> record diabaikan
+    uint16_t length;  // panjang payload
+    uint16_t reserved;
+    uint32_t seq;     // naik terus, record terakhir per section yang berlaku
+    uint32_t crc;     // CRC-32 header (crc = 0) + payload
+};
+
+// ---------------------------------------------------------
+// Journal append-only untuk record config biner
+// ---------------------------------------------------------
+// Setiap simpan menambah satu record di akhir file, tanpa menulis ulang
+// seluruh config. Saat boot file di-scan sampai record rusak pertama
+// (mis. listrik mati saat append); record valid terakhir per section
+// yang dipakai. Jika file sudah terlalu besar atau ekornya rusak,
+// compact() menyalin record terbaru ke file baru lalu rename.
+class ConfigJournal
+{
+public:
+    ConfigJournal();
+
+    // LittleFS harus sudah di-mount
+    bool begin();
+
+    // Payload record terbaru section ini; false jika tidak ada / versi
+    // atau ukuran tidak cocok / CRC gagal.
+    bool read(uint8_t section, uint8_t version, void *data, size_t size);
+
+    // Tambah record. Isi yang sama dengan record terakhir tidak ditulis.
+    bool append(uint8_t section, uint8_t version, const void *data, size_t size);
+
+    bool needsCompact() const { return _needsCompact || _size >= JOURNAL_COMPACT_SIZE; }
+    bool compact();
+
+    uint32_t size() const { return _size; }
+    uint32_t records() const { return _records; }
+    uint32_t compactions() const { return _compactions; }
+
+    static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+private:
+    struct Entry
+    {
+        uint32_t offset; // posisi header di file; 0xFFFFFFFF = tidak ada
+        uint32_t crc;
+        uint16_t length;
+        uint8_t version;
+    };
+
+    bool scan();
+    static bool readRecord(File &f, JournalHeader &h, uint32_t &payloadCrc);
+    static uint32_t headerCrc(const JournalHeader &h);
+
+    Entry _index[JOURNAL_MAX_SECTIONS];
+    uint32_t _size;
+    uint32_t _seq;
+    uint32_t _records;
+    uint32_t _compactions;
+    bool _needsCompact;
+};
+
+#endif // CONFIGJOURNAL_H
@@ -0,0 +1,392 @@
+#include "DataLogger.h"
+#include "ConfigCache.h"
+#include "Metrics.h"
+#include <time.h>
+
+DataLogger logger;
+
+DataLogger::DataLogger()
+    : _active(0), _nextId(1), _batchCount(0), _batchSinceMs(0), _flushIntervalMs(300000UL),
+      _clock(0), _clockMs(0), _flushes(0), _dropped(0), _appended(0), _enabled(false)
+{
+    memset(_index, 0, sizeof(_index));
+}
+
+void DataLogger::segmentPath(uint8_t slot, char *path, size_t size)
+{
+    snprintf(path, size, LOG_DIR "/%u.seg", slot);
+}
+
+// ---------------------------------------------------------
+// Boot: bangun ulang indeks dari file segmen
+// ---------------------------------------------------------
+bool DataLogger::begin()
+{
+    LittleFS.mkdir(LOG_DIR);
+    uint32_t lastTime = 0;
+    for (uint8_t i = 0; i < LOG_SEGMENTS; i++)
+    {
+        loadSegment(i);
+        const Segment &s = _index[i];
+        if (s.id >= _nextId)
+        {
+            _nextId = s.id + 1;
+            _active = i;
+        }
+        if (s.count && s.last > lastTime)
+            lastTime = s.last;
+    }
+    // Tanpa RTC jam log melanjutkan dari record terakhir (waktu mati hilang)
+    _clock = lastTime ? lastTime + 1 : 0;
+    _clockMs = millis();
+    Serial.printf("DataLogger: %u segmen, %u record.\n", segments(), records());
+    return true;
+}
+
+void DataLogger::loadSegment(uint8_t slot)
+{
+    Segment &s = _index[slot];
+    memset(&s, 0, sizeof(s));
+    char path[24];
+    segmentPath(slot, path, sizeof(path));
+    if (!LittleFS.exists(path))
+        return;
+    File f = LittleFS.open(path, "r");
+    LogSegmentHeader h;
+    bool valid = f && f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) && h.magic == LOG_MAGIC &&
+                 h.version == LOG_VERSION && h.recordSize == sizeof(LogRecord) && h.id != 0;
+    if (!valid)
+    {
+        f.close();
+        LittleFS.remove(path);
+        return;
+    }
+    s.id = h.id;
+    // Sisa record yang terpotong (listrik mati saat tulis) diabaikan dan
+    // ditimpa oleh flush berikutnya
+    s.count = (f.size() - sizeof(LogSegmentHeader)) / sizeof(LogRecord);
+    if (s.count > LOG_SEGMENT_RECORDS)
+        s.count = LOG_SEGMENT_RECORDS;
+    LogRecord r;
+    if (s.count && readAt(f, 0, r))
+        s.first = r.time;
+    if (s.count && readAt(f, s.count - 1, r))
+        s.last = r.time;
+    f.close();
+}
+
+uint32_t DataLogger::now()
+{
+    uint32_t elapsed = (millis() - _clockMs) / 1000;
+    _clock += elapsed;
+    _clockMs += elapsed * 1000;
+    time_t t = time(nullptr);
+    if ((uint32_t)t >= LOG_EPOCH_VALID && (uint32_t)t > _clock)
+        _clock = t; // jam sistem diset (mis. NTP); tidak pernah mundur
+    return _clock;
+}
+
+// ---------------------------------------------------------
+// Tulis
+// ---------------------------------------------------------
+void DataLogger::append(uint8_t channel, float value)
+{
+    if (!_enabled)
+        return;
+    if (_batchCount >= LOG_BATCH_RECORDS && !flush())
+    {
+        _dropped++;
+        return;
+    }
+    if (_batchCount == 0)
+        _batchSinceMs = millis();
+    _appended++;
+    LogRecord &r = _batch[_batchCount++];
+    r.time = now();
+    r.channel = channel;
+    r.flags = 0;
+    r.reserved = 0;
+    r.value = value;
+    if (_batchCount >= LOG_BATCH_RECORDS)
+        flush();
+}
+
+void DataLogger::service()
+{
+    if (_batchCount && millis() - _batchSinceMs >= _flushIntervalMs)
+        flush();
+}
+
+bool DataLogger::flush()
+{
+    if (_batchCount == 0)
+        return true;
+    METRIC_SPAN(METRIC_FLASH_WRITE);
+    if (_index[_active].id == 0 || _index[_active].count + _batchCount > LOG_SEGMENT_RECORDS)
+    {
+        if (!rotate())
+            return false;
+    }
+    if (!ensureSpace())
+        return false;
+
+    Segment &s = _index[_active];
+    char path[24];
+    segmentPath(_active, path, sizeof(path));
+    File f = LittleFS.open(path, "r+");
+    if (!f)
+        return false;
+    // Tulis di posisi dari indeks (bukan append) supaya record terpotong
+    // di ekor file ikut tertimpa
+    size_t bytes = _batchCount * sizeof(LogRecord);
+    bool ok = f.seek(sizeof(LogSegmentHeader) + s.count * sizeof(LogRecord)) &&
+              f.write((const uint8_t *)_batch, bytes) == bytes;
+    f.close();
+    if (!ok)
+    {
+        Serial.println("DataLogger: gagal menulis segmen.");
+        return false;
+    }
+    if (s.count == 0)
+        s.first = _batch[0].time;
+    s.last = _batch[_batchCount - 1].time;
+    s.count += _batchCount;
+    _batchCount = 0;
+    _flushes++;
+    return true;
+}
+
+// Pindah ke slot berikutnya; isi lamanya (segmen tertua) ditimpa
+bool DataLogger::rotate()
+{
+    uint8_t slot = _index[_active].id ? (_active + 1) % LOG_SEGMENTS : _active;
+    dropSegment(slot);
+    char path[24];
+    segmentPath(slot, path, sizeof(path));
+    File f = LittleFS.open(path, "w");
+    if (!f)
+        return false;
+    LogSegmentHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = LOG_MAGIC;
+    h.version = LOG_VERSION;
+    h.recordSize = sizeof(LogRecord);
+    h.id = _nextId;
+    bool ok = f.write((const uint8_t *)&h, sizeof(h)) == sizeof(h);
+    f.close();
+    if (!ok)
+        return false;
+    _index[slot].id = _nextId++;
+    _active = slot;
+    return true;
+}
+
+// Partisi dipakai bersama config & web: buang segmen tertua jika sisa
+// ruang tidak cukup untuk satu batch lagi
+bool DataLogger::ensureSpace()
+{
+    while (LittleFS.totalBytes() - LittleFS.usedBytes() < LOG_MIN_FREE + LOG_BATCH_SIZE)
+    {
+        uint8_t oldest = LOG_SEGMENTS;
+        for (uint8_t i = 0; i < LOG_SEGMENTS; i++)
+        {
+            if (i == _active || _index[i].id == 0)
+                continue;
+            if (oldest == LOG_SEGMENTS || _index[i].id < _index[oldest].id)
+                oldest = i;
+        }
+        if (oldest == LOG_SEGMENTS)
+        {
+            Serial.println("DataLogger: partisi penuh.");
+            return false;
+        }
+        dropSegment(oldest);
+    }
+    return true;
+}
+
+void DataLogger::dropSegment(uint8_t slot)
+{
+    if (_index[slot].id == 0)
+        return;
+    char path[24];
+    segmentPath(slot, path, sizeof(path));
+    LittleFS.remove(path);
+    memset(&_index[slot], 0, sizeof(Segment));
+}
+
+// ---------------------------------------------------------
+// Query
+// ---------------------------------------------------------
+bool DataLogger::readAt(File &f, uint32_t index, LogRecord &r)
+{
+    return f.seek(sizeof(LogSegmentHeader) + index * sizeof(LogRecord)) &&
+           f.read((uint8_t *)&r, sizeof(r)) == sizeof(r);
+}
+
+// Indeks record pertama dengan time >= from
+uint32_t DataLogger::lowerBound(File &f, uint32_t count, uint32_t from)
+{
+    uint32_t lo = 0, hi = count;
+    LogRecord r;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!readAt(f, mid, r))
+            return count;
+        if (r.time < from)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void DataLogger::openRange(LogCursor &c, uint32_t from, uint32_t to, uint32_t mask)
+{
+    c.from = from;
+    c.to = to;
+    c.mask = mask;
+    c.orderCount = 0;
+    c.orderPos = 0;
+    c.index = c.end = 0;
+    c.bufCount = c.bufPos = 0;
+    c.file.close();
+    // Hanya segmen yang beririsan dengan range, urut id (= urut waktu)
+    for (uint8_t i = 0; i < LOG_SEGMENTS; i++)
+    {
+        const Segment &s = _index[i];
+        if (s.id == 0 || s.count == 0 || s.last < from || s.first > to)
+            continue;
+        uint8_t j = c.orderCount++;
+        while (j > 0 && _index[c.order[j - 1]].id > s.id)
+        {
+            c.order[j] = c.order[j - 1];
+            j--;
+        }
+        c.order[j] = i;
+    }
+    c.order[c.orderCount++] = LOG_SEGMENTS; // batch yang belum di-flush
+}
+
+bool DataLogger::next(LogCursor &c, LogRecord &r)
+{
+    for (;;)
+    {
+        while (c.bufPos < c.bufCount)
+        {
+            const LogRecord &rec = c.buf[c.bufPos++];
+            if (rec.time > c.to)
+            {
+                // Record urut waktu: sisanya pasti di luar range
+                c.orderPos = c.orderCount;
+                c.index = c.end;
+                c.bufCount = 0;
+                c.file.close();
+                return false;
+            }
+            if (rec.time < c.from || rec.channel >= LOG_CHANNELS || !(c.mask & (1UL << rec.channel)))
+                continue;
+            r = rec;
+            return true;
+        }
+        if (!fill(c))
+            return false;
+    }
+}
+
+// Isi buffer cursor dari sumber saat ini, atau buka sumber berikutnya
+bool DataLogger::fill(LogCursor &c)
+{
+    c.bufPos = c.bufCount = 0;
+    while (c.index >= c.end)
+    {
+        c.file.close();
+        if (c.orderPos >= c.orderCount)
+            return false;
+        uint8_t slot = c.order[c.orderPos++];
+        if (slot == LOG_SEGMENTS)
+        {
+            c.index = 0;
+            c.end = _batchCount;
+            continue;
+        }
+        char path[24];
+        segmentPath(slot, path, sizeof(path));
+        c.file = LittleFS.open(path, "r");
+        if (!c.file)
+            continue;
+        c.end = _index[slot].count;
+        c.index = lowerBound(c.file, c.end, c.from);
+    }
+
+    uint32_t n = c.end - c.index;
+    if (n > LOG_READ_RECORDS)
+        n = LOG_READ_RECORDS;
+    if (!c.file)
+    {
+        memcpy(c.buf, _batch + c.index, n * sizeof(LogRecord));
+    }
+    else
+    {
+        size_t got = c.file.seek(sizeof(LogSegmentHeader) + c.index * sizeof(LogRecord))
+                         ? c.file.read((uint8_t *)c.buf, n * sizeof(LogRecord))
+                         : 0;
+        if (got < n * sizeof(LogRecord))
+        {
+            n = got / sizeof(LogRecord);
+            c.end = c.index + n; // file lebih pendek dari indeks
+        }
+    }
+    c.index += n;
+    c.bufCount = n;
+    return true;
+}
+
+// Nama channel = KodeSensor yang sama dengan event "values"/"modbus"
+const char *DataLogger::channelName(uint8_t ch, char *fallback, size_t size)
+{
+    const char *name = "";
+    if (ch >= LOG_CH_MODBUS && ch - LOG_CH_MODBUS < config.modbus().tagCount)
+        name = config.modbus().tags[ch - LOG_CH_MODBUS].name;
+    else if (ch >= LOG_CH_DI && ch - LOG_CH_DI < CFG_DI_COUNT)
+        name = config.digital().di[ch - LOG_CH_DI].name;
+    else if (ch < CFG_AI_COUNT)
+        name = config.analog().ai[ch].name;
+    if (name[0])
+        return name;
+    if (ch >= LOG_CH_MODBUS)
+        snprintf(fallback, size, "MB%u", ch - LOG_CH_MODBUS + 1);
+    else if (ch >= LOG_CH_DI)
+        snprintf(fallback, size, "DI%u", ch - LOG_CH_DI + 1);
+    else
+        snprintf(fallback, size, "AI%u", ch + 1);
+    return fallback;
+}
+
+uint32_t DataLogger::records() const
+{
+    uint32_t n = _batchCount;
+    for (uint8_t i = 0; i < LOG_SEGMENTS; i++)
+        n += _index[i].count;
+    return n;
+}
+
+uint32_t DataLogger::oldest() const
+{
+    uint32_t t = _batchCount ? _batch[0].time : 0;
+    for (uint8_t i = 0; i < LOG_SEGMENTS; i++)
+    {
+        if (_index[i].count && (t == 0 || _index[i].first < t))
+            t = _index[i].first;
+    }
+    return t;
+}
+
+uint8_t DataLogger::segments() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < LOG_SEGMENTS; i++)
+        n += _index[i].id != 0;
+    return n;
+}
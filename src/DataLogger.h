@@ -0,0 +1,144 @@
+#ifndef DATALOGGER_H
+#define DATALOGGER_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define LOG_DIR "/log"
+#define LOG_SEGMENTS 8            // slot segmen, dipakai bergiliran (ring)
+#define LOG_BATCH_SIZE 4096       // satu halaman flash per tulis
+#define LOG_BATCH_RECORDS (LOG_BATCH_SIZE / sizeof(LogRecord))
+#define LOG_SEGMENT_RECORDS (16 * LOG_BATCH_RECORDS) // +-64 KB per segmen
+#define LOG_MIN_FREE 32768        // sisakan ruang untuk journal config & OTA
+#define LOG_MAGIC 0x4C47
+#define LOG_VERSION 1
+#define LOG_EPOCH_VALID 1600000000UL // time() di atas ini = jam sudah diset
+#define LOG_READ_RECORDS 16       // buffer baca cursor
+#define LOG_QUERY_MAX 2000        // titik per respons /getValue
+
+// Nomor channel di log
+#define LOG_CH_AI 0      // AI1..AI4 -> 0..3
+#define LOG_CH_DI 8      // DI1..DI4 -> 8..11
+#define LOG_CH_MODBUS 16 // tag modbus -> 16..31
+#define LOG_CHANNELS 32  // mask query 32 bit
+
+// Record berukuran tetap (12 byte, little-endian)
+struct LogRecord
+{
+    uint32_t time; // detik (jam log, lihat DataLogger::now())
+    uint8_t channel;
+    uint8_t flags;
+    uint16_t reserved;
+    float value;
+};
+
+// Header di awal tiap file segmen (16 byte)
+struct LogSegmentHeader
+{
+    uint16_t magic;
+    uint8_t version;
+    uint8_t recordSize;
+    uint32_t id; // naik terus; segmen dengan id terbesar = aktif
+    uint32_t reserved[2];
+};
+
+// Posisi baca query range; diisi DataLogger::openRange()
+struct LogCursor
+{
+    uint32_t from;
+    uint32_t to;
+    uint32_t mask;
+    uint8_t order[LOG_SEGMENTS]; // slot urut id, lalu batch RAM
+    uint8_t orderCount;
+    uint8_t orderPos;
+    uint32_t index;              // record berikutnya di segmen / batch
+    uint32_t end;
+    File file;
+    LogRecord buf[LOG_READ_RECORDS];
+    uint8_t bufCount;
+    uint8_t bufPos;
+};
+
+// ---------------------------------------------------------
+// Log time-series biner append-only di LittleFS
+// ---------------------------------------------------------
+// Nilai channel ditampung di batch RAM lalu ditulis sekaligus satu
+// halaman (LOG_BATCH_SIZE), atau lebih awal setelah flush interval
+// (sdInterval). File segmen /log/N.seg dipakai bergiliran: jika slot
+// berikutnya masih berisi data, itu segmen tertua dan ditimpa. Jika
+// partisi hampir penuh, segmen tertua dihapus lebih dulu.
+// Indeks kecil per segmen (id, waktu pertama/terakhir, jumlah record)
+// dibangun ulang saat boot dari header + record pertama/terakhir, jadi
+// query hanya membuka segmen yang beririsan dan mencari awal range
+// dengan binary search (record urut waktu).
+// Tidak thread-safe: append, flush dan query dari task yang sama (comms).
+class DataLogger
+{
+public:
+    DataLogger();
+
+    // LittleFS harus sudah di-mount
+    bool begin();
+
+    void setEnabled(bool on) { _enabled = on; }
+    bool enabled() const { return _enabled; }
+    void setFlushInterval(uint32_t ms) { _flushIntervalMs = ms; }
+
+    // Jam log (detik): epoch jika jam sistem sudah diset, jika belum
+    // lanjutan dari record terakhir + uptime. Selalu naik.
+    uint32_t now();
+
+    void append(uint8_t channel, float value);
+    void service(); // flush batch yang sudah menunggu flush interval
+    bool flush();
+
+    // Query range [from, to] (inklusif) untuk channel di mask
+    void openRange(LogCursor &c, uint32_t from, uint32_t to, uint32_t mask);
+    bool next(LogCursor &c, LogRecord &r);
+
+    uint32_t records() const;
+    uint32_t oldest() const;
+    uint8_t segments() const;
+    uint32_t appended() const { return _appended; } // total sejak boot
+    uint32_t flushes() const { return _flushes; }
+    uint32_t dropped() const { return _dropped; }
+
+    // KodeSensor channel; fallback diisi "AIn"/"DIn"/"MBn" jika nama kosong
+    static const char *channelName(uint8_t ch, char *fallback, size_t size);
+
+private:
+    struct Segment
+    {
+        uint32_t id; // 0 = slot kosong
+        uint32_t first;
+        uint32_t last;
+        uint32_t count;
+    };
+
+    static void segmentPath(uint8_t slot, char *path, size_t size);
+    void loadSegment(uint8_t slot);
+    bool rotate();
+    bool ensureSpace();
+    void dropSegment(uint8_t slot);
+    bool readAt(File &f, uint32_t index, LogRecord &r);
+    uint32_t lowerBound(File &f, uint32_t count, uint32_t from);
+    bool fill(LogCursor &c);
+
+    Segment _index[LOG_SEGMENTS];
+    uint8_t _active;
+    uint32_t _nextId;
+    LogRecord _batch[LOG_BATCH_RECORDS];
+    uint16_t _batchCount;
+    uint32_t _batchSinceMs;
+    uint32_t _flushIntervalMs;
+    uint32_t _clock;   // detik jam log
+    uint32_t _clockMs; // millis() saat _clock terakhir dinaikkan
+    uint32_t _flushes;
+    uint32_t _dropped;
+    uint32_t _appended;
+    bool _enabled;
+};
+
+extern DataLogger logger;
+
+#endif // DATALOGGER_H
@@ -0,0 +1,249 @@
+#include "DigitalInputs.h"
+#include <driver/pcnt.h>
+
+DigitalInputs digitalInputs;
+
+volatile uint32_t DigitalInputs::_overflows[DI_CHANNELS];
+DiEdgeTimer DigitalInputs::_timers[DI_CHANNELS];
+Seqlock<DiEdgeTimer> DigitalInputs::_published[DI_CHANNELS];
+uint8_t DigitalInputs::_pins[DI_CHANNELS] = {DI1_PIN, DI2_PIN, DI3_PIN, DI4_PIN};
+bool DigitalInputs::_activeHigh[DI_CHANNELS];
+
+static const pcnt_unit_t PCNT_UNITS[DI_CHANNELS] = {PCNT_UNIT_0, PCNT_UNIT_1, PCNT_UNIT_2, PCNT_UNIT_3};
+
+DigitalInputs::DigitalInputs() : _started(false)
+{
+    memset(_channels, 0, sizeof(_channels));
+    memset(_readings, 0, sizeof(_readings));
+    memset(_applied, 0, sizeof(_applied));
+}
+
+DiMode DigitalInputs::parseMode(const char *taskMode)
+{
+    if (strcmp(taskMode, "Counting") == 0)
+        return DI_MODE_COUNTING;
+    if (strcmp(taskMode, "Cycle Time") == 0)
+        return DI_MODE_CYCLE_TIME;
+    if (strcmp(taskMode, "Run Time") == 0)
+        return DI_MODE_RUN_TIME;
+    if (strcmp(taskMode, "Pulse Mode") == 0)
+        return DI_MODE_PULSE;
+    return DI_MODE_NORMAL;
+}
+
+// ---------------------------------------------------------
+// ISR
+// ---------------------------------------------------------
+// Event batas atas PCNT: counter hardware sudah kembali ke 0
+void IRAM_ATTR DigitalInputs::onOverflow(void *arg)
+{
+    uint8_t ch = (uint8_t)(uintptr_t)arg;
+    _overflows[ch] = _overflows[ch] + 1;
+}
+
+void IRAM_ATTR DigitalInputs::onEdge(uint8_t ch)
+{
+    bool level = (digitalRead(_pins[ch]) == HIGH) == _activeHigh[ch];
+    _timers[ch].edge(micros(), level);
+    _published[ch].write(_timers[ch]);
+}
+
+void IRAM_ATTR DigitalInputs::onEdge0() { onEdge(0); }
+void IRAM_ATTR DigitalInputs::onEdge1() { onEdge(1); }
+void IRAM_ATTR DigitalInputs::onEdge2() { onEdge(2); }
+void IRAM_ATTR DigitalInputs::onEdge3() { onEdge(3); }
+
+// ---------------------------------------------------------
+// Konfigurasi
+// ---------------------------------------------------------
+void DigitalInputs::begin()
+{
+    pcnt_isr_service_install(0);
+    for (uint8_t ch = 0; ch < DI_CHANNELS; ch++)
+        pcnt_isr_handler_add(PCNT_UNITS[ch], onOverflow, (void *)(uintptr_t)ch);
+    _started = true;
+}
+
+// Hanya field yang memengaruhi pengukuran (ganti nama tidak mereset counter)
+bool DigitalInputs::sameSetup(const DigitalInputConfig &a, const DigitalInputConfig &b)
+{
+    return a.invers == b.invers &&
+           strcmp(a.taskMode, b.taskMode) == 0 &&
+           strcmp(a.inputState, b.inputState) == 0 &&
+           a.intervalTime == b.intervalTime &&
+           a.conversionFactor == b.conversionFactor;
+}
+
+void DigitalInputs::configure(const DigitalConfig &cfg)
+{
+    if (!_started)
+        return;
+    for (uint8_t ch = 0; ch < DI_CHANNELS; ch++)
+    {
+        if (_channels[ch].configured && sameSetup(_applied[ch], cfg.di[ch]))
+            continue;
+        _applied[ch] = cfg.di[ch];
+        setupChannel(ch, cfg.di[ch]);
+    }
+}
+
+void DigitalInputs::setupChannel(uint8_t ch, const DigitalInputConfig &cfg)
+{
+    static void (*const edgeIsr[DI_CHANNELS])() = {onEdge0, onEdge1, onEdge2, onEdge3};
+    Channel &c = _channels[ch];
+    uint8_t pin = _pins[ch];
+    pcnt_unit_t unit = PCNT_UNITS[ch];
+
+    if (c.timed)
+        detachInterrupt(digitalPinToInterrupt(pin));
+
+    c.configured = true;
+    c.mode = parseMode(cfg.taskMode);
+    c.timed = c.mode == DI_MODE_CYCLE_TIME || c.mode == DI_MODE_RUN_TIME;
+    c.factor = cfg.conversionFactor != 0 ? cfg.conversionFactor : 1.0f;
+    c.windowMs = cfg.intervalTime == 0 ? DI_DEFAULT_WINDOW_MS : min(cfg.intervalTime, (uint32_t)DI_MAX_WINDOW_MS);
+    bool activeHigh = (strcmp(cfg.inputState, "Low") != 0) != cfg.invers;
+    _activeHigh[ch] = activeHigh;
+
+    // PCNT menghitung awal fase aktif: rising jika aktif = HIGH, falling jika LOW
+    pinMode(pin, INPUT);
+    pcnt_config_t pc = {};
+    pc.pulse_gpio_num = pin;
+    pc.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+    pc.lctrl_mode = PCNT_MODE_KEEP;
+    pc.hctrl_mode = PCNT_MODE_KEEP;
+    pc.pos_mode = activeHigh ? PCNT_COUNT_INC : PCNT_COUNT_DIS;
+    pc.neg_mode = activeHigh ? PCNT_COUNT_DIS : PCNT_COUNT_INC;
+    pc.counter_h_lim = DI_PCNT_LIMIT;
+    pc.counter_l_lim = 0;
+    pc.unit = unit;
+    pc.channel = PCNT_CHANNEL_0;
+    pcnt_unit_config(&pc);
+    pcnt_set_filter_value(unit, DI_FILTER_CYCLES);
+    pcnt_filter_enable(unit);
+    pcnt_event_enable(unit, PCNT_EVT_H_LIM);
+    pcnt_counter_pause(unit);
+    pcnt_counter_clear(unit);
+    _overflows[ch] = 0;
+    pcnt_counter_resume(unit);
+
+    // ISR belum/tidak terpasang: aman menulis timer dari task
+    uint32_t now = micros();
+    _timers[ch].reset(now, activeLevel(ch));
+    _published[ch].write(_timers[ch]);
+    if (c.timed)
+        attachInterrupt(digitalPinToInterrupt(pin), edgeIsr[ch], CHANGE);
+
+    c.lastTotal = 0;
+    c.windowTotal = 0;
+    c.windowStartMs = millis();
+    c.windowStartUs = now;
+    c.windowActiveUs = 0;
+    c.windowPeriodUs = 0;
+    c.windowPeriods = 0;
+    c.runSeconds = 0;
+
+    DiReading &r = _readings[ch];
+    memset(&r, 0, sizeof(r));
+    r.level = activeLevel(ch);
+    if (c.mode == DI_MODE_NORMAL)
+        r.value = r.level ? 1 : 0;
+}
+
+// ---------------------------------------------------------
+// Pengukuran
+// ---------------------------------------------------------
+bool DigitalInputs::activeLevel(uint8_t ch) const
+{
+    return (digitalRead(_pins[ch]) == HIGH) == _activeHigh[ch];
+}
+
+// Counter 16 bit + jumlah event batas atas = total 32 bit
+uint32_t DigitalInputs::pulseTotal(uint8_t ch) const
+{
+    uint32_t high;
+    int16_t low;
+    do
+    {
+        high = _overflows[ch];
+        pcnt_get_counter_value(PCNT_UNITS[ch], &low);
+    } while (high != _overflows[ch]);
+    return high * DI_PCNT_LIMIT + (uint16_t)low;
+}
+
+int32_t DigitalInputs::value(uint8_t ch) const
+{
+    return (int32_t)lroundf(_readings[ch].value);
+}
+
+void DigitalInputs::service()
+{
+    if (!_started)
+        return;
+    uint32_t now = millis();
+    for (uint8_t ch = 0; ch < DI_CHANNELS; ch++)
+    {
+        Channel &c = _channels[ch];
+        if (!c.configured)
+            continue;
+        DiReading &r = _readings[ch];
+        uint32_t total = pulseTotal(ch);
+        // Counter sudah kembali ke 0 tapi ISR overflow belum berjalan:
+        // pakai nilai sebelumnya, terbaca benar di putaran berikutnya
+        if (total - c.lastTotal > 0x80000000UL)
+            total = c.lastTotal;
+        c.lastTotal = total;
+        r.count = total;
+        r.level = activeLevel(ch);
+        if (c.mode == DI_MODE_NORMAL)
+            r.value = r.level ? 1 : 0;
+        else if (c.mode == DI_MODE_COUNTING)
+            r.value = total * c.factor;
+        if (now - c.windowStartMs >= c.windowMs)
+            closeWindow(ch, now, total);
+    }
+}
+
+void DigitalInputs::closeWindow(uint8_t ch, uint32_t now, uint32_t total)
+{
+    Channel &c = _channels[ch];
+    DiReading &r = _readings[ch];
+    DiEdgeTimer t = {};
+    if (c.timed)
+        _published[ch].read(t);
+    // Setelah salinan timer, supaya now tidak pernah lebih awal dari edge terakhir
+    uint32_t nowUs = micros();
+    uint32_t elapsedUs = nowUs - c.windowStartUs;
+    uint32_t pulses = total - c.windowTotal;
+    r.frequency = elapsedUs ? pulses * 1e6f / elapsedUs : 0;
+
+    if (c.timed)
+    {
+        uint32_t active = t.activeUntil(nowUs);
+        uint32_t activeUs = active - c.windowActiveUs;
+        uint32_t periods = t.periods - c.windowPeriods;
+        uint32_t periodUs = t.periodUs - c.windowPeriodUs;
+        r.duty = elapsedUs ? min(1.0f, (float)activeUs / elapsedUs) : 0;
+        if (c.mode == DI_MODE_RUN_TIME)
+        {
+            c.runSeconds += activeUs * 1e-6;
+            r.value = c.runSeconds * c.factor;
+        }
+        else
+        {
+            // Tanpa periode lengkap dalam window (mesin berhenti) = 0
+            r.value = periods ? (float)periodUs / periods * 1e-6f * c.factor : 0;
+        }
+        c.windowActiveUs = active;
+        c.windowPeriods = t.periods;
+        c.windowPeriodUs = t.periodUs;
+    }
+    else if (c.mode == DI_MODE_PULSE)
+    {
+        r.value = pulses * c.factor;
+    }
+
+    c.windowTotal = total;
+    c.windowStartMs = now;
+    c.windowStartUs = nowUs;
+}
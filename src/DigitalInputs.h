@@ -0,0 +1,173 @@
+#ifndef DIGITALINPUTS_H
+#define DIGITALINPUTS_H
+
+#include <Arduino.h>
+#include "ConfigCache.h"
+#include "Seqlock.h"
+
+// Pin DI1..DI4 (GPIO input-only tanpa pull-up internal, bisa di-override
+// lewat build_flags)
+#ifndef DI1_PIN
+#define DI1_PIN 34
+#endif
+#ifndef DI2_PIN
+#define DI2_PIN 35
+#endif
+#ifndef DI3_PIN
+#define DI3_PIN 36
+#endif
+#ifndef DI4_PIN
+#define DI4_PIN 39
+#endif
+
+// Filter glitch PCNT dalam siklus APB 80 MHz (maks. 1023); 100 = pulsa
+// < 1.25 us diabaikan, cukup untuk sinyal puluhan kHz
+#ifndef DI_FILTER_CYCLES
+#define DI_FILTER_CYCLES 100
+#endif
+
+#define DI_CHANNELS CFG_DI_COUNT
+#define DI_PCNT_LIMIT 30000          // counter PCNT 16 bit kembali ke 0 + event di sini
+#define DI_DEFAULT_WINDOW_MS 1000    // intervalTime 0
+#define DI_MAX_WINDOW_MS 3600000     // akumulator us 32 bit aman < 71 menit
+
+enum DiMode : uint8_t
+{
+    DI_MODE_NORMAL,     // level input 0/1
+    DI_MODE_COUNTING,   // total pulsa x conversionFactor
+    DI_MODE_CYCLE_TIME, // rata-rata periode (detik) dalam window x conversionFactor
+    DI_MODE_RUN_TIME,   // total waktu aktif (detik) x conversionFactor
+    DI_MODE_PULSE       // pulsa per window x conversionFactor (mis. liter per interval)
+};
+
+// Waktu aktif & periode dari timestamp edge. Tanpa akses hardware, jadi
+// bisa juga diberi timestamp rekaman. Semua waktu micros() (wrap aman
+// selama selisih < 71 menit).
+struct DiEdgeTimer
+{
+    uint32_t lastEdgeUs;
+    uint32_t lastStartUs; // awal fase aktif terakhir
+    uint32_t activeUs;    // total waktu aktif s/d lastEdgeUs
+    uint32_t periodUs;    // jumlah periode lengkap (awal aktif -> awal aktif)
+    uint32_t periods;
+    bool active;
+    bool haveStart;
+
+    void reset(uint32_t us, bool level)
+    {
+        memset(this, 0, sizeof(*this));
+        lastEdgeUs = us;
+        active = level;
+    }
+
+    void edge(uint32_t us, bool level)
+    {
+        if (level == active)
+            return; // edge terlewat (ISR telat / glitch), tunggu edge berikutnya
+        if (active)
+            activeUs += us - lastEdgeUs;
+        else
+        {
+            if (haveStart)
+            {
+                periodUs += us - lastStartUs;
+                periods++;
+            }
+            lastStartUs = us;
+            haveStart = true;
+        }
+        lastEdgeUs = us;
+        active = level;
+    }
+
+    // Total waktu aktif s/d now, termasuk fase aktif yang sedang berjalan
+    uint32_t activeUntil(uint32_t now) const { return activeUs + (active ? now - lastEdgeUs : 0); }
+};
+
+struct DiReading
+{
+    float value;     // sesuai taskMode, sudah x conversionFactor
+    float frequency; // Hz, awal fase aktif per detik dalam window terakhir
+    float duty;      // 0..1 porsi waktu aktif dalam window (Cycle/Run Time)
+    uint32_t count;  // total pulsa sejak channel dikonfigurasi
+    bool level;      // aktif (setelah inputState & invers)
+};
+
+// ---------------------------------------------------------
+// Input digital DI1..DI4 (pulse counter PCNT + ISR edge)
+// ---------------------------------------------------------
+// Tiap DI memakai satu unit PCNT yang menghitung awal fase aktif di
+// hardware (tanpa kerja CPU per edge), 16 bit diperluas ke 32 bit lewat
+// event batas atas. Mode Cycle Time / Run Time butuh lebar pulsa, jadi
+// hanya mode itu yang memasang ISR CHANGE yang mencatat timestamp edge
+// ke DiEdgeTimer (dipublikasikan lewat seqlock).
+//
+// Aktif = level pin sama dengan inputState ("High"/"Low"), dibalik jika
+// invers. Frekuensi, duty dan nilai mode window dihitung service() tiap
+// intervalTime ms. conversionFactor 0 dianggap 1 (default file config).
+//
+// begin() dan configure() dipanggil dari task comms supaya ISR PCNT dan
+// GPIO terpasang di core 0, jauh dari task akuisisi. Tidak thread-safe:
+// service() dan pembacaan dari task comms.
+class DigitalInputs
+{
+public:
+    DigitalInputs();
+
+    void begin();
+    // No-op untuk channel yang config-nya tidak berubah (counter tetap jalan)
+    void configure(const DigitalConfig &cfg);
+    void service();
+
+    const DiReading &reading(uint8_t ch) const { return _readings[ch]; }
+    // Nilai dibulatkan (live, register Modbus)
+    int32_t value(uint8_t ch) const;
+
+    static DiMode parseMode(const char *taskMode);
+
+private:
+    struct Channel
+    {
+        bool configured;
+        DiMode mode;
+        bool timed; // ISR edge terpasang
+        float factor;
+        uint32_t windowMs;
+        uint32_t lastTotal;
+        uint32_t windowTotal;   // total pulsa di awal window
+        uint32_t windowStartMs;
+        uint32_t windowStartUs;
+        uint32_t windowActiveUs; // DiEdgeTimer::activeUntil di awal window
+        uint32_t windowPeriodUs;
+        uint32_t windowPeriods;
+        double runSeconds;
+    };
+
+    static bool sameSetup(const DigitalInputConfig &a, const DigitalInputConfig &b);
+    void setupChannel(uint8_t ch, const DigitalInputConfig &cfg);
+    void closeWindow(uint8_t ch, uint32_t now, uint32_t total);
+    uint32_t pulseTotal(uint8_t ch) const;
+    bool activeLevel(uint8_t ch) const;
+
+    static void IRAM_ATTR onOverflow(void *arg);
+    static void IRAM_ATTR onEdge(uint8_t ch);
+    static void IRAM_ATTR onEdge0();
+    static void IRAM_ATTR onEdge1();
+    static void IRAM_ATTR onEdge2();
+    static void IRAM_ATTR onEdge3();
+
+    Channel _channels[DI_CHANNELS];
+    DiReading _readings[DI_CHANNELS];
+    DigitalInputConfig _applied[DI_CHANNELS];
+    bool _started;
+
+    static volatile uint32_t _overflows[DI_CHANNELS];
+    static DiEdgeTimer _timers[DI_CHANNELS]; // milik ISR
+    static Seqlock<DiEdgeTimer> _published[DI_CHANNELS];
+    static uint8_t _pins[DI_CHANNELS];
+    static bool _activeHigh[DI_CHANNELS];
+};
+
+extern DigitalInputs digitalInputs;
+
+#endif // DIGITALINPUTS_H
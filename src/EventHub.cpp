@@ -0,0 +1,161 @@
+#include "EventHub.h"
+
+EventHub events;
+
+typedef void (*FramePut)(void *dst, const char *s, size_t n);
+
+// Bentuk frame SSE: "event: X\n" + "data: baris\n" per baris + "\n"
+static size_t emitFrame(const char *event, const char *data, FramePut put, void *dst)
+{
+    size_t total = 0;
+    if (event && *event)
+    {
+        size_t n = strlen(event);
+        if (put)
+        {
+            put(dst, "event: ", 7);
+            put(dst, event, n);
+            put(dst, "\n", 1);
+        }
+        total += 8 + n;
+    }
+    const char *p = data;
+    do
+    {
+        const char *eol = strchr(p, '\n');
+        size_t n = eol ? (size_t)(eol - p) : strlen(p);
+        if (n > 0 && p[n - 1] == '\r')
+            n--;
+        if (put)
+        {
+            put(dst, "data: ", 6);
+            put(dst, p, n);
+            put(dst, "\n", 1);
+        }
+        total += 7 + n;
+        p = eol ? eol + 1 : nullptr;
+    } while (p && *p);
+    if (put)
+        put(dst, "\n", 1);
+    return total + 1;
+}
+
+static void putPrint(void *dst, const char *s, size_t n)
+{
+    ((Print *)dst)->write((const uint8_t *)s, n);
+}
+
+EventHub::EventHub() : _head(0), _published(0), _lagged(0), _lineLen(0)
+{
+    memset(_retained, 0, sizeof(_retained));
+}
+
+size_t EventHub::frameLength(const char *event, const char *data)
+{
+    return emitFrame(event, data, nullptr, nullptr);
+}
+
+void EventHub::putRing(void *hub, const char *s, size_t n)
+{
+    ((EventHub *)hub)->put(s, n);
+}
+
+void EventHub::put(const char *s, size_t n)
+{
+    while (n > 0)
+    {
+        size_t idx = _head & (EVENT_BUFFER_SIZE - 1);
+        size_t chunk = min(n, (size_t)(EVENT_BUFFER_SIZE - idx));
+        memcpy(_ring + idx, s, chunk);
+        _head += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+bool EventHub::publish(const char *event, const char *data, bool retain)
+{
+    if (!data)
+        data = "";
+    // Frame harus muat jauh di dalam ring agar subscriber sempat membacanya
+    if (frameLength(event, data) > EVENT_BUFFER_SIZE / 2)
+        return false;
+
+    emitFrame(event, data, putRing, this);
+    _published++;
+
+    if (retain && event)
+    {
+        Retained *slot = nullptr;
+        for (uint8_t i = 0; i < EVENT_MAX_RETAINED && !slot; i++)
+        {
+            if (strcmp(_retained[i].name, event) == 0 || _retained[i].name[0] == '\0')
+                slot = &_retained[i];
+        }
+        if (slot && strlen(data) < EVENT_RETAIN_DATA)
+        {
+            strncpy(slot->name, event, EVENT_RETAIN_NAME - 1);
+            slot->name[EVENT_RETAIN_NAME - 1] = '\0';
+            strcpy(slot->data, data);
+        }
+    }
+    return true;
+}
+
+size_t EventHub::write(uint8_t c)
+{
+    if (c == '\r')
+        return 1;
+    if (c == '\n')
+    {
+        _line[_lineLen] = '\0';
+        publish(nullptr, _line);
+        _lineLen = 0;
+        return 1;
+    }
+    // Baris terlalu panjang dipecah, tidak dibuang
+    if (_lineLen >= EVENT_LINE_MAX - 1)
+    {
+        _line[_lineLen] = '\0';
+        publish(nullptr, _line);
+        _lineLen = 0;
+    }
+    _line[_lineLen++] = (char)c;
+    return 1;
+}
+
+size_t EventHub::read(uint32_t &pos, uint8_t *buf, size_t size)
+{
+    if (overrun(pos))
+        return 0;
+    size_t avail = _head - pos;
+    size_t n = min(avail, size);
+    for (size_t done = 0; done < n;)
+    {
+        size_t idx = (pos + done) & (EVENT_BUFFER_SIZE - 1);
+        size_t chunk = min(n - done, (size_t)(EVENT_BUFFER_SIZE - idx));
+        memcpy(buf + done, _ring + idx, chunk);
+        done += chunk;
+    }
+    pos += n;
+    return n;
+}
+
+void EventHub::writeRetained(Print &out) const
+{
+    for (uint8_t i = 0; i < EVENT_MAX_RETAINED; i++)
+    {
+        if (_retained[i].name[0] != '\0')
+            emitFrame(_retained[i].name, _retained[i].data, putPrint, &out);
+    }
+}
+
+const char *EventHub::retained(const char *event) const
+{
+    for (uint8_t i = 0; i < EVENT_MAX_RETAINED; i++)
+    {
+        if (_retained[i].name[0] != '\0' && strcmp(_retained[i].name, event) == 0)
+            return _retained[i].data;
+    }
+    return nullptr;
+}
@@ -0,0 +1,77 @@
+#ifndef EVENTHUB_H
+#define EVENTHUB_H
+
+#include <Arduino.h>
+
+#define EVENT_BUFFER_SIZE 4096   // ring bersama semua subscriber (harus 2^n)
+#define EVENT_MAX_RETAINED 4     // event terakhir per nama yang disimpan
+#define EVENT_RETAIN_NAME 16
+#define EVENT_RETAIN_DATA 1024   // muat 16 tag modbus
+#define EVENT_LINE_MAX 160       // satu baris log lewat print()
+
+// ---------------------------------------------------------
+// Hub Server-Sent Events (satu buffer, banyak subscriber)
+// ---------------------------------------------------------
+// Producer (loop sampling, modbus, log) menulis frame SSE yang sudah jadi
+// ke satu ring buffer. Tiap subscriber hanya menyimpan posisi baca
+// (offset absolut), jadi fan-out ke N browser tidak menggandakan data.
+//
+// publish() tidak pernah menunggu subscriber: data lama ditimpa. Subscriber
+// yang tertinggal lebih dari EVENT_BUFFER_SIZE (overrun) diputus oleh
+// server; EventSource di browser otomatis reconnect dan menerima event
+// retained lagi. Jadi client lambat tidak pernah menahan akuisisi.
+//
+// Turunan Print: baris yang di-print (diakhiri '\n') dikirim sebagai event
+// tanpa nama (onmessage di debug-monitor.html).
+class EventHub : public Print
+{
+public:
+    EventHub();
+
+    // event = nullptr -> event default "message". data boleh multi-baris.
+    // retain = simpan sebagai nilai terakhir (dikirim ke subscriber baru).
+    bool publish(const char *event, const char *data, bool retain = false);
+
+    // Print: kumpulkan baris log
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    // Posisi awal subscriber baru (hanya menerima event setelah ini)
+    uint32_t head() const { return _head; }
+    // Salin byte mulai pos; pos dimajukan. 0 jika tidak ada data baru
+    // atau subscriber overrun.
+    size_t read(uint32_t &pos, uint8_t *buf, size_t size);
+    bool overrun(uint32_t pos) const { return _head - pos > EVENT_BUFFER_SIZE; }
+    void countLagged() { _lagged++; }
+
+    // Kirim event retained (mis. "values") ke subscriber yang baru bergabung
+    void writeRetained(Print &out) const;
+    // Data event retained terakhir; nullptr jika belum ada
+    const char *retained(const char *event) const;
+
+    uint32_t published() const { return _published; }
+    uint32_t lagged() const { return _lagged; }
+
+private:
+    struct Retained
+    {
+        char name[EVENT_RETAIN_NAME];
+        char data[EVENT_RETAIN_DATA];
+    };
+
+    void put(const char *s, size_t n);
+    static void putRing(void *hub, const char *s, size_t n);
+    static size_t frameLength(const char *event, const char *data);
+
+    char _ring[EVENT_BUFFER_SIZE];
+    uint32_t _head; // total byte yang pernah ditulis
+    uint32_t _published;
+    uint32_t _lagged;
+    Retained _retained[EVENT_MAX_RETAINED];
+    char _line[EVENT_LINE_MAX];
+    uint8_t _lineLen;
+};
+
+extern EventHub events;
+
+#endif // EVENTHUB_H
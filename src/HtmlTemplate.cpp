@@ -0,0 +1,112 @@
+#include "HtmlTemplate.h"
+
+// Urutan harus sama dengan enum TemplateVar
+static const char *const kVarNames[TPL_VAR_COUNT] = {
+    "LINK_STATUS",
+};
+
+uint8_t TemplateScanner::varId(const char *name, size_t len)
+{
+    for (uint8_t i = 0; i < TPL_VAR_COUNT; i++)
+    {
+        if (strlen(kVarNames[i]) == len && memcmp(kVarNames[i], name, len) == 0)
+            return i;
+    }
+    return TPL_UNKNOWN;
+}
+
+static bool isNameChar(uint8_t c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+TemplateScanner::TemplateScanner(TemplateSegment *out, size_t capacity)
+    : _out(out), _capacity(capacity), _count(0), _overflow(false), _placeholders(0),
+      _state(TEXT), _pos(0), _textStart(0), _tokenStart(0), _nameLen(0)
+{
+}
+
+void TemplateScanner::push(uint32_t offset, uint32_t length, uint8_t var)
+{
+    // Teks panjang dipecah supaya muat di length 16 bit
+    while (length > 0)
+    {
+        if (_count >= _capacity)
+        {
+            _overflow = true;
+            return;
+        }
+        uint16_t n = min(length, (uint32_t)0xFFFF);
+        _out[_count].offset = offset;
+        _out[_count].length = n;
+        _out[_count].var = var;
+        _count++;
+        offset += n;
+        length -= n;
+    }
+}
+
+// Byte di luar placeholder: '{' bisa jadi awal placeholder berikutnya
+void TemplateScanner::text(uint8_t c)
+{
+    if (c == '{')
+    {
+        _state = OPEN;
+        _tokenStart = _pos;
+    }
+    else
+        _state = TEXT;
+}
+
+void TemplateScanner::feed(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++, _pos++)
+    {
+        uint8_t c = data[i];
+        switch (_state)
+        {
+        case TEXT:
+            text(c);
+            break;
+        case OPEN:
+            if (c == '{')
+            {
+                _state = NAME;
+                _nameLen = 0;
+            }
+            else
+                text(c);
+            break;
+        case NAME:
+            if (isNameChar(c) && _nameLen < TPL_MAX_NAME)
+                _name[_nameLen++] = (char)c;
+            else if (c == '}' && _nameLen > 0)
+                _state = CLOSE;
+            else if (c == '{' && _nameLen == 0)
+                _tokenStart++; // "{{{": geser satu
+            else
+                text(c);
+            break;
+        case CLOSE:
+            if (c == '}')
+            {
+                push(_textStart, _tokenStart - _textStart, TPL_LITERAL);
+                push(_tokenStart, _pos + 1 - _tokenStart, varId(_name, _nameLen));
+                _placeholders++;
+                _textStart = _pos + 1;
+                _state = TEXT;
+            }
+            else
+                text(c);
+            break;
+        }
+    }
+}
+
+int TemplateScanner::finish()
+{
+    push(_textStart, _pos - _textStart, TPL_LITERAL);
+    _textStart = _pos;
+    _state = TEXT;
+    return _overflow ? -1 : (int)_count;
+}
@@ -0,0 +1,80 @@
+#ifndef HTMLTEMPLATE_H
+#define HTMLTEMPLATE_H
+
+#include <Arduino.h>
+
+// Kapasitas pool segmen template di AssetCache (semua halaman HTML)
+#ifndef TPL_MAX_SEGMENTS
+#define TPL_MAX_SEGMENTS 96
+#endif
+#define TPL_MAX_NAME 32     // panjang nama placeholder maks. (tanpa {{ }})
+#define TPL_VALUE_MAX 64    // panjang nilai placeholder maks.
+#define TPL_LITERAL 0xFF    // TemplateSegment.var untuk potongan teks biasa
+#define TPL_UNKNOWN 0xFE    // placeholder yang tidak terdaftar -> kosong
+
+// Registry placeholder {{NAMA}}: id = urutan di enum, nama di HtmlTemplate.cpp
+enum TemplateVar : uint8_t
+{
+    TPL_VAR_LINK_STATUS, // ONLINE / OFFLINE / UNKNOWN
+    TPL_VAR_COUNT
+};
+
+// Satu potongan file template: teks biasa [offset, offset + length) atau
+// placeholder (length = panjang "{{NAMA}}" di file, dilewati saat serve)
+struct TemplateSegment
+{
+    uint32_t offset;
+    uint16_t length;
+    uint8_t var;
+};
+
+// ---------------------------------------------------------
+// Scanner template HTML
+// ---------------------------------------------------------
+// File dipindai sekali (AssetCache saat boot) menjadi daftar segmen teks
+// dan id placeholder, jadi saat serve tidak ada String per baris: teks
+// disalin dalam potongan besar, placeholder diisi dari registry. Jumlah
+// placeholder per baris bebas. Hanya {{NAMA}} dengan huruf besar, angka
+// dan '_' yang dianggap placeholder; "{{" lain (mis. di JS) tetap teks.
+//
+// Data boleh diumpankan bertahap (buffer baca file), placeholder boleh
+// terpotong di antara dua panggilan feed().
+class TemplateScanner
+{
+public:
+    TemplateScanner(TemplateSegment *out, size_t capacity);
+
+    void feed(const uint8_t *data, size_t len);
+    // Jumlah segmen, atau -1 jika kapasitas tidak cukup
+    int finish();
+    // Ada minimal satu placeholder (valid setelah finish)
+    bool templated() const { return _placeholders > 0; }
+
+    static uint8_t varId(const char *name, size_t len);
+
+private:
+    enum State : uint8_t
+    {
+        TEXT,
+        OPEN,  // '{'
+        NAME,  // "{{" + nama
+        CLOSE  // "{{NAMA}"
+    };
+
+    void push(uint32_t offset, uint32_t length, uint8_t var);
+    void text(uint8_t c);
+
+    TemplateSegment *_out;
+    size_t _capacity;
+    size_t _count;
+    bool _overflow;
+    uint16_t _placeholders;
+    State _state;
+    uint32_t _pos;        // offset byte berikutnya
+    uint32_t _textStart;  // awal teks yang belum dikeluarkan
+    uint32_t _tokenStart; // posisi '{' pertama
+    char _name[TPL_MAX_NAME];
+    uint8_t _nameLen;
+};
+
+#endif // HTMLTEMPLATE_H
@@ -0,0 +1,197 @@
+#include "HttpRequestParser.h"
+
+void HttpRequestParser::reset()
+{
+    _state = REQUEST_LINE;
+    _method = HTTP_METHOD_UNKNOWN;
+    _http11 = false;
+    _keepAlive = false;
+    _connectionSeen = false;
+    _lineOverflow = false;
+    _lineLen = 0;
+    _target[0] = '\0';
+    _pathLen = 0;
+    _targetLen = 0;
+    _queryPos = 0;
+    _ifNoneMatch[0] = '\0';
+    _contentType[0] = '\0';
+    _contentLength = 0;
+    _body[0] = '\0';
+    _bodyLen = 0;
+    _bodyReceived = 0;
+}
+
+const char *HttpRequestParser::methodName() const
+{
+    switch (_method)
+    {
+    case HTTP_METHOD_GET:
+        return "GET";
+    case HTTP_METHOD_POST:
+        return "POST";
+    case HTTP_METHOD_HEAD:
+        return "HEAD";
+    case HTTP_METHOD_OPTIONS:
+        return "OPTIONS";
+    default:
+        return "?";
+    }
+}
+
+size_t HttpRequestParser::feed(const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    // Fase header: kumpulkan per baris
+    while (i < len && (_state == REQUEST_LINE || _state == HEADERS))
+    {
+        char c = (char)data[i++];
+        if (c == '\r')
+            continue;
+        if (c != '\n')
+        {
+            if (_lineLen < HTTP_MAX_LINE - 1)
+                _line[_lineLen++] = c;
+            else
+                _lineOverflow = true;
+            continue;
+        }
+
+        _line[_lineLen] = '\0';
+        if (_state == REQUEST_LINE)
+        {
+            // Toleransi baris kosong sebelum request line (RFC 7230 3.5)
+            if (_lineLen > 0)
+            {
+                if (_lineOverflow || !parseRequestLine())
+                {
+                    _state = ERROR;
+                    return i;
+                }
+                _state = HEADERS;
+            }
+        }
+        else if (_lineLen == 0)
+        {
+            finishHeaders();
+            _lineLen = 0;
+            // Berhenti di sini: pemanggil memutuskan body di-buffer atau di-stream
+            return i;
+        }
+        else if (!_lineOverflow)
+        {
+            parseHeaderLine();
+        }
+        _lineLen = 0;
+        _lineOverflow = false;
+    }
+
+    // Fase body (buffer sampai HTTP_MAX_BODY, sisanya hanya dihitung)
+    if (_state == BODY && i < len)
+    {
+        size_t want = _contentLength - _bodyReceived;
+        size_t n = min(want, len - i);
+        if (_bodyLen < HTTP_MAX_BODY)
+        {
+            size_t copy = min(n, (size_t)(HTTP_MAX_BODY - _bodyLen));
+            memcpy(_body + _bodyLen, data + i, copy);
+            _bodyLen += copy;
+            _body[_bodyLen] = '\0';
+        }
+        _bodyReceived += n;
+        i += n;
+        if (_bodyReceived >= _contentLength)
+            _state = COMPLETE;
+    }
+    return i;
+}
+
+bool HttpRequestParser::parseRequestLine()
+{
+    // METHOD SP target SP HTTP/x.y
+    char *sp1 = strchr(_line, ' ');
+    if (!sp1)
+        return false;
+    *sp1 = '\0';
+    char *target = sp1 + 1;
+    char *sp2 = strchr(target, ' ');
+    if (!sp2)
+        return false;
+    *sp2 = '\0';
+    const char *version = sp2 + 1;
+
+    if (strcmp(_line, "GET") == 0)
+        _method = HTTP_METHOD_GET;
+    else if (strcmp(_line, "POST") == 0)
+        _method = HTTP_METHOD_POST;
+    else if (strcmp(_line, "HEAD") == 0)
+        _method = HTTP_METHOD_HEAD;
+    else if (strcmp(_line, "OPTIONS") == 0)
+        _method = HTTP_METHOD_OPTIONS;
+    else
+        _method = HTTP_METHOD_UNKNOWN;
+
+    size_t tlen = strlen(target);
+    if (tlen == 0 || tlen >= HTTP_MAX_TARGET)
+        return false;
+    memcpy(_target, target, tlen + 1);
+    _targetLen = tlen;
+
+    char *q = strchr(_target, '?');
+    if (q)
+    {
+        *q = '\0';
+        _queryPos = (q - _target) + 1;
+    }
+    _pathLen = strlen(_target);
+
+    if (strncmp(version, "HTTP/1.", 7) != 0)
+        return false;
+    _http11 = version[7] >= '1';
+    return true;
+}
+
+void HttpRequestParser::parseHeaderLine()
+{
+    char *colon = strchr(_line, ':');
+    if (!colon)
+        return;
+    *colon = '\0';
+    char *value = colon + 1;
+    while (*value == ' ' || *value == '\t')
+        value++;
+    // Trim spasi di akhir value
+    char *end = value + strlen(value);
+    while (end > value && (end[-1] == ' ' || end[-1] == '\t'))
+        *--end = '\0';
+
+    if (strcasecmp(_line, "Content-Length") == 0)
+    {
+        _contentLength = strtoul(value, nullptr, 10);
+    }
+    else if (strcasecmp(_line, "If-None-Match") == 0)
+    {
+        strncpy(_ifNoneMatch, value, HTTP_MAX_ETAG - 1);
+        _ifNoneMatch[HTTP_MAX_ETAG - 1] = '\0';
+    }
+    else if (strcasecmp(_line, "Content-Type") == 0)
+    {
+        strncpy(_contentType, value, HTTP_MAX_CONTENT_TYPE - 1);
+        _contentType[HTTP_MAX_CONTENT_TYPE - 1] = '\0';
+    }
+    else if (strcasecmp(_line, "Connection") == 0)
+    {
+        _connectionSeen = true;
+        if (strcasecmp(value, "close") == 0)
+            _keepAlive = false;
+        else if (strcasecmp(value, "keep-alive") == 0)
+            _keepAlive = true;
+    }
+}
+
+void HttpRequestParser::finishHeaders()
+{
+    if (!_connectionSeen)
+        _keepAlive = _http11;
+    _state = (_contentLength > 0) ? BODY : COMPLETE;
+}
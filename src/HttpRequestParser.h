@@ -0,0 +1,102 @@
+#ifndef HTTPREQUESTPARSER_H
+#define HTTPREQUESTPARSER_H
+
+#include <Arduino.h>
+
+#define HTTP_MAX_TARGET 160 // path + query
+#define HTTP_MAX_LINE 192   // satu baris header
+#define HTTP_MAX_ETAG 48
+#define HTTP_MAX_CONTENT_TYPE 112 // cukup untuk multipart boundary 70 karakter
+#define HTTP_MAX_BODY 2048  // body form/JSON yang di-buffer
+
+enum HttpMethod : uint8_t
+{
+    HTTP_METHOD_UNKNOWN = 0,
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_HEAD,
+    HTTP_METHOD_OPTIONS
+};
+
+// ---------------------------------------------------------
+// Parser HTTP request inkremental (state machine)
+// ---------------------------------------------------------
+// Byte dimasukkan lewat feed() dalam potongan sembarang (boleh 1 byte,
+// boleh seluruh request). Semua hasil disimpan di buffer tetap di dalam
+// objek, jadi tidak ada alokasi heap sama sekali.
+//
+// feed() berhenti tepat setelah header selesai supaya pemanggil bisa
+// memilih: buffer body (panggil feed() lagi) atau stream body langsung
+// (mis. OTA) memakai sisa byte yang belum dikonsumsi.
+class HttpRequestParser
+{
+public:
+    enum State : uint8_t
+    {
+        REQUEST_LINE,
+        HEADERS,
+        BODY,
+        COMPLETE,
+        ERROR
+    };
+
+    HttpRequestParser() { reset(); }
+    void reset();
+
+    // Mengembalikan jumlah byte yang dikonsumsi
+    size_t feed(const uint8_t *data, size_t len);
+
+    State state() const { return _state; }
+    bool headersComplete() const { return _state == BODY || _state == COMPLETE; }
+    bool complete() const { return _state == COMPLETE; }
+    bool failed() const { return _state == ERROR; }
+
+    HttpMethod method() const { return _method; }
+    const char *methodName() const;
+    // Target disimpan sebagai "path\0query\0" (tanda '?' diganti '\0')
+    const char *path() const { return _target; }
+    size_t pathLength() const { return _pathLen; }
+    const char *query() const { return _queryPos ? _target + _queryPos : ""; }
+
+    bool http11() const { return _http11; }
+    uint32_t contentLength() const { return _contentLength; }
+    bool keepAlive() const { return _keepAlive; }
+    const char *ifNoneMatch() const { return _ifNoneMatch; }
+    const char *contentType() const { return _contentType; }
+
+    // Body hanya terisi jika di-buffer lewat feed()
+    const char *body() const { return _body; }
+    size_t bodyLength() const { return _bodyLen; }
+    uint32_t bodyReceived() const { return _bodyReceived; }
+    bool bodyTruncated() const { return _bodyReceived > _bodyLen; }
+
+private:
+    bool parseRequestLine();
+    void parseHeaderLine();
+    void finishHeaders();
+
+    State _state;
+    HttpMethod _method;
+    bool _http11;
+    bool _keepAlive;
+    bool _connectionSeen;
+    bool _lineOverflow;
+
+    char _line[HTTP_MAX_LINE];
+    uint16_t _lineLen;
+
+    char _target[HTTP_MAX_TARGET];
+    uint16_t _pathLen;
+    uint16_t _targetLen;
+    uint16_t _queryPos; // 0 = tidak ada query
+
+    char _ifNoneMatch[HTTP_MAX_ETAG];
+    char _contentType[HTTP_MAX_CONTENT_TYPE];
+    uint32_t _contentLength;
+
+    char _body[HTTP_MAX_BODY + 1];
+    uint16_t _bodyLen;
+    uint32_t _bodyReceived;
+};
+
+#endif // HTTPREQUESTPARSER_H
@@ -0,0 +1,171 @@
+#include "JsonHelper.h"
+
+String getParam(String data, String key)
+{
+    String keyPair = key + "=";
+    int start = -1;
+    // Key harus di awal data atau setelah '&' / '?' (hindari "apSsid" cocok dengan "ssid")
+    int from = 0;
+    while ((start = data.indexOf(keyPair, from)) != -1)
+    {
+        if (start == 0 || data.charAt(start - 1) == '&' || data.charAt(start - 1) == '?')
+            break;
+        from = start + 1;
+    }
+    if (start == -1)
+        return "";
+
+    start += keyPair.length();
+    int end = data.indexOf("&", start);
+    if (end == -1)
+        end = data.length();
+
+    String value = data.substring(start, end);
+    value.replace("+", " ");
+    value.replace("%2F", "/");
+    value.replace("%3A", ":");
+    value.replace("%40", "@");
+    value.replace("%2C", ",");
+    return value;
+}
+
+String getNum(String data, String key)
+{
+    String val = getParam(data, key);
+    if (val == "")
+        return "0";
+    return val;
+}
+
+// Posisi awal value untuk "key" (setelah ':' dan spasi), -1 jika tidak ada
+static int findJsonValue(const String &json, const String &key)
+{
+    String search = "\"" + key + "\"";
+    int pos = json.indexOf(search);
+    while (pos != -1)
+    {
+        int p = pos + search.length();
+        while (p < (int)json.length() && isspace((unsigned char)json.charAt(p)))
+            p++;
+        if (json.charAt(p) == ':')
+        {
+            p++;
+            while (p < (int)json.length() && isspace((unsigned char)json.charAt(p)))
+                p++;
+            return p;
+        }
+        // Cocok dengan sebuah value string, bukan key: cari berikutnya
+        pos = json.indexOf(search, pos + 1);
+    }
+    return -1;
+}
+
+String getJsonVal(String json, String key)
+{
+    int start = findJsonValue(json, key);
+    if (start == -1)
+        return "";
+
+    bool isString = (json.charAt(start) == '"');
+    if (isString)
+        start++;
+
+    int end;
+    if (isString)
+    {
+        end = json.indexOf("\"", start);
+    }
+    else
+    {
+        int comma = json.indexOf(",", start);
+        int brace = json.indexOf("}", start);
+        if (comma == -1)
+            end = brace;
+        else if (brace == -1)
+            end = comma;
+        else
+            end = min(comma, brace);
+    }
+
+    if (end == -1)
+        return "";
+    String value = json.substring(start, end);
+    if (!isString)
+        value.trim();
+    return value;
+}
+
+String getJsonBlock(const String &json, const String &key)
+{
+    int start = findJsonValue(json, key);
+    if (start == -1 || json.charAt(start) != '{')
+        return "";
+
+    int depth = 0;
+    bool inString = false;
+    for (int i = start; i < (int)json.length(); i++)
+    {
+        char c = json.charAt(i);
+        if (inString)
+        {
+            if (c == '\\')
+                i++;
+            else if (c == '"')
+                inString = false;
+            continue;
+        }
+        if (c == '"')
+            inString = true;
+        else if (c == '{')
+            depth++;
+        else if (c == '}' && --depth == 0)
+            return json.substring(start, i + 1);
+    }
+    return "";
+}
+
+int getJsonArray(const String &json, const String &key, String *items, int maxItems)
+{
+    int start = findJsonValue(json, key);
+    if (start == -1 || json.charAt(start) != '[')
+        return 0;
+
+    int count = 0;
+    int i = start + 1;
+    int len = json.length();
+    while (i < len && count < maxItems)
+    {
+        while (i < len && (isspace((unsigned char)json.charAt(i)) || json.charAt(i) == ','))
+            i++;
+        if (i >= len || json.charAt(i) == ']')
+            break;
+
+        if (json.charAt(i) == '"')
+        {
+            int end = json.indexOf('"', i + 1);
+            if (end == -1)
+                break;
+            items[count++] = json.substring(i + 1, end);
+            i = end + 1;
+        }
+        else
+        {
+            int end = i;
+            while (end < len && json.charAt(end) != ',' && json.charAt(end) != ']')
+                end++;
+            String v = json.substring(i, end);
+            v.trim();
+            items[count++] = v;
+            i = end;
+        }
+    }
+    return count;
+}
+
+void copyField(char *dst, size_t size, const String &src)
+{
+    if (size == 0)
+        return;
+    strncpy(dst, src.c_str(), size - 1);
+    dst[size - 1] = '\0';
+}
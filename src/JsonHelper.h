@@ -0,0 +1,27 @@
+#ifndef JSONHELPER_H
+#define JSONHELPER_H
+
+#include <Arduino.h>
+
+// ---------------------------------------------------------
+// Helper parsing form (x-www-form-urlencoded) & JSON sederhana
+// ---------------------------------------------------------
+// Bukan parser JSON lengkap: cukup untuk file config kecil di LittleFS
+// (objek datar, objek DIx/AIx satu level, dan array angka/string).
+
+// Nilai parameter form "key=value&..." (sudah di-decode)
+String getParam(String data, String key);
+// Sama seperti getParam, tapi "0" jika kosong
+String getNum(String data, String key);
+
+// Nilai "key": <value> (string tanpa tanda kutip / angka / true / false)
+String getJsonVal(String json, String key);
+// Objek "key": { ... } termasuk kurung kurawal, "" jika tidak ada
+String getJsonBlock(const String &json, const String &key);
+// Isi array "key": [a, b, ...] -> items[], mengembalikan jumlah item
+int getJsonArray(const String &json, const String &key, String *items, int maxItems);
+
+// Salin String ke buffer char tetap (selalu null-terminated)
+void copyField(char *dst, size_t size, const String &src);
+
+#endif // JSONHELPER_H
@@ -0,0 +1,148 @@
+#include "JsonWriter.h"
+#include <math.h>
+
+void JsonWriter::printString(Print &out, const char *s)
+{
+    out.print('"');
+    if (s)
+    {
+        for (; *s; s++)
+        {
+            char c = *s;
+            if (c == '"' || c == '\\')
+            {
+                out.print('\\');
+                out.print(c);
+            }
+            else if (c == '\n')
+                out.print("\\n");
+            else if (c == '\r')
+                out.print("\\r");
+            else if (c == '\t')
+                out.print("\\t");
+            else if ((uint8_t)c < 0x20)
+            {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", (uint8_t)c);
+                out.print(esc);
+            }
+            else
+                out.print(c);
+        }
+    }
+    out.print('"');
+}
+
+void JsonWriter::printNumber(Print &out, double v, int8_t decimals)
+{
+    // JSON tidak punya NaN/Infinity
+    if (isnan(v) || isinf(v))
+    {
+        out.print("null");
+        return;
+    }
+    char buf[24];
+    if (decimals < 0)
+        snprintf(buf, sizeof(buf), "%.7g", v);
+    else
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    out.print(buf);
+}
+
+void JsonWriter::separator()
+{
+    if (_afterKey)
+    {
+        _afterKey = false;
+        return;
+    }
+    uint32_t bit = 1UL << _depth;
+    if (_first & bit)
+        _first &= ~bit;
+    else
+        _out.print(',');
+}
+
+JsonWriter &JsonWriter::beginObject(const char *key)
+{
+    if (key)
+        this->key(key);
+    separator();
+    _out.print('{');
+    if (_depth < JSON_MAX_DEPTH - 1)
+        _depth++;
+    _first |= 1UL << _depth;
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject()
+{
+    _out.print('}');
+    if (_depth > 0)
+        _depth--;
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray(const char *key)
+{
+    if (key)
+        this->key(key);
+    separator();
+    _out.print('[');
+    if (_depth < JSON_MAX_DEPTH - 1)
+        _depth++;
+    _first |= 1UL << _depth;
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray()
+{
+    _out.print(']');
+    if (_depth > 0)
+        _depth--;
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(const char *k)
+{
+    separator();
+    printString(_out, k);
+    _out.print(':');
+    _afterKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *s)
+{
+    separator();
+    printString(_out, s);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(bool b)
+{
+    separator();
+    _out.print(b ? "true" : "false");
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(long v)
+{
+    separator();
+    _out.print(v);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(unsigned long v)
+{
+    separator();
+    _out.print(v);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(double v, int8_t decimals)
+{
+    separator();
+    printNumber(_out, v, decimals);
+    return *this;
+}
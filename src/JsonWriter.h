@@ -0,0 +1,57 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <Arduino.h>
+
+#define JSON_MAX_DEPTH 16
+
+// ---------------------------------------------------------
+// Penulis JSON streaming (tanpa String / heap)
+// ---------------------------------------------------------
+// Menulis langsung ke Print (socket via ChunkedPrint, file, Serial).
+// Koma antar elemen diatur otomatis per level, string di-escape.
+//
+//   JsonWriter json(out);
+//   json.beginObject();
+//   json.kv("ssid", net.ssid).kv("port", net.port);
+//   json.beginArray("value");
+//   for (...) json.value(x);
+//   json.endArray().endObject();
+class JsonWriter
+{
+public:
+    explicit JsonWriter(Print &out) : _out(out), _depth(0), _first(1), _afterKey(false) {}
+
+    JsonWriter &beginObject(const char *key = nullptr);
+    JsonWriter &endObject();
+    JsonWriter &beginArray(const char *key = nullptr);
+    JsonWriter &endArray();
+
+    JsonWriter &key(const char *k);
+    JsonWriter &value(const char *s);
+    JsonWriter &value(bool b);
+    JsonWriter &value(int v) { return value((long)v); }
+    JsonWriter &value(unsigned int v) { return value((unsigned long)v); }
+    JsonWriter &value(long v);
+    JsonWriter &value(unsigned long v);
+    // decimals < 0: presisi float penuh (%.7g)
+    JsonWriter &value(double v, int8_t decimals = -1);
+
+    template <typename T>
+    JsonWriter &kv(const char *k, T v) { return key(k).value(v); }
+    JsonWriter &kv(const char *k, double v, int8_t decimals) { return key(k).value(v, decimals); }
+
+    // Dipakai juga oleh ConfigCache untuk file JSON
+    static void printString(Print &out, const char *s);
+    static void printNumber(Print &out, double v, int8_t decimals = -1);
+
+private:
+    void separator();
+
+    Print &_out;
+    uint8_t _depth;
+    uint32_t _first; // bit per level: belum ada elemen
+    bool _afterKey;
+};
+
+#endif // JSONWRITER_H
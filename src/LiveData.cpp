@@ -0,0 +1,66 @@
+#include "LiveData.h"
+
+LiveData live;
+
+LiveData::LiveData()
+{
+    memset(&_snap, 0, sizeof(_snap));
+}
+
+void LiveData::commit()
+{
+    _snap.uptimeMs = millis();
+    _snap.seq++;
+    if (_snap.seq == 0)
+        _snap.seq = 1; // 0 dipakai client sebagai "belum punya data"
+}
+
+static uint8_t *putU32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+    return p + 4;
+}
+
+static uint8_t *putF32(uint8_t *p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    return putU32(p, v);
+}
+
+size_t LiveData::encodeBinary(const LiveSnapshot &s, bool linkOn, uint8_t *buf, size_t size)
+{
+    if (size < LIVE_BINARY_SIZE)
+        return 0;
+    uint8_t *p = buf;
+    *p++ = LIVE_BINARY_VERSION;
+    *p++ = linkOn ? 0x01 : 0x00;
+    *p++ = s.aiMask;
+    *p++ = 0;
+    p = putU32(p, s.seq);
+    p = putU32(p, s.uptimeMs);
+    for (int i = 0; i < LIVE_DI_COUNT; i++)
+        p = putU32(p, (uint32_t)s.di[i]);
+    for (int i = 0; i < LIVE_AI_COUNT; i++)
+        p = putF32(p, s.aiRaw[i]);
+    for (int i = 0; i < LIVE_AI_COUNT; i++)
+        p = putF32(p, s.aiScaled[i]);
+    return p - buf;
+}
+
+size_t LiveData::encodeJson(const LiveSnapshot &s, bool linkOn, char *buf, size_t size)
+{
+    int n = snprintf(buf, size,
+                     "{\"seq\":%lu,\"t\":%lu,\"link\":%d,\"en\":%u,"
+                     "\"di\":[%ld,%ld,%ld,%ld],"
+                     "\"raw\":[%.0f,%.0f,%.0f,%.0f],"
+                     "\"val\":[%.2f,%.2f,%.2f,%.2f]}",
+                     (unsigned long)s.seq, (unsigned long)s.uptimeMs, linkOn ? 1 : 0, s.aiMask,
+                     (long)s.di[0], (long)s.di[1], (long)s.di[2], (long)s.di[3],
+                     s.aiRaw[0], s.aiRaw[1], s.aiRaw[2], s.aiRaw[3],
+                     s.aiScaled[0], s.aiScaled[1], s.aiScaled[2], s.aiScaled[3]);
+    return (n > 0 && (size_t)n < size) ? (size_t)n : 0;
+}
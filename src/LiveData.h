@@ -0,0 +1,59 @@
+#ifndef LIVEDATA_H
+#define LIVEDATA_H
+
+#include <Arduino.h>
+
+#define LIVE_AI_COUNT 4
+#define LIVE_DI_COUNT 4
+#define LIVE_BINARY_VERSION 1
+#define LIVE_BINARY_SIZE 60
+
+// Nilai yang berubah terus (dashboard home). Info statis ada di /info.
+struct LiveSnapshot
+{
+    uint32_t seq;      // naik setiap commit(); 0 = belum ada data
+    uint32_t uptimeMs; // millis() saat commit
+    uint8_t aiMask;    // channel AI aktif (bit0 = AI1)
+    int32_t di[LIVE_DI_COUNT];
+    float aiRaw[LIVE_AI_COUNT];    // 0..65535
+    float aiScaled[LIVE_AI_COUNT]; // satuan teknik
+};
+
+// ---------------------------------------------------------
+// Snapshot data live + encoder /live
+// ---------------------------------------------------------
+// Producer (loop utama) mengisi lewat edit() lalu commit(); reader hanya
+// menyalin snapshot. Nomor seq membuat client cukup bertanya "ada yang
+// baru sejak seq X?" dan server menjawab 204 jika tidak ada.
+//
+// Format biner (little-endian, LIVE_BINARY_SIZE byte):
+//   0  u8  versi (LIVE_BINARY_VERSION)
+//   1  u8  flags (bit0 = link ethernet ON)
+//   2  u8  aiMask
+//   3  u8  reserved
+//   4  u32 seq
+//   8  u32 uptimeMs
+//   12 i32 di[4]
+//   28 f32 aiRaw[4]
+//   44 f32 aiScaled[4]
+class LiveData
+{
+public:
+    LiveData();
+
+    LiveSnapshot &edit() { return _snap; }
+    void commit();
+
+    void read(LiveSnapshot &out) const { out = _snap; }
+    uint32_t seq() const { return _snap.seq; }
+
+    static size_t encodeBinary(const LiveSnapshot &s, bool linkOn, uint8_t *buf, size_t size);
+    static size_t encodeJson(const LiveSnapshot &s, bool linkOn, char *buf, size_t size);
+
+private:
+    LiveSnapshot _snap;
+};
+
+extern LiveData live;
+
+#endif // LIVEDATA_H
@@ -0,0 +1,122 @@
+#include "Metrics.h"
+
+#if METRICS_ENABLED
+
+Metrics metrics;
+
+// Batas atas bucket (mikrodetik): 5 us .. 100 ms
+static const uint32_t boundsUs[METRICS_BOUNDS] = {
+    5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 100000};
+static const char *const boundsLabel[METRICS_BOUNDS] = {
+    "5e-06", "1e-05", "2.5e-05", "5e-05", "0.0001", "0.00025", "0.0005",
+    "0.001", "0.0025", "0.005", "0.01", "0.025", "0.1"};
+
+static const char *const stageNames[METRIC_STAGES] = {
+    "adc_read", "calibration", "http_parse", "http_handler", "file_serve", "flash_write"};
+
+struct CounterInfo
+{
+    const char *name;
+    const char *help;
+};
+
+static const CounterInfo counterInfo[METRIC_COUNTERS] = {
+    {"iotnode_http_requests_total", "HTTP requests dispatched"},
+    {"iotnode_http_not_found_total", "HTTP 404 responses"},
+    {"iotnode_http_rx_bytes_total", "HTTP bytes received"},
+    {"iotnode_http_tx_bytes_total", "HTTP response bytes sent (headers and bodies)"},
+};
+
+Metrics::Metrics()
+{
+    memset((void *)_stages, 0, sizeof(_stages));
+    memset((void *)_counters, 0, sizeof(_counters));
+}
+
+void Metrics::record(MetricStage stage, uint32_t cycles)
+{
+    uint32_t us = cycles / METRICS_CPU_MHZ;
+    uint8_t b = 0;
+    while (b < METRICS_BOUNDS && us > boundsUs[b])
+        b++;
+    Histogram &h = _stages[stage];
+    h.buckets[b] = h.buckets[b] + 1;
+    h.count = h.count + 1;
+    h.sumUs = h.sumUs + us;
+}
+
+// Baris "# HELP/# TYPE" + satu nilai
+static void writeScalar(Print &out, const char *name, const char *type, const char *help, uint32_t value)
+{
+    out.print("# HELP ");
+    out.print(name);
+    out.print(' ');
+    out.print(help);
+    out.print("\n# TYPE ");
+    out.print(name);
+    out.print(' ');
+    out.print(type);
+    out.print('\n');
+    out.print(name);
+    out.print(' ');
+    out.print((unsigned long)value);
+    out.print('\n');
+}
+
+static void writeSeries(Print &out, const char *suffix, const char *stage, const char *le)
+{
+    out.print("iotnode_stage_seconds");
+    out.print(suffix);
+    out.print("{stage=\"");
+    out.print(stage);
+    if (le)
+    {
+        out.print("\",le=\"");
+        out.print(le);
+    }
+    out.print("\"} ");
+}
+
+void Metrics::writePrometheus(Print &out) const
+{
+    // print() per potong (printf core ESP32 memakai heap di atas 64 byte),
+    // akhir baris wajib \n tanpa \r
+    out.print("# HELP iotnode_stage_seconds Latency per processing stage (CPU cycle counter)\n"
+              "# TYPE iotnode_stage_seconds histogram\n");
+    char sum[16];
+    for (uint8_t s = 0; s < METRIC_STAGES; s++)
+    {
+        const Histogram &h = _stages[s];
+        // Salin dulu: writer bisa menambah bucket selagi kita mencetak
+        uint32_t buckets[METRICS_BOUNDS + 1];
+        for (uint8_t b = 0; b <= METRICS_BOUNDS; b++)
+            buckets[b] = h.buckets[b];
+        uint32_t sumUs = h.sumUs;
+
+        uint32_t cumulative = 0;
+        for (uint8_t b = 0; b <= METRICS_BOUNDS; b++)
+        {
+            cumulative += buckets[b];
+            writeSeries(out, "_bucket", stageNames[s], b < METRICS_BOUNDS ? boundsLabel[b] : "+Inf");
+            out.print((unsigned long)cumulative);
+            out.print('\n');
+        }
+        writeSeries(out, "_sum", stageNames[s], nullptr);
+        snprintf(sum, sizeof(sum), "%lu.%06lu\n", (unsigned long)(sumUs / 1000000), (unsigned long)(sumUs % 1000000));
+        out.print(sum);
+        // _count = total bucket, supaya konsisten dengan le="+Inf"
+        writeSeries(out, "_count", stageNames[s], nullptr);
+        out.print((unsigned long)cumulative);
+        out.print('\n');
+    }
+
+    for (uint8_t c = 0; c < METRIC_COUNTERS; c++)
+        writeScalar(out, counterInfo[c].name, "counter", counterInfo[c].help, _counters[c]);
+
+    writeScalar(out, "iotnode_heap_free_bytes", "gauge", "Free heap", ESP.getFreeHeap());
+    writeScalar(out, "iotnode_heap_min_free_bytes", "gauge", "Lowest free heap since boot", ESP.getMinFreeHeap());
+    writeScalar(out, "iotnode_heap_largest_free_block_bytes", "gauge", "Largest allocatable heap block",
+                ESP.getMaxAllocHeap());
+}
+
+#endif // METRICS_ENABLED
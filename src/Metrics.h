@@ -0,0 +1,106 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// 0 = semua instrumentasi hilang saat compile (build_flags -DMETRICS_ENABLED=0)
+#ifndef METRICS_ENABLED
+#define METRICS_ENABLED 1
+#endif
+
+// Frekuensi CCOUNT (ESP.getCycleCount), sama dengan CPU
+#ifndef METRICS_CPU_MHZ
+#define METRICS_CPU_MHZ 240
+#endif
+
+#define METRICS_BOUNDS 13 // batas bucket histogram, lihat Metrics.cpp (+Inf terpisah)
+
+enum MetricStage : uint8_t
+{
+    METRIC_ADC_READ,     // baca hasil konversi + ganti MUX (I2C)
+    METRIC_CALIBRATION,  // kalibrasi + filter satu blok per channel
+    METRIC_HTTP_PARSE,   // HttpRequestParser::feed
+    METRIC_HTTP_HANDLER, // dispatch route (termasuk header/body JSON)
+    METRIC_FILE_SERVE,   // satu potongan file LittleFS -> socket
+    METRIC_FLASH_WRITE,  // log, journal config, cursor uplink, OTA
+    METRIC_STAGES
+};
+
+enum MetricCounter : uint8_t
+{
+    METRIC_HTTP_REQUESTS,
+    METRIC_HTTP_NOT_FOUND,
+    METRIC_HTTP_RX_BYTES,
+    METRIC_HTTP_TX_BYTES,
+    METRIC_COUNTERS
+};
+
+#if METRICS_ENABLED
+
+// ---------------------------------------------------------
+// Histogram latensi per tahap + counter HTTP (/metrics)
+// ---------------------------------------------------------
+// Durasi diukur dengan cycle counter CPU (CCOUNT, per core; task yang
+// diukur di-pin ke satu core) dan dimasukkan ke bucket tetap, jadi
+// merekam cukup beberapa perbandingan dan increment tanpa lock.
+// Seperti TaskMonitor, setiap stage/counter hanya ditulis satu task
+// (ADC & kalibrasi: task akuisisi, sisanya: task comms); pembaca hanya
+// menyalin angka. sumUs berputar setelah ~71 menit waktu sibuk total,
+// Prometheus menganggapnya counter reset.
+class Metrics
+{
+public:
+    Metrics();
+
+    void record(MetricStage stage, uint32_t cycles);
+    void add(MetricCounter counter, uint32_t n)
+    {
+        _counters[counter] += n;
+    }
+
+    // Format teks Prometheus (exposition 0.0.4)
+    void writePrometheus(Print &out) const;
+
+private:
+    struct Histogram
+    {
+        volatile uint32_t buckets[METRICS_BOUNDS + 1]; // tidak kumulatif
+        volatile uint32_t count;
+        volatile uint32_t sumUs;
+    };
+
+    Histogram _stages[METRIC_STAGES];
+    volatile uint32_t _counters[METRIC_COUNTERS];
+};
+
+extern Metrics metrics;
+
+// Mengukur dari konstruksi sampai akhir scope
+class MetricSpan
+{
+public:
+    explicit MetricSpan(MetricStage stage) : _stage(stage), _start(ESP.getCycleCount()) {}
+    ~MetricSpan() { metrics.record(_stage, ESP.getCycleCount() - _start); }
+
+private:
+    MetricStage _stage;
+    uint32_t _start;
+};
+
+#define METRIC_CONCAT_(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_(a, b)
+#define METRIC_SPAN(stage) MetricSpan METRIC_CONCAT(metricSpan, __LINE__)(stage)
+#define METRIC_ADD(counter, n) metrics.add(counter, n)
+
+#else
+
+#define METRIC_SPAN(stage) \
+    do                     \
+    {                      \
+    } while (0)
+// Argumen tidak dievaluasi: jangan taruh efek samping (write dsb.) di dalamnya
+#define METRIC_ADD(counter, n) ((void)(n))
+
+#endif // METRICS_ENABLED
+
+#endif // METRICS_H
@@ -0,0 +1,309 @@
+#include "ModbusPoller.h"
+#include "RegisterImage.h"
+#include "TaskMonitor.h"
+
+ModbusPoller modbus;
+
+ModbusPoller::ModbusPoller()
+    : _pending(false), _started(false), _serialBaud(0), _serialConfig(0),
+      _tagCount(0), _blockCount(0), _requests(0), _errors(0), _seq(0)
+{
+    memset(&_plan, 0, sizeof(_plan));
+    memset(&_next, 0, sizeof(_next));
+    memset(_readings, 0, sizeof(_readings));
+}
+
+bool ModbusPoller::begin()
+{
+    if (_started)
+        return true;
+#if MODBUS_DE_PIN >= 0
+    pinMode(MODBUS_DE_PIN, OUTPUT);
+    digitalWrite(MODBUS_DE_PIN, LOW);
+    _node.preTransmission(preTransmission);
+    _node.postTransmission(postTransmission);
+#endif
+    if (xTaskCreatePinnedToCore(taskEntry, "modbus", MODBUS_TASK_STACK, this,
+                                MODBUS_TASK_PRIORITY, nullptr, MODBUS_TASK_CORE) != pdPASS)
+    {
+        Serial.println("Modbus: task tidak bisa dibuat.");
+        return false;
+    }
+    _started = true;
+    return true;
+}
+
+void ModbusPoller::preTransmission()
+{
+#if MODBUS_DE_PIN >= 0
+    digitalWrite(MODBUS_DE_PIN, HIGH);
+#endif
+}
+
+void ModbusPoller::postTransmission()
+{
+#if MODBUS_DE_PIN >= 0
+    // Tunggu byte terakhir keluar dari shift register sebelum lepas bus
+    MODBUS_SERIAL.flush();
+    digitalWrite(MODBUS_DE_PIN, LOW);
+#endif
+}
+
+uint32_t ModbusPoller::serialConfig(const ModbusConfig &cfg)
+{
+    bool seven = cfg.dataBit == 7;
+    bool two = cfg.stopBit == 2;
+    if (strcmp(cfg.parity, "Even") == 0)
+        return seven ? (two ? SERIAL_7E2 : SERIAL_7E1) : (two ? SERIAL_8E2 : SERIAL_8E1);
+    if (strcmp(cfg.parity, "Odd") == 0)
+        return seven ? (two ? SERIAL_7O2 : SERIAL_7O1) : (two ? SERIAL_8O2 : SERIAL_8O1);
+    return seven ? (two ? SERIAL_7N2 : SERIAL_7N1) : (two ? SERIAL_8N2 : SERIAL_8N1);
+}
+
+// ---------------------------------------------------------
+// Plan: urutkan tag lalu gabungkan register yang berdekatan
+// ---------------------------------------------------------
+static bool tagBefore(const ModbusTag &a, const ModbusTag &b)
+{
+    if (a.slave != b.slave)
+        return a.slave < b.slave;
+    if (a.function != b.function)
+        return a.function < b.function;
+    return a.reg < b.reg;
+}
+
+static bool supportedFunction(uint8_t fc)
+{
+    return fc >= 1 && fc <= 4;
+}
+
+void ModbusPoller::buildPlan(const ModbusConfig &cfg, ModbusPlan &plan)
+{
+    memset(&plan, 0, sizeof(plan));
+    plan.config = cfg;
+
+    // Insertion sort (maks. CFG_MODBUS_TAGS tag)
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < cfg.tagCount; i++)
+    {
+        if (!supportedFunction(cfg.tags[i].function))
+            continue;
+        uint8_t j = n++;
+        while (j > 0 && tagBefore(cfg.tags[i], cfg.tags[plan.order[j - 1]]))
+        {
+            plan.order[j] = plan.order[j - 1];
+            j--;
+        }
+        plan.order[j] = i;
+    }
+
+    uint32_t interval = (uint32_t)(cfg.scanRate * 1000.0f);
+    if (interval < MODBUS_MIN_INTERVAL_MS)
+        interval = MODBUS_MIN_INTERVAL_MS;
+
+    ModbusBlock *b = nullptr;
+    for (uint8_t k = 0; k < n; k++)
+    {
+        const ModbusTag &t = cfg.tags[plan.order[k]];
+        uint16_t maxCount = t.function <= 2 ? MODBUS_MAX_BLOCK_BITS : MODBUS_MAX_BLOCK_REGS;
+        bool join = b && b->slave == t.slave && b->function == t.function &&
+                    t.reg <= (uint32_t)b->start + b->count + MODBUS_MAX_GAP &&
+                    (uint32_t)t.reg - b->start + 1 <= maxCount;
+        if (join)
+        {
+            if (t.reg >= b->start + b->count)
+                b->count = t.reg - b->start + 1;
+            b->tagCount++;
+            continue;
+        }
+        b = &plan.blocks[plan.blockCount++];
+        b->slave = t.slave;
+        b->function = t.function;
+        b->start = t.reg;
+        b->count = 1;
+        b->firstTag = k;
+        b->tagCount = 1;
+        b->intervalMs = interval;
+    }
+
+    // Sebar fase awal supaya blok tidak jatuh tempo bersamaan
+    for (uint8_t i = 0; i < plan.blockCount; i++)
+        plan.blocks[i].nextDueMs = interval * i / plan.blockCount;
+}
+
+void ModbusPoller::configure(const ModbusConfig &cfg)
+{
+    // _next hanya ditulis dari sini, jadi boleh dibaca tanpa lock
+    if (_next.config.baudrate != 0 && memcmp(&cfg, &_next.config, sizeof(cfg)) == 0)
+        return;
+    static ModbusPlan plan; // ~1 KB, jangan di stack loop()
+    buildPlan(cfg, plan);
+    portENTER_CRITICAL(&_lock);
+    memcpy(&_next, &plan, sizeof(plan));
+    _pending = true;
+    portEXIT_CRITICAL(&_lock);
+}
+
+// ---------------------------------------------------------
+// Task
+// ---------------------------------------------------------
+void ModbusPoller::taskEntry(void *arg)
+{
+    ((ModbusPoller *)arg)->run();
+}
+
+void ModbusPoller::applyPlan()
+{
+    portENTER_CRITICAL(&_lock);
+    memcpy(&_plan, &_next, sizeof(_plan));
+    _pending = false;
+    memset(_readings, 0, sizeof(_readings));
+    _tagCount = _plan.config.tagCount;
+    _blockCount = _plan.blockCount;
+    portEXIT_CRITICAL(&_lock);
+
+    uint32_t cfg = serialConfig(_plan.config);
+    if (_plan.config.baudrate != _serialBaud || cfg != _serialConfig)
+    {
+        _serialBaud = _plan.config.baudrate;
+        _serialConfig = cfg;
+        MODBUS_SERIAL.begin(_serialBaud, _serialConfig, MODBUS_RX_PIN, MODBUS_TX_PIN);
+    }
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < _plan.blockCount; i++)
+        _plan.blocks[i].nextDueMs += now;
+    Serial.printf("Modbus: %u tag -> %u blok read\n", _plan.config.tagCount, _plan.blockCount);
+}
+
+void ModbusPoller::run()
+{
+    uint8_t slot = taskMonitor.add("modbus");
+    for (;;)
+    {
+        if (_pending)
+            applyPlan();
+
+        // Blok yang paling lama terlambat didahulukan
+        uint32_t now = millis();
+        uint32_t wait = MODBUS_IDLE_MS;
+        ModbusBlock *due = nullptr;
+        int32_t mostLate = 0;
+        for (uint8_t i = 0; i < _plan.blockCount; i++)
+        {
+            ModbusBlock &b = _plan.blocks[i];
+            int32_t late = (int32_t)(now - b.nextDueMs);
+            if (late >= 0 && (!due || late > mostLate))
+            {
+                due = &b;
+                mostLate = late;
+            }
+            else if (late < 0 && (uint32_t)-late < wait)
+            {
+                wait = -late;
+            }
+        }
+        if (!due)
+        {
+            vTaskDelay(pdMS_TO_TICKS(wait));
+            continue;
+        }
+
+        uint32_t start = micros();
+        pollBlock(*due);
+        taskMonitor.busy(slot, micros() - start);
+        due->nextDueMs += due->intervalMs;
+        // Bus terlalu lambat untuk jadwal ini: lewati siklus yang tertinggal
+        if ((int32_t)(millis() - due->nextDueMs) > (int32_t)due->intervalMs)
+            due->nextDueMs = millis() + due->intervalMs;
+        vTaskDelay(pdMS_TO_TICKS(MODBUS_FRAME_GAP_MS));
+    }
+}
+
+uint8_t ModbusPoller::request(const ModbusBlock &b)
+{
+    _node.begin(b.slave, MODBUS_SERIAL);
+    switch (b.function)
+    {
+    case 1:
+        return _node.readCoils(b.start, b.count);
+    case 2:
+        return _node.readDiscreteInputs(b.start, b.count);
+    case 3:
+        return _node.readHoldingRegisters(b.start, b.count);
+    default:
+        return _node.readInputRegisters(b.start, b.count);
+    }
+}
+
+void ModbusPoller::pollBlock(ModbusBlock &b)
+{
+    _requests++;
+    uint8_t rc = request(b);
+    uint32_t now = millis();
+
+    if (rc != ModbusMaster::ku8MBSuccess)
+    {
+        _errors++;
+        if (b.failures < 255)
+            b.failures++;
+        if (b.failures == MODBUS_FAIL_LIMIT)
+        {
+            Serial.printf("Modbus: slave %u FC%u @%u gagal (0x%02X)\n", b.slave, b.function, b.start, rc);
+            portENTER_CRITICAL(&_lock);
+            for (uint8_t k = 0; k < b.tagCount; k++)
+                _readings[_plan.order[b.firstTag + k]].valid = false;
+            portEXIT_CRITICAL(&_lock);
+        }
+        return;
+    }
+    b.failures = 0;
+
+    // Decode di luar critical section, lalu salin sekaligus
+    ModbusReading fresh[CFG_MODBUS_TAGS];
+    for (uint8_t k = 0; k < b.tagCount; k++)
+    {
+        const ModbusTag &t = _plan.config.tags[_plan.order[b.firstTag + k]];
+        uint16_t offset = t.reg - b.start;
+        ModbusReading &r = fresh[k];
+        if (b.function <= 2)
+        {
+            // Bit di-pack 16 per word response
+            r.raw = (_node.getResponseBuffer(offset / 16) >> (offset % 16)) & 1;
+            r.value = r.raw * t.multiplier;
+        }
+        else
+        {
+            // Register dianggap signed 16-bit (suhu bisa negatif)
+            r.raw = _node.getResponseBuffer(offset);
+            r.value = (int16_t)r.raw * t.multiplier;
+        }
+        r.valid = true;
+        r.updatedMs = now;
+    }
+    portENTER_CRITICAL(&_lock);
+    for (uint8_t k = 0; k < b.tagCount; k++)
+        _readings[_plan.order[b.firstTag + k]] = fresh[k];
+    portEXIT_CRITICAL(&_lock);
+
+    // Gateway: nilai mentah juga muncul di offsetAddress Modbus TCP
+    registers.beginWrite();
+    for (uint8_t k = 0; k < b.tagCount; k++)
+    {
+        uint16_t addr = _plan.config.tags[_plan.order[b.firstTag + k]].offset;
+        if (addr >= REG_TAG_FIRST && addr <= REG_TAG_LAST)
+            registers.set(addr, fresh[k].raw);
+    }
+    registers.endWrite();
+    _seq++;
+}
+
+bool ModbusPoller::reading(uint8_t tag, ModbusReading &out)
+{
+    if (tag >= CFG_MODBUS_TAGS)
+        return false;
+    portENTER_CRITICAL(&_lock);
+    out = _readings[tag];
+    portEXIT_CRITICAL(&_lock);
+    return out.valid;
+}
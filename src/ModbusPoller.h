@@ -0,0 +1,125 @@
+#ifndef MODBUSPOLLER_H
+#define MODBUSPOLLER_H
+
+#include <Arduino.h>
+#include <ModbusMaster.h>
+#include "ConfigCache.h"
+
+// Port RS-485 (bisa di-override lewat build_flags)
+#ifndef MODBUS_SERIAL
+#define MODBUS_SERIAL Serial2
+#endif
+#ifndef MODBUS_RX_PIN
+#define MODBUS_RX_PIN 16
+#endif
+#ifndef MODBUS_TX_PIN
+#define MODBUS_TX_PIN 17
+#endif
+#ifndef MODBUS_DE_PIN
+#define MODBUS_DE_PIN -1 // isi jika transceiver butuh DE/RE manual
+#endif
+
+#define MODBUS_MAX_BLOCK_REGS 32  // register per request (FC 3/4)
+#define MODBUS_MAX_BLOCK_BITS 128 // bit per request (FC 1/2)
+#define MODBUS_MAX_GAP 8          // alamat kosong yang boleh ikut dibaca agar blok bergabung
+#define MODBUS_MAX_BLOCKS CFG_MODBUS_TAGS
+#define MODBUS_MIN_INTERVAL_MS 100
+#define MODBUS_IDLE_MS 50         // tidur maksimum task saat tidak ada blok jatuh tempo
+#define MODBUS_FRAME_GAP_MS 5     // jeda antar request (turnaround RS-485)
+#define MODBUS_FAIL_LIMIT 3       // gagal berturut-turut sebelum nilai dianggap tidak valid
+#define MODBUS_TASK_STACK 4096
+#define MODBUS_TASK_PRIORITY 2
+#define MODBUS_TASK_CORE 0        // akuisisi analog di core 1
+
+// Satu request Modbus yang mencakup beberapa tag berurutan
+struct ModbusBlock
+{
+    uint8_t slave;
+    uint8_t function;
+    uint16_t start;
+    uint16_t count;    // jumlah register / bit
+    uint8_t firstTag;  // indeks ke ModbusPlan::order
+    uint8_t tagCount;
+    uint32_t intervalMs;
+    uint32_t nextDueMs;
+    uint8_t failures;
+};
+
+// Hasil pengelompokan tag dari ModbusConfig
+struct ModbusPlan
+{
+    ModbusConfig config;
+    uint8_t order[CFG_MODBUS_TAGS]; // indeks tag, urut (slave, fc, register)
+    ModbusBlock blocks[MODBUS_MAX_BLOCKS];
+    uint8_t blockCount;
+};
+
+struct ModbusReading
+{
+    float value;       // raw * multiplier
+    uint16_t raw;
+    bool valid;
+    uint32_t updatedMs;
+};
+
+// ---------------------------------------------------------
+// Poller Modbus RTU (master) di task sendiri
+// ---------------------------------------------------------
+// Tag dari modbusSetup.json dikelompokkan per (slave, function code) lalu
+// register yang berdekatan digabung menjadi satu blok read, termasuk celah
+// hingga MODBUS_MAX_GAP alamat. Setiap blok punya jadwal sendiri (interval
+// dari scanRate, fase awal disebar) sehingga bus tidak dibanjiri sekaligus.
+//
+// Task berjalan di core 0: menunggu balasan slave / timeout RS-485 tidak
+// menahan loop() dan web server. configure() dipanggil dari loop() saat
+// config berubah; plan baru diambil task di awal siklus berikutnya.
+class ModbusPoller
+{
+public:
+    ModbusPoller();
+
+    bool begin();
+    // Susun plan baru; diabaikan jika config modbus tidak berubah
+    void configure(const ModbusConfig &cfg);
+
+    // Nilai terakhir tag ke-i (urutan config.modbus().tags)
+    bool reading(uint8_t tag, ModbusReading &out);
+    uint8_t tagCount() const { return _tagCount; }
+    uint8_t blockCount() const { return _blockCount; }
+    uint32_t requests() const { return _requests; }
+    uint32_t errors() const { return _errors; }
+    // Naik setiap ada blok yang berhasil dibaca
+    uint32_t seq() const { return _seq; }
+
+    // Kelompokkan tag menjadi blok read (tanpa akses bus)
+    static void buildPlan(const ModbusConfig &cfg, ModbusPlan &plan);
+    static uint32_t serialConfig(const ModbusConfig &cfg);
+
+private:
+    static void taskEntry(void *arg);
+    static void preTransmission();
+    static void postTransmission();
+    void run();
+    void applyPlan();
+    void pollBlock(ModbusBlock &b);
+    uint8_t request(const ModbusBlock &b);
+
+    ModbusMaster _node;
+    ModbusPlan _plan;    // milik task
+    ModbusPlan _next;    // ditulis configure(), dilindungi _lock
+    bool _pending;
+    bool _started;
+    uint32_t _serialBaud;
+    uint32_t _serialConfig;
+    ModbusReading _readings[CFG_MODBUS_TAGS];
+    uint8_t _tagCount;
+    uint8_t _blockCount;
+    volatile uint32_t _requests;
+    volatile uint32_t _errors;
+    volatile uint32_t _seq;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern ModbusPoller modbus;
+
+#endif // MODBUSPOLLER_H
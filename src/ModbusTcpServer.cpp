@@ -0,0 +1,166 @@
+#include "ModbusTcpServer.h"
+#include "RegisterImage.h"
+
+ModbusTcpServer modbusTcp;
+
+#define MBAP_SIZE 7
+#define MB_EX_ILLEGAL_FUNCTION 0x01
+#define MB_EX_ILLEGAL_ADDRESS 0x02
+#define MB_EX_ILLEGAL_VALUE 0x03
+
+ModbusTcpServer::ModbusTcpServer()
+    : _server(MBTCP_DEFAULT_PORT), _unitId(1), _running(false),
+      _requests(0), _exceptions(0), _rejected(0)
+{
+    for (uint8_t i = 0; i < MBTCP_MAX_CLIENTS; i++)
+        _conns[i].used = false;
+}
+
+void ModbusTcpServer::begin(uint16_t port, uint8_t unitId)
+{
+    _unitId = unitId;
+    _server.begin(port ? port : MBTCP_DEFAULT_PORT);
+    _running = true;
+    Serial.printf("Modbus TCP server di port %u (unit %u).\n", port ? port : MBTCP_DEFAULT_PORT, unitId);
+}
+
+uint8_t ModbusTcpServer::activeClients() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MBTCP_MAX_CLIENTS; i++)
+        n += _conns[i].used;
+    return n;
+}
+
+void ModbusTcpServer::service()
+{
+    if (!_running)
+        return;
+    accept();
+    for (uint8_t i = 0; i < MBTCP_MAX_CLIENTS; i++)
+    {
+        if (_conns[i].used)
+            serviceConnection(_conns[i]);
+    }
+}
+
+void ModbusTcpServer::accept()
+{
+    EthernetClient client = _server.accept();
+    if (!client)
+        return;
+    for (uint8_t i = 0; i < MBTCP_MAX_CLIENTS; i++)
+    {
+        Connection &c = _conns[i];
+        if (c.used)
+            continue;
+        c.client = client;
+        c.used = true;
+        c.rxLen = 0;
+        c.lastActivityMs = millis();
+        return;
+    }
+    // Semua slot terpakai: tolak, master akan mencoba lagi
+    _rejected++;
+    client.stop();
+}
+
+void ModbusTcpServer::close(Connection &c)
+{
+    c.client.stop();
+    c.client = EthernetClient();
+    c.used = false;
+}
+
+void ModbusTcpServer::serviceConnection(Connection &c)
+{
+    if (!c.client.connected())
+    {
+        close(c);
+        return;
+    }
+
+    int avail = c.client.available();
+    if (avail > 0)
+    {
+        size_t room = sizeof(c.rx) - c.rxLen;
+        size_t n = c.client.read(c.rx + c.rxLen, min((size_t)avail, room));
+        c.rxLen += n;
+        c.lastActivityMs = millis();
+    }
+    else if (millis() - c.lastActivityMs > MBTCP_IDLE_TIMEOUT_MS)
+    {
+        close(c);
+        return;
+    }
+
+    // Layani semua frame lengkap di buffer
+    while (c.rxLen >= MBAP_SIZE)
+    {
+        uint16_t len = (c.rx[4] << 8) | c.rx[5]; // unit id + PDU
+        size_t frame = 6 + len;
+        if (len < 2 || frame > MBTCP_FRAME_MAX)
+        {
+            close(c); // bukan Modbus TCP
+            return;
+        }
+        if (c.rxLen < frame)
+            break;
+        uint8_t resp[MBTCP_FRAME_MAX];
+        size_t n = handleFrame(c.rx, frame, resp);
+        if (n)
+            c.client.write(resp, n);
+        c.rxLen -= frame;
+        memmove(c.rx, c.rx + frame, c.rxLen);
+    }
+}
+
+size_t ModbusTcpServer::exception(const uint8_t *req, uint8_t fc, uint8_t code, uint8_t *resp)
+{
+    _exceptions++;
+    memcpy(resp, req, MBAP_SIZE);
+    resp[4] = 0;
+    resp[5] = 3;
+    resp[7] = fc | 0x80;
+    resp[8] = code;
+    return MBAP_SIZE + 2;
+}
+
+size_t ModbusTcpServer::handleFrame(const uint8_t *req, size_t len, uint8_t *resp)
+{
+    // Protocol id harus 0; unit 0/255 dipakai banyak master TCP
+    if (len < MBAP_SIZE + 1 || req[2] != 0 || req[3] != 0)
+        return 0;
+    uint8_t unit = req[6];
+    if (unit != _unitId && unit != 0 && unit != 0xFF)
+        return 0;
+    _requests++;
+
+    uint8_t fc = req[7];
+    if (fc != 3 && fc != 4)
+        return exception(req, fc, MB_EX_ILLEGAL_FUNCTION, resp);
+    if (len != MBAP_SIZE + 5)
+        return exception(req, fc, MB_EX_ILLEGAL_VALUE, resp);
+
+    uint16_t start = (req[8] << 8) | req[9];
+    uint16_t count = (req[10] << 8) | req[11];
+    if (count == 0 || count > MBTCP_MAX_READ)
+        return exception(req, fc, MB_EX_ILLEGAL_VALUE, resp);
+
+    uint16_t regs[MBTCP_MAX_READ];
+    if (!registers.read(start, count, regs))
+        return exception(req, fc, MB_EX_ILLEGAL_ADDRESS, resp);
+
+    memcpy(resp, req, MBAP_SIZE);
+    uint16_t pduLen = 2 + count * 2;
+    resp[4] = (pduLen + 1) >> 8;
+    resp[5] = (pduLen + 1) & 0xFF;
+    resp[7] = fc;
+    resp[8] = count * 2;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        resp[9 + i * 2] = regs[i] >> 8;
+        resp[10 + i * 2] = regs[i] & 0xFF;
+    }
+    return MBAP_SIZE + pduLen;
+}
@@ -0,0 +1,63 @@
+#ifndef MODBUSTCPSERVER_H
+#define MODBUSTCPSERVER_H
+
+#include <Arduino.h>
+#include <EthernetESP32.h>
+
+#define MBTCP_DEFAULT_PORT 502
+#define MBTCP_MAX_CLIENTS 4          // master (SCADA/HMI) bersamaan
+#define MBTCP_FRAME_MAX 260          // MBAP 7 + PDU 253
+#define MBTCP_MAX_READ 125           // register per request (spec FC 3/4)
+#define MBTCP_IDLE_TIMEOUT_MS 60000
+
+// ---------------------------------------------------------
+// Server Modbus TCP (slave) dari RegisterImage
+// ---------------------------------------------------------
+// FC 3 (holding) dan FC 4 (input) membaca image yang sama. Non-blocking
+// seperti WebServerHandler: service() dari loop menerima koneksi baru,
+// mengumpulkan byte per koneksi, lalu menjawab setiap frame lengkap
+// (beberapa request dalam satu segmen TCP juga dilayani).
+class ModbusTcpServer
+{
+public:
+    ModbusTcpServer();
+
+    void begin(uint16_t port, uint8_t unitId);
+    void service();
+    bool running() const { return _running; }
+
+    uint8_t activeClients() const;
+    uint32_t requests() const { return _requests; }
+    uint32_t exceptions() const { return _exceptions; }
+    uint32_t rejected() const { return _rejected; }
+
+    // Proses satu frame ADU lengkap; panjang response (0 = tidak dijawab)
+    size_t handleFrame(const uint8_t *req, size_t len, uint8_t *resp);
+
+private:
+    struct Connection
+    {
+        EthernetClient client;
+        bool used;
+        uint16_t rxLen;
+        uint32_t lastActivityMs;
+        uint8_t rx[MBTCP_FRAME_MAX];
+    };
+
+    void accept();
+    void serviceConnection(Connection &c);
+    void close(Connection &c);
+    size_t exception(const uint8_t *req, uint8_t fc, uint8_t code, uint8_t *resp);
+
+    EthernetServer _server;
+    Connection _conns[MBTCP_MAX_CLIENTS];
+    uint8_t _unitId;
+    bool _running;
+    uint32_t _requests;
+    uint32_t _exceptions;
+    uint32_t _rejected;
+};
+
+extern ModbusTcpServer modbusTcp;
+
+#endif // MODBUSTCPSERVER_H
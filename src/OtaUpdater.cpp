@@ -0,0 +1,377 @@
+#include "OtaUpdater.h"
+#include <Update.h>
+#include "JsonHelper.h"
+#include "Metrics.h"
+#include "TaskMonitor.h"
+
+OtaUpdater ota;
+
+OtaUpdater::OtaUpdater()
+    : _fill(0), _drain(0), _task(nullptr), _written(0), _writeError(false), _state(OTA_IDLE),
+      _httpStatus("200 OK"), _error(""), _contentLength(0), _bodyReceived(0), _multipart(false),
+      _headerDone(false), _headerLen(0), _trailerMatched(0), _size(0), _received(0), _startMs(0),
+      _activeMs(0), _lastActivityMs(0)
+{
+    for (uint8_t i = 0; i < OTA_BLOCKS; i++)
+    {
+        _blocks[i].length = 0;
+        _blocks[i].state.store(BLOCK_FREE);
+    }
+    _boundary[0] = '\0';
+    _expectedMd5[0] = '\0';
+    _md5[0] = '\0';
+}
+
+void OtaUpdater::begin()
+{
+    if (xTaskCreatePinnedToCore(taskEntry, "ota", OTA_TASK_STACK, this,
+                                OTA_TASK_PRIORITY, &_task, OTA_TASK_CORE) != pdPASS)
+    {
+        // Tetap bisa update, hanya tanpa overlap (blok ditulis di submit)
+        Serial.println("OTA: task gagal dibuat.");
+        _task = nullptr;
+    }
+}
+
+const char *OtaUpdater::stateName() const
+{
+    switch (_state)
+    {
+    case OTA_RECEIVING:
+        return "receiving";
+    case OTA_PAUSED:
+        return "paused";
+    case OTA_DONE:
+        return "done";
+    case OTA_FAILED:
+        return "failed";
+    default:
+        return "idle";
+    }
+}
+
+uint32_t OtaUpdater::activeMs() const
+{
+    return _activeMs + (_state == OTA_RECEIVING ? millis() - _startMs : 0);
+}
+
+uint32_t OtaUpdater::bytesPerSecond() const
+{
+    uint32_t ms = activeMs();
+    return ms ? (uint32_t)((uint64_t)_received * 1000 / ms) : 0;
+}
+
+void OtaUpdater::service()
+{
+    if (_state == OTA_PAUSED && millis() - _lastActivityMs > OTA_RESUME_TIMEOUT_MS)
+        abort("Resume timeout");
+}
+
+// ---------------------------------------------------------
+// Request
+// ---------------------------------------------------------
+// Tolak request tanpa mengganggu sesi yang sedang berjalan
+bool OtaUpdater::reject(const char *status, const char *reason)
+{
+    _httpStatus = status;
+    _error = reason;
+    return false;
+}
+
+// Sesi gagal: image dibuang
+bool OtaUpdater::fail(const char *status, const char *reason)
+{
+    if (_state == OTA_RECEIVING || _state == OTA_PAUSED)
+    {
+        waitIdle();
+        Update.abort();
+        resetBlocks();
+        _activeMs = activeMs();
+    }
+    _state = OTA_FAILED;
+    _httpStatus = status;
+    _error = reason;
+    Serial.print("OTA gagal: ");
+    Serial.println(reason);
+    return false;
+}
+
+void OtaUpdater::abort(const char *reason)
+{
+    if (_state == OTA_RECEIVING || _state == OTA_PAUSED)
+        fail("500 Error", reason);
+}
+
+bool OtaUpdater::start(uint32_t contentLength, const char *contentType, const char *query)
+{
+    if (_state == OTA_RECEIVING)
+        return reject("409 Conflict", "Update Busy");
+    if (contentLength == 0)
+        return reject("400 Bad Request", "Empty body");
+
+    String q = query;
+    uint32_t offset = getParam(q, "offset").toInt();
+    uint32_t size = getParam(q, "size").toInt();
+    bool multipart = strncasecmp(contentType, "multipart/form-data", 19) == 0;
+
+    _contentLength = contentLength;
+    _bodyReceived = 0;
+    _multipart = multipart;
+    _headerDone = !multipart;
+    _headerLen = 0;
+    _trailerMatched = 0;
+
+    if (offset > 0)
+    {
+        // Lanjutan: harus tepat di byte berikutnya dari sesi yang sama
+        if (_state != OTA_PAUSED || multipart)
+            return reject("409 Conflict", "No upload to resume");
+        if (offset != _received || size != _size)
+            return reject("409 Conflict", "Offset mismatch");
+        if (contentLength > _size - _received)
+            return reject("400 Bad Request", "Body exceeds image size");
+        _state = OTA_RECEIVING;
+        _error = "";
+        _startMs = _lastActivityMs = millis();
+        return true;
+    }
+
+    // Upload baru menggantikan sesi terputus
+    abort("Replaced by new upload");
+    _received = 0;
+    _written.store(0);
+    _writeError.store(false);
+    _activeMs = 0;
+    _md5[0] = '\0';
+    _error = "";
+    _httpStatus = "200 OK";
+    String md5 = getParam(q, "md5");
+    strncpy(_expectedMd5, md5.c_str(), sizeof(_expectedMd5) - 1);
+    _expectedMd5[sizeof(_expectedMd5) - 1] = '\0';
+    _state = OTA_RECEIVING;
+    _startMs = _lastActivityMs = millis();
+
+    if (multipart)
+    {
+        // Ukuran image baru diketahui setelah header part
+        const char *b = strstr(contentType, "boundary=");
+        if (!b)
+            return fail("400 Bad Request", "Missing boundary");
+        b += 9;
+        if (*b == '"')
+            b++;
+        size_t n = strcspn(b, "\";");
+        if (n == 0 || n > OTA_MAX_BOUNDARY)
+            return fail("400 Bad Request", "Bad boundary");
+        memcpy(_boundary, b, n);
+        _boundary[n] = '\0';
+        return true;
+    }
+
+    if (size == 0)
+        size = contentLength;
+    if (size < contentLength)
+        return fail("400 Bad Request", "Body exceeds image size");
+    return beginImage(size);
+}
+
+bool OtaUpdater::beginImage(uint32_t size)
+{
+    _size = size;
+    if (!Update.begin(size, U_FLASH))
+        return fail("500 Error", Update.errorString());
+    if (_expectedMd5[0] && !Update.setMD5(_expectedMd5))
+        return fail("400 Bad Request", "Bad MD5");
+    return true;
+}
+
+// Header part: "--boundary\r\n" ... "\r\n\r\n". Image = sisa body tanpa
+// penutup "\r\n--boundary--\r\n".
+bool OtaUpdater::parseMultipartHeader(const uint8_t *data, size_t len, size_t &used)
+{
+    while (used < len)
+    {
+        if (_headerLen >= sizeof(_header))
+            return fail("400 Bad Request", "Bad multipart");
+        _header[_headerLen++] = data[used++];
+        if (_headerLen < 4 || memcmp(_header + _headerLen - 4, "\r\n\r\n", 4) != 0)
+            continue;
+
+        size_t blen = strlen(_boundary);
+        if (_headerLen < blen + 2 || memcmp(_header, "--", 2) != 0 || memcmp(_header + 2, _boundary, blen) != 0)
+            return fail("400 Bad Request", "Bad multipart");
+        uint32_t overhead = _headerLen + blen + 8;
+        if (_contentLength <= overhead)
+            return fail("400 Bad Request", "Empty image");
+        _headerDone = true;
+        return beginImage(_contentLength - overhead);
+    }
+    return true;
+}
+
+size_t OtaUpdater::write(const uint8_t *data, size_t len)
+{
+    if (_state != OTA_RECEIVING)
+        return 0;
+
+    size_t used = 0;
+    if (!_headerDone && !parseMultipartHeader(data, len, used))
+        return used;
+
+    while (used < len && _headerDone && _received < _size)
+    {
+        Block &b = _blocks[_fill];
+        if (b.state.load(std::memory_order_acquire) != BLOCK_FREE)
+            break; // kedua blok masih ditulis: sisanya tunggu giliran berikutnya
+        size_t n = min(min(len - used, (size_t)(OTA_BLOCK_SIZE - b.length)), (size_t)(_size - _received));
+        memcpy(b.data + b.length, data + used, n);
+        b.length += n;
+        used += n;
+        _received += n;
+        if (b.length == OTA_BLOCK_SIZE || _received == _size)
+            submit();
+    }
+
+    if (_multipart && _headerDone && _received == _size)
+    {
+        // Penutup harus diawali "\r\n--boundary"; sisanya ("--\r\n") diabaikan
+        size_t blen = strlen(_boundary);
+        for (; used < len; used++, _trailerMatched++)
+        {
+            if (_trailerMatched >= blen + 4)
+                continue;
+            char expect = _trailerMatched < 4 ? "\r\n--"[_trailerMatched] : _boundary[_trailerMatched - 4];
+            if ((char)data[used] != expect)
+                return fail("400 Bad Request", "Bad multipart");
+        }
+    }
+
+    _bodyReceived += used;
+    _lastActivityMs = millis();
+    if (_writeError.load(std::memory_order_acquire))
+        fail("500 Error", Update.errorString());
+    return used;
+}
+
+bool OtaUpdater::finish()
+{
+    if (_state != OTA_RECEIVING)
+        return false;
+    if (!_headerDone)
+        return fail("400 Bad Request", "Bad multipart");
+
+    if (_received < _size)
+    {
+        // Body mentah berisi sebagian image: tunggu POST ?offset= berikutnya.
+        // Blok yang belum penuh tetap di RAM supaya tulis flash tetap per sektor.
+        _activeMs = activeMs();
+        _state = OTA_PAUSED;
+        _httpStatus = "202 Accepted";
+        return true;
+    }
+
+    if (!waitIdle())
+        return fail("500 Error", "Flash write timeout");
+    if (_writeError.load(std::memory_order_acquire))
+        return fail("500 Error", Update.errorString());
+    if (!Update.end())
+        return fail("500 Error", Update.errorString());
+
+    strncpy(_md5, Update.md5String().c_str(), sizeof(_md5) - 1);
+    _md5[sizeof(_md5) - 1] = '\0';
+    _activeMs = activeMs();
+    _state = OTA_DONE;
+    _httpStatus = "200 OK";
+    Serial.printf("OTA selesai: %lu byte, %lu B/s\n", (unsigned long)_received, (unsigned long)bytesPerSecond());
+    return true;
+}
+
+void OtaUpdater::interrupt()
+{
+    if (_state != OTA_RECEIVING)
+        return;
+    // Form multipart tidak bisa dilanjutkan dari tengah
+    if (_multipart)
+    {
+        abort("Connection lost");
+        return;
+    }
+    _activeMs = activeMs();
+    _state = OTA_PAUSED;
+    _lastActivityMs = millis();
+}
+
+// ---------------------------------------------------------
+// Serah-terima blok
+// ---------------------------------------------------------
+bool OtaUpdater::submit()
+{
+    Block &b = _blocks[_fill];
+    _fill = (_fill + 1) % OTA_BLOCKS;
+    if (!_task)
+    {
+        METRIC_SPAN(METRIC_FLASH_WRITE);
+        bool ok = Update.write(b.data, b.length) == b.length;
+        _written.fetch_add(b.length);
+        b.length = 0;
+        if (!ok)
+            _writeError.store(true);
+        return ok;
+    }
+    b.state.store(BLOCK_FULL, std::memory_order_release);
+    xTaskNotifyGive(_task);
+    return true;
+}
+
+bool OtaUpdater::waitIdle()
+{
+    uint32_t start = millis();
+    for (uint8_t i = 0; i < OTA_BLOCKS; i++)
+    {
+        while (_blocks[i].state.load(std::memory_order_acquire) != BLOCK_FREE)
+        {
+            if (millis() - start > OTA_FINISH_TIMEOUT_MS)
+                return false;
+            vTaskDelay(1);
+        }
+    }
+    return true;
+}
+
+// Hanya blok milik comms (sesudah waitIdle); _fill/_drain tetap berurutan
+void OtaUpdater::resetBlocks()
+{
+    _blocks[_fill].length = 0;
+}
+
+void OtaUpdater::taskEntry(void *arg)
+{
+    ((OtaUpdater *)arg)->run();
+}
+
+void OtaUpdater::run()
+{
+    uint8_t slot = taskMonitor.add("ota");
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        Block *b;
+        while ((b = &_blocks[_drain])->state.load(std::memory_order_acquire) == BLOCK_FULL)
+        {
+            uint32_t start = micros();
+            bool ok;
+            {
+                METRIC_SPAN(METRIC_FLASH_WRITE);
+                ok = Update.write(b->data, b->length) == b->length;
+            }
+            taskMonitor.busy(slot, micros() - start);
+            if (!ok)
+                _writeError.store(true, std::memory_order_release);
+            _written.fetch_add(b->length, std::memory_order_relaxed);
+            b->length = 0;
+            // Indeks maju dulu, baru blok dilepas (waitIdle = penulis benar-benar diam)
+            _drain = (_drain + 1) % OTA_BLOCKS;
+            b->state.store(BLOCK_FREE, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef OTAUPDATER_H
+#define OTAUPDATER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define OTA_BLOCK_SIZE 4096          // satu sektor flash per tulis
+#define OTA_BLOCKS 2                 // double buffer: satu diisi, satu ditulis
+#define OTA_MULTIPART_HEADER 512     // boundary + header part (Content-Disposition, ...)
+#define OTA_MAX_BOUNDARY 72          // RFC 2046: maks. 70 karakter
+#define OTA_RESUME_TIMEOUT_MS 120000 // upload terputus boleh dilanjutkan selama ini
+#define OTA_FINISH_TIMEOUT_MS 5000   // tunggu blok terakhir selesai ditulis
+#define OTA_TASK_STACK 4096
+#define OTA_TASK_PRIORITY 1          // di bawah task akuisisi (core yang sama)
+#define OTA_TASK_CORE 1
+
+enum OtaState : uint8_t
+{
+    OTA_IDLE,
+    OTA_RECEIVING,
+    OTA_PAUSED,   // koneksi putus, menunggu POST lanjutan (?offset=)
+    OTA_DONE,     // image terverifikasi, menunggu restart
+    OTA_FAILED
+};
+
+// ---------------------------------------------------------
+// OTA firmware: socket -> double buffer -> flash
+// ---------------------------------------------------------
+// Body POST /update diterima task comms per potongan (route streamBody)
+// dan disalin ke salah satu dari dua blok 4 KB. Blok yang penuh
+// diserahkan ke task "ota" (core 1, prioritas di bawah akuisisi) yang
+// memanggil Update.write(); sementara itu comms sudah mengisi blok
+// berikutnya dan tetap melayani request lain. Jika kedua blok masih
+// dipakai, write() hanya mengambil sebagian sehingga sisa body tetap di
+// buffer socket (backpressure TCP). Serah-terima per blok lewat state
+// atomik.
+//
+// Body boleh berupa image mentah atau multipart/form-data (form
+// UpdateOTA.html, hanya satu part). Query opsional:
+//   md5=HEX     digest MD5 image, dicek inkremental oleh Update (end())
+//   offset=N    lanjutkan upload mentah yang terputus mulai byte N
+//   size=N      ukuran total image (wajib jika offset > 0)
+// Body mentah yang lebih pendek dari size dijawab 202 dan sesi menunggu
+// potongan berikutnya, begitu juga upload yang terputus; keduanya ditahan
+// OTA_RESUME_TIMEOUT_MS. Byte yang sudah diterima (received) terlihat di
+// /updateStatus.
+//
+// Semua method kecuali task penulis dipanggil dari task comms.
+class OtaUpdater
+{
+public:
+    OtaUpdater();
+
+    void begin();
+    // Buang sesi terputus yang tidak dilanjutkan
+    void service();
+
+    // Awal request. false = ditolak, lihat httpStatus() / error()
+    bool start(uint32_t contentLength, const char *contentType, const char *query);
+    // Byte body yang diambil (kurang dari len jika kedua blok penuh)
+    size_t write(const uint8_t *data, size_t len);
+    // Seluruh body sudah diterima
+    bool bodyComplete() const { return _bodyReceived >= _contentLength; }
+    // Tulis blok terakhir, tunggu task penulis, verifikasi (Update.end)
+    bool finish();
+    // Koneksi putus: sesi mentah ditahan untuk dilanjutkan
+    void interrupt();
+    void abort(const char *reason);
+
+    OtaState state() const { return _state; }
+    const char *stateName() const;
+    const char *httpStatus() const { return _httpStatus; }
+    const char *error() const { return _error; }
+    uint32_t size() const { return _size; }
+    uint32_t received() const { return _received; }
+    uint32_t written() const { return _written.load(std::memory_order_relaxed); }
+    uint32_t activeMs() const;
+    uint32_t bytesPerSecond() const;
+    const char *md5() const { return _md5; }
+
+private:
+    enum BlockState : uint8_t
+    {
+        BLOCK_FREE,
+        BLOCK_FULL // milik task penulis
+    };
+
+    struct Block
+    {
+        uint8_t data[OTA_BLOCK_SIZE];
+        uint16_t length;
+        std::atomic<uint8_t> state;
+    };
+
+    static void taskEntry(void *arg);
+    void run();
+
+    bool reject(const char *status, const char *reason);
+    bool fail(const char *status, const char *reason);
+    bool parseMultipartHeader(const uint8_t *data, size_t len, size_t &used);
+    bool beginImage(uint32_t size);
+    bool submit();
+    bool waitIdle();
+    void resetBlocks();
+
+    Block _blocks[OTA_BLOCKS];
+    uint8_t _fill;  // blok yang sedang diisi comms
+    uint8_t _drain; // blok berikutnya untuk task penulis
+    TaskHandle_t _task;
+    std::atomic<uint32_t> _written;
+    std::atomic<bool> _writeError;
+
+    OtaState _state;
+    const char *_httpStatus;
+    const char *_error;
+    char _expectedMd5[33];
+    char _md5[33];          // hasil Update setelah end()
+
+    // Request yang sedang berjalan
+    uint32_t _contentLength;
+    uint32_t _bodyReceived;
+    bool _multipart;
+    bool _headerDone;
+    char _boundary[OTA_MAX_BOUNDARY + 1];
+    char _header[OTA_MULTIPART_HEADER];
+    uint16_t _headerLen;
+    uint32_t _trailerMatched; // byte penutup "\r\n--boundary" yang sudah dicek
+
+    // Sesi image (bisa lintas request jika dilanjutkan)
+    uint32_t _size;
+    uint32_t _received;
+    uint32_t _startMs;      // awal koneksi yang sedang berjalan
+    uint32_t _activeMs;     // total durasi koneksi sebelumnya
+    uint32_t _lastActivityMs;
+};
+
+extern OtaUpdater ota;
+
+#endif // OTAUPDATER_H
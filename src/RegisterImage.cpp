@@ -0,0 +1,61 @@
+#include "RegisterImage.h"
+
+RegisterImage registers;
+
+RegisterImage::RegisterImage() : _seq(0), _retries(0)
+{
+    memset(_regs, 0, sizeof(_regs));
+}
+
+void RegisterImage::beginWrite()
+{
+    portENTER_CRITICAL(&_writer);
+    _seq++; // ganjil: update sedang berjalan
+    __sync_synchronize();
+}
+
+void RegisterImage::endWrite()
+{
+    __sync_synchronize();
+    _seq++;
+    portEXIT_CRITICAL(&_writer);
+}
+
+void RegisterImage::set(uint16_t addr, uint16_t value)
+{
+    if (addr < REG_IMAGE_SIZE)
+        _regs[addr] = value;
+}
+
+void RegisterImage::setU32(uint16_t addr, uint32_t value)
+{
+    set(addr, value >> 16);
+    set(addr + 1, value & 0xFFFF);
+}
+
+void RegisterImage::setFloat(uint16_t addr, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    setU32(addr, bits);
+}
+
+bool RegisterImage::read(uint16_t start, uint16_t count, uint16_t *out) const
+{
+    if ((uint32_t)start + count > REG_IMAGE_SIZE)
+        return false;
+    for (;;)
+    {
+        uint32_t before = _seq;
+        __sync_synchronize();
+        if (!(before & 1))
+        {
+            memcpy(out, (const void *)(_regs + start), count * sizeof(uint16_t));
+            __sync_synchronize();
+            if (_seq == before)
+                return true;
+        }
+        _retries++;
+        yield();
+    }
+}
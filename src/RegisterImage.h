@@ -0,0 +1,53 @@
+#ifndef REGISTERIMAGE_H
+#define REGISTERIMAGE_H
+
+#include <Arduino.h>
+
+#define REG_IMAGE_SIZE 128
+
+// Peta register (sama untuk FC 3 dan FC 4)
+#define REG_AI_VALUE 0    // AI1..AI4 nilai kalibrasi, float32 2 register (word tinggi dulu)
+#define REG_AI_X100 8     // AI1..AI4 nilai kalibrasi x100, int16
+#define REG_AI_RAW 12     // AI1..AI4 raw (13107..65535)
+#define REG_DI_VALUE 16   // DI1..DI4 (16 bit bawah)
+#define REG_UPTIME 20     // uptime detik, uint32 2 register
+#define REG_STATUS 22     // bit 0 link, bit 8..11 AI aktif
+#define REG_SEQ 23        // naik setiap update analog
+#define REG_TAG_FIRST 31  // nilai mentah tag RTU di offsetAddress (31..100)
+#define REG_TAG_LAST 100
+
+// ---------------------------------------------------------
+// Register image bersama (seqlock)
+// ---------------------------------------------------------
+// Writer (loop sampling, task modbus RTU) membungkus update dengan
+// beginWrite()/endWrite(); antar writer diserialkan spinlock. Reader
+// (server Modbus TCP) tidak pernah mengunci: salin range, lalu ulangi
+// jika nomor urut berubah atau ganjil di tengah jalan. Jadi pembacaan
+// tidak menahan sampling dan tidak pernah melihat update setengah jadi
+// (mis. float32 yang baru satu word-nya tertulis).
+class RegisterImage
+{
+public:
+    RegisterImage();
+
+    void beginWrite();
+    void endWrite();
+    // Hanya di antara beginWrite()/endWrite()
+    void set(uint16_t addr, uint16_t value);
+    void setU32(uint16_t addr, uint32_t value);
+    void setFloat(uint16_t addr, float value);
+
+    // Salinan konsisten register [start, start + count); false jika di luar image
+    bool read(uint16_t start, uint16_t count, uint16_t *out) const;
+    uint32_t retries() const { return _retries; }
+
+private:
+    uint16_t _regs[REG_IMAGE_SIZE];
+    volatile uint32_t _seq;
+    mutable volatile uint32_t _retries;
+    portMUX_TYPE _writer = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern RegisterImage registers;
+
+#endif // REGISTERIMAGE_H
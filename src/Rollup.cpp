@@ -0,0 +1,90 @@
+#include "Rollup.h"
+
+RollupEngine rollups;
+
+struct RollupLevel
+{
+    uint32_t resolution; // detik per bucket
+    uint16_t capacity;   // slot ring
+    uint16_t offset;     // posisi di RollupEngine::_buckets[ch]
+};
+
+// 2 menit, 2 jam, 24 jam, 7 hari (+1 slot untuk bucket yang sedang berjalan)
+static const RollupLevel levels[ROLLUP_LEVELS] = {
+    {1, 121, 0},
+    {60, 121, 121},
+    {900, 97, 242},
+    {3600, 169, 339},
+};
+
+static_assert(339 + 169 == ROLLUP_BUCKETS, "ROLLUP_BUCKETS must match the level table");
+
+RollupEngine::RollupEngine()
+{
+    memset(_buckets, 0, sizeof(_buckets));
+}
+
+uint32_t RollupEngine::resolution(uint8_t level)
+{
+    return levels[level].resolution;
+}
+
+uint16_t RollupEngine::capacity(uint8_t level)
+{
+    return levels[level].capacity;
+}
+
+void RollupEngine::add(uint8_t channel, uint32_t time, const RollupSample &s)
+{
+    if (channel >= ROLLUP_CHANNELS || s.count == 0)
+        return;
+    for (uint8_t l = 0; l < ROLLUP_LEVELS; l++)
+    {
+        const RollupLevel &lv = levels[l];
+        uint32_t slot = time / lv.resolution;
+        uint32_t start = slot * lv.resolution;
+        RollupBucket &b = _buckets[channel][lv.offset + slot % lv.capacity];
+        if (b.count == 0 || b.time != start)
+        {
+            // Slot kosong atau masih berisi putaran ring sebelumnya
+            b.time = start;
+            b.min = s.min;
+            b.max = s.max;
+            b.sum = s.sum;
+            b.count = s.count;
+            continue;
+        }
+        if (s.min < b.min)
+            b.min = s.min;
+        if (s.max > b.max)
+            b.max = s.max;
+        b.sum += s.sum;
+        b.count += s.count;
+    }
+}
+
+uint8_t RollupEngine::pickLevel(uint32_t from, uint32_t to, uint16_t points, uint32_t now) const
+{
+    uint32_t span = to > from ? to - from : 0;
+    for (uint8_t l = 0; l < ROLLUP_LEVELS; l++)
+    {
+        const RollupLevel &lv = levels[l];
+        uint32_t kept = lv.resolution * (lv.capacity - 1); // bucket berjalan ikut dihitung
+        bool covers = from >= now || now - from <= kept;
+        if (covers && span / lv.resolution < points)
+            return l;
+    }
+    return ROLLUP_LEVELS - 1;
+}
+
+bool RollupEngine::bucket(uint8_t level, uint8_t channel, uint32_t time, RollupBucket &out) const
+{
+    if (level >= ROLLUP_LEVELS || channel >= ROLLUP_CHANNELS)
+        return false;
+    const RollupLevel &lv = levels[level];
+    const RollupBucket &b = _buckets[channel][lv.offset + (time / lv.resolution) % lv.capacity];
+    if (b.count == 0 || b.time != time)
+        return false;
+    out = b;
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <Arduino.h>
+#include <float.h>
+
+#define ROLLUP_CHANNELS 4     // AI1..AI4 (nilai terkalibrasi), nomor = channel log
+#define ROLLUP_LEVELS 4
+#define ROLLUP_BUCKETS 508    // total slot per channel, lihat tabel level di Rollup.cpp
+#define ROLLUP_MAX_POINTS 400 // titik per series per respons
+
+// Agregat sementara (mis. semua sampel dalam satu frame 100 ms)
+struct RollupSample
+{
+    float min;
+    float max;
+    float sum;
+    uint32_t count;
+
+    void reset()
+    {
+        min = FLT_MAX;
+        max = -FLT_MAX;
+        sum = 0;
+        count = 0;
+    }
+    void add(float v)
+    {
+        if (v < min)
+            min = v;
+        if (v > max)
+            max = v;
+        sum += v;
+        count++;
+    }
+};
+
+struct RollupBucket
+{
+    uint32_t time; // awal bucket (detik jam log), kelipatan resolusi
+    float min;
+    float max;
+    uint32_t count; // 0 = kosong
+    double sum;     // bucket 1 jam bisa berisi ~800 ribu sampel
+};
+
+// ---------------------------------------------------------
+// Agregasi min/max/mean/count multi-resolusi
+// ---------------------------------------------------------
+// Tiap channel punya ring bucket per level (1 s, 1 min, 15 min, 1 h).
+// add() menggabungkan satu agregat ke bucket yang sedang berjalan di
+// semua level sekaligus (O(level), tanpa kaskade); slot ring yang
+// ditimpa dikenali dari waktu bucket-nya. Query memilih level paling
+// halus yang masih mencakup range dengan <= points titik, sehingga
+// grafik 7 hari tetap ~170 titik.
+// Tidak thread-safe: add() dan query dari task comms.
+class RollupEngine
+{
+public:
+    RollupEngine();
+
+    void add(uint8_t channel, uint32_t time, const RollupSample &s);
+
+    // Level terbaik untuk range [from, to] dengan maks. points titik
+    uint8_t pickLevel(uint32_t from, uint32_t to, uint16_t points, uint32_t now) const;
+    static uint32_t resolution(uint8_t level);
+    static uint16_t capacity(uint8_t level);
+
+    // Bucket yang dimulai pada time (harus kelipatan resolusi)
+    bool bucket(uint8_t level, uint8_t channel, uint32_t time, RollupBucket &out) const;
+
+private:
+    RollupBucket _buckets[ROLLUP_CHANNELS][ROLLUP_BUCKETS];
+};
+
+extern RollupEngine rollups;
+
+#endif // ROLLUP_H
@@ -0,0 +1,74 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// ---------------------------------------------------------
+// Ring buffer lock-free Single-Producer / Single-Consumer
+// ---------------------------------------------------------
+// Producer hanya menulis _head, consumer hanya menulis _tail, jadi
+// tidak perlu mutex. N harus kelipatan 2 (power of two) supaya indeks
+// cukup di-mask. Jika penuh, push() menolak item baru dan menaikkan
+// counter dropped() (data lama yang belum dibaca tidak ditimpa).
+template <typename T, size_t N>
+class SampleRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SampleRing size must be a power of two");
+
+public:
+    bool push(const T &item)
+    {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+        if (head - tail >= N)
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _buf[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t head = _head.load(std::memory_order_acquire);
+        if (head == tail)
+            return false;
+        item = _buf[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Ambil sampai maxItems item sekaligus (satu kali update _tail)
+    size_t popBlock(T *out, size_t maxItems)
+    {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t head = _head.load(std::memory_order_acquire);
+        size_t n = head - tail;
+        if (n > maxItems)
+            n = maxItems;
+        for (size_t i = 0; i < n; i++)
+            out[i] = _buf[(tail + i) & (N - 1)];
+        _tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return N; }
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    T _buf[N];
+    std::atomic<uint32_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+    std::atomic<uint32_t> _dropped{0};
+};
+
+#endif // SAMPLERING_H
@@ -0,0 +1,187 @@
+#include "SampleStream.h"
+
+SampleStream sampleStream;
+
+SampleStream::SampleStream()
+    : _mode(STREAM_OFF), _mask(0), _seq(0), _pending(0), _sent(0), _frames(0)
+{
+    for (uint8_t i = 0; i < STREAM_CHANNELS; i++)
+    {
+        _building[i].type = STREAM_OFF;
+        _building[i].channel = i;
+        _building[i].count = 0;
+    }
+}
+
+void SampleStream::setMode(StreamMode mode, uint8_t channelMask)
+{
+    _mask.store(channelMask & 0x0F, std::memory_order_relaxed);
+    _mode.store(mode, std::memory_order_relaxed);
+}
+
+void SampleStream::add(uint8_t channel, const int16_t *codes, const int32_t *eng, size_t count,
+                       uint32_t firstUs, uint32_t lastUs)
+{
+    StreamBlock &b = _building[channel];
+    StreamMode m = mode();
+    if (m == STREAM_OFF || !(channelMask() & (1 << channel)) || b.type != m)
+    {
+        // Mode / channel berubah: blok setengah jadi dibuang
+        b.type = m;
+        b.count = 0;
+        if (m == STREAM_OFF || !(channelMask() & (1 << channel)))
+            return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t t = count > 1 ? firstUs + (uint32_t)((uint64_t)(lastUs - firstUs) * i / (count - 1)) : lastUs;
+        // Celah panjang (channel sempat nonaktif): blok lama dikirim apa adanya
+        if (b.count > 0 && t - b.lastUs >= STREAM_BLOCK_US)
+            queue(b);
+        if (b.count == 0)
+            b.firstUs = t;
+        b.values[b.count++] = m == STREAM_RAW ? codes[i] : eng[i];
+        b.lastUs = t;
+        if (b.count == STREAM_BLOCK_MAX)
+            queue(b);
+    }
+    if (b.count > 0 && b.lastUs - b.firstUs >= STREAM_BLOCK_US)
+        queue(b);
+}
+
+// Penuh -> blok dibuang (dropped), terlihat sebagai lompatan seq di host
+void SampleStream::queue(StreamBlock &block)
+{
+    _ring.push(block);
+    block.count = 0;
+}
+
+uint16_t SampleStream::crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+// COBS: setiap 0x00 diganti jarak ke 0x00 berikutnya, jadi 0x00 hanya
+// muncul sebagai pemisah frame
+size_t SampleStream::cobsEncode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t codePos = 0;
+    size_t o = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (in[i] == 0)
+        {
+            out[codePos] = code;
+            codePos = o++;
+            code = 1;
+            continue;
+        }
+        out[o++] = in[i];
+        if (++code == 0xFF)
+        {
+            out[codePos] = code;
+            codePos = o++;
+            code = 1;
+        }
+    }
+    out[codePos] = code;
+    out[o++] = 0x00;
+    return o;
+}
+
+static uint8_t *putU16(uint8_t *p, uint16_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static uint8_t *putU32(uint8_t *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+size_t SampleStream::buildFrame(const StreamBlock &block)
+{
+    uint8_t *p = _frame;
+    *p++ = block.type;
+    *p++ = block.channel;
+    p = putU16(p, _seq++);
+    p = putU32(p, block.firstUs);
+    p = putU32(p, block.lastUs);
+    *p++ = block.count;
+    for (uint8_t i = 0; i < block.count; i++)
+    {
+        if (block.type == STREAM_RAW)
+            p = putU16(p, (uint16_t)block.values[i]);
+        else
+            p = putU32(p, (uint32_t)block.values[i]);
+    }
+    p = putU16(p, crc16(_frame, p - _frame));
+    return p - _frame;
+}
+
+void SampleStream::writePending(HardwareSerial &port, bool block)
+{
+    while (_pending > 0)
+    {
+        size_t n = _pending;
+        if (!block)
+        {
+            int room = port.availableForWrite();
+            if (room <= 0)
+                return;
+            n = min(n, (size_t)room);
+        }
+        n = port.write(_encoded + _sent, n);
+        _sent += n;
+        _pending -= n;
+        if (n == 0 && !block)
+            return;
+    }
+}
+
+void SampleStream::service(HardwareSerial &port)
+{
+    if (mode() == STREAM_OFF)
+    {
+        // Stream dimatikan: frame terakhir diselesaikan, sisa antrean dibuang
+        writePending(port, false);
+        while (_ring.pop(_block))
+        {
+        }
+        return;
+    }
+
+    for (;;)
+    {
+        writePending(port, false);
+        if (_pending > 0)
+            return; // TX UART penuh, lanjut di putaran comms berikutnya
+        if (!_ring.pop(_block))
+            return;
+        size_t len = buildFrame(_block);
+        _encoded[0] = 0x00; // pisahkan dari teks yang mungkin tercetak sebelumnya
+        _pending = 1 + cobsEncode(_frame, len, _encoded + 1);
+        _sent = 0;
+        _frames++;
+    }
+}
+
+void SampleStream::flush(HardwareSerial &port)
+{
+    writePending(port, true);
+}
@@ -0,0 +1,99 @@
+#ifndef SAMPLESTREAM_H
+#define SAMPLESTREAM_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "SampleRing.h"
+
+#define STREAM_CHANNELS 4
+#define STREAM_BLOCK_MAX 64     // sampel per frame
+#define STREAM_BLOCK_US 100000  // umur blok maks. sebelum dikirim (rate rendah)
+#define STREAM_RING_SIZE 8      // blok antre dari task akuisisi ke comms
+#define STREAM_HEADER_SIZE 13 // type, channel, seq, t0, t1, count
+#define STREAM_FRAME_MAX (STREAM_HEADER_SIZE + STREAM_BLOCK_MAX * 4 + 2)
+// COBS: +1 byte per 254 byte data, +1 byte awal, delimiter 0x00 di depan & belakang
+#define STREAM_ENCODED_MAX (STREAM_FRAME_MAX + STREAM_FRAME_MAX / 254 + 3)
+
+enum StreamMode : uint8_t
+{
+    STREAM_OFF,
+    STREAM_RAW = 1, // kode ADC int16 (type frame = 1)
+    STREAM_ENG = 2  // nilai teknik milli-unit int32 (type frame = 2)
+};
+
+// Satu blok sampel satu channel (= satu frame)
+struct StreamBlock
+{
+    uint32_t firstUs; // micros() RDY sampel pertama
+    uint32_t lastUs;  // micros() RDY sampel terakhir
+    uint8_t type;     // StreamMode saat blok dibuat
+    uint8_t channel;
+    uint8_t count;
+    int32_t values[STREAM_BLOCK_MAX]; // kode (RAW) atau milli-unit (ENG)
+};
+
+// ---------------------------------------------------------
+// Streaming sampel biner lewat serial (frame COBS + CRC16)
+// ---------------------------------------------------------
+// Task akuisisi mengumpulkan sampel per channel menjadi blok (penuh
+// STREAM_BLOCK_MAX sampel atau berumur STREAM_BLOCK_US) lalu menaruhnya
+// ke ring SPSC tanpa menunggu; task comms membungkusnya jadi frame dan menulis hanya
+// sebanyak ruang TX UART (availableForWrite), jadi loop comms tidak
+// pernah tertahan serial. Blok yang tidak sempat terkirim dibuang dan
+// terlihat sebagai lompatan seq di host.
+//
+// Frame (little-endian) sebelum COBS:
+//   u8 type (1 = RAW int16, 2 = ENG int32), u8 channel (0..3), u16 seq,
+//   u32 t0 (us), u32 t1 (us), u8 count, count x nilai, u16 CRC-16/CCITT
+//   (poly 0x1021, init 0xFFFF) atas semua byte sebelumnya.
+// Setiap frame diapit 0x00 sehingga teks console / log di antara frame
+// menjadi paket tersendiri yang gagal CRC dan diabaikan decoder
+// (tools/stream_decode.c).
+class SampleStream
+{
+public:
+    SampleStream();
+
+    // Task comms
+    void setMode(StreamMode mode, uint8_t channelMask);
+    StreamMode mode() const { return (StreamMode)_mode.load(std::memory_order_relaxed); }
+    bool active() const { return mode() != STREAM_OFF; }
+    uint8_t channelMask() const { return _mask.load(std::memory_order_relaxed); }
+    // Kirim sebanyak ruang TX tanpa menunggu
+    void service(HardwareSerial &port);
+    // Selesaikan frame yang setengah terkirim (blocking, sebelum teks console)
+    void flush(HardwareSerial &port);
+    uint32_t frames() const { return _frames; }
+    uint32_t dropped() const { return _ring.dropped(); }
+
+    // Task akuisisi: potongan sampel satu channel dari readSensors(), waktu
+    // sampel di antara firstUs dan lastUs diinterpolasi. Diabaikan jika
+    // channel tidak di-stream.
+    void add(uint8_t channel, const int16_t *codes, const int32_t *eng, size_t count,
+             uint32_t firstUs, uint32_t lastUs);
+
+    static uint16_t crc16(const uint8_t *data, size_t len);
+    // Mengembalikan panjang hasil termasuk delimiter 0x00
+    static size_t cobsEncode(const uint8_t *in, size_t len, uint8_t *out);
+
+private:
+    void queue(StreamBlock &block);
+    size_t buildFrame(const StreamBlock &block);
+    void writePending(HardwareSerial &port, bool block);
+
+    std::atomic<uint8_t> _mode;
+    std::atomic<uint8_t> _mask;
+    StreamBlock _building[STREAM_CHANNELS]; // milik task akuisisi
+    SampleRing<StreamBlock, STREAM_RING_SIZE> _ring;
+    uint16_t _seq;
+    StreamBlock _block;
+    uint8_t _frame[STREAM_FRAME_MAX];
+    uint8_t _encoded[STREAM_ENCODED_MAX];
+    size_t _pending; // byte _encoded yang belum terkirim
+    size_t _sent;
+    uint32_t _frames;
+};
+
+extern SampleStream sampleStream;
+
+#endif // SAMPLESTREAM_H
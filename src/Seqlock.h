@@ -0,0 +1,53 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// ---------------------------------------------------------
+// Nilai terakhir dengan seqlock (satu writer, banyak reader)
+// ---------------------------------------------------------
+// Writer tidak pernah menunggu reader: nomor urut dibuat ganjil selama
+// menulis, reader menyalin lalu mengulang jika nomor berubah. Cocok untuk
+// struct kecil yang ditulis task berprioritas tinggi (akuisisi) dan
+// dibaca task lain (web, modbus) tanpa mutex.
+template <typename T>
+class Seqlock
+{
+public:
+    Seqlock() : _value() {}
+
+    void write(const T &value)
+    {
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy((void *)&_value, &value, sizeof(T));
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Salinan konsisten; mengembalikan nomor urut (genap, 0 = belum ditulis)
+    uint32_t read(T &out) const
+    {
+        for (;;)
+        {
+            uint32_t before = _seq.load(std::memory_order_acquire);
+            if (!(before & 1))
+            {
+                memcpy(&out, (const void *)&_value, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_seq.load(std::memory_order_relaxed) == before)
+                    return before;
+            }
+            yield();
+        }
+    }
+
+    uint32_t seq() const { return _seq.load(std::memory_order_acquire); }
+
+private:
+    T _value;
+    std::atomic<uint32_t> _seq{0};
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,74 @@
+#include "SerialConsole.h"
+
+bool SerialConsole::poll()
+{
+    while (_in.available() > 0)
+    {
+        int c = _in.read();
+        if (c < 0)
+            break;
+        if (c == '\r' || c == '\n')
+        {
+            bool ready = _len > 0 && !_overflow;
+            if (_overflow)
+                _len = 0;
+            _overflow = false;
+            if (ready)
+            {
+                _line[_len] = '\0';
+                return true;
+            }
+            continue;
+        }
+        if (c == '\b' || c == 0x7F)
+        {
+            if (_len > 0)
+                _len--;
+            continue;
+        }
+        if (_len >= CONSOLE_LINE_MAX)
+        {
+            _overflow = true;
+            continue;
+        }
+        _line[_len++] = (char)c;
+    }
+    return false;
+}
+
+void SerialConsole::execute(Print &out)
+{
+    char *argv[CONSOLE_MAX_ARGS];
+    uint8_t argc = 0;
+    char *save = nullptr;
+    for (char *tok = strtok_r(_line, " =\t", &save); tok && argc < CONSOLE_MAX_ARGS;
+         tok = strtok_r(nullptr, " =\t", &save))
+        argv[argc++] = tok;
+    _len = 0;
+    if (argc == 0)
+        return;
+
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (strcasecmp(argv[0], _commands[i].name) == 0)
+        {
+            _commands[i].handler(argc, argv, out);
+            return;
+        }
+    }
+    out.print("Unknown command: ");
+    out.println(argv[0]);
+    printHelp(out);
+}
+
+void SerialConsole::printHelp(Print &out) const
+{
+    out.println("Commands:");
+    for (size_t i = 0; i < _count; i++)
+    {
+        out.print("  ");
+        out.print(_commands[i].name);
+        out.print(' ');
+        out.println(_commands[i].usage);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef SERIALCONSOLE_H
+#define SERIALCONSOLE_H
+
+#include <Arduino.h>
+
+#define CONSOLE_LINE_MAX 96 // panjang baris perintah maks. (tanpa '\n')
+#define CONSOLE_MAX_ARGS 6  // nama perintah + argumen
+
+// Satu perintah console. argv[0] = nama perintah
+struct ConsoleCommand
+{
+    const char *name;
+    void (*handler)(uint8_t argc, char **argv, Print &out);
+    const char *usage;
+};
+
+// ---------------------------------------------------------
+// Console serial non-blocking
+// ---------------------------------------------------------
+// poll() hanya mengambil byte yang sudah ada di buffer RX, jadi task
+// comms tidak pernah menunggu timeout readStringUntil(). Baris dipecah
+// pada spasi, tab dan '=' (perintah lama "m=1.5" tetap jalan) lalu
+// dicocokkan ke tabel perintah (nama tidak peka huruf besar/kecil).
+// Backspace didukung; baris yang terlalu panjang dibuang.
+class SerialConsole
+{
+public:
+    SerialConsole(Stream &in, const ConsoleCommand *commands, size_t count)
+        : _in(in), _commands(commands), _count(count), _len(0), _overflow(false) {}
+
+    // true jika satu baris lengkap siap dijalankan
+    bool poll();
+    // Jalankan baris terakhir, balasan ke out
+    void execute(Print &out);
+    void printHelp(Print &out) const;
+
+private:
+    Stream &_in;
+    const ConsoleCommand *_commands;
+    size_t _count;
+    char _line[CONSOLE_LINE_MAX + 1];
+    uint8_t _len;
+    bool _overflow;
+};
+
+#endif // SERIALCONSOLE_H
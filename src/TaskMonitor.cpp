@@ -0,0 +1,44 @@
+#include "TaskMonitor.h"
+
+TaskMonitor taskMonitor;
+
+TaskMonitor::TaskMonitor() : _lastUpdateUs(0), _count(0)
+{
+    memset(_tasks, 0, sizeof(_tasks));
+    for (uint8_t i = 0; i < TASK_MONITOR_MAX; i++)
+    {
+        _busyUs[i] = 0;
+        _lastBusyUs[i] = 0;
+    }
+}
+
+uint8_t TaskMonitor::add(const char *name)
+{
+    // Task bisa mendaftar bersamaan dari dua core
+    portENTER_CRITICAL(&_lock);
+    uint8_t slot = _count < TASK_MONITOR_MAX ? _count++ : TASK_MONITOR_MAX;
+    portEXIT_CRITICAL(&_lock);
+    if (slot >= TASK_MONITOR_MAX)
+        return slot;
+    TaskInfo &t = _tasks[slot];
+    strncpy(t.name, name, TASK_NAME_LEN - 1);
+    t.handle = xTaskGetCurrentTaskHandle();
+    t.core = xPortGetCoreID();
+    return slot;
+}
+
+void TaskMonitor::update()
+{
+    uint32_t now = micros();
+    uint32_t window = now - _lastUpdateUs;
+    _lastUpdateUs = now;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        TaskInfo &t = _tasks[i];
+        uint32_t busy = _busyUs[i];
+        uint32_t delta = busy - _lastBusyUs[i];
+        _lastBusyUs[i] = busy;
+        t.load = window ? delta * 100.0f / window : 0;
+        t.stackFree = uxTaskGetStackHighWaterMark(t.handle);
+    }
+}
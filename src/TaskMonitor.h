@@ -0,0 +1,53 @@
+#ifndef TASKMONITOR_H
+#define TASKMONITOR_H
+
+#include <Arduino.h>
+
+#define TASK_MONITOR_MAX 6
+#define TASK_NAME_LEN 12
+
+struct TaskInfo
+{
+    char name[TASK_NAME_LEN];
+    TaskHandle_t handle;
+    uint8_t core;
+    uint32_t stackFree;  // high-water mark (byte tersisa terkecil)
+    float load;          // % waktu sibuk di jendela terakhir
+};
+
+// ---------------------------------------------------------
+// Statistik task: stack high-water & beban CPU
+// ---------------------------------------------------------
+// Run-time stats FreeRTOS tidak aktif di core Arduino, jadi tiap task
+// melaporkan sendiri lama kerjanya lewat busy() (hanya task itu yang
+// menulis slot-nya). update() dipanggil sekali per detik untuk
+// menghitung beban per jendela dan membaca stack high-water.
+class TaskMonitor
+{
+public:
+    TaskMonitor();
+
+    // Dipanggil dari task yang didaftarkan; mengembalikan slot
+    uint8_t add(const char *name);
+    void busy(uint8_t slot, uint32_t us)
+    {
+        if (slot < TASK_MONITOR_MAX)
+            _busyUs[slot] += us;
+    }
+
+    void update();
+    uint8_t count() const { return _count; }
+    const TaskInfo &task(uint8_t i) const { return _tasks[i]; }
+
+private:
+    TaskInfo _tasks[TASK_MONITOR_MAX];
+    volatile uint32_t _busyUs[TASK_MONITOR_MAX];
+    uint32_t _lastBusyUs[TASK_MONITOR_MAX];
+    uint32_t _lastUpdateUs;
+    uint8_t _count;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern TaskMonitor taskMonitor;
+
+#endif // TASKMONITOR_H
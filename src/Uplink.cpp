@@ -0,0 +1,513 @@
+#include "Uplink.h"
+#include "DataLogger.h"
+#include "Metrics.h"
+#include "TaskMonitor.h"
+
+Uplink uplink;
+
+#define UPLINK_CURSOR_MAGIC 0x55504C31UL // "UPL1"
+
+#define MQTT_CONNECT 0x10
+#define MQTT_CONNACK 0x20
+#define MQTT_PUBLISH_QOS1 0x32
+#define MQTT_PUBACK 0x40
+#define MQTT_PINGREQ 0xC0
+#define MQTT_PINGRESP 0xD0
+
+struct UplinkCursorFile
+{
+    uint32_t magic;
+    uint32_t time;
+};
+
+static char mqttClientId[24];
+
+Uplink::Uplink()
+    : _state(STATE_IDLE), _task(nullptr), _enabled(false), _intervalMs(10000), _nextMs(0),
+      _retryMs(0), _cursor(0), _savedCursor(0), _savedMs(0), _appendedAtBuild(0), _sent(0),
+      _sentRecords(0), _failures(0), _error(""), _mqttActivityMs(0), _packetId(0), _sendError("")
+{
+    memset(&_target, 0, sizeof(_target));
+    memset(&_mqttTarget, 0, sizeof(_mqttTarget));
+}
+
+void Uplink::begin()
+{
+    uint8_t mac[6];
+    Ethernet.macAddress(mac);
+    snprintf(mqttClientId, sizeof(mqttClientId), "node-%02x%02x%02x%02x%02x%02x",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    loadCursor();
+    _nextMs = millis();
+    if (xTaskCreatePinnedToCore(taskEntry, "uplink", UPLINK_TASK_STACK, this,
+                                UPLINK_TASK_PRIORITY, &_task, UPLINK_TASK_CORE) != pdPASS)
+    {
+        Serial.println("Uplink: task gagal dibuat.");
+        _task = nullptr;
+    }
+}
+
+// ---------------------------------------------------------
+// Config
+// ---------------------------------------------------------
+// endpoint: "http://host[:port]/path" (HTTP) atau "host" / "mqtt://host[:port]"
+// (MQTT). Port di URL didahulukan, lalu "port" dari config, lalu default
+// skema. HTTPS belum didukung (W5500 tanpa TLS).
+bool Uplink::parseEndpoint(const NetworkConfig &net, UplinkTarget &t)
+{
+    memset(&t, 0, sizeof(t));
+    if (strcmp(net.protocolMode, "HTTP") == 0)
+        t.protocol = UPLINK_HTTP;
+    else if (strcmp(net.protocolMode, "MQTT") == 0)
+        t.protocol = UPLINK_MQTT;
+    else
+        return false;
+
+    const char *p = net.endpoint;
+    uint16_t defaultPort = t.protocol == UPLINK_HTTP ? 80 : 1883;
+    if (strncmp(p, "https://", 8) == 0 || strncmp(p, "mqtts://", 8) == 0)
+        return false;
+    const char *scheme = strstr(p, "://");
+    if (scheme)
+        p = scheme + 3;
+
+    size_t hostLen = strcspn(p, ":/");
+    if (hostLen == 0 || hostLen >= sizeof(t.host))
+        return false;
+    memcpy(t.host, p, hostLen);
+    p += hostLen;
+    t.port = net.port ? net.port : defaultPort;
+    if (*p == ':')
+    {
+        t.port = strtoul(p + 1, nullptr, 10);
+        p += 1 + strspn(p + 1, "0123456789");
+    }
+    strncpy(t.path, *p == '/' ? p : "/", sizeof(t.path) - 1);
+    strncpy(t.topic, net.pubTopic, sizeof(t.topic) - 1);
+    strncpy(t.username, net.mqttUsername, sizeof(t.username) - 1);
+    strncpy(t.password, net.mqttPass, sizeof(t.password) - 1);
+    return t.port != 0;
+}
+
+void Uplink::configure(const NetworkConfig &net)
+{
+    _intervalMs = net.sendInterval * 1000UL;
+    if (_intervalMs < UPLINK_MIN_INTERVAL_MS)
+        _intervalMs = UPLINK_MIN_INTERVAL_MS;
+    _enabled = false;
+    if (!net.loggerMode)
+        return;
+    // Trigger DI belum ada: hanya "Time/interval"
+    if (strncmp(net.sendTrig, "Time", 4) != 0)
+    {
+        _error = "sendTrig tidak didukung";
+        return;
+    }
+    if (!parseEndpoint(net, _target))
+    {
+        _error = "endpoint tidak didukung";
+        return;
+    }
+    _enabled = true;
+    _error = "";
+}
+
+// ---------------------------------------------------------
+// Cursor
+// ---------------------------------------------------------
+void Uplink::loadCursor()
+{
+    UplinkCursorFile c = {0, 0};
+    File f = LittleFS.open(UPLINK_CURSOR_PATH, "r");
+    if (f)
+    {
+        f.read((uint8_t *)&c, sizeof(c));
+        f.close();
+    }
+    // Belum pernah kirim: mulai dari sekarang, bukan seluruh isi log
+    _cursor = c.magic == UPLINK_CURSOR_MAGIC ? c.time : logger.now();
+    _savedCursor = _cursor;
+}
+
+void Uplink::saveCursor()
+{
+    if (_cursor == _savedCursor)
+        return;
+    METRIC_SPAN(METRIC_FLASH_WRITE);
+    UplinkCursorFile c = {UPLINK_CURSOR_MAGIC, _cursor};
+    File f = LittleFS.open(UPLINK_CURSOR_PATH, "w");
+    if (!f)
+        return;
+    f.write((const uint8_t *)&c, sizeof(c));
+    f.close();
+    _savedCursor = _cursor;
+    _savedMs = millis();
+}
+
+// ---------------------------------------------------------
+// Sisi comms
+// ---------------------------------------------------------
+void Uplink::service(EthernetLinkStatus link)
+{
+    uint8_t state = _state.load(std::memory_order_acquire);
+    if (state == STATE_READY)
+        return; // task uplink sedang mengirim
+    if (state != STATE_IDLE)
+    {
+        complete(state == STATE_SENT);
+        _state.store(STATE_IDLE, std::memory_order_relaxed);
+    }
+    if (_cursor != _savedCursor && millis() - _savedMs >= UPLINK_CURSOR_SAVE_MS)
+        saveCursor();
+
+    // Link mati: backlog menunggu di log, tidak perlu mencoba connect
+    if (!_enabled || !_task || link != LinkON)
+        return;
+    uint32_t now = millis();
+    bool sizeDue = _retryMs == 0 && logger.appended() - _appendedAtBuild >= UPLINK_BATCH_RECORDS;
+    if ((int32_t)(now - _nextMs) < 0 && !sizeDue)
+        return;
+    _appendedAtBuild = logger.appended();
+    if (!buildBatch())
+    {
+        _nextMs = now + _intervalMs;
+        return;
+    }
+    _state.store(STATE_READY, std::memory_order_release);
+    xTaskNotifyGive(_task);
+}
+
+// Record setelah cursor, dipotong di batas waktu (record dengan waktu
+// yang sama tidak pernah terbelah antar batch)
+bool Uplink::buildBatch()
+{
+    static LogCursor c;
+    UplinkBatch &b = _batch;
+    b.target = _target;
+    b.length = 0;
+    b.records = 0;
+    b.full = false;
+    b.payload[b.length++] = '[';
+
+    uint16_t boundaryLen = b.length, boundaryRecords = 0;
+    uint32_t boundaryTime = _cursor, time = _cursor;
+    LogRecord r;
+    logger.openRange(c, _cursor + 1, 0xFFFFFFFFUL, 0xFFFFFFFFUL);
+    while (logger.next(c, r))
+    {
+        if (r.time != time)
+        {
+            boundaryLen = b.length;
+            boundaryRecords = b.records;
+            boundaryTime = time;
+            time = r.time;
+        }
+        char fallback[8];
+        size_t room = sizeof(b.payload) - b.length - 1; // sisakan ']'
+        int n = snprintf(b.payload + b.length, room, "%s{\"KodeSensor\":\"%s\",\"Value\":%.2f,\"Time\":%u}",
+                         b.records ? "," : "", DataLogger::channelName(r.channel, fallback, sizeof(fallback)),
+                         r.value, (unsigned)r.time);
+        if (n < 0 || (size_t)n >= room)
+        {
+            b.full = true;
+            break;
+        }
+        b.length += n;
+        b.records++;
+    }
+    c.file.close();
+    if (b.full && boundaryRecords > 0)
+    {
+        b.length = boundaryLen;
+        b.records = boundaryRecords;
+        time = boundaryTime;
+    }
+    b.payload[b.length++] = ']';
+    b.lastTime = time;
+    return b.records > 0;
+}
+
+void Uplink::complete(bool ok)
+{
+    uint32_t now = millis();
+    _error = _sendError;
+    if (!ok)
+    {
+        // Backoff eksponensial; batch yang sama disusun ulang nanti
+        _failures++;
+        _retryMs = _retryMs ? min(_retryMs * 2, (uint32_t)UPLINK_RETRY_MAX_MS) : UPLINK_RETRY_MIN_MS;
+        _nextMs = now + _retryMs;
+        return;
+    }
+    _cursor = _batch.lastTime;
+    _sent++;
+    _sentRecords += _batch.records;
+    _retryMs = 0;
+    // Masih ada backlog: batch berikutnya setelah jeda pendek
+    _nextMs = now + (_batch.full ? UPLINK_DRAIN_GAP_MS : _intervalMs);
+}
+
+// ---------------------------------------------------------
+// Task uplink
+// ---------------------------------------------------------
+void Uplink::taskEntry(void *arg)
+{
+    ((Uplink *)arg)->run();
+}
+
+void Uplink::run()
+{
+    // Waktu tunggu jaringan bukan beban CPU: hanya stack yang dipantau
+    taskMonitor.add("uplink");
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        if (_state.load(std::memory_order_acquire) != STATE_READY)
+        {
+            mqttKeepAlive();
+            continue;
+        }
+        _sendError = "";
+        bool ok = send(_batch);
+        _state.store(ok ? STATE_SENT : STATE_FAILED, std::memory_order_release);
+    }
+}
+
+bool Uplink::send(const UplinkBatch &b)
+{
+    if (b.target.protocol == UPLINK_HTTP)
+        return postHttp(b);
+    if (b.target.protocol == UPLINK_MQTT)
+        return publishMqtt(b);
+    return false;
+}
+
+static void base64(const char *in, char *out, size_t size)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t len = strlen(in), o = 0;
+    for (size_t i = 0; i < len && o + 4 < size; i += 3)
+    {
+        uint32_t v = (uint8_t)in[i] << 16;
+        if (i + 1 < len)
+            v |= (uint8_t)in[i + 1] << 8;
+        if (i + 2 < len)
+            v |= (uint8_t)in[i + 2];
+        out[o++] = table[(v >> 18) & 0x3F];
+        out[o++] = table[(v >> 12) & 0x3F];
+        out[o++] = i + 1 < len ? table[(v >> 6) & 0x3F] : '=';
+        out[o++] = i + 2 < len ? table[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+}
+
+// Satu batch = satu POST; 2xx = diterima
+bool Uplink::postHttp(const UplinkBatch &b)
+{
+    const UplinkTarget &t = b.target;
+    EthernetClient client;
+    client.setConnectionTimeout(UPLINK_TIMEOUT_MS);
+    if (!client.connect(t.host, t.port))
+    {
+        _sendError = "connect gagal";
+        return false;
+    }
+    client.printf("POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                  "Content-Length: %u\r\nConnection: close\r\n",
+                  t.path, t.host, b.length);
+    if (t.username[0])
+    {
+        char credentials[sizeof(t.username) + sizeof(t.password)];
+        char auth[sizeof(credentials) * 4 / 3 + 4];
+        snprintf(credentials, sizeof(credentials), "%s:%s", t.username, t.password);
+        base64(credentials, auth, sizeof(auth));
+        client.printf("Authorization: Basic %s\r\n", auth);
+    }
+    client.print("\r\n");
+    client.write((const uint8_t *)b.payload, b.length);
+
+    // Status line: "HTTP/1.1 200 OK"
+    char line[32];
+    size_t n = 0;
+    uint32_t start = millis();
+    while (n < sizeof(line) - 1 && millis() - start < UPLINK_TIMEOUT_MS)
+    {
+        int c = client.read();
+        if (c < 0)
+        {
+            if (!client.connected())
+                break;
+            vTaskDelay(pdMS_TO_TICKS(5));
+            continue;
+        }
+        if (c == '\n')
+            break;
+        line[n++] = c;
+    }
+    line[n] = '\0';
+    client.stop();
+    const char *space = strchr(line, ' ');
+    int status = space ? atoi(space + 1) : 0;
+    if (status < 200 || status > 299)
+    {
+        _sendError = status ? "HTTP ditolak" : "HTTP tanpa respons";
+        return false;
+    }
+    return true;
+}
+
+// MQTT 3.1.1 minimal: CONNECT + PUBLISH QoS 1 (tunggu PUBACK) + PINGREQ.
+// Koneksi dibiarkan terbuka antar batch.
+static size_t mqttRemainingLength(uint32_t len, uint8_t *out)
+{
+    size_t n = 0;
+    do
+    {
+        uint8_t b = len & 0x7F;
+        len >>= 7;
+        out[n++] = len ? b | 0x80 : b;
+    } while (len && n < 4);
+    return n;
+}
+
+static void mqttString(Client &c, const char *s)
+{
+    uint16_t len = strlen(s);
+    c.write((uint8_t)(len >> 8));
+    c.write((uint8_t)(len & 0xFF));
+    c.write((const uint8_t *)s, len);
+}
+
+bool Uplink::mqttReadPacket(uint8_t &type, uint8_t *body, size_t size)
+{
+    uint32_t start = millis();
+    uint8_t header[5];
+    size_t got = 0;
+    uint32_t remaining = 0;
+    uint8_t shift = 0;
+    // Header tetap + remaining length (varint), lalu body
+    while (millis() - start < UPLINK_TIMEOUT_MS)
+    {
+        int c = _mqtt.read();
+        if (c < 0)
+        {
+            if (!_mqtt.connected())
+                return false;
+            vTaskDelay(pdMS_TO_TICKS(5));
+            continue;
+        }
+        header[got++] = c;
+        if (got == 1)
+            continue;
+        remaining |= (uint32_t)(c & 0x7F) << shift;
+        shift += 7;
+        if (!(c & 0x80) || got == sizeof(header))
+            break;
+    }
+    if (got < 2)
+        return false;
+    type = header[0];
+    for (uint32_t i = 0; i < remaining; i++)
+    {
+        int c = -1;
+        while ((c = _mqtt.read()) < 0)
+        {
+            if (!_mqtt.connected() || millis() - start >= UPLINK_TIMEOUT_MS)
+                return false;
+            vTaskDelay(pdMS_TO_TICKS(5));
+        }
+        if (i < size)
+            body[i] = c;
+    }
+    return true;
+}
+
+bool Uplink::mqttConnect(const UplinkTarget &t)
+{
+    if (_mqtt.connected() && memcmp(&t, &_mqttTarget, sizeof(t)) == 0)
+        return true;
+    _mqtt.stop();
+    _mqtt.setConnectionTimeout(UPLINK_TIMEOUT_MS);
+    if (!_mqtt.connect(t.host, t.port))
+    {
+        _sendError = "connect gagal";
+        return false;
+    }
+    uint8_t flags = 0x02; // clean session
+    uint32_t len = 10 + 2 + strlen(mqttClientId);
+    if (t.username[0])
+    {
+        flags |= 0x80;
+        len += 2 + strlen(t.username);
+        if (t.password[0])
+        {
+            flags |= 0x40;
+            len += 2 + strlen(t.password);
+        }
+    }
+    uint8_t head[5] = {MQTT_CONNECT};
+    size_t n = 1 + mqttRemainingLength(len, head + 1);
+    _mqtt.write(head, n);
+    mqttString(_mqtt, "MQTT");
+    const uint8_t variable[] = {4, flags, 0, UPLINK_MQTT_KEEPALIVE};
+    _mqtt.write(variable, sizeof(variable));
+    mqttString(_mqtt, mqttClientId);
+    if (flags & 0x80)
+        mqttString(_mqtt, t.username);
+    if (flags & 0x40)
+        mqttString(_mqtt, t.password);
+
+    uint8_t type, ack[2] = {0, 0xFF};
+    if (!mqttReadPacket(type, ack, sizeof(ack)) || type != MQTT_CONNACK || ack[1] != 0)
+    {
+        _sendError = "MQTT CONNACK ditolak";
+        _mqtt.stop();
+        return false;
+    }
+    _mqttTarget = t;
+    _mqttActivityMs = millis();
+    return true;
+}
+
+bool Uplink::publishMqtt(const UplinkBatch &b)
+{
+    const UplinkTarget &t = b.target;
+    if (!mqttConnect(t))
+        return false;
+    if (++_packetId == 0)
+        _packetId = 1;
+    uint16_t topicLen = strlen(t.topic);
+    uint8_t head[5] = {MQTT_PUBLISH_QOS1};
+    size_t n = 1 + mqttRemainingLength(2 + topicLen + 2 + b.length, head + 1);
+    _mqtt.write(head, n);
+    mqttString(_mqtt, t.topic);
+    const uint8_t id[] = {(uint8_t)(_packetId >> 8), (uint8_t)(_packetId & 0xFF)};
+    _mqtt.write(id, sizeof(id));
+    _mqtt.write((const uint8_t *)b.payload, b.length);
+
+    // QoS 1: batch dianggap terkirim setelah PUBACK dengan id yang sama
+    uint8_t type, ack[2];
+    while (mqttReadPacket(type, ack, sizeof(ack)))
+    {
+        if ((type & 0xF0) == MQTT_PUBACK && ack[0] == id[0] && ack[1] == id[1])
+        {
+            _mqttActivityMs = millis();
+            return true;
+        }
+    }
+    _sendError = "MQTT tanpa PUBACK";
+    _mqtt.stop();
+    return false;
+}
+
+void Uplink::mqttKeepAlive()
+{
+    if (!_mqtt.connected() || millis() - _mqttActivityMs < UPLINK_MQTT_KEEPALIVE * 500UL)
+        return;
+    const uint8_t ping[] = {MQTT_PINGREQ, 0};
+    _mqtt.write(ping, sizeof(ping));
+    uint8_t type;
+    if (!mqttReadPacket(type, nullptr, 0) || type != MQTT_PINGRESP)
+        _mqtt.stop();
+    _mqttActivityMs = millis();
+}
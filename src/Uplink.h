@@ -0,0 +1,139 @@
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include <Arduino.h>
+#include <EthernetESP32.h>
+#include <atomic>
+#include "ConfigCache.h"
+
+#define UPLINK_PAYLOAD_MAX 8192      // satu POST / PUBLISH
+#define UPLINK_BATCH_RECORDS 160     // kirim lebih awal jika log bertambah sebanyak ini
+#define UPLINK_MIN_INTERVAL_MS 1000
+#define UPLINK_DRAIN_GAP_MS 2000     // jeda antar batch saat menguras backlog
+#define UPLINK_RETRY_MIN_MS 5000     // backoff setelah gagal, dilipatgandakan
+#define UPLINK_RETRY_MAX_MS 300000
+#define UPLINK_TIMEOUT_MS 5000       // connect / tunggu respons
+#define UPLINK_CURSOR_PATH "/log/uplink.pos"
+#define UPLINK_CURSOR_SAVE_MS 60000  // cursor ke flash paling sering sekali per menit
+#define UPLINK_MQTT_KEEPALIVE 60     // detik
+#define UPLINK_TASK_STACK 6144
+#define UPLINK_TASK_PRIORITY 1
+#define UPLINK_TASK_CORE 0
+
+enum UplinkProtocol : uint8_t
+{
+    UPLINK_NONE,
+    UPLINK_HTTP,
+    UPLINK_MQTT
+};
+
+// Tujuan kirim, hasil parse configNetwork.json (protocolMode/endpoint/port/...)
+struct UplinkTarget
+{
+    UplinkProtocol protocol;
+    char host[64];
+    uint16_t port;
+    char path[96];     // HTTP
+    char topic[64];    // MQTT pubTopic
+    char username[33];
+    char password[65];
+};
+
+// Satu payload yang sedang dikirim task uplink
+struct UplinkBatch
+{
+    UplinkTarget target;
+    char payload[UPLINK_PAYLOAD_MAX];
+    uint16_t length;
+    uint16_t records;
+    uint32_t lastTime; // waktu log record terakhir di payload
+    bool full;         // masih ada backlog setelah batch ini
+};
+
+// ---------------------------------------------------------
+// Uplink store-and-forward (HTTP POST / MQTT publish)
+// ---------------------------------------------------------
+// Backlog persisten = DataLogger: uplink hanya menyimpan cursor (waktu
+// log record terakhir yang sudah diterima server) di /log/uplink.pos.
+// Selama link mati data tetap tercatat di log (dibatasi ring segmen);
+// setelah link kembali, backlog dikuras per batch dengan jeda
+// UPLINK_DRAIN_GAP_MS. Satu batch = record sejak cursor, dikirim setiap
+// sendInterval atau lebih awal jika sudah UPLINK_BATCH_RECORDS record.
+//
+// service() (task comms, pemilik config & log) menyusun batch lalu
+// menyerahkannya ke task uplink; connect/kirim yang blocking berjalan di
+// task itu sehingga web server tidak ikut tertahan. Serah-terima lewat
+// satu state atomik, tanpa lock.
+class Uplink
+{
+public:
+    Uplink();
+
+    // DataLogger harus sudah begin()
+    void begin();
+    void configure(const NetworkConfig &net);
+    void service(EthernetLinkStatus link);
+    void saveCursor(); // sebelum restart
+
+    bool enabled() const { return _enabled; }
+    uint32_t cursor() const { return _cursor; }
+    uint32_t sent() const { return _sent; }
+    uint32_t sentRecords() const { return _sentRecords; }
+    uint32_t failures() const { return _failures; }
+    const char *error() const { return _error; }
+
+    static bool parseEndpoint(const NetworkConfig &net, UplinkTarget &t);
+
+private:
+    enum State : uint8_t
+    {
+        STATE_IDLE,
+        STATE_READY,   // batch siap, milik task uplink
+        STATE_SENT,
+        STATE_FAILED
+    };
+
+    bool buildBatch();
+    void complete(bool ok);
+    void loadCursor();
+
+    // Task uplink
+    static void taskEntry(void *arg);
+    void run();
+    bool send(const UplinkBatch &b);
+    bool postHttp(const UplinkBatch &b);
+    bool publishMqtt(const UplinkBatch &b);
+    bool mqttConnect(const UplinkTarget &t);
+    bool mqttReadPacket(uint8_t &type, uint8_t *body, size_t size);
+    void mqttKeepAlive();
+
+    UplinkBatch _batch;
+    std::atomic<uint8_t> _state;
+    TaskHandle_t _task;
+
+    // Sisi comms
+    UplinkTarget _target;
+    bool _enabled;
+    uint32_t _intervalMs;
+    uint32_t _nextMs;
+    uint32_t _retryMs;
+    uint32_t _cursor;
+    uint32_t _savedCursor;
+    uint32_t _savedMs;
+    uint32_t _appendedAtBuild;
+    uint32_t _sent;
+    uint32_t _sentRecords;
+    uint32_t _failures;
+    const char *_error;
+
+    // Sisi task uplink
+    EthernetClient _mqtt;
+    UplinkTarget _mqttTarget; // target koneksi MQTT yang sedang terbuka
+    uint32_t _mqttActivityMs;
+    uint16_t _packetId;
+    const char *_sendError;
+};
+
+extern Uplink uplink;
+
+#endif // UPLINK_H
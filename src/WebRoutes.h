@@ -0,0 +1,105 @@
+#ifndef WEBROUTES_H
+#define WEBROUTES_H
+
+#include "WebServerHandler.h"
+
+// ---------------------------------------------------------
+// Tabel route (dibentuk saat compile)
+// ---------------------------------------------------------
+// Satu baris = method + path -> handler (+ file asset untuk halaman).
+// Tabel WAJIB terurut menurut path (strcmp) lalu method; urutan dicek
+// oleh static_assert, sehingga lookup cukup binary search (~6 strcmp).
+// Endpoint baru cukup ditambah di sini, dispatcher tidak perlu diubah.
+struct Route
+{
+    const char *path;
+    HttpMethod method;
+    WebServerHandler::RouteHandler handler;
+    const char *asset;  // nullptr = pakai path request
+    bool streamBody;    // true = body tidak di-buffer (mis. OTA)
+};
+
+// strcmp versi constexpr (C++11: satu return statement)
+constexpr int routeStrCmp(const char *a, const char *b)
+{
+    return (*a != *b) ? ((unsigned char)*a < (unsigned char)*b ? -1 : 1)
+                      : (*a == '\0' ? 0 : routeStrCmp(a + 1, b + 1));
+}
+
+constexpr bool routeLess(const Route &a, const Route &b)
+{
+    return routeStrCmp(a.path, b.path) < 0 ||
+           (routeStrCmp(a.path, b.path) == 0 && a.method < b.method);
+}
+
+struct WebRoutes
+{
+    typedef WebServerHandler W;
+
+    static constexpr Route table[] = {
+        {"/", HTTP_METHOD_GET, &W::serveFile, "/home.html", false},
+        {"/", HTTP_METHOD_POST, &W::handleConfigSave, nullptr, false},
+        {"/UpdateOTA.js", HTTP_METHOD_GET, &W::serveFile, "/js/UpdateOTA.js", false},
+        {"/analogLoad", HTTP_METHOD_GET, &W::handleAnalogLoad, nullptr, false},
+        {"/analog_input", HTTP_METHOD_GET, &W::serveFile, "/analog_input.html", false},
+        {"/debugStream", HTTP_METHOD_GET, &W::handleEventStream, nullptr, false},
+        {"/digitalLoad", HTTP_METHOD_GET, &W::handleDigitalLoad, nullptr, false},
+        {"/digital_IO", HTTP_METHOD_GET, &W::serveFile, "/digital_IO.html", false},
+        {"/digital_IO.js", HTTP_METHOD_GET, &W::serveFile, "/js/digital_IO.js", false},
+        {"/events", HTTP_METHOD_GET, &W::handleEventStream, nullptr, false},
+        {"/getTime", HTTP_METHOD_GET, &W::handleGetTime, nullptr, false},
+        {"/getValue", HTTP_METHOD_GET, &W::handleGetValue, nullptr, false},
+        {"/home", HTTP_METHOD_GET, &W::serveFile, "/home.html", false},
+        {"/home.js", HTTP_METHOD_GET, &W::serveFile, "/js/home.js", false},
+        {"/homeLoad", HTTP_METHOD_GET, &W::handleHomeLoad, nullptr, false},
+        {"/info", HTTP_METHOD_GET, &W::handleInfo, nullptr, false},
+        {"/live", HTTP_METHOD_GET, &W::handleLive, nullptr, false},
+#if METRICS_ENABLED
+        {"/metrics", HTTP_METHOD_GET, &W::handleMetrics, nullptr, false},
+#endif
+        {"/modbusLoad", HTTP_METHOD_GET, &W::handleModbusLoad, nullptr, false},
+        {"/modbus_setup", HTTP_METHOD_GET, &W::serveFile, "/modbus_setup.html", false},
+        {"/modbus_setup", HTTP_METHOD_POST, &W::handleModbusSave, nullptr, false},
+        {"/modbus_setup.js", HTTP_METHOD_GET, &W::serveFile, "/js/modbus_setup.js", false},
+        {"/network", HTTP_METHOD_GET, &W::serveFile, "/network.html", false},
+        {"/network.js", HTTP_METHOD_GET, &W::serveFile, "/js/network.js", false},
+        {"/networkLoad", HTTP_METHOD_GET, &W::handleNetworkLoad, nullptr, false},
+        {"/rollup", HTTP_METHOD_GET, &W::handleRollup, nullptr, false},
+        {"/settingsLoad", HTTP_METHOD_GET, &W::handleSettingsLoad, nullptr, false},
+        {"/system_setting.js", HTTP_METHOD_GET, &W::serveFile, "/js/system_setting.js", false},
+        {"/system_settings", HTTP_METHOD_GET, &W::serveFile, "/system_settings.html", false},
+        {"/update", HTTP_METHOD_POST, &W::handleOtaUpload, nullptr, true},
+        {"/updateOTA", HTTP_METHOD_GET, &W::serveFile, "/UpdateOTA.html", false},
+        {"/updateStatus", HTTP_METHOD_GET, &W::handleUpdateStatus, nullptr, false},
+    };
+    static constexpr size_t count = sizeof(table) / sizeof(table[0]);
+
+    static constexpr bool sortedFrom(size_t i)
+    {
+        return (i + 1 >= count) ? true : (routeLess(table[i], table[i + 1]) && sortedFrom(i + 1));
+    }
+
+    // Binary search; nullptr jika path/method tidak terdaftar
+    static const Route *find(HttpMethod method, const char *path)
+    {
+        size_t lo = 0, hi = count;
+        while (lo < hi)
+        {
+            size_t mid = (lo + hi) / 2;
+            int cmp = strcmp(table[mid].path, path);
+            if (cmp == 0)
+                cmp = (int)table[mid].method - (int)method;
+            if (cmp == 0)
+                return &table[mid];
+            if (cmp < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return nullptr;
+    }
+};
+
+static_assert(WebRoutes::sortedFrom(0), "WebRoutes::table must be sorted by path, then method");
+
+#endif // WEBROUTES_H
@@ -1,7 +1,28 @@
 #include "WebServerHandler.h"
-#include <Update.h> // Library OTA
+#include "WebRoutes.h"
+#include "ConfigCache.h"
+#include "DataLogger.h"
+#include "DigitalInputs.h"
+#include "JsonHelper.h"
+#include "LiveData.h"
+#include "ModbusPoller.h"
+#include "ModbusTcpServer.h"
+#include "OtaUpdater.h"
+#include "Rollup.h"
+#include "TaskMonitor.h"
+#include "Uplink.h"
+#include "JsonWriter.h"
+#include "ChunkedPrint.h"
+#include "Metrics.h"
 
-WebServerHandler::WebServerHandler(uint16_t port) : _server(port) {}
+constexpr Route WebRoutes::table[];
+
+WebServerHandler::WebServerHandler(uint16_t port)
+    : _server(port), _linkStatus(Unknown), _accepted(0), _rejected(0)
+{
+    for (uint8_t i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+        _conns[i].state = Connection::FREE;
+}
 
 void WebServerHandler::begin()
 {
@@ -11,717 +32,1363 @@ void WebServerHandler::begin()
         return;
     }
     Serial.println("LittleFS Mounted Successfully.");
+    _assets.begin();
     _server.begin();
     Serial.println("Web Server started on port 80.");
 }
 
 String WebServerHandler::getContentType(String filename)
 {
-    if (filename.endsWith(".html"))
-        return "text/html";
-    else if (filename.endsWith(".css"))
-        return "text/css";
-    else if (filename.endsWith(".js"))
-        return "application/javascript";
-    else if (filename.endsWith(".json"))
-        return "application/json";
-    else if (filename.endsWith(".png"))
-        return "image/png";
-    else if (filename.endsWith(".jpg"))
-        return "image/jpeg";
-    else if (filename.endsWith(".ico"))
-        return "image/x-icon";
-    else if (filename.endsWith(".gz"))
-        return "application/x-gzip";
-    return "text/plain";
+    return AssetCache::contentType(filename.c_str());
 }
 
-// Processor Template HTML
-String WebServerHandler::processor(const String &var, EthernetLinkStatus linkStatus)
+// Nilai placeholder template (registry di HtmlTemplate.h); tidak
+// terdaftar = kosong. Mengembalikan panjang nilai di buf.
+size_t WebServerHandler::templateValue(uint8_t var, EthernetLinkStatus linkStatus, char *buf, size_t size)
 {
-    if (var == "LINK_STATUS")
+    const char *value = "";
+    switch (var)
     {
-        if (linkStatus == LinkON)
-            return "ONLINE";
-        if (linkStatus == LinkOFF)
-            return "OFFLINE";
-        return "UNKNOWN";
+    case TPL_VAR_LINK_STATUS:
+        value = linkStatus == LinkON ? "ONLINE" : linkStatus == LinkOFF ? "OFFLINE" : "UNKNOWN";
+        break;
     }
-    return String();
+    strncpy(buf, value, size - 1);
+    buf[size - 1] = '\0';
+    return strlen(buf);
 }
 
 // ---------------------------------------------------------
-// Helper Parsing
+// Helper Response
 // ---------------------------------------------------------
-String getParam(String data, String key)
+static const char *connectionHeader(const WebServerHandler::RequestContext &ctx)
 {
-    String keyPair = key + "=";
-    int start = data.indexOf(keyPair);
-    if (start == -1)
-        return "";
+    return ctx.keepAlive ? "keep-alive" : "close";
+}
 
-    start += keyPair.length();
-    int end = data.indexOf("&", start);
-    if (end == -1)
-        end = data.length();
+static void sendBody(WebServerHandler::RequestContext &ctx, const char *type, const uint8_t *data, size_t len)
+{
+    size_t n = ctx.client.printf("HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: %s\r\n\r\n",
+                                 type, (unsigned)len, connectionHeader(ctx));
+    n += ctx.client.write(data, len);
+    METRIC_ADD(METRIC_HTTP_TX_BYTES, n);
+}
 
-    String value = data.substring(start, end);
-    value.replace("+", " ");
-    value.replace("%2F", "/");
-    value.replace("%3A", ":");
-    value.replace("%40", "@");
-    return value;
+static void sendJson(WebServerHandler::RequestContext &ctx, const char *json)
+{
+    sendBody(ctx, "application/json", (const uint8_t *)json, strlen(json));
 }
 
-String getNum(String data, String key)
+// Header respon yang body-nya di-stream (ChunkedPrint). Mengembalikan true
+// jika chunked; client HTTP/1.0 mendapat body yang diakhiri tutup koneksi.
+static bool beginStream(WebServerHandler::RequestContext &ctx, const char *type, const char *extraHeaders = "")
 {
-    String val = getParam(data, key);
-    if (val == "")
-        return "0";
-    return val;
+    bool chunked = ctx.req.http11();
+    if (!chunked)
+        ctx.keepAlive = false;
+    size_t n = ctx.client.printf("HTTP/1.1 200 OK\r\nContent-Type: %s\r\n%s%sConnection: %s\r\n\r\n",
+                                 type, extraHeaders, chunked ? "Transfer-Encoding: chunked\r\n" : "", connectionHeader(ctx));
+    METRIC_ADD(METRIC_HTTP_TX_BYTES, n);
+    return chunked;
 }
 
-String getJsonVal(String json, String key)
+// status contoh: "200 OK", "400 Bad Request"
+static void sendText(WebServerHandler::RequestContext &ctx, const char *status, const char *text)
 {
-    String search = "\"" + key + "\":";
-    int start = json.indexOf(search);
-    if (start == -1)
-        return "";
-    start += search.length();
+    size_t n = ctx.client.printf("HTTP/1.1 %s\r\nContent-Type: text/plain\r\nContent-Length: %u\r\nConnection: %s\r\n\r\n%s",
+                                 status, (unsigned)strlen(text), connectionHeader(ctx), text);
+    METRIC_ADD(METRIC_HTTP_TX_BYTES, n);
+    if (strncmp(status, "404", 3) == 0)
+        METRIC_ADD(METRIC_HTTP_NOT_FOUND, 1);
+}
 
-    bool isString = (json.charAt(start) == '"');
-    if (isString)
-        start++;
+// ---------------------------------------------------------
+// Handle Client (multi koneksi, non-blocking)
+// ---------------------------------------------------------
+// Setiap socket punya state machine sendiri. Satu panggilan handleClient()
+// memberi tiap koneksi satu giliran pendek: baca byte yang sudah ada,
+// jalankan handler jika request lengkap, atau kirim satu potongan file.
+// Tidak ada loop tunggu, jadi browser lambat / upload OTA tidak menahan
+// koneksi lain maupun loop sampling.
+void WebServerHandler::handleClient(EthernetLinkStatus linkStatus)
+{
+    _linkStatus = linkStatus;
+    acceptConnections();
+    for (uint8_t i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+    {
+        if (_conns[i].state != Connection::FREE)
+            serviceConnection(_conns[i]);
+    }
+}
 
-    int end;
-    if (isString)
+uint8_t WebServerHandler::eventSubscribers() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < HTTP_MAX_CONNECTIONS; i++)
     {
-        end = json.indexOf("\"", start);
+        if (_conns[i].state == Connection::EVENT_STREAM)
+            n++;
     }
-    else
+    return n;
+}
+
+uint8_t WebServerHandler::activeConnections() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+    {
+        if (_conns[i].state != Connection::FREE)
+            n++;
+    }
+    return n;
+}
+
+void WebServerHandler::acceptConnections()
+{
+    EthernetClient client = _server.accept();
+    while (client)
     {
-        int comma = json.indexOf(",", start);
-        int brace = json.indexOf("}", start);
-        if (comma == -1)
-            end = brace;
-        else if (brace == -1)
-            end = comma;
+        Connection *slot = nullptr;
+        for (uint8_t i = 0; i < HTTP_MAX_CONNECTIONS && !slot; i++)
+        {
+            if (_conns[i].state == Connection::FREE)
+                slot = &_conns[i];
+        }
+        if (!slot)
+        {
+            // Semua slot terpakai: tolak cepat daripada menggantung
+            _rejected++;
+            client.print("HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            client.stop();
+        }
         else
-            end = min(comma, brace);
+        {
+            _accepted++;
+            slot->client = client;
+            slot->parser.reset();
+            slot->state = Connection::READ_HEADERS;
+            slot->requestStarted = false;
+            slot->rxLen = slot->rxPos = 0;
+            slot->lastActivityMs = millis();
+        }
+        client = _server.accept();
     }
+}
 
-    if (end == -1)
-        return "";
-    return json.substring(start, end);
+// Ambil byte yang sudah tersedia di socket (tanpa menunggu)
+bool WebServerHandler::fillRx(Connection &c)
+{
+    if (c.rxPos < c.rxLen)
+        return true;
+    int avail = c.client.available();
+    if (avail <= 0)
+        return false;
+    int n = c.client.read(c.rx, min((size_t)avail, sizeof(c.rx)));
+    if (n <= 0)
+        return false;
+    c.rxLen = n;
+    c.rxPos = 0;
+    c.lastActivityMs = millis();
+    METRIC_ADD(METRIC_HTTP_RX_BYTES, n);
+    return true;
 }
 
-// ---------------------------------------------------------
-// Handle Client
-// ---------------------------------------------------------
-void WebServerHandler::handleClient(EthernetLinkStatus linkStatus)
+void WebServerHandler::serviceConnection(Connection &c)
 {
-    EthernetClient client = _server.available();
+    uint32_t now = millis();
 
-    if (client)
+    switch (c.state)
     {
-        String reqLine = client.readStringUntil('\r');
-        client.readStringUntil('\n');
-
-        if (reqLine.length() > 0)
+    case Connection::READ_HEADERS:
+    case Connection::READ_BODY:
+        while (fillRx(c))
         {
-            String method = reqLine.substring(0, reqLine.indexOf(' '));
-            int addr_start = reqLine.indexOf(' ');
-            int addr_end = reqLine.indexOf(' ', addr_start + 1);
-            String path = reqLine.substring(addr_start + 1, addr_end);
-
-            // Uncomment untuk debug path
-            // Serial.print("Req: "); Serial.print(method); Serial.print(" "); Serial.println(path);
-
-            // ============================================================
-            // 1. HANDLE POST (Simpan Data & OTA)
-            // ============================================================
-            if (method == "POST")
+            c.requestStarted = true;
             {
-                // A. OTA UPDATE
-                if (path == "/update")
-                {
-                    long contentLength = 0;
-                    while (client.connected())
-                    {
-                        String line = client.readStringUntil('\n');
-                        if (line == "\r")
-                            break;
-                        if (line.startsWith("Content-Length: "))
-                            contentLength = line.substring(16).toInt();
-                    }
-                    if (contentLength > 0 && Update.begin(contentLength, U_FLASH))
-                    {
-                        Update.writeStream(client);
-                        if (Update.end(true))
-                        {
-                            client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nSuccess");
-                            delay(100);
-                            client.stop();
-                            ESP.restart();
-                            return;
-                        }
-                    }
-                    client.println("HTTP/1.1 500 Error\r\nConnection: close\r\n\r\nFailed");
-                }
-
-                // B. CONFIG SAVE
-                else
-                {
-                    while (client.connected())
-                    {
-                        String line = client.readStringUntil('\n');
-                        if (line == "\r")
-                            break;
-                    }
-                    String body = "";
-                    while (client.available())
-                        body += (char)client.read();
-
-                    // --- System Settings ---
-                    if (body.indexOf("username=") != -1 || body.indexOf("sdInterval=") != -1)
-                    {
-                        String user = getParam(body, "username");
-                        String pass = getParam(body, "password");
-                        String interval = getParam(body, "sdInterval");
-                        String jsonString = "{\"username\":\"" + user + "\",\"password\":\"" + pass + "\",\"sdInterval\":\"" + interval + "\"}";
-                        File file = LittleFS.open("/systemSettings.json", "w");
-                        if (file)
-                        {
-                            file.print(jsonString);
-                            file.close();
-                        }
-                        client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nSystem Saved");
-                    }
-
-                    // --- Modbus Config ---
-                    else if (body.indexOf("baudrate=") != -1 || body.indexOf("slaveid=") != -1)
-                    {
-                        String jsonString = "{";
-                        jsonString += "\"baudrate\":\"" + getParam(body, "baudrate") + "\",";
-                        jsonString += "\"parity\":\"" + getParam(body, "parity") + "\",";
-                        jsonString += "\"stopbits\":\"" + getParam(body, "stopbits") + "\",";
-                        jsonString += "\"databits\":\"" + getParam(body, "databits") + "\",";
-                        jsonString += "\"slaveid\":\"" + getParam(body, "slaveid") + "\",";
-                        jsonString += "\"mode\":\"" + getParam(body, "mode") + "\"";
-                        jsonString += "}";
-                        File file = LittleFS.open("/modbusSetup.json", "w");
-                        if (file)
-                        {
-                            file.print(jsonString);
-                            file.close();
-                        }
-                        client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nModbus Saved");
-                    }
-
-                    // --- Digital IO Config (Partial) ---
-                    else if (body.indexOf("inputPin=") != -1)
-                    {
-                        String targetKey = getParam(body, "inputPin");
-                        targetKey.replace(" ", "");
-                        String jsonContent = "{}";
-                        if (LittleFS.exists("/configDigital.json"))
-                        {
-                            File f = LittleFS.open("/configDigital.json", "r");
-                            if (f)
-                            {
-                                jsonContent = f.readString();
-                                f.close();
-                            }
-                        }
-                        String inv = (body.indexOf("inputInversion=") != -1) ? "1" : "0";
-                        String newBlock = "\"" + targetKey + "\":{";
-                        newBlock += "\"name\":\"" + getParam(body, "nameDI") + "\",";
-                        newBlock += "\"invers\":" + inv + ",";
-                        newBlock += "\"taskMode\":\"" + getParam(body, "taskMode") + "\",";
-                        newBlock += "\"inputState\":\"" + getParam(body, "inputState") + "\",";
-                        newBlock += "\"intervalTime\":" + getNum(body, "intervalTime") + ",";
-                        newBlock += "\"conversionFactor\":" + getNum(body, "conversionFactor");
-                        newBlock += "}";
-                        String searchKey = "\"" + targetKey + "\":";
-                        int startPos = jsonContent.indexOf(searchKey);
-                        if (startPos != -1)
-                        {
-                            int openBrace = jsonContent.indexOf("{", startPos);
-                            int closeBrace = jsonContent.indexOf("}", openBrace);
-                            if (openBrace != -1 && closeBrace != -1)
-                            {
-                                String oldBlock = jsonContent.substring(startPos, closeBrace + 1);
-                                String newValueOnly = searchKey + newBlock.substring(newBlock.indexOf('{'));
-                                jsonContent.replace(oldBlock, newValueOnly);
-                            }
-                        }
-                        File f = LittleFS.open("/configDigital.json", "w");
-                        if (f)
-                        {
-                            f.print(jsonContent);
-                            f.close();
-                        }
-                        client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nDigital Saved");
-                    }
-
-                    // --- Network & ERP Config ---
-                    else if (body.indexOf("ssid=") != -1 || body.indexOf("erpUrl=") != -1)
-                    {
-                        String jsonC = "{}";
-                        if (LittleFS.exists("/configNetwork.json"))
-                        {
-                            File f = LittleFS.open("/configNetwork.json", "r");
-                            if (f)
-                            {
-                                jsonC = f.readString();
-                                f.close();
-                            }
-                        }
-                        String netMode = getJsonVal(jsonC, "networkMode");
-                        String ssid = getJsonVal(jsonC, "ssid");
-                        String pass = getJsonVal(jsonC, "password");
-                        String apSsid = getJsonVal(jsonC, "apSsid");
-                        String apPass = getJsonVal(jsonC, "apPassword");
-                        String dhcp = getJsonVal(jsonC, "dhcpMode");
-                        String ip = getJsonVal(jsonC, "ipAddress");
-                        String sub = getJsonVal(jsonC, "subnet");
-                        String gw = getJsonVal(jsonC, "ipGateway");
-                        String dns = getJsonVal(jsonC, "ipDNS");
-                        String sendInt = getJsonVal(jsonC, "sendInterval");
-                        String proto = getJsonVal(jsonC, "protocolMode");
-                        String endp = getJsonVal(jsonC, "endpoint");
-                        String port = getJsonVal(jsonC, "port");
-                        String pub = getJsonVal(jsonC, "pubTopic");
-                        String subT = getJsonVal(jsonC, "subTopic");
-                        String mUser = getJsonVal(jsonC, "mqttUsername");
-                        String mPass = getJsonVal(jsonC, "mqttPass");
-                        String logMode = getJsonVal(jsonC, "loggerMode");
-                        String modMode = getJsonVal(jsonC, "modbusMode");
-                        String proto2 = getJsonVal(jsonC, "protocolMode2");
-                        String mPort = getJsonVal(jsonC, "modbusPort");
-                        String slave = getJsonVal(jsonC, "modbusSlaveID");
-                        String trig = getJsonVal(jsonC, "sendTrig");
-                        String erpU = getJsonVal(jsonC, "erpUrl");
-                        String erpN = getJsonVal(jsonC, "erpUsername");
-                        String erpP = getJsonVal(jsonC, "erpPassword");
-
-                        if (body.indexOf("ssid=") != -1)
-                        {
-                            netMode = getParam(body, "networkMode");
-                            ssid = getParam(body, "ssid");
-                            pass = getParam(body, "password");
-                            apSsid = getParam(body, "apSsid");
-                            apPass = getParam(body, "apPassword");
-                            dhcp = getParam(body, "dhcpMode");
-                            ip = getParam(body, "ipAddress");
-                            sub = getParam(body, "subnet");
-                            gw = getParam(body, "ipGateway");
-                            dns = getParam(body, "ipDNS");
-                            sendInt = getParam(body, "sendInterval");
-                            proto = getParam(body, "protocolMode");
-                            endp = getParam(body, "endpoint");
-                            port = getParam(body, "port");
-                            pub = getParam(body, "pubTopic");
-                            subT = getParam(body, "subTopic");
-                            mUser = getParam(body, "mqttUsername");
-                            mPass = getParam(body, "mqttPass");
-                            logMode = (body.indexOf("loggerMode=") != -1) ? "true" : "false";
-                            modMode = (body.indexOf("modbusMode=") != -1) ? "true" : "false";
-                            proto2 = getParam(body, "protocolMode2");
-                            mPort = getParam(body, "modbusPort");
-                            slave = getParam(body, "modbusSlaveID");
-                            trig = getParam(body, "sendTrig");
-                        }
-                        if (body.indexOf("erpUrl=") != -1)
-                        {
-                            erpU = getParam(body, "erpUrl");
-                            erpN = getParam(body, "erpUsername");
-                            erpP = getParam(body, "erpPassword");
-                        }
-
-                        String j = "{";
-                        j += "\"networkMode\":\"" + netMode + "\",\"ssid\":\"" + ssid + "\",\"password\":\"" + pass + "\",\"apSsid\":\"" + apSsid + "\",\"apPassword\":\"" + apPass + "\",";
-                        j += "\"dhcpMode\":\"" + dhcp + "\",\"ipAddress\":\"" + ip + "\",\"subnet\":\"" + sub + "\",\"ipGateway\":\"" + gw + "\",\"ipDNS\":\"" + dns + "\",";
-                        j += "\"sendInterval\":\"" + sendInt + "\",\"protocolMode\":\"" + proto + "\",\"endpoint\":\"" + endp + "\",\"port\":\"" + port + "\",";
-                        j += "\"pubTopic\":\"" + pub + "\",\"subTopic\":\"" + subT + "\",\"mqttUsername\":\"" + mUser + "\",\"mqttPass\":\"" + mPass + "\",";
-                        j += "\"loggerMode\":" + logMode + ",\"modbusMode\":" + modMode + ",\"protocolMode2\":\"" + proto2 + "\",\"modbusPort\":\"" + mPort + "\",";
-                        j += "\"modbusSlaveID\":\"" + slave + "\",\"sendTrig\":\"" + trig + "\",\"erpUrl\":\"" + erpU + "\",\"erpUsername\":\"" + erpN + "\",\"erpPassword\":\"" + erpP + "\"";
-                        j += "}";
-
-                        File f = LittleFS.open("/configNetwork.json", "w");
-                        if (f)
-                        {
-                            f.print(j);
-                            f.close();
-                        }
-                        client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nNetwork Saved");
-                    }
-                }
+                METRIC_SPAN(METRIC_HTTP_PARSE);
+                c.rxPos += c.parser.feed(c.rx + c.rxPos, c.rxLen - c.rxPos);
             }
-
-            // ============================================================
-            // 2. HANDLE GET
-            // ============================================================
-            else if (method == "GET")
+            if (c.parser.failed())
+            {
+                RequestContext ctx = makeContext(c, nullptr);
+                sendText(ctx, "400 Bad Request", "Bad Request");
+                closeConnection(c);
+                return;
+            }
+            if (c.state == Connection::READ_HEADERS && c.parser.headersComplete())
             {
-                // --- API: HOME LOAD (BARU - Fokus Home.js) ---
-                // if (path == "/homeLoad")
-                // {
-                //     // 1. Baca Config Network (untuk Header Dashboard)
-                //     String netJson = "{}";
-                //     if (LittleFS.exists("/configNetwork.json"))
-                //     {
-                //         File f = LittleFS.open("/configNetwork.json", "r");
-                //         if (f)
-                //         {
-                //             netJson = f.readString();
-                //             f.close();
-                //         }
-                //     }
-
-                //     // 2. Baca Config Digital (untuk Task Mode Labels)
-                //     String digJson = "{}";
-                //     if (LittleFS.exists("/configDigital.json"))
-                //     {
-                //         File f = LittleFS.open("/configDigital.json", "r");
-                //         if (f)
-                //         {
-                //             digJson = f.readString();
-                //             f.close();
-                //         }
-                //     }
-
-                //     // 3. Extract Info Dasar
-                //     String nMode = getJsonVal(netJson, "networkMode");
-                //     String ssid = getJsonVal(netJson, "ssid");
-                //     String ip = getJsonVal(netJson, "ipAddress");
-                //     String sInt = getJsonVal(netJson, "sendInterval");
-                //     String pMode = getJsonVal(netJson, "protocolMode");
-                //     String endp = getJsonVal(netJson, "endpoint");
-
-                //     // Cek Status Link
-                //     String conn = (linkStatus == LinkON) ? "Connected" : "Disconnected";
-
-                //     // 4. Extract Task Mode (Manual Parse untuk 4 Pin)
-                //     // Default Normal jika file tidak ada
-                //     String tasks[4] = {"Normal", "Normal", "Normal", "Normal"};
-                //     for (int i = 1; i <= 4; i++)
-                //     {
-                //         String key = "DI" + String(i);
-                //         // Cari blok DIx
-                //         String searchKey = "\"" + key + "\":";
-                //         int startPos = digJson.indexOf(searchKey);
-                //         if (startPos != -1)
-                //         {
-                //             int openB = digJson.indexOf("{", startPos);
-                //             int closeB = digJson.indexOf("}", openB);
-                //             if (openB != -1 && closeB != -1)
-                //             {
-                //                 String block = digJson.substring(openB, closeB + 1);
-                //                 String val = getJsonVal(block, "taskMode");
-                //                 if (val != "")
-                //                     tasks[i - 1] = val;
-                //             }
-                //         }
-                //     }
-
-                //     // 5. Rakit JSON Response (Sesuai struktur home.js)
-                //     String res = "{";
-                //     res += "\"networkMode\":\"" + nMode + "\",";
-                //     res += "\"ssid\":\"" + ssid + "\",";
-                //     res += "\"ipAddress\":\"" + ip + "\",";
-                //     res += "\"macAddress\":\"02:00:00:00:00:01\","; // Hardcode (sesuai main.cpp)
-                //     res += "\"connStatus\":\"" + conn + "\",";
-                //     res += "\"jobNumber\":\"JOB-001\","; // Dummy
-                //     res += "\"sendInterval\":\"" + sInt + "\",";
-                //     res += "\"protocolMode\":\"" + pMode + "\",";
-                //     res += "\"endpoint\":\"" + endp + "\",";
-
-                //     // DI Object
-                //     res += "\"DI\":{";
-                //     res += "\"value\":[0,0,0,0],"; // Dummy Sensor Values (0)
-                //     res += "\"taskMode\":[\"" + tasks[0] + "\",\"" + tasks[1] + "\",\"" + tasks[2] + "\",\"" + tasks[3] + "\"]";
-                //     res += "},";
-
-                //     // AI Object
-                //     res += "\"AI\":{";
-                //     res += "\"rawValue\":[0,0,0,0],";
-                //     res += "\"scaledValue\":[0,0,0,0]";
-                //     res += "},";
-
-                //     res += "\"enAI\":[1,1,1,1],";
-                //     res += "\"datetime\":\"2024-01-01 12:00:00\"";
-                //     res += "}";
-
-                //     client.println("HTTP/1.1 200 OK");
-                //     client.println("Content-Type: application/json");
-                //     client.println("Connection: close");
-                //     client.println();
-                //     client.print(res);
-                //     client.stop();
-                //     return;
-                // }
-
-
-if (path == "/homeLoad")
+                const Route *route = WebRoutes::find(c.parser.method(), c.parser.path());
+                if (route && route->streamBody)
                 {
-                    // 1. Baca Config Network
-                    String netJson = "{}";
-                    if (LittleFS.exists("/configNetwork.json")) {
-                        File f = LittleFS.open("/configNetwork.json", "r");
-                        if (f) { netJson = f.readString(); f.close(); }
-                    }
-
-                    // 2. Baca Config Digital
-                    String digJson = "{}";
-                    if (LittleFS.exists("/configDigital.json")) {
-                        File f = LittleFS.open("/configDigital.json", "r");
-                        if (f) { digJson = f.readString(); f.close(); }
-                    }
-
-                    String nMode = getJsonVal(netJson, "networkMode");
-                    String ssid = getJsonVal(netJson, "ssid");
-                    String ip = getJsonVal(netJson, "ipAddress");
-                    String sInt = getJsonVal(netJson, "sendInterval");
-                    String pMode = getJsonVal(netJson, "protocolMode");
-                    String endp = getJsonVal(netJson, "endpoint");
-                    String conn = (linkStatus == LinkON) ? "Connected" : "Disconnected";
-
-                    String tasks[4] = {"Normal", "Normal", "Normal", "Normal"};
-                    // (Logika parsing taskMode tetap sama...)
-
-                    // 5. Rakit JSON Response dengan DATA MODBUS REAL
-                    String res = "{";
-                    res += "\"networkMode\":\"" + nMode + "\",";
-                    res += "\"ssid\":\"" + ssid + "\",";
-                    res += "\"ipAddress\":\"" + ip + "\",";
-                    res += "\"macAddress\":\"02:00:00:00:00:01\","; 
-                    res += "\"connStatus\":\"" + conn + "\",";
-                    res += "\"jobNumber\":\"JOB-001\","; 
-                    res += "\"sendInterval\":\"" + sInt + "\",";
-                    res += "\"protocolMode\":\"" + pMode + "\",";
-                    res += "\"endpoint\":\"" + endp + "\",";
-
-                    // --- BAGIAN INI MENGGUNAKAN DATA MODBUS ---
-                    res += "\"DI\":{";
-                    // Contoh: Menggunakan register 0-3 sebagai nilai sensor
-                    res += "\"value\":[" + String(modbusData[0]) + "," + String(modbusData[1]) + "," + String(modbusData[2]) + "," + String(modbusData[3]) + "],"; 
-                    res += "\"taskMode\":[\"" + tasks[0] + "\",\"" + tasks[1] + "\",\"" + tasks[2] + "\",\"" + tasks[3] + "\"]";
-                    res += "},";
-
-                    res += "\"AI\":{";
-                    // Contoh: Menampilkan nilai mentah yang sama (bisa disesuaikan jika register AI berbeda)
-                    res += "\"rawValue\":[" + String(modbusData[0]) + "," + String(modbusData[1]) + "," + String(modbusData[2]) + "," + String(modbusData[3]) + "],";
-                    res += "\"scaledValue\":[" + String(modbusData[0]) + "," + String(modbusData[1]) + "," + String(modbusData[2]) + "," + String(modbusData[3]) + "]";
-                    res += "},";
-                    // ------------------------------------------
-
-                    res += "\"enAI\":[1,1,1,1],";
-                    res += "\"datetime\":\"2024-01-01 12:00:00\"";
-                    res += "}";
-
-                    client.println("HTTP/1.1 200 OK");
-                    client.println("Content-Type: application/json");
-                    client.println("Connection: close");
-                    client.println();
-                    client.print(res);
-                    client.stop();
+                    // Body tidak di-buffer: serahkan ke handler per potongan
+                    c.state = Connection::STREAM_BODY;
+                    c.streamHandler = route->handler;
+                    c.bodyOffset = 0;
+                    c.keepAlive = c.parser.keepAlive();
+                    METRIC_ADD(METRIC_HTTP_REQUESTS, 1);
+                    streamBody(c, true);
                     return;
                 }
+                c.state = Connection::READ_BODY;
+            }
+            if (c.parser.complete())
+            {
+                dispatch(c);
+                return;
+            }
+        }
+        // Body kosong (GET) sudah lengkap bersamaan dengan header
+        if (c.state == Connection::READ_BODY && c.parser.complete())
+        {
+            dispatch(c);
+            return;
+        }
+        if (!c.client.connected())
+        {
+            closeConnection(c);
+            return;
+        }
+        if (now - c.lastActivityMs > (c.requestStarted ? HTTP_READ_TIMEOUT_MS : HTTP_KEEPALIVE_TIMEOUT_MS))
+        {
+            if (c.requestStarted)
+            {
+                RequestContext ctx = makeContext(c, nullptr);
+                sendText(ctx, "408 Request Timeout", "Request Timeout");
+            }
+            closeConnection(c);
+        }
+        break;
 
-                // --- API Config Loads ---
-                else if (path == "/settingsLoad")
-                    path = "/systemSettings.json";
-                else if (path == "/modbusLoad")
-                    path = "/modbusSetup.json";
-                else if (path.indexOf("/networkLoad") != -1)
-                {
-                    if (path.indexOf("restart=1") != -1)
-                    {
-                        client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nRestarting...");
-                        client.stop();
-                        delay(500);
-                        ESP.restart();
-                        return;
-                    }
-                    path = "/configNetwork.json";
-                }
+    case Connection::STREAM_BODY:
+        streamBody(c, false);
+        break;
 
-                // --- API Digital Load ---
-                else if (path.indexOf("/digitalLoad") != -1)
-                {
-                    int qMark = path.indexOf('?');
-                    String query = (qMark != -1) ? path.substring(qMark + 1) : "";
-                    String inputVal = getParam(query, "input");
-                    if (inputVal != "")
-                    {
-                        String targetKey = "DI" + inputVal;
-                        String jsonContent = "{}";
-                        File f = LittleFS.open("/configDigital.json", "r");
-                        if (f)
-                        {
-                            jsonContent = f.readString();
-                            f.close();
-                        }
-
-                        String searchKey = "\"" + targetKey + "\":";
-                        int startPos = jsonContent.indexOf(searchKey);
-                        String pinBlock = "";
-                        if (startPos != -1)
-                        {
-                            int openBrace = jsonContent.indexOf("{", startPos);
-                            int closeBrace = jsonContent.indexOf("}", openBrace);
-                            if (openBrace != -1 && closeBrace != -1)
-                                pinBlock = jsonContent.substring(openBrace, closeBrace + 1);
-                        }
-                        String name = getJsonVal(pinBlock, "name");
-                        String inv = getJsonVal(pinBlock, "invers");
-                        String tm = getJsonVal(pinBlock, "taskMode");
-                        String is = getJsonVal(pinBlock, "inputState");
-                        String it = getJsonVal(pinBlock, "intervalTime");
-                        String cf = getJsonVal(pinBlock, "conversionFactor");
-
-                        String respJson = "{";
-                        respJson += "\"nameDI\":\"" + name + "\",\"invDI\":" + (inv == "" ? "0" : inv) + ",";
-                        respJson += "\"taskMode\":\"" + tm + "\",\"inputState\":\"" + is + "\",";
-                        respJson += "\"intervalTime\":" + (it == "" ? "0" : it) + ",\"conversionFactor\":" + (cf == "" ? "0" : cf);
-                        respJson += "}";
-                        client.println("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n" + respJson);
-                        client.stop();
-                        return;
-                    }
-                    else
-                    {
-                        path = "/configDigital.json";
-                    }
-                }
+    case Connection::SEND_FILE:
+        sendFileChunk(c);
+        break;
 
-                // --- API OTA Status ---
-                else if (path == "/updateStatus")
-                {
-                    String json = "{";
-                    json += "\"freeHeap\":" + String(ESP.getFreeHeap()) + ",";
-                    json += "\"sketchSize\":" + String(ESP.getSketchSize()) + ",";
-                    json += "\"freeSketchSpace\":" + String(ESP.getFreeSketchSpace());
-                    json += "}";
-                    client.println("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n" + json);
-                    client.stop();
-                    return;
-                }
+    case Connection::EVENT_STREAM:
+        sendEvents(c);
+        break;
 
-                else if (path == "/getTime")
-                {
-                    client.println("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n{\"datetime\":\"2024-01-01 12:00:00\"}");
-                    client.stop();
-                    return;
-                }
-                else if (path == "/getValue")
-                {
-                    client.println("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n[]");
-                    client.stop();
-                    return;
-                }
+    default:
+        break;
+    }
+}
 
-                // --- Routing Pages ---
-                if (path == "/")
-                    path = "/home.html";
-                else if (path == "/home")
-                    path = "/home.html";
-                else if (path == "/network")
-                    path = "/network.html";
-                else if (path == "/analog_input")
-                    path = "/analog_input.html";
-                else if (path == "/digital_IO")
-                    path = "/digital_IO.html";
-                else if (path == "/modbus_setup")
-                    path = "/modbus_setup.html";
-                else if (path == "/system_settings")
-                    path = "/system_settings.html";
-                else if (path == "/updateOTA")
-                    path = "/UpdateOTA.html";
-
-                // --- Routing JS ---
-                if (path.indexOf("network.js") != -1)
-                    path = "/js/network.js";
-                if (path.indexOf("system_setting.js") != -1)
-                    path = "/js/system_setting.js";
-                if (path.indexOf("modbus_setup.js") != -1)
-                    path = "/js/modbus_setup.js";
-                if (path.indexOf("digital_IO.js") != -1)
-                    path = "/js/digital_IO.js";
-                if (path.indexOf("UpdateOTA.js") != -1)
-                    path = "/js/UpdateOTA.js";
-                if (path.indexOf("home.js") != -1)
-                    path = "/js/home.js"; // Tambahan JS Home
-
-                // --- Serve File ---
-                String pathWithGz = path + ".gz";
-                bool fileFound = false;
-                bool isGzipped = false;
-
-                if (LittleFS.exists(pathWithGz))
-                {
-                    fileFound = true;
-                    isGzipped = true;
-                    path = pathWithGz;
-                }
-                else if (LittleFS.exists(path))
-                {
-                    fileFound = true;
-                    isGzipped = false;
-                }
+void WebServerHandler::dispatch(Connection &c)
+{
+    const Route *route = WebRoutes::find(c.parser.method(), c.parser.path());
 
-                if (fileFound)
-                {
-                    File file = LittleFS.open(path, "r");
-                    String filenameForMime = isGzipped ? path.substring(0, path.length() - 3) : path;
-                    String dataType = getContentType(filenameForMime);
-
-                    client.println("HTTP/1.1 200 OK");
-                    client.println("Content-Type: " + dataType);
-                    if (isGzipped)
-                        client.println("Content-Encoding: gzip");
-                    client.println("Connection: close");
-                    client.println();
-
-                    if (filenameForMime.endsWith(".html") && !isGzipped)
-                    {
-                        while (file.available())
-                        {
-                            String line = file.readStringUntil('\n');
-                            if (line.indexOf("{{") != -1 && line.indexOf("}}") != -1)
-                            {
-                                int s = line.indexOf("{{") + 2;
-                                int e = line.indexOf("}}");
-                                String var = line.substring(s, e);
-                                line.replace("{{" + var + "}}", processor(var, linkStatus));
-                            }
-                            client.println(line);
-                        }
-                    }
-                    else
-                    {
-                        uint8_t buf[512];
-                        while (file.available())
-                        {
-                            int n = file.read(buf, sizeof(buf));
-                            client.write(buf, n);
-                        }
-                    }
-                    file.close();
-                }
-                else
-                {
-                    Serial.print("ERROR 404: ");
-                    Serial.println(path);
-                    client.println("HTTP/1.1 404 Not Found");
-                    client.println("Content-Type: text/plain");
-                    client.println();
-                    client.println("404: File Not Found");
-                }
+    RequestContext ctx = makeContext(c, route ? route->asset : nullptr);
+    METRIC_ADD(METRIC_HTTP_REQUESTS, 1);
+
+    // Uncomment untuk debug path
+    // Serial.print("Req: "); Serial.print(c.parser.methodName()); Serial.print(" "); Serial.println(c.parser.path());
+
+    {
+        METRIC_SPAN(METRIC_HTTP_HANDLER);
+        if (c.parser.bodyTruncated())
+        {
+            // Body terpotong tidak boleh sampai ke parser config
+            sendText(ctx, "413 Payload Too Large", "Payload Too Large");
+        }
+        else if (route)
+        {
+            (this->*route->handler)(ctx);
+        }
+        else if (c.parser.method() == HTTP_METHOD_GET)
+        {
+            // Path tak terdaftar: coba sebagai file statis (css, gambar, dll)
+            serveFile(ctx);
+        }
+        else
+        {
+            sendText(ctx, "404 Not Found", "404: Not Found");
+        }
+    }
+
+    if (ctx.eventStream)
+    {
+        // Mulai dari event berikutnya; retained sudah dikirim handler
+        c.state = Connection::EVENT_STREAM;
+        c.eventPos = events.head();
+        c.lastActivityMs = millis();
+        return;
+    }
+    if (ctx.file)
+    {
+        // Isi file dikirim bertahap di giliran berikutnya
+        c.file = ctx.file;
+        c.fileRemaining = ctx.fileRemaining;
+        c.keepAlive = ctx.keepAlive;
+        c.state = Connection::SEND_FILE;
+        c.lastActivityMs = millis();
+        return;
+    }
+    finishResponse(c, ctx.keepAlive);
+}
+
+// Teruskan potongan body ke handler streamBody (mis. OTA), beberapa
+// potongan rx per giliran sampai HTTP_STREAM_BUDGET byte. Handler boleh
+// mengambil sebagian (ctx.consumed); sisanya ditawarkan lagi giliran
+// berikutnya.
+void WebServerHandler::streamBody(Connection &c, bool start)
+{
+    uint32_t total = c.parser.contentLength();
+    size_t budget = HTTP_STREAM_BUDGET;
+    for (;;)
+    {
+        bool gotData = c.rxPos < c.rxLen || fillRx(c);
+        if (!gotData && !start)
+            break;
+        RequestContext ctx = makeContext(c, nullptr);
+        ctx.keepAlive = c.keepAlive;
+        ctx.bodyStart = start;
+        size_t n = gotData ? min((size_t)(c.rxLen - c.rxPos), (size_t)(total - c.bodyOffset)) : 0;
+        ctx.pending = c.rx + c.rxPos;
+        ctx.pendingLen = n;
+        ctx.consumed = n;
+        ctx.bodyOffset = c.bodyOffset;
+        (this->*c.streamHandler)(ctx);
+        c.rxPos += ctx.consumed;
+        c.bodyOffset += ctx.consumed;
+        if (ctx.done)
+        {
+            finishResponse(c, ctx.keepAlive && c.bodyOffset >= total);
+            return;
+        }
+        start = false;
+        if (ctx.consumed > 0)
+            c.lastActivityMs = millis();
+        if (n == 0 || ctx.consumed < n || ctx.consumed >= budget)
+            break;
+        budget -= ctx.consumed;
+    }
+
+    if (!c.client.connected() || millis() - c.lastActivityMs > HTTP_READ_TIMEOUT_MS)
+        closeConnection(c);
+}
+
+void WebServerHandler::sendFileChunk(Connection &c)
+{
+    METRIC_SPAN(METRIC_FILE_SERVE);
+    uint8_t buf[HTTP_SEND_CHUNK];
+    size_t want = min((size_t)c.fileRemaining, sizeof(buf));
+    int n = want ? c.file.read(buf, want) : 0;
+    if (n > 0)
+    {
+        // Socket bisa menerima sebagian saja: sisa dibaca ulang putaran berikutnya
+        size_t sent = c.client.write(buf, n);
+        if (sent < (size_t)n)
+            c.file.seek(c.file.position() - (n - sent));
+        METRIC_ADD(METRIC_HTTP_TX_BYTES, sent);
+        c.fileRemaining -= sent;
+        if (sent > 0)
+            c.lastActivityMs = millis();
+    }
+    if (n <= 0 || c.fileRemaining == 0)
+    {
+        c.file.close();
+        // File terpotong = Content-Length tidak terpenuhi -> wajib tutup
+        finishResponse(c, c.keepAlive && c.fileRemaining == 0);
+    }
+    else if (!c.client.connected() || millis() - c.lastActivityMs > HTTP_WRITE_TIMEOUT_MS)
+    {
+        c.file.close();
+        closeConnection(c);
+    }
+}
+
+WebServerHandler::RequestContext WebServerHandler::makeContext(Connection &c, const char *asset)
+{
+    RequestContext ctx = {c.client, c.parser, _linkStatus, asset,
+                          nullptr, 0, 0, 0, false, false, false,
+                          c.parser.keepAlive(), File(), 0, false};
+    return ctx;
+}
+
+// Teruskan event baru ke satu subscriber, maksimal HTTP_SEND_CHUNK per giliran
+void WebServerHandler::sendEvents(Connection &c)
+{
+    // Request dari client pada koneksi SSE diabaikan
+    while (c.client.available() > 0)
+        c.client.read(c.rx, sizeof(c.rx));
+
+    if (!c.client.connected())
+    {
+        closeConnection(c);
+        return;
+    }
+    if (events.overrun(c.eventPos))
+    {
+        // Terlalu lambat: putus, browser reconnect dan dapat retained lagi
+        events.countLagged();
+        closeConnection(c);
+        return;
+    }
+
+    // Hanya sebanyak ruang TX socket: subscriber lambat tidak menahan loop
+    static const char ping[] = ": ping\n\n";
+    int room = c.client.availableForWrite();
+    if (room <= 0)
+        return;
+    uint8_t buf[HTTP_SEND_CHUNK];
+    uint32_t pos = c.eventPos;
+    size_t n = events.read(pos, buf, min((size_t)room, sizeof(buf)));
+    if (n > 0)
+    {
+        // Posisi maju sebanyak yang terkirim; sisa frame dibaca ulang nanti
+        size_t sent = c.client.write(buf, n);
+        METRIC_ADD(METRIC_HTTP_TX_BYTES, sent);
+        c.eventPos += sent;
+        if (sent > 0)
+            c.lastActivityMs = millis();
+    }
+    else if (millis() - c.lastActivityMs > HTTP_EVENT_PING_MS && (size_t)room >= sizeof(ping) - 1)
+    {
+        // Komentar SSE: menjaga proxy tetap terbuka & mendeteksi socket mati
+        c.client.print(ping);
+        c.lastActivityMs = millis();
+    }
+}
+
+// Respon selesai: kembali menunggu request berikutnya atau tutup socket
+void WebServerHandler::finishResponse(Connection &c, bool keepAlive)
+{
+    if (!keepAlive || !c.client.connected())
+    {
+        closeConnection(c);
+        return;
+    }
+    // Sisa byte di rx (pipelining) diproses di giliran berikutnya
+    c.parser.reset();
+    c.state = Connection::READ_HEADERS;
+    c.requestStarted = false;
+    c.lastActivityMs = millis();
+}
+
+void WebServerHandler::closeConnection(Connection &c)
+{
+    if (c.state == Connection::STREAM_BODY)
+    {
+        // Beri tahu handler agar membatalkan pekerjaannya (mis. OTA ditahan untuk dilanjutkan)
+        RequestContext ctx = makeContext(c, nullptr);
+        ctx.aborted = true;
+        (this->*c.streamHandler)(ctx);
+    }
+    if (c.file)
+        c.file.close();
+    c.client.stop();
+    c.state = Connection::FREE;
+}
+
+// ---------------------------------------------------------
+// Handler API (GET)
+// ---------------------------------------------------------
+void WebServerHandler::handleHomeLoad(RequestContext &ctx)
+{
+    // Info network & task mode langsung dari cache RAM (tanpa baca flash)
+    const NetworkConfig &net = config.network();
+    const DigitalConfig &dig = config.digital();
+
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    JsonWriter json(body);
+    json.beginObject();
+    json.kv("networkMode", net.networkMode);
+    json.kv("ssid", net.ssid);
+    json.kv("ipAddress", net.ipAddress);
+    json.kv("macAddress", "02:00:00:00:00:01");
+    json.kv("connStatus", ctx.linkStatus == LinkON ? "Connected" : "Disconnected");
+    json.kv("jobNumber", "JOB-001");
+    char interval[12];
+    snprintf(interval, sizeof(interval), "%lu", (unsigned long)net.sendInterval);
+    json.kv("sendInterval", interval); // tetap string seperti format lama
+    json.kv("protocolMode", net.protocolMode);
+    json.kv("endpoint", net.endpoint);
+
+    // --- BAGIAN INI MENGGUNAKAN DATA MODBUS ---
+    // Register mentah 4 tag pertama dari poller
+    for (int i = 0; i < 4; i++)
+    {
+        ModbusReading r;
+        modbusData[i] = modbus.reading(i, r) ? r.raw : 0;
+    }
+    json.beginObject("DI");
+    json.beginArray("value");
+    for (int i = 0; i < CFG_DI_COUNT; i++)
+        json.value((long)digitalInputs.value(i));
+    json.endArray();
+    json.beginArray("taskMode");
+    for (int i = 0; i < CFG_DI_COUNT; i++)
+        json.value(dig.di[i].taskMode);
+    json.endArray();
+    json.endObject();
+
+    // Contoh: Menampilkan nilai mentah yang sama (bisa disesuaikan jika register AI berbeda)
+    json.beginObject("AI");
+    json.beginArray("rawValue");
+    for (int i = 0; i < 4; i++)
+        json.value(modbusData[i]);
+    json.endArray();
+    json.beginArray("scaledValue");
+    for (int i = 0; i < 4; i++)
+        json.value(modbusData[i]);
+    json.endArray();
+    json.endObject();
+    // ------------------------------------------
+
+    json.beginArray("enAI");
+    for (int i = 0; i < 4; i++)
+        json.value(1);
+    json.endArray();
+    json.kv("datetime", "2024-01-01 12:00:00");
+    json.endObject();
+    body.end();
+}
+
+// GET /info: bagian statis dashboard, diambil sekali oleh home.js.
+// ETag = revisi config, jadi reload halaman cukup dijawab 304.
+void WebServerHandler::handleInfo(RequestContext &ctx)
+{
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"cfg-%lu\"", (unsigned long)config.revision());
+    if (AssetCache::etagMatches(etag, ctx.req.ifNoneMatch()))
+    {
+        ctx.client.printf("HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: no-cache\r\nConnection: %s\r\n\r\n",
+                          etag, connectionHeader(ctx));
+        return;
+    }
+    char headers[64];
+    snprintf(headers, sizeof(headers), "ETag: %s\r\nCache-Control: no-cache\r\n", etag);
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json", headers));
+    config.writeInfoJson(body);
+    body.end();
+}
+
+// GET /live?since=<seq>&fmt=bin: hanya nilai yang berubah.
+// since == seq terbaru -> 204 (tanpa body). fmt=bin -> LIVE_BINARY_SIZE byte.
+void WebServerHandler::handleLive(RequestContext &ctx)
+{
+    LiveSnapshot snap;
+    live.read(snap);
+    bool linkOn = ctx.linkStatus == LinkON;
+
+    String since = getParam(ctx.req.query(), "since");
+    if (since != "" && (uint32_t)strtoul(since.c_str(), nullptr, 10) == snap.seq)
+    {
+        ctx.client.printf("HTTP/1.1 204 No Content\r\nCache-Control: no-store\r\nConnection: %s\r\n\r\n",
+                          connectionHeader(ctx));
+        return;
+    }
+
+    if (getParam(ctx.req.query(), "fmt") == "bin")
+    {
+        uint8_t bin[LIVE_BINARY_SIZE];
+        size_t n = LiveData::encodeBinary(snap, linkOn, bin, sizeof(bin));
+        sendBody(ctx, "application/octet-stream", bin, n);
+    }
+    else
+    {
+        char json[256];
+        size_t n = LiveData::encodeJson(snap, linkOn, json, sizeof(json));
+        sendBody(ctx, "application/json", (const uint8_t *)json, n);
+    }
+}
+
+#if METRICS_ENABLED
+// Format teks Prometheus (histogram latensi, counter HTTP, heap)
+void WebServerHandler::handleMetrics(RequestContext &ctx)
+{
+    ChunkedPrint body(ctx.client, beginStream(ctx, "text/plain; version=0.0.4"));
+    metrics.writePrometheus(body);
+    body.end();
+}
+#endif
+
+void WebServerHandler::handleSettingsLoad(RequestContext &ctx)
+{
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    config.writeSystemJson(body);
+    body.end();
+}
+
+void WebServerHandler::handleModbusLoad(RequestContext &ctx)
+{
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    config.writeModbusJson(body);
+    body.end();
+}
+
+void WebServerHandler::handleNetworkLoad(RequestContext &ctx)
+{
+    if (getParam(ctx.req.query(), "restart") == "1")
+    {
+        ctx.client.println("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nRestarting...");
+        ctx.client.stop();
+        config.flush(); // simpan yang masih menunggu debounce
+        logger.flush();
+        uplink.saveCursor();
+        delay(500);
+        ESP.restart();
+        return;
+    }
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    config.writeNetworkJson(body);
+    body.end();
+}
+
+void WebServerHandler::handleAnalogLoad(RequestContext &ctx)
+{
+    int idx = getParam(ctx.req.query(), "input").toInt() - 1;
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    if (idx >= 0 && idx < CFG_AI_COUNT)
+        config.writeAnalogChannelJson(body, idx);
+    else
+        config.writeAnalogJson(body);
+    body.end();
+}
+
+void WebServerHandler::handleDigitalLoad(RequestContext &ctx)
+{
+    int idx = getParam(ctx.req.query(), "input").toInt() - 1;
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    if (idx >= 0 && idx < CFG_DI_COUNT)
+    {
+        // Nama field mengikuti digital_IO.js
+        const DigitalInputConfig &di = config.digital().di[idx];
+        JsonWriter json(body);
+        json.beginObject();
+        json.kv("nameDI", di.name);
+        json.kv("invDI", di.invers ? 1 : 0);
+        json.kv("taskMode", di.taskMode);
+        json.kv("inputState", di.inputState);
+        json.kv("intervalTime", di.intervalTime);
+        json.kv("conversionFactor", di.conversionFactor, 3);
+        // Hasil pengukuran terakhir (window intervalTime)
+        const DiReading &r = digitalInputs.reading(idx);
+        json.kv("value", r.value, 3);
+        json.kv("frequency", r.frequency, 2);
+        json.kv("duty", r.duty, 3);
+        json.kv("count", (unsigned long)r.count);
+        json.kv("level", r.level ? 1 : 0);
+        json.endObject();
+    }
+    else
+    {
+        config.writeDigitalJson(body);
+    }
+    body.end();
+}
+
+void WebServerHandler::handleUpdateStatus(RequestContext &ctx)
+{
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    JsonWriter json(body);
+    json.beginObject();
+    json.kv("freeHeap", ESP.getFreeHeap());
+    json.kv("sketchSize", ESP.getSketchSize());
+    json.kv("freeSketchSpace", ESP.getFreeSketchSpace());
+    json.kv("httpActive", activeConnections());
+    json.kv("httpAccepted", _accepted);
+    json.kv("httpRejected", _rejected);
+    json.kv("eventSubscribers", eventSubscribers());
+    json.kv("eventLagged", events.lagged());
+    json.kv("configJournal", config.journal().size());
+    json.kv("modbusBlocks", modbus.blockCount());
+    json.kv("modbusRequests", modbus.requests());
+    json.kv("modbusErrors", modbus.errors());
+    json.kv("modbusTcpClients", modbusTcp.activeClients());
+    json.kv("modbusTcpRequests", modbusTcp.requests());
+    json.kv("configPending", config.pending());
+    json.kv("logRecords", logger.records());
+    json.kv("logSegments", logger.segments());
+    json.kv("logDropped", logger.dropped());
+    json.kv("uplinkSent", uplink.sent());
+    json.kv("uplinkRecords", uplink.sentRecords());
+    json.kv("uplinkFailures", uplink.failures());
+    json.kv("uplinkLag", uplink.enabled() ? logger.now() - uplink.cursor() : 0);
+    json.kv("uplinkError", uplink.error());
+    json.beginObject("ota");
+    json.kv("state", ota.stateName());
+    json.kv("size", ota.size());
+    json.kv("received", ota.received());
+    json.kv("written", ota.written());
+    json.kv("progress", ota.size() ? (double)ota.received() / ota.size() : 0.0, 3);
+    json.kv("bytesPerSec", ota.bytesPerSecond());
+    json.kv("elapsedMs", ota.activeMs());
+    json.kv("md5", ota.md5());
+    json.kv("error", ota.error());
+    json.endObject();
+    json.beginArray("tasks");
+    for (uint8_t i = 0; i < taskMonitor.count(); i++)
+    {
+        const TaskInfo &t = taskMonitor.task(i);
+        json.beginObject();
+        json.kv("name", t.name);
+        json.kv("core", t.core);
+        json.kv("stackFree", t.stackFree);
+        json.kv("load", t.load, 1);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    body.end();
+}
+
+void WebServerHandler::handleGetTime(RequestContext &ctx)
+{
+    sendJson(ctx, "{\"datetime\":\"2024-01-01 12:00:00\"}");
+}
+
+// Isi array JSON tanpa '[' dan ']' (nullptr / "[]" -> kosong)
+static size_t arrayItems(const char *json, const char *&items)
+{
+    size_t n = json ? strlen(json) : 0;
+    if (n < 3)
+        return 0;
+    items = json + 1;
+    return n - 2;
+}
+
+// "ch=0,2,Suhu1": nomor channel log atau KodeSensor; kosong = semua
+static uint32_t logChannelMask(const String &list)
+{
+    if (list == "")
+        return 0xFFFFFFFFUL;
+    uint32_t mask = 0;
+    int start = 0;
+    while (start <= (int)list.length())
+    {
+        int comma = list.indexOf(',', start);
+        String item = list.substring(start, comma < 0 ? list.length() : comma);
+        start = comma < 0 ? list.length() + 1 : comma + 1;
+        if (item == "")
+            continue;
+        if (isDigit(item.charAt(0)))
+        {
+            long ch = item.toInt();
+            if (ch < LOG_CHANNELS)
+                mask |= 1UL << ch;
+            continue;
+        }
+        for (uint8_t ch = 0; ch < LOG_CHANNELS; ch++)
+        {
+            char fallback[8];
+            if (item == DataLogger::channelName(ch, fallback, sizeof(fallback)))
+                mask |= 1UL << ch;
+        }
+    }
+    return mask;
+}
+
+// Waktu query: angka = jam log (detik), "-N" = N detik sebelum sekarang
+static uint32_t logTime(const String &param, uint32_t now, uint32_t fallback)
+{
+    if (param == "")
+        return fallback;
+    if (param.charAt(0) == '-')
+    {
+        uint32_t ago = strtoul(param.c_str() + 1, nullptr, 10);
+        return ago < now ? now - ago : 0;
+    }
+    return strtoul(param.c_str(), nullptr, 10);
+}
+
+// GET /getValue?from=&to=&ch=: riwayat dari DataLogger, di-stream per
+// record. Maks. LOG_QUERY_MAX titik; jika terpotong "next" berisi from
+// untuk halaman berikutnya (record dengan waktu yang sama tidak dipisah).
+void WebServerHandler::handleHistory(RequestContext &ctx)
+{
+    const char *query = ctx.req.query();
+    uint32_t now = logger.now();
+    uint32_t from = logTime(getParam(query, "from"), now, now > 3600 ? now - 3600 : 0);
+    uint32_t to = logTime(getParam(query, "to"), now, now);
+    uint32_t mask = logChannelMask(getParam(query, "ch"));
+
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    JsonWriter json(body);
+    json.beginObject();
+    json.kv("now", now);
+    json.kv("from", from);
+    json.kv("to", to);
+    json.kv("oldest", logger.oldest());
+    json.beginArray("channels");
+    for (uint8_t ch = 0; ch < LOG_CHANNELS; ch++)
+    {
+        char fallback[8];
+        if (!(mask & (1UL << ch)))
+            continue;
+        if (ch >= CFG_AI_COUNT && ch < LOG_CH_DI)
+            continue;
+        if (ch >= LOG_CH_DI + CFG_DI_COUNT && ch < LOG_CH_MODBUS)
+            continue;
+        if (ch >= LOG_CH_MODBUS && ch - LOG_CH_MODBUS >= config.modbus().tagCount)
+            continue;
+        json.beginObject();
+        json.kv("ch", ch);
+        json.kv("KodeSensor", DataLogger::channelName(ch, fallback, sizeof(fallback)));
+        json.endObject();
+    }
+    json.endArray();
+
+    // [waktu, channel, nilai]
+    json.beginArray("data");
+    static LogCursor cursor; // +-250 byte, hanya dipakai task comms
+    LogRecord r;
+    uint32_t points = 0, lastTime = 0;
+    bool more = false;
+    logger.openRange(cursor, from, to, mask);
+    while (logger.next(cursor, r))
+    {
+        if (points >= LOG_QUERY_MAX && r.time != lastTime)
+        {
+            more = true;
+            break;
+        }
+        json.beginArray();
+        json.value(r.time);
+        json.value(r.channel);
+        json.value(r.value);
+        json.endArray();
+        lastTime = r.time;
+        points++;
+    }
+    cursor.file.close();
+    json.endArray();
+    if (more)
+        json.kv("next", r.time);
+    json.endObject();
+    body.end();
+}
+
+// GET /rollup?from=&to=&ch=&points=: min/max/mean/count per bucket dengan
+// resolusi (1 s .. 1 h) yang dipilih otomatis dari panjang range.
+// data: [[waktu, min, max, mean, count], ...], bucket kosong dilewati.
+void WebServerHandler::handleRollup(RequestContext &ctx)
+{
+    const char *query = ctx.req.query();
+    uint32_t now = logger.now();
+    uint32_t from = logTime(getParam(query, "from"), now, now > 600 ? now - 600 : 0);
+    uint32_t to = logTime(getParam(query, "to"), now, now);
+    uint32_t mask = logChannelMask(getParam(query, "ch"));
+    long points = getParam(query, "points").toInt();
+    if (points <= 0 || points > ROLLUP_MAX_POINTS)
+        points = ROLLUP_MAX_POINTS;
+    // Bucket masa depan tidak ada; tanpa batas ini to=4294967295 memutar
+    // loop di bawah ~2^32/res kali per channel di task comms
+    if (to > now)
+        to = now;
+    if (from > to)
+    {
+        sendText(ctx, "400 Bad Request", "from > to");
+        return;
+    }
+
+    uint8_t level = rollups.pickLevel(from, to, points, now);
+    uint32_t res = RollupEngine::resolution(level);
+    uint32_t start = from - from % res;
+    // Bucket yang sudah tertimpa ring tidak perlu dicari
+    uint32_t kept = res * (RollupEngine::capacity(level) - 1);
+    uint32_t oldest = now > kept ? (now - now % res) - kept : 0;
+    if (start < oldest)
+        start = oldest;
+    // Maks. points bucket per series, yang terbaru diutamakan
+    uint32_t last = to - to % res;
+    if (last >= start && (last - start) / res >= (uint32_t)points)
+        start = last - (uint32_t)(points - 1) * res;
+
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    JsonWriter json(body);
+    json.beginObject();
+    json.kv("now", now);
+    json.kv("res", res);
+    json.kv("from", start);
+    json.kv("to", to);
+    json.beginArray("series");
+    for (uint8_t ch = 0; ch < ROLLUP_CHANNELS; ch++)
+    {
+        if (!(mask & (1UL << (LOG_CH_AI + ch))))
+            continue;
+        char fallback[8];
+        json.beginObject();
+        json.kv("ch", LOG_CH_AI + ch);
+        json.kv("KodeSensor", DataLogger::channelName(LOG_CH_AI + ch, fallback, sizeof(fallback)));
+        json.beginArray("data");
+        RollupBucket b;
+        for (uint32_t t = start; t <= to && t >= start; t += res)
+        {
+            if (!rollups.bucket(level, LOG_CH_AI + ch, t, b))
+                continue;
+            json.beginArray();
+            json.value(b.time);
+            json.value(b.min);
+            json.value(b.max);
+            json.value(b.sum / b.count);
+            json.value(b.count);
+            json.endArray();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    body.end();
+}
+
+void WebServerHandler::handleGetValue(RequestContext &ctx)
+{
+    const char *query = ctx.req.query();
+    if (getParam(query, "from") != "" || getParam(query, "to") != "" || getParam(query, "ch") != "")
+    {
+        handleHistory(ctx);
+        return;
+    }
+    // Nilai terakhir yang juga di-push lewat event "values" (AI) dan
+    // "modbus", digabung menjadi satu array
+    const char *ai = nullptr, *mb = nullptr;
+    size_t aiLen = arrayItems(events.retained("values"), ai);
+    size_t mbLen = arrayItems(events.retained("modbus"), mb);
+    ChunkedPrint body(ctx.client, beginStream(ctx, "application/json"));
+    body.print('[');
+    body.write((const uint8_t *)ai, aiLen);
+    if (aiLen && mbLen)
+        body.print(',');
+    body.write((const uint8_t *)mb, mbLen);
+    body.print(']');
+    body.end();
+}
+
+// GET /events & /debugStream: Server-Sent Events
+void WebServerHandler::handleEventStream(RequestContext &ctx)
+{
+    if (eventSubscribers() >= HTTP_MAX_EVENT_STREAMS)
+    {
+        ctx.keepAlive = false;
+        sendText(ctx, "503 Service Unavailable", "Too Many Streams");
+        return;
+    }
+    ctx.client.print("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n");
+    // Jeda reconnect browser jika koneksi diputus (mis. overrun)
+    ctx.client.print("retry: 2000\n\n");
+    events.writeRetained(ctx.client);
+    ctx.eventStream = true;
+}
+
+// ---------------------------------------------------------
+// Handler POST
+// ---------------------------------------------------------
+// "1.5,2,3.25" -> out[], maks. max item; jumlah item terbaca
+static uint8_t floatList(const String &list, float *out, uint8_t max)
+{
+    uint8_t n = 0;
+    int start = 0;
+    while (n < max && start < (int)list.length())
+    {
+        int comma = list.indexOf(',', start);
+        String item = list.substring(start, comma < 0 ? list.length() : comma);
+        start = comma < 0 ? list.length() : comma + 1;
+        item.trim();
+        if (item != "")
+            out[n++] = item.toFloat();
+    }
+    return n;
+}
+
+// Form config (system, modbus serial, analog, digital, network/ERP)
+// dibedakan dari isi body karena semua halaman POST ke "/".
+void WebServerHandler::handleConfigSave(RequestContext &ctx)
+{
+    String body = ctx.req.body();
+
+    // --- System Settings ---
+    if (body.indexOf("username=") != -1 || body.indexOf("sdInterval=") != -1)
+    {
+        SystemConfig &sys = config.editSystem();
+        copyField(sys.username, sizeof(sys.username), getParam(body, "username"));
+        copyField(sys.password, sizeof(sys.password), getParam(body, "password"));
+        sys.sdInterval = getNum(body, "sdInterval").toInt();
+        config.saveSystem();
+        sendText(ctx, "200 OK", "System Saved");
+    }
+
+    // --- Modbus Config (form) ---
+    else if (body.indexOf("baudrate=") != -1 || body.indexOf("slaveid=") != -1)
+    {
+        // Field yang tidak dikirim tetap memakai nilai sebelumnya
+        const ModbusConfig &cur = config.modbus();
+        String baud = getParam(body, "baudrate");
+        String parity = getParam(body, "parity");
+        String stop = getParam(body, "stopbits");
+        String data = getParam(body, "databits");
+        long baudrate = baud != "" ? baud.toInt() : (long)cur.baudrate;
+        long stopBit = stop != "" ? stop.toInt() : cur.stopBit;
+        long dataBit = data != "" ? data.toInt() : cur.dataBit;
+        if (parity == "")
+            parity = cur.parity;
+        bool valid = baudrate >= 1200 && baudrate <= 115200 &&
+                     (stopBit == 1 || stopBit == 2) && (dataBit == 7 || dataBit == 8) &&
+                     (parity == "None" || parity == "Even" || parity == "Odd");
+        if (valid)
+        {
+            ModbusConfig &mb = config.editModbus();
+            mb.baudrate = baudrate;
+            copyField(mb.parity, sizeof(mb.parity), parity);
+            mb.stopBit = stopBit;
+            mb.dataBit = dataBit;
+            config.saveModbus();
+            sendText(ctx, "200 OK", "Modbus Saved");
+        }
+        else
+        {
+            sendText(ctx, "400 Bad Request", "Invalid Modbus Settings");
+        }
+    }
+
+    // --- Analog Input Config (inputPin=AIx) ---
+    else if (body.indexOf("inputPin=AI") != -1)
+    {
+        int idx = getParam(body, "inputPin").substring(2).toInt() - 1;
+        if (idx >= 0 && idx < CFG_AI_COUNT)
+        {
+            AnalogChannelConfig &ai = config.editAnalog().ai[idx];
+            copyField(ai.name, sizeof(ai.name), getParam(body, "name"));
+            copyField(ai.inputType, sizeof(ai.inputType), getParam(body, "inputType"));
+            // Checkbox hanya terkirim jika dicentang
+            ai.filter = body.indexOf("filter=on") != -1;
+            if (getParam(body, "filterType") != "")
+                copyField(ai.filterType, sizeof(ai.filterType), getParam(body, "filterType"));
+            if (getParam(body, "filterPeriod") != "")
+                ai.filterPeriod = getParam(body, "filterPeriod").toFloat();
+            ai.scaling = body.indexOf("scaling=on") != -1;
+            if (getParam(body, "lowLimit") != "")
+                ai.lowLimit = getParam(body, "lowLimit").toFloat();
+            if (getParam(body, "highLimit") != "")
+                ai.highLimit = getParam(body, "highLimit").toFloat();
+            ai.calibration = body.indexOf("calibration=on") != -1;
+            if (getParam(body, "mValue") != "")
+                ai.mValue = getParam(body, "mValue").toFloat();
+            if (getParam(body, "cValue") != "")
+                ai.cValue = getParam(body, "cValue").toFloat();
+            // Kurva multi-titik opsional: calCurve=pwl&calX=..&calY=.. (daftar koma)
+            if (getParam(body, "calCurve") != "")
+            {
+                copyField(ai.calCurve, sizeof(ai.calCurve), getParam(body, "calCurve"));
+                float xs[CFG_CAL_POINTS] = {};
+                uint8_t nx = floatList(getParam(body, "calX"), xs, CFG_CAL_POINTS);
+                uint8_t ny = floatList(getParam(body, "calY"), ai.calY, CFG_CAL_POINTS);
+                bool poly = strcmp(ai.calCurve, "poly") == 0;
+                ai.calPoints = poly ? ny : min(nx, ny);
+                memcpy(ai.calX, xs, sizeof(xs));
             }
+            config.saveAnalog();
+            sendText(ctx, "200 OK", "Analog Saved");
+        }
+        else
+        {
+            sendText(ctx, "400 Bad Request", "Invalid Input");
         }
-        delay(2);
-        client.stop();
     }
-}
\ No newline at end of file
+
+    // --- Digital IO Config (Partial) ---
+    else if (body.indexOf("inputPin=") != -1)
+    {
+        String targetKey = getParam(body, "inputPin");
+        targetKey.replace(" ", "");
+        int idx = targetKey.substring(2).toInt() - 1;
+        if (targetKey.startsWith("DI") && idx >= 0 && idx < CFG_DI_COUNT)
+        {
+            DigitalInputConfig &di = config.editDigital().di[idx];
+            copyField(di.name, sizeof(di.name), getParam(body, "nameDI"));
+            di.invers = body.indexOf("inputInversion=") != -1;
+            copyField(di.taskMode, sizeof(di.taskMode), getParam(body, "taskMode"));
+            copyField(di.inputState, sizeof(di.inputState), getParam(body, "inputState"));
+            di.intervalTime = getNum(body, "intervalTime").toInt();
+            di.conversionFactor = getNum(body, "conversionFactor").toFloat();
+            config.saveDigital();
+            sendText(ctx, "200 OK", "Digital Saved");
+        }
+        else
+        {
+            sendText(ctx, "400 Bad Request", "Invalid Input");
+        }
+    }
+
+    // --- Network & ERP Config ---
+    else if (body.indexOf("ssid=") != -1 || body.indexOf("erpUrl=") != -1)
+    {
+        NetworkConfig &n = config.editNetwork();
+        if (body.indexOf("ssid=") != -1)
+        {
+            copyField(n.networkMode, sizeof(n.networkMode), getParam(body, "networkMode"));
+            copyField(n.ssid, sizeof(n.ssid), getParam(body, "ssid"));
+            copyField(n.password, sizeof(n.password), getParam(body, "password"));
+            copyField(n.apSsid, sizeof(n.apSsid), getParam(body, "apSsid"));
+            copyField(n.apPassword, sizeof(n.apPassword), getParam(body, "apPassword"));
+            copyField(n.dhcpMode, sizeof(n.dhcpMode), getParam(body, "dhcpMode"));
+            copyField(n.ipAddress, sizeof(n.ipAddress), getParam(body, "ipAddress"));
+            copyField(n.subnet, sizeof(n.subnet), getParam(body, "subnet"));
+            copyField(n.ipGateway, sizeof(n.ipGateway), getParam(body, "ipGateway"));
+            copyField(n.ipDNS, sizeof(n.ipDNS), getParam(body, "ipDNS"));
+            n.sendInterval = getNum(body, "sendInterval").toInt();
+            copyField(n.protocolMode, sizeof(n.protocolMode), getParam(body, "protocolMode"));
+            copyField(n.endpoint, sizeof(n.endpoint), getParam(body, "endpoint"));
+            n.port = getNum(body, "port").toInt();
+            copyField(n.pubTopic, sizeof(n.pubTopic), getParam(body, "pubTopic"));
+            copyField(n.subTopic, sizeof(n.subTopic), getParam(body, "subTopic"));
+            copyField(n.mqttUsername, sizeof(n.mqttUsername), getParam(body, "mqttUsername"));
+            copyField(n.mqttPass, sizeof(n.mqttPass), getParam(body, "mqttPass"));
+            n.loggerMode = body.indexOf("loggerMode=") != -1;
+            n.modbusMode = body.indexOf("modbusMode=") != -1;
+            copyField(n.protocolMode2, sizeof(n.protocolMode2), getParam(body, "protocolMode2"));
+            n.modbusPort = getNum(body, "modbusPort").toInt();
+            n.modbusSlaveID = getNum(body, "modbusSlaveID").toInt();
+            copyField(n.sendTrig, sizeof(n.sendTrig), getParam(body, "sendTrig"));
+        }
+        if (body.indexOf("erpUrl=") != -1)
+        {
+            copyField(n.erpUrl, sizeof(n.erpUrl), getParam(body, "erpUrl"));
+            copyField(n.erpUsername, sizeof(n.erpUsername), getParam(body, "erpUsername"));
+            copyField(n.erpPassword, sizeof(n.erpPassword), getParam(body, "erpPassword"));
+        }
+        config.saveNetwork();
+        sendText(ctx, "200 OK", "Network Saved");
+    }
+    else
+    {
+        sendText(ctx, "400 Bad Request", "Unknown Form");
+    }
+}
+
+// JSON dari modbus_setup.js
+void WebServerHandler::handleModbusSave(RequestContext &ctx)
+{
+    config.parseModbus(ctx.req.body());
+    config.saveModbus();
+    sendText(ctx, "200 OK", "Modbus Saved");
+}
+
+// Dipanggil per potongan body (route streamBody), jadi upload firmware
+// tidak menahan koneksi lain. Tulis flash di task OtaUpdater.
+void WebServerHandler::handleOtaUpload(RequestContext &ctx)
+{
+    if (ctx.aborted)
+    {
+        ota.interrupt();
+        return;
+    }
+    if (ctx.bodyStart && !ota.start(ctx.req.contentLength(), ctx.req.contentType(), ctx.req.query()))
+    {
+        // Sesi lain (jika ada) tidak disentuh
+        ctx.keepAlive = false;
+        sendText(ctx, ota.httpStatus(), ota.error());
+        ctx.done = true;
+        return;
+    }
+
+    ctx.consumed = ota.write(ctx.pending, ctx.pendingLen);
+    if (ota.state() == OTA_RECEIVING && ota.bodyComplete())
+        ota.finish();
+    if (ota.state() == OTA_RECEIVING)
+        return;
+
+    ctx.done = true;
+    if (ota.state() == OTA_PAUSED)
+    {
+        // Potongan diterima, image belum lengkap: client kirim ?offset= berikutnya
+        char text[48];
+        snprintf(text, sizeof(text), "%lu/%lu", (unsigned long)ota.received(), (unsigned long)ota.size());
+        sendText(ctx, ota.httpStatus(), text);
+        return;
+    }
+    ctx.keepAlive = false;
+    if (ota.state() == OTA_DONE)
+    {
+        sendText(ctx, "200 OK", "Success");
+        delay(100);
+        ctx.client.stop();
+        config.flush();
+        logger.flush();
+        uplink.saveCursor();
+        ESP.restart();
+        return;
+    }
+    sendText(ctx, ota.httpStatus(), ota.error());
+}
+
+// ---------------------------------------------------------
+// Serve File (halaman, JS, asset statis)
+// ---------------------------------------------------------
+void WebServerHandler::serveFile(RequestContext &ctx)
+{
+    const char *target = ctx.asset ? ctx.asset : ctx.req.path();
+    const AssetInfo *asset = _assets.find(target);
+    if (asset)
+    {
+        serveAsset(ctx, *asset);
+        return;
+    }
+
+    // Tidak ada di index (mis. file ditulis setelah boot): cara lama,
+    // respon tanpa Content-Length -> koneksi ditutup sesudahnya
+    ctx.keepAlive = false;
+    EthernetClient &client = ctx.client;
+    String path = target;
+    String pathWithGz = path + ".gz";
+    bool fileFound = false;
+    bool isGzipped = false;
+
+    if (LittleFS.exists(pathWithGz))
+    {
+        fileFound = true;
+        isGzipped = true;
+        path = pathWithGz;
+    }
+    else if (LittleFS.exists(path))
+    {
+        fileFound = true;
+        isGzipped = false;
+    }
+
+    if (fileFound)
+    {
+        File file = LittleFS.open(path, "r");
+        String filenameForMime = isGzipped ? path.substring(0, path.length() - 3) : path;
+        String dataType = getContentType(filenameForMime);
+
+        // HTML dipindai dulu (sekali baca), lalu dikirim seperti asset ter-index
+        int segments = -1;
+        if (filenameForMime.endsWith(".html") && !isGzipped)
+        {
+            TemplateScanner scanner(_templateScratch, TPL_MAX_SEGMENTS);
+            uint8_t buf[512];
+            int n;
+            while ((n = file.read(buf, sizeof(buf))) > 0)
+                scanner.feed(buf, n);
+            segments = scanner.finish();
+            if (segments < 0)
+                Serial.printf("Template terlalu besar, dikirim apa adanya: %s\n", path.c_str());
+            file.seek(0);
+        }
+
+        client.println("HTTP/1.1 200 OK");
+        client.println("Content-Type: " + dataType);
+        if (isGzipped)
+            client.println("Content-Encoding: gzip");
+
+        if (segments >= 0)
+        {
+            sendTemplate(ctx, file, _templateScratch, segments);
+        }
+        else
+        {
+            client.println("Connection: close");
+            client.println();
+            uint8_t buf[512];
+            while (file.available())
+            {
+                int n = file.read(buf, sizeof(buf));
+                client.write(buf, n);
+            }
+        }
+        file.close();
+    }
+    else
+    {
+        Serial.print("ERROR 404: ");
+        Serial.println(path);
+        METRIC_ADD(METRIC_HTTP_NOT_FOUND, 1);
+        client.println("HTTP/1.1 404 Not Found");
+        client.println("Content-Type: text/plain");
+        client.println();
+        client.println("404: File Not Found");
+    }
+}
+
+// Sisa header + isi template: teks disalin dari file per HTTP_SEND_CHUNK,
+// placeholder diisi templateValue(). Nilai dihitung dua kali (panjang
+// lalu isi) supaya Content-Length diketahui dan koneksi tetap keep-alive.
+void WebServerHandler::sendTemplate(RequestContext &ctx, File &file, const TemplateSegment *segments, size_t count)
+{
+    EthernetClient &client = ctx.client;
+    char value[TPL_VALUE_MAX];
+    uint32_t length = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const TemplateSegment &s = segments[i];
+        length += s.var == TPL_LITERAL ? s.length : templateValue(s.var, ctx.linkStatus, value, sizeof(value));
+    }
+    client.printf("Content-Length: %lu\r\nConnection: %s\r\n\r\n", (unsigned long)length, connectionHeader(ctx));
+
+    uint8_t buf[HTTP_SEND_CHUNK];
+    for (size_t i = 0; i < count; i++)
+    {
+        const TemplateSegment &s = segments[i];
+        if (s.var != TPL_LITERAL)
+        {
+            size_t n = templateValue(s.var, ctx.linkStatus, value, sizeof(value));
+            client.write((const uint8_t *)value, n);
+            continue;
+        }
+        file.seek(s.offset);
+        uint32_t remaining = s.length;
+        while (remaining > 0)
+        {
+            int n = file.read(buf, min((size_t)remaining, sizeof(buf)));
+            if (n <= 0)
+            {
+                // File berubah setelah dipindai: panjang tidak bisa dipenuhi
+                ctx.keepAlive = false;
+                return;
+            }
+            client.write(buf, n);
+            remaining -= n;
+        }
+    }
+}
+
+// Serve asset yang sudah di-index: tanpa exists(), ETag/304, Content-Length
+void WebServerHandler::serveAsset(RequestContext &ctx, const AssetInfo &asset)
+{
+    EthernetClient &client = ctx.client;
+    char etag[ASSET_ETAG_LEN];
+    AssetCache::formatEtag(asset, etag, sizeof(etag));
+
+    if (!asset.templated && AssetCache::etagMatches(etag, ctx.req.ifNoneMatch()))
+    {
+        // Browser sudah punya versi ini: file tidak perlu dibuka
+        client.printf("HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: %s\r\nConnection: %s\r\n\r\n",
+                      etag, AssetCache::cacheControl(asset), connectionHeader(ctx));
+        return;
+    }
+
+    char fsPath[ASSET_MAX_PATH + 4];
+    AssetCache::filePath(asset, fsPath, sizeof(fsPath));
+    File file = LittleFS.open(fsPath, "r");
+    if (!file)
+    {
+        sendText(ctx, "404 Not Found", "404: File Not Found");
+        return;
+    }
+
+    client.printf("HTTP/1.1 200 OK\r\nContent-Type: %s\r\nCache-Control: %s\r\n",
+                  asset.contentType, AssetCache::cacheControl(asset));
+    if (asset.gzip)
+        client.print("Content-Encoding: gzip\r\n");
+
+    if (asset.templated)
+    {
+        // Isi berubah per request -> tanpa ETag
+        sendTemplate(ctx, file, _assets.segments(asset), asset.segmentCount);
+    }
+    else
+    {
+        client.printf("ETag: %s\r\nContent-Length: %lu\r\nConnection: %s\r\n\r\n",
+                      etag, (unsigned long)asset.size, connectionHeader(ctx));
+        // Isi dikirim bertahap oleh server (HTTP_SEND_CHUNK per giliran)
+        ctx.file = file;
+        ctx.fileRemaining = asset.size;
+        return;
+    }
+    file.close();
+}
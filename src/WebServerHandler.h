@@ -4,25 +4,138 @@
 #include <Arduino.h>
 #include <EthernetESP32.h>
 #include <SPI.h>
-#include <LittleFS.h> 
+#include <LittleFS.h>
+#include "HttpRequestParser.h"
+#include "AssetCache.h"
+#include "EventHub.h"
+#include "Metrics.h"
+
+#define HTTP_MAX_CONNECTIONS 6          // socket yang dilayani bersamaan
+#define HTTP_MAX_EVENT_STREAMS 3        // maks. subscriber SSE (sisa slot untuk request biasa)
+#define HTTP_EVENT_PING_MS 15000        // komentar keep-alive SSE
+#define HTTP_READ_TIMEOUT_MS 2000       // request setengah jalan
+#define HTTP_KEEPALIVE_TIMEOUT_MS 5000  // koneksi idle di antara request
+#define HTTP_WRITE_TIMEOUT_MS 5000      // client berhenti menerima saat kirim file
+#define HTTP_RX_BUFFER 256
+#define HTTP_SEND_CHUNK 1024            // byte file per giliran koneksi
+#define HTTP_STREAM_BUDGET 4096         // byte body streamBody per giliran koneksi
+
+struct WebRoutes;
 
 class WebServerHandler {
 public:
     WebServerHandler(uint16_t port);
     void begin();
-    
-    // Fungsi utama
-    void handleClient(EthernetLinkStatus linkStatus); 
+
+    // Fungsi utama: non-blocking, panggil setiap loop()
+    void handleClient(EthernetLinkStatus linkStatus);
     uint16_t modbusData[4] = {0, 0, 0, 0};
 
+    // Statistik koneksi
+    uint8_t activeConnections() const;
+    uint32_t acceptedConnections() const { return _accepted; }
+    uint32_t rejectedConnections() const { return _rejected; }
+    uint8_t eventSubscribers() const;
+
+    // Konteks satu request untuk handler route
+    struct RequestContext {
+        EthernetClient &client;
+        const HttpRequestParser &req;
+        EthernetLinkStatus linkStatus;
+        const char *asset;        // file tujuan untuk route halaman
+        // Route streamBody: handler dipanggil per potongan body
+        const uint8_t *pending;
+        size_t pendingLen;
+        size_t consumed;          // byte yang diambil handler (default semua)
+        uint32_t bodyOffset;      // posisi potongan di dalam body
+        bool bodyStart;           // panggilan pertama
+        bool aborted;             // koneksi putus sebelum body selesai
+        bool done;                // handler streamBody sudah mengirim respon
+        // Respon
+        bool keepAlive;           // handler set false jika panjang respon tak diketahui
+        File file;                // jika dibuka handler: dikirim bertahap oleh server
+        uint32_t fileRemaining;
+        bool eventStream;         // handler set true: koneksi jadi subscriber SSE
+    };
+    typedef void (WebServerHandler::*RouteHandler)(RequestContext &ctx);
+
 private:
+    friend struct WebRoutes;
+
+    // State machine per socket
+    struct Connection {
+        enum State : uint8_t {
+            FREE,
+            READ_HEADERS,
+            READ_BODY,
+            STREAM_BODY,
+            SEND_FILE,
+            EVENT_STREAM
+        };
+        EthernetClient client;
+        HttpRequestParser parser;
+        State state;
+        bool requestStarted;      // sudah ada byte request (untuk timeout)
+        bool keepAlive;
+        uint16_t rxLen, rxPos;
+        uint32_t lastActivityMs;
+        uint32_t bodyOffset;
+        RouteHandler streamHandler;
+        File file;
+        uint32_t fileRemaining;
+        uint32_t eventPos;        // posisi baca di EventHub
+        uint8_t rx[HTTP_RX_BUFFER];
+    };
+
     EthernetServer _server;
-    
+    AssetCache _assets;
+    Connection _conns[HTTP_MAX_CONNECTIONS];
+    EthernetLinkStatus _linkStatus;
+    uint32_t _accepted;
+    uint32_t _rejected;
+    TemplateSegment _templateScratch[TPL_MAX_SEGMENTS]; // HTML di luar index, dipindai per request
+
+    void acceptConnections();
+    void serviceConnection(Connection &c);
+    bool fillRx(Connection &c);
+    void dispatch(Connection &c);
+    void streamBody(Connection &c, bool start);
+    void sendFileChunk(Connection &c);
+    void sendEvents(Connection &c);
+    void finishResponse(Connection &c, bool keepAlive);
+    void closeConnection(Connection &c);
+    RequestContext makeContext(Connection &c, const char *asset);
+
     // Helper untuk mendeteksi tipe file (CSS/JS/JSON/PNG, dll)
     String getContentType(String filename);
-    
-    // Processor template HTML ({{VAR}})
-    String processor(const String& var, EthernetLinkStatus linkStatus); 
+
+    // Nilai placeholder template HTML ({{VAR}}, id dari TemplateScanner)
+    size_t templateValue(uint8_t var, EthernetLinkStatus linkStatus, char *buf, size_t size);
+    void sendTemplate(RequestContext &ctx, File &file, const TemplateSegment *segments, size_t count);
+
+    // --- Handler route (didaftarkan di WebRoutes.h) ---
+    void handleHomeLoad(RequestContext &ctx);
+    void handleInfo(RequestContext &ctx);
+    void handleLive(RequestContext &ctx);
+#if METRICS_ENABLED
+    void handleMetrics(RequestContext &ctx);
+#endif
+    void handleSettingsLoad(RequestContext &ctx);
+    void handleModbusLoad(RequestContext &ctx);
+    void handleNetworkLoad(RequestContext &ctx);
+    void handleAnalogLoad(RequestContext &ctx);
+    void handleDigitalLoad(RequestContext &ctx);
+    void handleUpdateStatus(RequestContext &ctx);
+    void handleGetTime(RequestContext &ctx);
+    void handleGetValue(RequestContext &ctx);
+    void handleHistory(RequestContext &ctx);
+    void handleRollup(RequestContext &ctx);
+    void handleEventStream(RequestContext &ctx);
+    void handleConfigSave(RequestContext &ctx);
+    void handleModbusSave(RequestContext &ctx);
+    void handleOtaUpload(RequestContext &ctx);
+    void serveFile(RequestContext &ctx);
+    void serveAsset(RequestContext &ctx, const AssetInfo &asset);
 };
 
-#endif // WEBSERVERHANDLER_H
\ No newline at end of file
+#endif // WEBSERVERHANDLER_H
@@ -1,87 +1,794 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_ADS1X15.h>
+#include "AdsAcquisition.h"
+#include "Calibration.h"
+#include "AnalogFilter.h"
+#include "ConfigCache.h"
+#include "DataLogger.h"
+#include "DigitalInputs.h"
+#include "EventHub.h"
+#include "LiveData.h"
+#include "Metrics.h"
+#include "ModbusPoller.h"
+#include "ModbusTcpServer.h"
+#include "OtaUpdater.h"
+#include "RegisterImage.h"
+#include "Rollup.h"
+#include "SampleRing.h"
+#include "SampleStream.h"
+#include "SerialConsole.h"
+#include "Seqlock.h"
+#include "TaskMonitor.h"
+#include "Uplink.h"
+#include "WebServerHandler.h"
+
+// Pin W5500 (bisa di-override lewat build_flags)
+#ifndef ETH_CS_PIN
+#define ETH_CS_PIN 5
+#endif
+#ifndef ETH_INT_PIN
+#define ETH_INT_PIN -1
+#endif
+#ifndef ETH_RST_PIN
+#define ETH_RST_PIN -1
+#endif
+
 Adafruit_ADS1115 ads;
+AdsAcquisition acquisition(ads);
+CalibrationKernel calibration;
+AnalogFilterBank filters;
+WebServerHandler web(80);
 struct AnalogConfig
 {
   float slope;      // m
   float intercept;  // c
   float scaledRaw;  // 'x' in the formula (Range: 13107 - 65535)
   float tempValue;  // 'y' in the formula (Temperature)
+  FilterType filterType;
+  float filterPeriod; // detik (configAnalog.json "filterPeriod")
+  uint32_t lastSampleUs;
+};
+
+// ---------------------------------------------------------
+// Pembagian task
+// ---------------------------------------------------------
+//   core 1: acquisitionTask (prioritas tinggi) - ADS1115, kalibrasi, filter
+//   core 0: commsTask - web, Modbus TCP, config, DI, console, laporan 1 detik
+//           (task Modbus RTU juga di core 0, lihat ModbusPoller)
+// analogInput[] hanya disentuh task akuisisi. Task lain mengirim perintah
+// lewat acqCommands, menerima frame 100 ms lewat analogFrames (keduanya
+// SampleRing SPSC lock-free) dan membaca nilai terakhir dari seqlock
+// analogSnapshot, jadi trafik web tidak pernah menahan sampling.
+struct AnalogSnapshot
+{
+  uint8_t mask;
+  float slope[ADC_CHANNELS];
+  float intercept[ADC_CHANNELS];
+  float scaledRaw[ADC_CHANNELS];
+  float tempValue[ADC_CHANNELS];
+  uint32_t sampleCount;
+  uint32_t overruns;
+  uint32_t dropped;
+  uint32_t maxLatencyUs; // RDY -> task akuisisi berjalan, maks. per frame
+  uint16_t dataRate;     // SPS ADS1115
+  adsGain_t gain;
+  uint32_t filterSpan[ADC_CHANNELS]; // window moving average efektif (sampel)
+  uint8_t filterLimited;             // mask: filterPeriod dipotong ke window maks.
+};
+
+struct AnalogFrame
+{
+  uint32_t ms;
+  uint8_t mask;
+  float scaledRaw[ADC_CHANNELS];
+  float tempValue[ADC_CHANNELS];
+  RollupSample stats[ADC_CHANNELS]; // min/max/sum/count semua sampel dalam frame
 };
 
-AnalogConfig analogInput;
-const float shuntResistor = 250.0; 
+enum AcqCommandType : uint8_t
+{
+  ACQ_CMD_CHANNEL,   // config lengkap satu channel (configAnalog.json)
+  ACQ_CMD_SLOPE,     // console "m=" (kembali ke kalibrasi linear)
+  ACQ_CMD_INTERCEPT, // console "c=" (kembali ke kalibrasi linear)
+  ACQ_CMD_MASK,      // console "ch": channel aktif
+  ACQ_CMD_GAIN,      // console "gain": PGA ADS1115 + kalibrasi
+  ACQ_CMD_RATE       // console "rate": SPS ADS1115
+};
+
+struct AcqCommand
+{
+  AcqCommandType type;
+  uint8_t channel;
+  bool calibration;
+  FilterType filterType;
+  float m;  // slope, atau nilai baru untuk SLOPE / INTERCEPT
+  float c;
+  float filterPeriod;
+  CalCurve curve; // calCurve/calX/calY, untuk ACQ_CMD_CHANNEL
+  uint16_t value; // mask / adsGain_t / SPS, untuk MASK / GAIN / RATE
+};
+
+AnalogConfig analogInput[ADC_CHANNELS];
+SampleRing<AcqCommand, 16> acqCommands;
+SampleRing<AnalogFrame, 32> analogFrames;
+Seqlock<AnalogSnapshot> analogSnapshot;
+RollupSample frameStats[ADC_CHANNELS]; // milik task akuisisi
+const float shuntResistor = 250.0;
+const uint16_t sampleRate = 860;  // SPS total (dibagi ke channel aktif)
+uint32_t appliedConfigRev = 0;
 unsigned long previousMillis = 0;
-const long interval = 1000; 
+const long interval = 1000;
+const size_t sampleBlock = 64;
+const unsigned long framePeriod = 100; // ms, frame ke comms (register image Modbus TCP)
+const unsigned long logPeriod = 10000; // ms, satu record per channel ke DataLogger
+const uint8_t acqCore = 1;
+const UBaseType_t acqPriority = 6;    // di atas loopTask & task jaringan
+const uint32_t acqStack = 4096;
+const uint8_t commsCore = 0;
+const UBaseType_t commsPriority = 3;
+const uint32_t commsStack = 8192;
+uint8_t ethMac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}; // sama dengan macAddress di /info
+void acquisitionTask(void *arg);
+void commsTask(void *arg);
+void startNetwork();
+void applyCommands();
+void publishFrame(uint32_t maxLatencyUs);
+void applyAnalogConfig();
+void applyLoggerConfig();
+void logValues(const AnalogSnapshot &snap);
 void readSensors();
+void printSensors(Print &out, const AnalogSnapshot &snap);
+void publishValues(const AnalogSnapshot &snap);
+void publishModbus();
+void updateLiveData(const AnalogSnapshot &snap);
+void updateRegisters(const AnalogFrame &frame, EthernetLinkStatus link);
+void updateRollups(const AnalogFrame &frame);
 void handleSerialCommands();
+void reconfigureFilters();
+void cmdHelp(uint8_t argc, char **argv, Print &out);
+void cmdStats(uint8_t argc, char **argv, Print &out);
+void cmdChannels(uint8_t argc, char **argv, Print &out);
+void cmdGain(uint8_t argc, char **argv, Print &out);
+void cmdRate(uint8_t argc, char **argv, Print &out);
+void cmdCal(uint8_t argc, char **argv, Print &out);
+void cmdSlope(uint8_t argc, char **argv, Print &out);
+void cmdIntercept(uint8_t argc, char **argv, Print &out);
+void cmdStream(uint8_t argc, char **argv, Print &out);
+
+// Console serial (task comms). Perubahan lewat console hanya di RAM,
+// config di flash tidak ikut berubah.
+const ConsoleCommand consoleCommands[] = {
+  {"help", cmdHelp, "- daftar perintah"},
+  {"stats", cmdStats, "- nilai, counter sampel & stream"},
+  {"ch", cmdChannels, "<1..4>[,..] - channel aktif, mis. ch 1,3"},
+  {"gain", cmdGain, "<2/3|1|2|4|8|16> - PGA ADS1115"},
+  {"rate", cmdRate, "<8..860> - SPS ADS1115 (dibagi ke channel aktif)"},
+  {"cal", cmdCal, "<1..4> <m> <c> - kalibrasi linear"},
+  {"m", cmdSlope, "<value> - slope AI1"},
+  {"c", cmdIntercept, "<value> - intercept AI1"},
+  {"stream", cmdStream, "raw|eng|off [1..4[,..]] - stream biner COBS"},
+};
+SerialConsole console(Serial, consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]));
 
 void setup() {
   Serial.begin(115200);
   while (!Serial) delay(10);
   Serial.println("--- SYSTEM STARTING (Range: 13107-65535) ---");
-  Serial.println("Commands: 'm=<value>' or 'c=<value>' to calibrate.");
+  Serial.println("Commands: 'm=<value>' or 'c=<value>' to calibrate, 'help' for more.");
   Wire.begin();
   if (!ads.begin()) {
     Serial.println("Error: ADS1115 not found.");
     while (1);
   }
   ads.setGain(GAIN_TWOTHIRDS);
-  analogInput.slope = 0.004888;     //suhu normal
-  analogInput.intercept = -185.711; //suhu normal
+  calibration.setGain(GAIN_TWOTHIRDS);
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    frameStats[i].reset();
+    analogInput[i].slope = 0.004888;     //suhu normal
+    analogInput[i].intercept = -185.711; //suhu normal
+    analogInput[i].filterType = FILTER_NONE;
+    analogInput[i].filterPeriod = 0.1;
+    calibration.configure(i, analogInput[i].slope, analogInput[i].intercept);
+  }
+  config.begin();
+  logger.begin();
+  applyLoggerConfig();
+  if (!acquisition.begin(sampleRate, 0x0F)) {
+    Serial.println("Error: ADS1115 acquisition not started.");
+  }
+  applyAnalogConfig(); // diantrikan, diterapkan task akuisisi saat mulai
+  modbus.configure(config.modbus());
+  modbus.begin();
+  xTaskCreatePinnedToCore(acquisitionTask, "acq", acqStack, nullptr, acqPriority, nullptr, acqCore);
+  xTaskCreatePinnedToCore(commsTask, "comms", commsStack, nullptr, commsPriority, nullptr, commsCore);
 }
 
 void loop() {
-  handleSerialCommands();
-  unsigned long currentMillis = millis();
-  if (currentMillis - previousMillis >= interval) {
-    previousMillis = currentMillis;
+  // Semua kerja ada di task; loopTask tidak dibutuhkan lagi
+  vTaskDelete(nullptr);
+}
+
+// ---------------------------------------------------------
+// Task akuisisi (core 1)
+// ---------------------------------------------------------
+void acquisitionTask(void *arg) {
+  uint8_t slot = taskMonitor.add("acq");
+  acquisition.setNotifyTask(xTaskGetCurrentTaskHandle());
+  uint32_t frameMillis = millis();
+  uint32_t maxLatencyUs = 0;
+  for (;;) {
+    // Tidur sampai RDY; timeout hanya jaga-jaga jika interrupt hilang
+    bool woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10)) > 0;
+    uint32_t start = micros();
+    uint32_t latency = start - acquisition.lastReadyUs();
+    if (woken && latency > maxLatencyUs) maxLatencyUs = latency;
+    applyCommands();
+    acquisition.service();
     readSensors();
+    if (millis() - frameMillis >= framePeriod) {
+      frameMillis = millis();
+      publishFrame(maxLatencyUs);
+      maxLatencyUs = 0;
+    }
+    taskMonitor.busy(slot, micros() - start);
+  }
+}
+
+// Perintah dari task comms (config web / console)
+void applyCommands() {
+  AcqCommand cmd;
+  while (acqCommands.pop(cmd)) {
+    AnalogConfig &ai = analogInput[cmd.channel];
+    switch (cmd.type) {
+      case ACQ_CMD_CHANNEL:
+        if (cmd.calibration) {
+          ai.slope = cmd.m;
+          ai.intercept = cmd.c;
+          calibration.setCurve(cmd.channel, cmd.curve);
+        }
+        ai.filterType = cmd.filterType;
+        if (cmd.filterPeriod > 0) ai.filterPeriod = cmd.filterPeriod;
+        filters.configure(cmd.channel, ai.filterType, ai.filterPeriod, acquisition.channelRate());
+        break;
+      case ACQ_CMD_SLOPE:
+        ai.slope = cmd.m;
+        calibration.setCurve(cmd.channel, cmd.curve);
+        break;
+      case ACQ_CMD_INTERCEPT:
+        ai.intercept = cmd.m;
+        calibration.setCurve(cmd.channel, cmd.curve);
+        break;
+      // Perintah global: tanpa configure() per channel di bawah
+      case ACQ_CMD_MASK:
+        acquisition.setChannelMask(cmd.value);
+        reconfigureFilters(); // laju per channel ikut berubah
+        continue;
+      case ACQ_CMD_RATE:
+        acquisition.setDataRate(cmd.value);
+        reconfigureFilters();
+        continue;
+      case ACQ_CMD_GAIN:
+        acquisition.setGain((adsGain_t)cmd.value);
+        calibration.setGain((adsGain_t)cmd.value); // menghitung ulang semua channel
+        continue;
+    }
+    calibration.configure(cmd.channel, ai.slope, ai.intercept);
+  }
+}
+
+void reconfigureFilters() {
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    filters.configure(i, analogInput[i].filterType, analogInput[i].filterPeriod, acquisition.channelRate());
   }
 }
 
+// Snapshot (seqlock) + frame ke antrean comms
+void publishFrame(uint32_t maxLatencyUs) {
+  AnalogSnapshot snap;
+  AnalogFrame frame;
+  snap.mask = frame.mask = acquisition.channelMask();
+  frame.ms = millis();
+  snap.filterLimited = 0;
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    const AnalogConfig &ai = analogInput[i];
+    snap.filterSpan[i] = filters.span(i);
+    if (filters.limited(i)) snap.filterLimited |= 1 << i;
+    snap.slope[i] = ai.slope;
+    snap.intercept[i] = ai.intercept;
+    snap.scaledRaw[i] = frame.scaledRaw[i] = ai.scaledRaw;
+    snap.tempValue[i] = frame.tempValue[i] = ai.tempValue;
+    frame.stats[i] = frameStats[i];
+    frameStats[i].reset();
+  }
+  snap.sampleCount = acquisition.sampleCount();
+  snap.overruns = acquisition.overruns();
+  snap.dropped = acquisition.samples().dropped();
+  snap.maxLatencyUs = maxLatencyUs;
+  snap.dataRate = acquisition.dataRate();
+  snap.gain = acquisition.gain();
+  analogSnapshot.write(snap);
+  analogFrames.push(frame); // penuh -> frame dibuang, dihitung dropped()
+}
+
 void readSensors() {
-  int16_t adc0 = ads.readADC_SingleEnded(0);
-  float voltage = ads.computeVolts(adc0);
-
-  // 3. Calculate Scaled Raw (13107 - 65535)
-  // This maps the 0-5V range to a 16-bit scale.
-  // 1V (4mA) = (1.0/5.0) * 65535 = 13107
-  // 5V (20mA) = (5.0/5.0) * 65535 = 65535
-  float raw_x = (voltage / 5.0) * 65535.0;
-  analogInput.scaledRaw = raw_x;
-  // 4. Calculate Temperature (y = mx + c)
-  float m = analogInput.slope;
-  float c = analogInput.intercept;
-  analogInput.tempValue = (m * raw_x) + c;
-  Serial.print("Raw: "); 
-  Serial.print(analogInput.scaledRaw, 0); // Display as integer-like
-  Serial.print(" | m: "); 
-  Serial.print(m, 6); // High precision for small slope
-  Serial.print(" c: "); 
-  Serial.print(c, 3);
-  Serial.print(" | Temp: "); 
-  Serial.print(analogInput.tempValue, 2); 
-  Serial.println(" C");
+  // Kuras ring buffer, pisahkan per channel, lalu kalibrasi per blok
+  static AdcSample block[sampleBlock];
+  static int16_t codes[ADC_CHANNELS][sampleBlock];
+  static int32_t raw[sampleBlock];
+  static int32_t eng[sampleBlock];
+  size_t n;
+  while ((n = acquisition.samples().popBlock(block, sampleBlock)) > 0) {
+    size_t count[ADC_CHANNELS] = {0, 0, 0, 0};
+    uint32_t first[ADC_CHANNELS] = {0, 0, 0, 0};
+    uint32_t stamp[ADC_CHANNELS] = {0, 0, 0, 0};
+    for (size_t i = 0; i < n; i++) {
+      uint8_t ch = block[i].channel;
+      if (count[ch] == 0) first[ch] = block[i].timestampUs;
+      codes[ch][count[ch]++] = block[i].code;
+      stamp[ch] = block[i].timestampUs;
+    }
+    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+      if (count[ch] == 0) continue;
+      {
+        METRIC_SPAN(METRIC_CALIBRATION);
+        // x = code -> 0..65535, y = m * x + c (fixed-point, milli-unit)
+        calibration.process(ch, codes[ch], count[ch], raw, eng);
+        filters.process(ch, eng, count[ch]);
+      }
+      for (size_t k = 0; k < count[ch]; k++) {
+        frameStats[ch].add(CalibrationKernel::toUnits(eng[k]));
+      }
+      AnalogConfig &ai = analogInput[ch];
+      ai.scaledRaw = raw[count[ch] - 1];
+      ai.tempValue = CalibrationKernel::toUnits(eng[count[ch] - 1]);
+      ai.lastSampleUs = stamp[ch];
+      // Kode mentah atau hasil kalibrasi + filter ke stream serial
+      sampleStream.add(ch, codes[ch], eng, count[ch], first[ch], stamp[ch]);
+    }
+  }
 }
 
-void handleSerialCommands() {
-  if (Serial.available() > 0) {
-    String input = Serial.readStringUntil('\n');
-    input.trim();
-    
-    // Update Slope (m)
-    if (input.startsWith("m=") || input.startsWith("M=")) {
-      analogInput.slope = input.substring(2).toFloat();
-      Serial.print(">>> Updated Slope (m): ");
-      Serial.println(analogInput.slope, 6);
+// ---------------------------------------------------------
+// Task comms (core 0)
+// ---------------------------------------------------------
+void commsTask(void *arg) {
+  uint8_t slot = taskMonitor.add("comms");
+  startNetwork();
+  digitalInputs.begin(); // ISR PCNT/GPIO ikut core task ini
+  digitalInputs.configure(config.digital());
+  previousMillis = millis();
+  unsigned long logMillis = millis();
+  for (;;) {
+    uint32_t start = micros();
+    handleSerialCommands();
+    sampleStream.service(Serial);
+    config.service(); // simpan config (debounce) & compact journal
+    if (config.revision() != appliedConfigRev) {
+      applyAnalogConfig();
+      applyLoggerConfig();
+      modbus.configure(config.modbus()); // no-op jika bagian modbus tidak berubah
+      digitalInputs.configure(config.digital()); // idem, per channel DI
+    }
+    digitalInputs.service();
+    logger.service();
+    EthernetLinkStatus link = Ethernet.linkStatus();
+    uplink.service(link);
+    web.handleClient(link);
+    ota.service();
+    modbusTcp.service();
+    AnalogFrame frame;
+    while (analogFrames.pop(frame)) {
+      updateRegisters(frame, link);
+      updateRollups(frame);
     }
-    // Update Intercept (c)
-    else if (input.startsWith("c=") || input.startsWith("C=")) {
-      analogInput.intercept = input.substring(2).toFloat();
-      Serial.print(">>> Updated Intercept (c): ");
-      Serial.println(analogInput.intercept, 2);
+    if (millis() - previousMillis >= (unsigned long)interval) {
+      previousMillis = millis();
+      AnalogSnapshot snap;
+      analogSnapshot.read(snap);
+      if (!sampleStream.active()) printSensors(Serial, snap); // teks memotong frame biner
+      printSensors(events, snap); // log yang sama ke /debugStream
+      publishValues(snap);
+      publishModbus();
+      updateLiveData(snap);
+      taskMonitor.update();
+    }
+    if (millis() - logMillis >= logPeriod) {
+      logMillis = millis();
+      AnalogSnapshot snap;
+      analogSnapshot.read(snap);
+      logValues(snap);
+    }
+    taskMonitor.busy(slot, micros() - start);
+    vTaskDelay(1); // beri jatah idle task core 0 (watchdog)
+  }
+}
+
+// Ethernet (W5500) + server. DHCP bisa lama, karena itu dijalankan di
+// task comms setelah akuisisi sudah berjalan.
+void startNetwork() {
+  static W5500Driver driver(ETH_CS_PIN, ETH_INT_PIN, ETH_RST_PIN);
+  Ethernet.init(driver);
+  const NetworkConfig &net = config.network();
+  if (strcmp(net.dhcpMode, "Static") == 0) {
+    IPAddress ip, dns, gateway, subnet;
+    ip.fromString(net.ipAddress);
+    dns.fromString(net.ipDNS);
+    gateway.fromString(net.ipGateway);
+    subnet.fromString(net.subnet);
+    Ethernet.begin(ethMac, ip, dns, gateway, subnet);
+  } else if (!Ethernet.begin(ethMac)) {
+    Serial.println("Ethernet: DHCP gagal.");
+  }
+  web.begin();
+  uplink.begin();
+  ota.begin();
+  // Port & slave ID dibaca sekali: perubahan berlaku setelah restart
+  if (net.modbusMode && strstr(net.protocolMode2, "TCP")) {
+    modbusTcp.begin(net.modbusPort, net.modbusSlaveID);
+  }
+}
+
+// Ambil mValue/cValue, kurva kalibrasi & filter dari configAnalog.json (cache RAM),
+// diteruskan ke task akuisisi lewat antrean
+void applyAnalogConfig() {
+  appliedConfigRev = config.revision();
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    const AnalogChannelConfig &cfg = config.analog().ai[i];
+    AcqCommand cmd;
+    cmd.type = ACQ_CMD_CHANNEL;
+    cmd.channel = i;
+    cmd.calibration = cfg.calibration;
+    cmd.m = cfg.mValue;
+    cmd.c = cfg.cValue;
+    cmd.filterType = cfg.filter ? AnalogFilterBank::parseType(cfg.filterType) : FILTER_NONE;
+    cmd.filterPeriod = cfg.filterPeriod;
+    cmd.curve.type = CalibrationKernel::parseCurveType(cfg.calCurve);
+    cmd.curve.count = min(cfg.calPoints, (uint8_t)CAL_MAX_POINTS);
+    memcpy(cmd.curve.x, cfg.calX, cmd.curve.count * sizeof(float));
+    memcpy(cmd.curve.y, cfg.calY, cmd.curve.count * sizeof(float));
+    if (!acqCommands.push(cmd)) Serial.println("Error: antrean akuisisi penuh.");
+  }
+}
+
+// loggerMode (configNetwork.json) menyalakan log + uplink, sdInterval
+// (menit) = batas lama data menunggu di RAM sebelum ditulis ke flash
+void applyLoggerConfig() {
+  logger.setEnabled(config.network().loggerMode);
+  logger.setFlushInterval(config.system().sdInterval * 60000UL);
+  uplink.configure(config.network());
+}
+
+// AI aktif, DI + tag modbus yang sudah terbaca
+void logValues(const AnalogSnapshot &snap) {
+  if (!logger.enabled()) return;
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    if (snap.mask & (1 << i)) logger.append(LOG_CH_AI + i, snap.tempValue[i]);
+  }
+  for (int i = 0; i < DI_CHANNELS; i++) {
+    logger.append(LOG_CH_DI + i, digitalInputs.reading(i).value);
+  }
+  uint8_t tags = min(config.modbus().tagCount, modbus.tagCount());
+  for (uint8_t i = 0; i < tags && LOG_CH_MODBUS + i < LOG_CHANNELS; i++) {
+    ModbusReading r;
+    if (modbus.reading(i, r)) logger.append(LOG_CH_MODBUS + i, r.value);
+  }
+}
+
+void printSensors(Print &out, const AnalogSnapshot &snap) {
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    if (!(snap.mask & (1 << i))) continue;
+    out.print("AI"); out.print(i + 1);
+    out.print(" Raw: ");
+    out.print(snap.scaledRaw[i], 0); // Display as integer-like
+    out.print(" | m: ");
+    out.print(snap.slope[i], 6); // High precision for small slope
+    out.print(" c: ");
+    out.print(snap.intercept[i], 3);
+    out.print(" | Temp: ");
+    out.print(snap.tempValue[i], 2);
+    out.print(" C");
+    if (snap.filterLimited & (1 << i)) {
+      // filterPeriod lebih panjang dari window maksimum filter
+      out.print(" | Filter dibatasi: "); out.print(snap.filterSpan[i]); out.print(" sampel");
     }
+    out.println();
+  }
+  out.print("Samples: "); out.print(snap.sampleCount);
+  out.print(" | Overrun: "); out.print(snap.overruns);
+  out.print(" | Dropped: "); out.print(snap.dropped);
+  out.print(" | Latency max: "); out.print(snap.maxLatencyUs); out.println(" us");
+}
+
+// Event "values" (retained) untuk /events dan /getValue:
+// [{"KodeSensor":"<nama AI>","Value":x}, ...]
+void publishValues(const AnalogSnapshot &snap) {
+  char json[EVENT_RETAIN_DATA];
+  size_t len = 0;
+  json[len++] = '[';
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    if (!(snap.mask & (1 << i))) continue;
+    const char *name = config.analog().ai[i].name;
+    char fallback[4] = {'A', 'I', (char)('1' + i), '\0'};
+    int n = snprintf(json + len, sizeof(json) - len, "%s{\"KodeSensor\":\"%s\",\"Value\":%.2f}",
+                     len > 1 ? "," : "", name[0] ? name : fallback, snap.tempValue[i]);
+    if (n < 0 || (size_t)n >= sizeof(json) - len - 1) break;
+    len += n;
+  }
+  json[len++] = ']';
+  json[len] = '\0';
+  events.publish("values", json, true);
+}
+
+// Event "modbus" (retained): format sama dengan "values", hanya tag yang
+// sudah terbaca dari slave. Tidak dikirim ulang jika tidak ada blok baru.
+void publishModbus() {
+  static uint32_t publishedSeq = 0;
+  if (modbus.seq() == publishedSeq) return;
+  publishedSeq = modbus.seq();
+  char json[EVENT_RETAIN_DATA];
+  size_t len = 0;
+  json[len++] = '[';
+  const ModbusConfig &cfg = config.modbus();
+  for (uint8_t i = 0; i < cfg.tagCount && i < modbus.tagCount(); i++) {
+    ModbusReading r;
+    if (!modbus.reading(i, r)) continue;
+    int n = snprintf(json + len, sizeof(json) - len, "%s{\"KodeSensor\":\"%s\",\"Value\":%.2f}",
+                     len > 1 ? "," : "", cfg.tags[i].name, r.value);
+    if (n < 0 || (size_t)n >= sizeof(json) - len - 1) break;
+    len += n;
+  }
+  json[len++] = ']';
+  json[len] = '\0';
+  events.publish("modbus", json, true);
+}
+
+// Snapshot untuk /live (dashboard home), seq naik setiap detik
+void updateLiveData(const AnalogSnapshot &analog) {
+  LiveSnapshot &snap = live.edit();
+  snap.aiMask = analog.mask;
+  for (int i = 0; i < ADC_CHANNELS && i < LIVE_AI_COUNT; i++) {
+    snap.aiRaw[i] = analog.scaledRaw[i];
+    snap.aiScaled[i] = analog.tempValue[i];
   }
-}
\ No newline at end of file
+  for (int i = 0; i < DI_CHANNELS && i < LIVE_DI_COUNT; i++) {
+    snap.di[i] = digitalInputs.value(i);
+  }
+  live.commit();
+}
+
+// Register image Modbus TCP (peta di RegisterImage.h). Tag RTU ditulis
+// langsung oleh task poller. Semua nilai dihitung dulu: di antara
+// beginWrite()/endWrite() interrupt mati, jadi isinya hanya store.
+void updateRegisters(const AnalogFrame &frame, EthernetLinkStatus link) {
+  static uint16_t seq = 0;
+  uint16_t x100[ADC_CHANNELS], raw[ADC_CHANNELS], di[DI_CHANNELS];
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    x100[i] = (uint16_t)(int16_t)constrain(frame.tempValue[i] * 100.0f, -32768.0f, 32767.0f);
+    // Raw tak bertanda (0..65535); kode ADC negatif -> 0, bukan UB float->uint16
+    raw[i] = (uint16_t)constrain(frame.scaledRaw[i], 0.0f, 65535.0f);
+  }
+  for (int i = 0; i < DI_CHANNELS; i++) {
+    di[i] = (uint16_t)digitalInputs.value(i);
+  }
+  uint16_t status = (link == LinkON ? 1 : 0) | (frame.mask << 8);
+  seq++;
+
+  registers.beginWrite();
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    registers.setFloat(REG_AI_VALUE + i * 2, frame.tempValue[i]);
+    registers.set(REG_AI_X100 + i, x100[i]);
+    registers.set(REG_AI_RAW + i, raw[i]);
+  }
+  for (int i = 0; i < DI_CHANNELS; i++) {
+    registers.set(REG_DI_VALUE + i, di[i]);
+  }
+  registers.setU32(REG_UPTIME, frame.ms / 1000);
+  registers.set(REG_STATUS, status);
+  registers.set(REG_SEQ, seq);
+  registers.endWrite();
+}
+
+// Agregat per frame -> bucket 1 s / 1 min / 15 min / 1 h (grafik /rollup)
+void updateRollups(const AnalogFrame &frame) {
+  uint32_t now = logger.now();
+  for (int i = 0; i < ADC_CHANNELS && i < ROLLUP_CHANNELS; i++) {
+    if (frame.mask & (1 << i)) rollups.add(LOG_CH_AI + i, now, frame.stats[i]);
+  }
+}
+
+void handleSerialCommands() {
+  // Hanya byte yang sudah ada di buffer RX; baris lengkap baru dijalankan
+  if (!console.poll()) return;
+  sampleStream.flush(Serial); // balasan tidak boleh memotong frame biner
+  console.execute(Serial);
+}
+
+// Perintah ke task akuisisi; gagal hanya jika antrean penuh
+bool queueCommand(const AcqCommand &cmd, Print &out) {
+  if (acqCommands.push(cmd)) return true;
+  out.println("Error: antrean akuisisi penuh.");
+  return false;
+}
+
+// "1,3" atau "1 3" -> bit 0..3 (AI1..AI4); 0 = tidak valid
+uint8_t parseChannels(uint8_t argc, char **argv, uint8_t first) {
+  uint8_t mask = 0;
+  for (uint8_t i = first; i < argc; i++) {
+    for (const char *p = argv[i]; *p; p++) {
+      if (*p == ',') continue;
+      if (*p < '1' || *p > '4') return 0;
+      mask |= 1 << (*p - '1');
+    }
+  }
+  return mask;
+}
+
+struct GainOption
+{
+  const char *name;
+  adsGain_t gain;
+  const char *range;
+};
+
+const GainOption gainOptions[] = {
+  {"2/3", GAIN_TWOTHIRDS, "+/-6.144V"},
+  {"1", GAIN_ONE, "+/-4.096V"},
+  {"2", GAIN_TWO, "+/-2.048V"},
+  {"4", GAIN_FOUR, "+/-1.024V"},
+  {"8", GAIN_EIGHT, "+/-0.512V"},
+  {"16", GAIN_SIXTEEN, "+/-0.256V"},
+};
+
+const GainOption *findGain(adsGain_t gain) {
+  for (const GainOption &g : gainOptions) {
+    if (g.gain == gain) return &g;
+  }
+  return &gainOptions[0];
+}
+
+void printUsage(const char *name, Print &out) {
+  for (const ConsoleCommand &c : consoleCommands) {
+    if (strcmp(c.name, name) != 0) continue;
+    out.print("Usage: "); out.print(c.name); out.print(' '); out.println(c.usage);
+  }
+}
+
+void printMask(uint8_t mask, Print &out) {
+  bool any = false;
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    if (!(mask & (1 << i))) continue;
+    if (any) out.print(',');
+    out.print("AI"); out.print(i + 1);
+    any = true;
+  }
+  if (!any) out.print('-');
+}
+
+void cmdHelp(uint8_t argc, char **argv, Print &out) {
+  console.printHelp(out);
+}
+
+void cmdStats(uint8_t argc, char **argv, Print &out) {
+  AnalogSnapshot snap;
+  analogSnapshot.read(snap);
+  printSensors(out, snap);
+  const GainOption *g = findGain(snap.gain);
+  out.print("Rate: "); out.print(snap.dataRate);
+  out.print(" SPS | Gain: "); out.print(g->name); out.print(" ("); out.print(g->range);
+  out.print(") | Channels: "); printMask(snap.mask, out);
+  out.println();
+  out.print("Filter window (sampel):");
+  for (int i = 0; i < ADC_CHANNELS; i++) {
+    if (!(snap.mask & (1 << i))) continue;
+    out.print(" AI"); out.print(i + 1); out.print('='); out.print(snap.filterSpan[i]);
+    if (snap.filterLimited & (1 << i)) out.print(" (dibatasi)");
+  }
+  out.println();
+  static const char *const modes[] = {"off", "raw", "eng"};
+  out.print("Stream: "); out.print(modes[sampleStream.mode()]);
+  out.print(" | Channels: "); printMask(sampleStream.channelMask(), out);
+  out.print(" | Frames: "); out.print(sampleStream.frames());
+  out.print(" | Dropped: "); out.println(sampleStream.dropped());
+}
+
+void cmdChannels(uint8_t argc, char **argv, Print &out) {
+  AcqCommand cmd = {};
+  cmd.type = ACQ_CMD_MASK;
+  cmd.value = parseChannels(argc, argv, 1);
+  if (argc < 2 || cmd.value == 0) {
+    printUsage(argv[0], out);
+    return;
+  }
+  if (!queueCommand(cmd, out)) return;
+  out.print(">>> Channels: "); printMask(cmd.value, out); out.println();
+}
+
+void cmdGain(uint8_t argc, char **argv, Print &out) {
+  for (const GainOption &g : gainOptions) {
+    if (argc < 2 || strcmp(argv[1], g.name) != 0) continue;
+    AcqCommand cmd = {};
+    cmd.type = ACQ_CMD_GAIN;
+    cmd.value = g.gain;
+    if (!queueCommand(cmd, out)) return;
+    out.print(">>> Gain: "); out.print(g.name); out.print(" ("); out.print(g.range); out.println(")");
+    return;
+  }
+  printUsage(argv[0], out);
+}
+
+void cmdRate(uint8_t argc, char **argv, Print &out) {
+  long sps = argc < 2 ? 0 : atol(argv[1]);
+  if (sps < 8 || sps > 860) {
+    printUsage(argv[0], out);
+    return;
+  }
+  AcqCommand cmd = {};
+  cmd.type = ACQ_CMD_RATE;
+  cmd.value = sps;
+  if (!queueCommand(cmd, out)) return;
+  // Dibulatkan ke atas ke rate ADS1115 (lihat AdsAcquisition::setDataRate)
+  out.print(">>> Rate: "); out.print(sps); out.println(" SPS");
+}
+
+// Slope lalu intercept; keduanya mengembalikan channel ke kalibrasi linear
+bool queueCalibration(uint8_t channel, AcqCommandType type, float value, Print &out) {
+  AcqCommand cmd = {};
+  cmd.type = type;
+  cmd.channel = channel;
+  cmd.m = value;
+  return queueCommand(cmd, out);
+}
+
+void cmdCal(uint8_t argc, char **argv, Print &out) {
+  int ch = argc < 4 ? 0 : atoi(argv[1]);
+  if (ch < 1 || ch > ADC_CHANNELS) {
+    printUsage(argv[0], out);
+    return;
+  }
+  float m = atof(argv[2]);
+  float c = atof(argv[3]);
+  if (!queueCalibration(ch - 1, ACQ_CMD_SLOPE, m, out)) return;
+  if (!queueCalibration(ch - 1, ACQ_CMD_INTERCEPT, c, out)) return;
+  out.print(">>> AI"); out.print(ch);
+  out.print(" m: "); out.print(m, 6);
+  out.print(" c: "); out.println(c, 3);
+}
+
+// Perintah lama "m=<value>" / "c=<value>" (AI1)
+void cmdSlope(uint8_t argc, char **argv, Print &out) {
+  float m = argc < 2 ? 0 : atof(argv[1]);
+  if (!queueCalibration(0, ACQ_CMD_SLOPE, m, out)) return;
+  out.print(">>> Updated Slope (m): ");
+  out.println(m, 6);
+}
+
+void cmdIntercept(uint8_t argc, char **argv, Print &out) {
+  float c = argc < 2 ? 0 : atof(argv[1]);
+  if (!queueCalibration(0, ACQ_CMD_INTERCEPT, c, out)) return;
+  out.print(">>> Updated Intercept (c): ");
+  out.println(c, 2);
+}
+
+void cmdStream(uint8_t argc, char **argv, Print &out) {
+  StreamMode mode;
+  if (argc >= 2 && strcasecmp(argv[1], "raw") == 0) mode = STREAM_RAW;
+  else if (argc >= 2 && strcasecmp(argv[1], "eng") == 0) mode = STREAM_ENG;
+  else if (argc >= 2 && strcasecmp(argv[1], "off") == 0) mode = STREAM_OFF;
+  else {
+    printUsage(argv[0], out);
+    return;
+  }
+  uint8_t mask = 0x0F;
+  if (argc > 2 && (mask = parseChannels(argc, argv, 2)) == 0) {
+    printUsage(argv[0], out);
+    return;
+  }
+  // Balasan dikirim sebelum frame pertama
+  out.print(">>> Stream: "); out.print(argv[1]);
+  if (mode != STREAM_OFF) {
+    out.print(' '); printMask(mask, out);
+  }
+  out.println();
+  sampleStream.setMode(mode, mode == STREAM_OFF ? 0 : mask);
+}
@@ -0,0 +1,275 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "AdsAcquisition.h"
+#include "AnalogFilter.h"
+#include "Calibration.h"
+
+// Kalibrasi fixed-point vs jalur float lama (computeVolts -> scaled raw ->
+// m * x + c) untuk semua kode ADC int16
+
+static CalibrationKernel kernel;
+static int16_t codes[65536];
+static int32_t raw[65536];
+static int32_t eng[65536];
+
+static float gainRange(adsGain_t gain)
+{
+    switch (gain)
+    {
+    case GAIN_ONE:
+        return 4.096f;
+    case GAIN_TWO:
+        return 2.048f;
+    case GAIN_FOUR:
+        return 1.024f;
+    case GAIN_EIGHT:
+        return 0.512f;
+    case GAIN_SIXTEEN:
+        return 0.256f;
+    default:
+        return 6.144f;
+    }
+}
+
+// Persis seperti readSensors() sebelum CalibrationKernel
+static float floatRaw(int16_t code, adsGain_t gain)
+{
+    float voltage = code * (gainRange(gain) / 32768.0f);
+    return (voltage / 5.0) * 65535.0;
+}
+
+// Referensi presisi double dengan koefisien float yang sama
+static double exactRaw(int16_t code, adsGain_t gain)
+{
+    return code * (double)gainRange(gain) / 32768.0 / 5.0 * 65535.0;
+}
+
+static void processAll(uint8_t channel)
+{
+    kernel.process(channel, codes, 65536, raw, eng);
+}
+
+void setUp(void)
+{
+    for (int32_t i = 0; i < 65536; i++)
+        codes[i] = (int16_t)(i - 32768);
+    kernel = CalibrationKernel();
+}
+
+void tearDown(void)
+{
+}
+
+static void checkLinear(adsGain_t gain, float m, float c)
+{
+    kernel.setGain(gain);
+    kernel.configure(0, m, c);
+    processAll(0);
+    for (int32_t i = 0; i < 65536; i++)
+    {
+        float x = floatRaw(codes[i], gain);
+        float yFloat = m * x + c;
+        int64_t exact = llround(((double)m * exactRaw(codes[i], gain) + c) * CAL_ENG_SCALE);
+        // Scaled raw dibulatkan ke integer, nilai teknik ke milli-unit;
+        // tidak boleh lebih jauh dari nilai eksak daripada jalur float
+        TEST_ASSERT_INT_WITHIN(1, lroundf(x), raw[i]);
+        TEST_ASSERT_INT_WITHIN(1, exact, eng[i]);
+        TEST_ASSERT_LESS_OR_EQUAL(llabs(llround((double)yFloat * CAL_ENG_SCALE) - exact) + 1,
+                                  llabs(eng[i] - exact));
+    }
+}
+
+void test_linear_default_config(void)
+{
+    // configAnalog.json bawaan: 4..20 mA -> -150..250 C
+    checkLinear(GAIN_TWOTHIRDS, 0.004888f, -185.711f);
+}
+
+void test_linear_all_gains(void)
+{
+    const adsGain_t gains[] = {GAIN_TWOTHIRDS, GAIN_ONE, GAIN_TWO, GAIN_FOUR, GAIN_EIGHT, GAIN_SIXTEEN};
+    for (adsGain_t g : gains)
+        checkLinear(g, 0.01f, 2.5f);
+}
+
+void test_linear_small_and_negative_slope(void)
+{
+    checkLinear(GAIN_ONE, 1.5e-5f, 0.0f);
+    checkLinear(GAIN_ONE, -0.25f, 1000.0f);
+}
+
+void test_gain_change_recomputes_channels(void)
+{
+    kernel.configure(1, 0.004888f, -185.711f);
+    kernel.setGain(GAIN_FOUR);
+    kernel.process(1, codes, 65536, raw, eng);
+    for (int32_t i = 0; i < 65536; i += 97)
+    {
+        double y = (double)0.004888f * exactRaw(codes[i], GAIN_FOUR) + (double)-185.711f;
+        TEST_ASSERT_INT_WITHIN(1, llround(y * CAL_ENG_SCALE), eng[i]);
+    }
+}
+
+void test_saturates_instead_of_wrapping(void)
+{
+    kernel.configure(0, 1.0e6f, 0.0f);
+    int16_t ends[] = {-32768, 32767};
+    int32_t out[2];
+    kernel.process(0, ends, 2, nullptr, out);
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, out[0]);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, out[1]);
+}
+
+void test_pwl_curve_through_points(void)
+{
+    // Titik sengaja tidak urut: setCurve() mengurutkan menurut x
+    CalCurve curve = {CAL_CURVE_PWL, 3, {65535, 13107, 39321}, {250, -150, 0}};
+    kernel.setCurve(2, curve);
+    processAll(2);
+
+    double k = exactRaw(1, GAIN_TWOTHIRDS);
+    double segment = k * (1 << CAL_LUT_SHIFT);
+    int32_t worst = 0;
+    for (int32_t i = 0; i < 65536; i++)
+    {
+        double x = codes[i] * k;
+        double y;
+        if (x <= 39321)
+            y = -150 + (x - 13107) * 150.0 / 26214;
+        else
+            y = (x - 39321) * 250.0 / 26214;
+        int32_t err = abs((int32_t)(eng[i] - llround(y * CAL_ENG_SCALE)));
+        // Di luar segmen LUT yang memuat lekukan (x = 39321) hanya pembulatan
+        bool knee = fabs(x - 39321) < segment;
+        if (!knee)
+            TEST_ASSERT_LESS_OR_EQUAL(1, err);
+        worst = max(worst, err);
+    }
+    // Lekukan: paling jauh |selisih slope| x lebar segmen / 4
+    double slopeStep = (250.0 - 150.0) / 26214 * CAL_ENG_SCALE;
+    TEST_ASSERT_LESS_OR_EQUAL(lround(slopeStep * segment / 4) + 1, worst);
+}
+
+void test_poly_curve(void)
+{
+    // y = 2 + 0.001 x + 1e-8 x^2
+    CalCurve curve = {CAL_CURVE_POLY, 3, {}, {2.0f, 0.001f, 1.0e-8f}};
+    kernel.setCurve(3, curve);
+    processAll(3);
+
+    for (int32_t i = 0; i < 65536; i++)
+    {
+        double x = exactRaw(codes[i], GAIN_TWOTHIRDS);
+        double y = curve.y[0] + curve.y[1] * x + curve.y[2] * x * x;
+        // Interpolasi LUT: y'' * h^2 / 8 < 1 milli-unit, ditambah pembulatan
+        TEST_ASSERT_INT_WITHIN(2, llround(y * CAL_ENG_SCALE), eng[i]);
+    }
+}
+
+void test_linear_curve_type_falls_back(void)
+{
+    kernel.configure(0, 0.01f, 1.0f);
+    CalCurve pwl = {CAL_CURVE_PWL, 2, {0, 65535}, {0, 100}};
+    kernel.setCurve(0, pwl);
+    CalCurve linear = {CAL_CURVE_LINEAR, 0, {}, {}};
+    kernel.setCurve(0, linear);
+    int16_t code = 16000;
+    int32_t out;
+    kernel.process(0, &code, 1, nullptr, &out);
+    TEST_ASSERT_INT_WITHIN(1, llround(((double)0.01f * exactRaw(code, GAIN_TWOTHIRDS) + 1.0) * CAL_ENG_SCALE), out);
+    TEST_ASSERT_EQUAL(CAL_CURVE_PWL, CalibrationKernel::parseCurveType("pwl"));
+    TEST_ASSERT_EQUAL(CAL_CURVE_POLY, CalibrationKernel::parseCurveType("poly"));
+    TEST_ASSERT_EQUAL(CAL_CURVE_LINEAR, CalibrationKernel::parseCurveType("x"));
+}
+
+// ---------------------------------------------------------
+// Benchmark host: ring -> kalibrasi -> filter per blok, seperti
+// readSensors(), dibanding jalur float lama per sampel
+// ---------------------------------------------------------
+#define BENCH_BLOCK 64
+#define BENCH_SAMPLES (4 * 65536)
+
+static AdcRing ring;
+static AnalogFilterBank filters;
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void test_pipeline_throughput(void)
+{
+    for (uint8_t ch = 0; ch < CAL_CHANNELS; ch++)
+    {
+        kernel.configure(ch, 0.004888f, -185.711f);
+        filters.configure(ch, FILTER_AVERAGE, 1.0f, 860.0f);
+    }
+
+    static AdcSample block[BENCH_BLOCK];
+    static int16_t chCodes[CAL_CHANNELS][BENCH_BLOCK];
+    static int32_t chRaw[BENCH_BLOCK], chEng[BENCH_BLOCK];
+    int64_t checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i += BENCH_BLOCK)
+    {
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++)
+            ring.push({i + k, codes[(i + k) & 0xFFFF], (uint8_t)(k & 3)});
+        size_t n = ring.popBlock(block, BENCH_BLOCK);
+        size_t count[CAL_CHANNELS] = {0, 0, 0, 0};
+        for (size_t k = 0; k < n; k++)
+            chCodes[block[k].channel][count[block[k].channel]++] = block[k].code;
+        for (uint8_t ch = 0; ch < CAL_CHANNELS; ch++)
+        {
+            kernel.process(ch, chCodes[ch], count[ch], chRaw, chEng);
+            filters.process(ch, chEng, count[ch]);
+            checksum += chEng[0];
+        }
+    }
+    double fixedSec = secondsSince(start);
+
+    // Kernel saja vs jalur float lama, keluaran sama (scaled raw + nilai teknik)
+    static float floatRawOut[BENCH_BLOCK], floatEngOut[BENCH_BLOCK];
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i += BENCH_BLOCK)
+        kernel.process(0, codes + (i & 0xFFFF), BENCH_BLOCK, chRaw, chEng);
+    double kernelSec = secondsSince(start);
+    checksum += chEng[0];
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i += BENCH_BLOCK)
+    {
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++)
+        {
+            floatRawOut[k] = floatRaw(codes[(i + k) & 0xFFFF], GAIN_TWOTHIRDS);
+            floatEngOut[k] = 0.004888f * floatRawOut[k] + -185.711f;
+        }
+        checksum += (int64_t)floatEngOut[0];
+    }
+    double floatSec = secondsSince(start);
+
+    // Angka host hanya untuk regresi; angka ESP32 lihat METRIC_CALIBRATION di /metrics
+    char msg[160];
+    snprintf(msg, sizeof(msg), "Msampel/s host: kernel %.1f, float lama %.1f, ring+kernel+filter %.1f",
+             BENCH_SAMPLES / kernelSec / 1e6, BENCH_SAMPLES / floatSec / 1e6, BENCH_SAMPLES / fixedSec / 1e6);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(0, ring.dropped());
+    TEST_ASSERT_NOT_EQUAL(0, checksum);
+    // 4 channel x 860 SPS hanya sebagian kecil dari kemampuan host
+    TEST_ASSERT_GREATER_THAN(100 * 4 * 860, (int64_t)(BENCH_SAMPLES / fixedSec));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_default_config);
+    RUN_TEST(test_linear_all_gains);
+    RUN_TEST(test_linear_small_and_negative_slope);
+    RUN_TEST(test_gain_change_recomputes_channels);
+    RUN_TEST(test_saturates_instead_of_wrapping);
+    RUN_TEST(test_pwl_curve_through_points);
+    RUN_TEST(test_poly_curve);
+    RUN_TEST(test_linear_curve_type_falls_back);
+    RUN_TEST(test_pipeline_throughput);
+    return UNITY_END();
+}
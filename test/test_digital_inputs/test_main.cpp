@@ -0,0 +1,192 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include <thread>
+#include "SimDigital.h"
+#include "DigitalInputs.h"
+
+// Rekaman edge "us,level" diputar ulang lewat sumber file: NativeSim
+// (sama seperti --diN file:PATH), jadi PCNT, ISR edge dan window
+// DigitalInputs berjalan seperti di board
+
+static std::string recordingDir;
+
+static std::string writeRecording(const char *name, const std::string &text)
+{
+    std::string path = recordingDir + "/" + name;
+    FILE *f = fopen(path.c_str(), "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs(text.c_str(), f);
+    fclose(f);
+    return path;
+}
+
+// Kotak periodUs dengan fase HIGH highUs, satu siklus rekaman = satu periode
+static std::string square(uint32_t periodUs, uint32_t highUs)
+{
+    char text[96];
+    snprintf(text, sizeof(text), "# kotak\n0,1\n%u,0\n%u,0\n", highUs, periodUs);
+    return text;
+}
+
+static void replay(uint8_t pin, const std::string &path)
+{
+    static SimPulseSource sources[DI_CHANNELS];
+    static uint8_t used = 0;
+    SimPulseSource &s = sources[used++];
+    TEST_ASSERT_TRUE(s.parse(("file:" + path).c_str()));
+    std::thread(&SimPulseSource::run, &s, pin).detach();
+}
+
+static DigitalInputConfig input(const char *mode, uint32_t intervalTime, float factor,
+                                const char *state = "High", bool invers = false)
+{
+    DigitalInputConfig c;
+    memset(&c, 0, sizeof(c));
+    strcpy(c.taskMode, mode);
+    strcpy(c.inputState, state);
+    c.invers = invers;
+    c.intervalTime = intervalTime;
+    c.conversionFactor = factor;
+    return c;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_parse_mode(void)
+{
+    TEST_ASSERT_EQUAL(DI_MODE_COUNTING, DigitalInputs::parseMode("Counting"));
+    TEST_ASSERT_EQUAL(DI_MODE_CYCLE_TIME, DigitalInputs::parseMode("Cycle Time"));
+    TEST_ASSERT_EQUAL(DI_MODE_RUN_TIME, DigitalInputs::parseMode("Run Time"));
+    TEST_ASSERT_EQUAL(DI_MODE_PULSE, DigitalInputs::parseMode("Pulse Mode"));
+    TEST_ASSERT_EQUAL(DI_MODE_NORMAL, DigitalInputs::parseMode("Normal"));
+    TEST_ASSERT_EQUAL(DI_MODE_NORMAL, DigitalInputs::parseMode(""));
+}
+
+// Timestamp rekaman langsung ke DiEdgeTimer (jalur ISR tanpa hardware)
+void test_edge_timer_recorded(void)
+{
+    const uint32_t edges[][2] = {{2000, 1}, {2500, 0}, {4000, 1}, {4700, 0}, {6000, 1}};
+    DiEdgeTimer t;
+    t.reset(1000, false);
+    for (const uint32_t *e : edges)
+        t.edge(e[0], e[1]);
+    TEST_ASSERT_EQUAL(500 + 700, t.activeUs);
+    TEST_ASSERT_EQUAL(2, t.periods);
+    TEST_ASSERT_EQUAL(4000, t.periodUs);
+    TEST_ASSERT_TRUE(t.active);
+    // Fase aktif yang sedang berjalan ikut dihitung
+    TEST_ASSERT_EQUAL(1200 + 300, t.activeUntil(6300));
+}
+
+// Glitch / edge terlewat: ISR membaca level yang sama dua kali.
+// Edge itu diabaikan, pengukuran lanjut dari edge berikutnya.
+void test_edge_timer_ignores_glitch(void)
+{
+    DiEdgeTimer t;
+    t.reset(0, false);
+    t.edge(1000, true);
+    t.edge(1001, true); // pulsa sempit: falling terlewat, terbaca HIGH lagi
+    t.edge(1500, false);
+    t.edge(1600, false);
+    t.edge(3000, true);
+    TEST_ASSERT_EQUAL(500, t.activeUs);
+    TEST_ASSERT_EQUAL(1, t.periods);
+    TEST_ASSERT_EQUAL(2000, t.periodUs);
+    TEST_ASSERT_EQUAL(3000, t.lastEdgeUs);
+}
+
+void test_edge_timer_micros_wrap(void)
+{
+    DiEdgeTimer t;
+    t.reset(0xFFFFFC00UL, false);
+    t.edge(0xFFFFFE00UL, true);
+    t.edge(0x00000100UL, false); // micros() wrap di tengah fase aktif
+    t.edge(0x00000300UL, true);
+    TEST_ASSERT_EQUAL(0x300, t.activeUs);
+    TEST_ASSERT_EQUAL(1, t.periods);
+    TEST_ASSERT_EQUAL(0x500, t.periodUs);
+}
+
+// Empat DI sekaligus dari rekaman edge, lewat PCNT simulasi dan ISR
+void test_replay_through_inputs(void)
+{
+    char dir[] = "/tmp/di-test-XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(dir));
+    recordingDir = dir;
+
+    // DI1: 100 pulsa 1 kHz lalu diam (edge terakhir di 30 s = panjang rekaman)
+    std::string burst = "# burst\n";
+    for (int i = 0; i < 100; i++)
+        burst += std::to_string(i * 1000) + ",1\n" + std::to_string(i * 1000 + 400) + ",0\n";
+    burst += "30000000,0\n";
+    std::string burstPath = writeRecording("burst.txt", burst);
+    // DI2/DI3: 100 Hz, HIGH 25%; DI4: 1 kHz
+    std::string cyclePath = writeRecording("cycle.txt", square(10000, 2500));
+    std::string pulsePath = writeRecording("pulse.txt", square(1000, 500));
+
+    DigitalConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.di[0] = input("Counting", 500, 0.5f);
+    cfg.di[1] = input("Cycle Time", 500, 1000.0f); // periode dalam ms
+    cfg.di[2] = input("Run Time", 500, 1.0f, "High", true); // aktif = LOW (75%)
+    cfg.di[3] = input("Pulse Mode", 500, 0.01f);
+    static DigitalInputs inputs;
+    inputs.begin();
+    inputs.configure(cfg);
+
+    // Replay setelah unit PCNT jalan, supaya edge pertama ikut terhitung
+    replay(DI1_PIN, burstPath);
+    replay(DI2_PIN, cyclePath);
+    replay(DI3_PIN, cyclePath);
+    replay(DI4_PIN, pulsePath);
+
+    // Tiga window penuh; window pertama ikut fase awal replay
+    uint32_t start = millis();
+    while (millis() - start < 1600)
+    {
+        inputs.service();
+        delay(5);
+    }
+
+    const DiReading &counter = inputs.reading(0);
+    TEST_ASSERT_EQUAL(100, counter.count); // PCNT: tepat satu per rising edge
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 50.0, counter.value);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, counter.frequency); // burst sudah lewat
+    TEST_ASSERT_EQUAL(50, inputs.value(0));
+
+    const DiReading &cycle = inputs.reading(1);
+    TEST_ASSERT_FLOAT_WITHIN(3.0, 100.0, cycle.frequency);
+    TEST_ASSERT_FLOAT_WITHIN(0.3, 10.0, cycle.value);
+    TEST_ASSERT_FLOAT_WITHIN(0.03, 0.25, cycle.duty);
+
+    // invers: aktif LOW, PCNT menghitung falling edge
+    const DiReading &run = inputs.reading(2);
+    TEST_ASSERT_FLOAT_WITHIN(3.0, 100.0, run.frequency);
+    TEST_ASSERT_FLOAT_WITHIN(0.03, 0.75, run.duty);
+    // Run time bertambah 0.75 s per detik (window pertama mulai dari configure)
+    TEST_ASSERT_FLOAT_WITHIN(0.08, 0.75 * 1.5, run.value);
+    TEST_ASSERT_INT_WITHIN(3, run.count, inputs.reading(1).count);
+
+    const DiReading &pulse = inputs.reading(3);
+    TEST_ASSERT_FLOAT_WITHIN(30.0, 1000.0, pulse.frequency);
+    TEST_ASSERT_FLOAT_WITHIN(0.15, 500 * 0.01, pulse.value);
+    TEST_ASSERT_INT_WITHIN(40, 1600, pulse.count);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_mode);
+    RUN_TEST(test_edge_timer_recorded);
+    RUN_TEST(test_edge_timer_ignores_glitch);
+    RUN_TEST(test_edge_timer_micros_wrap);
+    RUN_TEST(test_replay_through_inputs);
+    return UNITY_END();
+}
@@ -0,0 +1,335 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include "HttpRequestParser.h"
+
+static HttpRequestParser parser;
+
+// Masukkan seluruh teks dalam potongan `chunk` byte, seperti handleClient:
+// feed() diulang selama masih ada sisa dan parser belum selesai / gagal
+static size_t feedAll(const char *text, size_t len, size_t chunk)
+{
+    size_t pos = 0;
+    while (pos < len && !parser.complete() && !parser.failed())
+    {
+        size_t n = min(chunk, len - pos);
+        size_t used = parser.feed((const uint8_t *)text + pos, n);
+        pos += used;
+        if (used == 0)
+            break;
+    }
+    return pos;
+}
+
+static size_t feedAll(const char *text, size_t chunk = 4096)
+{
+    return feedAll(text, strlen(text), chunk);
+}
+
+void setUp(void)
+{
+    parser.reset();
+}
+
+void tearDown(void)
+{
+}
+
+void test_get_with_query(void)
+{
+    feedAll("GET /rollup?ch=1&res=60 HTTP/1.1\r\nHost: x\r\nIf-None-Match: \"abc\"\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL(HTTP_METHOD_GET, parser.method());
+    TEST_ASSERT_EQUAL_STRING("GET", parser.methodName());
+    TEST_ASSERT_EQUAL_STRING("/rollup", parser.path());
+    TEST_ASSERT_EQUAL(7, parser.pathLength());
+    TEST_ASSERT_EQUAL_STRING("ch=1&res=60", parser.query());
+    TEST_ASSERT_EQUAL_STRING("\"abc\"", parser.ifNoneMatch());
+    TEST_ASSERT_TRUE(parser.http11());
+    TEST_ASSERT_TRUE(parser.keepAlive());
+}
+
+void test_without_query(void)
+{
+    feedAll("GET / HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL_STRING("/", parser.path());
+    TEST_ASSERT_EQUAL_STRING("", parser.query());
+}
+
+void test_keep_alive_rules(void)
+{
+    feedAll("GET / HTTP/1.0\r\n\r\n");
+    TEST_ASSERT_FALSE(parser.keepAlive());
+
+    parser.reset();
+    feedAll("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.keepAlive());
+
+    parser.reset();
+    feedAll("GET / HTTP/1.1\r\nconnection:   close  \r\n\r\n");
+    TEST_ASSERT_FALSE(parser.keepAlive());
+}
+
+// Hasil sama berapa pun ukuran potongan TCP
+void test_any_chunk_size(void)
+{
+    const char *req = "POST /save HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+                      "Content-Length: 21\r\n\r\ninputPin=DI2&mode=on!";
+    for (size_t chunk = 1; chunk <= strlen(req); chunk++)
+    {
+        parser.reset();
+        TEST_ASSERT_EQUAL(strlen(req), feedAll(req, chunk));
+        TEST_ASSERT_TRUE(parser.complete());
+        TEST_ASSERT_EQUAL(HTTP_METHOD_POST, parser.method());
+        TEST_ASSERT_EQUAL_STRING("/save", parser.path());
+        TEST_ASSERT_EQUAL_STRING("application/x-www-form-urlencoded", parser.contentType());
+        TEST_ASSERT_EQUAL(21, parser.contentLength());
+        TEST_ASSERT_EQUAL_STRING("inputPin=DI2&mode=on!", parser.body());
+        TEST_ASSERT_FALSE(parser.bodyTruncated());
+    }
+}
+
+// feed() berhenti setelah header: sisa byte milik body (stream OTA)
+void test_stops_after_headers(void)
+{
+    const char *req = "POST /update HTTP/1.1\r\nContent-Length: 4\r\n\r\nABCD";
+    size_t used = parser.feed((const uint8_t *)req, strlen(req));
+    TEST_ASSERT_EQUAL(strlen(req) - 4, used);
+    TEST_ASSERT_TRUE(parser.headersComplete());
+    TEST_ASSERT_EQUAL(HttpRequestParser::BODY, parser.state());
+    TEST_ASSERT_EQUAL(0, parser.bodyReceived());
+}
+
+void test_body_split_from_next_request(void)
+{
+    // Pipelining: feed() tidak mengambil byte milik request berikutnya
+    const char *req = "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nxyzGET /b HTTP/1.1\r\n\r\n";
+    size_t used = feedAll(req);
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL_STRING("xyz", parser.body());
+    TEST_ASSERT_EQUAL_STRING("GET /b HTTP/1.1\r\n\r\n", req + used);
+}
+
+void test_body_truncated(void)
+{
+    static char req[HTTP_MAX_BODY + 200];
+    int head = snprintf(req, sizeof(req), "POST / HTTP/1.1\r\nContent-Length: %u\r\n\r\n", HTTP_MAX_BODY + 10);
+    memset(req + head, 'a', HTTP_MAX_BODY + 10);
+    req[head + HTTP_MAX_BODY + 10] = '\0';
+    feedAll(req, 100);
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL(HTTP_MAX_BODY, parser.bodyLength());
+    TEST_ASSERT_EQUAL(HTTP_MAX_BODY + 10, parser.bodyReceived());
+    TEST_ASSERT_TRUE(parser.bodyTruncated());
+    TEST_ASSERT_EQUAL(HTTP_MAX_BODY, strlen(parser.body()));
+}
+
+void test_leading_blank_lines_and_bare_lf(void)
+{
+    feedAll("\r\n\nHEAD /info HTTP/1.1\nHost: x\n\n");
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL(HTTP_METHOD_HEAD, parser.method());
+    TEST_ASSERT_EQUAL_STRING("/info", parser.path());
+}
+
+void test_unknown_method_is_parsed(void)
+{
+    feedAll("DELETE /x HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL(HTTP_METHOD_UNKNOWN, parser.method());
+}
+
+void test_malformed_request_line(void)
+{
+    feedAll("GET /\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.failed());
+
+    parser.reset();
+    feedAll("GET / HTTP/2.0\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.failed());
+}
+
+void test_target_too_long(void)
+{
+    char req[HTTP_MAX_LINE + 64];
+    char path[HTTP_MAX_TARGET + 1];
+    memset(path, 'p', HTTP_MAX_TARGET);
+    path[0] = '/';
+    path[HTTP_MAX_TARGET] = '\0';
+    snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\n\r\n", path);
+    feedAll(req);
+    TEST_ASSERT_TRUE(parser.failed());
+}
+
+// Header terlalu panjang diabaikan, request tetap jalan
+void test_long_header_ignored(void)
+{
+    char req[HTTP_MAX_LINE * 2 + 64];
+    char cookie[HTTP_MAX_LINE + 20];
+    memset(cookie, 'c', sizeof(cookie) - 1);
+    cookie[sizeof(cookie) - 1] = '\0';
+    snprintf(req, sizeof(req), "GET /a HTTP/1.1\r\nCookie: %s\r\nIf-None-Match: W/\"e\"\r\n\r\n", cookie);
+    feedAll(req, 7);
+    TEST_ASSERT_TRUE(parser.complete());
+    TEST_ASSERT_EQUAL_STRING("W/\"e\"", parser.ifNoneMatch());
+}
+
+void test_reset_clears_previous_request(void)
+{
+    feedAll("POST /a?x=1 HTTP/1.1\r\nContent-Length: 2\r\nIf-None-Match: \"1\"\r\n\r\nok");
+    parser.reset();
+    feedAll("GET /b HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL_STRING("/b", parser.path());
+    TEST_ASSERT_EQUAL_STRING("", parser.query());
+    TEST_ASSERT_EQUAL_STRING("", parser.ifNoneMatch());
+    TEST_ASSERT_EQUAL(0, parser.contentLength());
+    TEST_ASSERT_EQUAL(0, parser.bodyLength());
+}
+
+// ---------------------------------------------------------
+// Fuzz: request valid yang dimutasi acak, dipotong acak
+// ---------------------------------------------------------
+static uint32_t fuzzState = 12345;
+
+static uint32_t fuzzRandom()
+{
+    // xorshift32: deterministik, kasus gagal bisa diulang
+    fuzzState ^= fuzzState << 13;
+    fuzzState ^= fuzzState >> 17;
+    fuzzState ^= fuzzState << 5;
+    return fuzzState;
+}
+
+struct ParseResult
+{
+    HttpRequestParser::State state;
+    std::string path, query, etag, contentType, body;
+    size_t used;
+};
+
+static ParseResult parseInChunks(const std::string &req, bool randomChunks)
+{
+    parser.reset();
+    size_t pos = 0;
+    while (pos < req.size() && !parser.complete() && !parser.failed())
+    {
+        size_t n = randomChunks ? 1 + fuzzRandom() % 64 : req.size();
+        n = min(n, req.size() - pos);
+        size_t used = parser.feed((const uint8_t *)req.data() + pos, n);
+        TEST_ASSERT_LESS_OR_EQUAL(n, used);
+        pos += used;
+        if (used == 0)
+            break;
+    }
+    // Semua field selalu string C yang valid di dalam buffer-nya
+    TEST_ASSERT_EQUAL(parser.pathLength(), strlen(parser.path()));
+    TEST_ASSERT_LESS_THAN(HTTP_MAX_TARGET, parser.pathLength() + strlen(parser.query()));
+    TEST_ASSERT_LESS_THAN(HTTP_MAX_ETAG, strlen(parser.ifNoneMatch()));
+    TEST_ASSERT_LESS_THAN(HTTP_MAX_CONTENT_TYPE, strlen(parser.contentType()));
+    TEST_ASSERT_LESS_OR_EQUAL(HTTP_MAX_BODY, parser.bodyLength());
+    TEST_ASSERT_EQUAL(0, parser.body()[parser.bodyLength()]);
+    if (parser.complete())
+        TEST_ASSERT_EQUAL(parser.contentLength(), parser.bodyReceived());
+    return {parser.state(), parser.path(), parser.query(), parser.ifNoneMatch(), parser.contentType(),
+            std::string(parser.body(), parser.bodyLength()), pos};
+}
+
+static void mutate(std::string &req)
+{
+    static const char special[] = "\r\n :?\0\t/";
+    uint32_t edits = 1 + fuzzRandom() % 4;
+    for (uint32_t e = 0; e < edits && !req.empty(); e++)
+    {
+        size_t at = fuzzRandom() % req.size();
+        char c = fuzzRandom() & 1 ? (char)fuzzRandom() : special[fuzzRandom() % (sizeof(special) - 1)];
+        switch (fuzzRandom() % 5)
+        {
+        case 0:
+            req[at] = c;
+            break;
+        case 1:
+            req.insert(at, 1, c);
+            break;
+        case 2:
+            req.erase(at, 1 + fuzzRandom() % 8);
+            break;
+        case 3:
+            req.insert(at, req.substr(at, fuzzRandom() % 300)); // baris/field diperpanjang
+            break;
+        default:
+            req.resize(at); // koneksi putus di tengah
+            break;
+        }
+    }
+}
+
+void test_fuzz_mutated_requests(void)
+{
+    const char *seeds[] = {
+        "GET /rollup?ch=1&res=60 HTTP/1.1\r\nHost: x\r\nIf-None-Match: \"abc\"\r\nConnection: close\r\n\r\n",
+        "POST /save HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+        "Content-Length: 21\r\n\r\ninputPin=DI2&mode=on!",
+        "POST /update HTTP/1.0\r\nContent-Type: multipart/form-data; boundary=----x\r\n"
+        "Content-Length: 8\r\n\r\n------x-",
+        "HEAD / HTTP/1.1\n\n",
+    };
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        std::string req = seeds[i % (sizeof(seeds) / sizeof(seeds[0]))];
+        mutate(req);
+        // Hasil tidak bergantung pada cara TCP memotong byte
+        ParseResult whole = parseInChunks(req, false);
+        ParseResult chunked = parseInChunks(req, true);
+        TEST_ASSERT_EQUAL(whole.state, chunked.state);
+        TEST_ASSERT_EQUAL(whole.used, chunked.used);
+        TEST_ASSERT_TRUE(whole.path == chunked.path && whole.query == chunked.query);
+        TEST_ASSERT_TRUE(whole.etag == chunked.etag && whole.contentType == chunked.contentType);
+        TEST_ASSERT_TRUE(whole.body == chunked.body);
+    }
+}
+
+void test_parse_throughput(void)
+{
+    const char *req = "GET /getValue?from=1700000000&to=1700003600&mask=15 HTTP/1.1\r\n"
+                      "Host: 192.168.1.10\r\nUser-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+                      "Accept: application/json\r\nAccept-Encoding: gzip, deflate\r\n"
+                      "If-None-Match: \"cfg-42\"\r\nConnection: keep-alive\r\n\r\n";
+    const uint32_t rounds = 100000;
+    size_t len = strlen(req);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        parser.reset();
+        parser.feed((const uint8_t *)req, len);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(parser.complete());
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%.0f request/s, %.1f MB/s (host)", rounds / sec, rounds * len / sec / 1e6);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_GREATER_THAN(10000, (int64_t)(rounds / sec));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_get_with_query);
+    RUN_TEST(test_without_query);
+    RUN_TEST(test_keep_alive_rules);
+    RUN_TEST(test_any_chunk_size);
+    RUN_TEST(test_stops_after_headers);
+    RUN_TEST(test_body_split_from_next_request);
+    RUN_TEST(test_body_truncated);
+    RUN_TEST(test_leading_blank_lines_and_bare_lf);
+    RUN_TEST(test_unknown_method_is_parsed);
+    RUN_TEST(test_malformed_request_line);
+    RUN_TEST(test_target_too_long);
+    RUN_TEST(test_long_header_ignored);
+    RUN_TEST(test_reset_clears_previous_request);
+    RUN_TEST(test_fuzz_mutated_requests);
+    RUN_TEST(test_parse_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,368 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include "JsonWriter.h"
+#include "ChunkedPrint.h"
+
+// Print yang menampung seluruh output untuk dibandingkan
+class CapturePrint : public Print
+{
+public:
+    size_t write(uint8_t c) override
+    {
+        text += (char)c;
+        return 1;
+    }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        text.append((const char *)buf, size);
+        return size;
+    }
+    using Print::write;
+
+    std::string text;
+};
+
+static CapturePrint out;
+
+// Hitung alokasi heap (String lama vs JsonWriter) lewat operator new global
+static std::atomic<uint32_t> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+// Socket palsu: hanya menghitung byte
+class CountPrint : public Print
+{
+public:
+    size_t write(uint8_t) override
+    {
+        bytes++;
+        return 1;
+    }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        bytes += size;
+        return size;
+    }
+    using Print::write;
+
+    size_t bytes = 0;
+};
+
+// Gabungkan kembali body chunked; false jika format chunk salah
+static bool dechunk(const std::string &in, std::string &body, size_t &maxChunk)
+{
+    size_t pos = 0;
+    body.clear();
+    maxChunk = 0;
+    for (;;)
+    {
+        size_t eol = in.find("\r\n", pos);
+        if (eol == std::string::npos)
+            return false;
+        size_t len = strtoul(in.substr(pos, eol - pos).c_str(), nullptr, 16);
+        pos = eol + 2;
+        if (len == 0)
+            return in.compare(pos, std::string::npos, "\r\n") == 0;
+        if (in.compare(pos + len, 2, "\r\n") != 0)
+            return false;
+        body.append(in, pos, len);
+        maxChunk = max(maxChunk, len);
+        pos += len + 2;
+    }
+}
+
+void setUp(void)
+{
+    out.text.clear();
+}
+
+void tearDown(void)
+{
+}
+
+void test_nested_structure(void)
+{
+    JsonWriter json(out);
+    json.beginObject();
+    json.kv("ssid", "plant-01").kv("port", 502).kv("dhcp", true);
+    json.beginArray("value");
+    for (int i = 0; i < 3; i++)
+        json.value(i * 10);
+    json.endArray();
+    json.beginObject("modbus").kv("baud", 9600UL).endObject();
+    json.beginArray("empty").endArray();
+    json.beginArray("tags");
+    json.beginObject().kv("name", "T1").endObject();
+    json.beginObject().kv("name", "T2").endObject();
+    json.endArray();
+    json.endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"ssid\":\"plant-01\",\"port\":502,\"dhcp\":true,\"value\":[0,10,20],"
+                             "\"modbus\":{\"baud\":9600},\"empty\":[],"
+                             "\"tags\":[{\"name\":\"T1\"},{\"name\":\"T2\"}]}",
+                             out.text.c_str());
+}
+
+void test_top_level_array(void)
+{
+    JsonWriter json(out);
+    json.beginArray().value("a").value(false).beginArray().value(-1L).endArray().endArray();
+    TEST_ASSERT_EQUAL_STRING("[\"a\",false,[-1]]", out.text.c_str());
+}
+
+void test_string_escaping(void)
+{
+    JsonWriter json(out);
+    json.beginObject().kv("s", "q\"b\\n\nr\rt\t\x01\x1f").kv("null", (const char *)nullptr).endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"s\":\"q\\\"b\\\\n\\nr\\rt\\t\\u0001\\u001f\",\"null\":\"\"}", out.text.c_str());
+}
+
+void test_numbers(void)
+{
+    JsonWriter json(out);
+    json.beginArray();
+    json.value(12.5).value(1.0 / 3).value(1.0 / 3, 2).value(-0.5, 0);
+    json.value(NAN).value(INFINITY, 3);
+    json.value(4294967295UL).value(-2147483647L - 1);
+    json.endArray();
+    TEST_ASSERT_EQUAL_STRING("[12.5,0.3333333,0.33,-0,null,null,4294967295,-2147483648]", out.text.c_str());
+}
+
+void test_kv_with_decimals(void)
+{
+    JsonWriter json(out);
+    json.beginObject().kv("t", 21.456, 1).kv("n", 3.0f).endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"t\":21.5,\"n\":3}", out.text.c_str());
+}
+
+void test_deep_nesting(void)
+{
+    JsonWriter json(out);
+    for (int i = 0; i < JSON_MAX_DEPTH - 1; i++)
+        json.beginArray().value(i);
+    for (int i = 0; i < JSON_MAX_DEPTH - 1; i++)
+        json.endArray();
+    // Koma per level tetap benar sampai kedalaman maksimum
+    std::string want;
+    for (int i = 0; i < JSON_MAX_DEPTH - 1; i++)
+        want += "[" + std::to_string(i) + (i < JSON_MAX_DEPTH - 2 ? "," : "");
+    want.append(JSON_MAX_DEPTH - 1, ']');
+    TEST_ASSERT_EQUAL_STRING(want.c_str(), out.text.c_str());
+}
+
+void test_chunked_small_body(void)
+{
+    ChunkedPrint body(out, true);
+    body.print("{\"a\":1}");
+    TEST_ASSERT_EQUAL_STRING("", out.text.c_str()); // masih di buffer
+    body.end();
+    TEST_ASSERT_EQUAL_STRING("7\r\n{\"a\":1}\r\n0\r\n\r\n", out.text.c_str());
+    TEST_ASSERT_EQUAL(7, body.total());
+}
+
+void test_chunked_empty_body(void)
+{
+    ChunkedPrint body(out, true);
+    body.end();
+    TEST_ASSERT_EQUAL_STRING("0\r\n\r\n", out.text.c_str());
+}
+
+void test_chunked_exact_buffer(void)
+{
+    std::string data(HTTP_CHUNK_BUFFER, 'x');
+    ChunkedPrint body(out, true);
+    body.write((const uint8_t *)data.data(), data.size());
+    body.end();
+    char head[16];
+    snprintf(head, sizeof(head), "%X\r\n", HTTP_CHUNK_BUFFER);
+    TEST_ASSERT_EQUAL_STRING((head + data + "\r\n0\r\n\r\n").c_str(), out.text.c_str());
+}
+
+// Tulisan sembarang ukuran -> chunk <= HTTP_CHUNK_BUFFER, isi utuh
+void test_chunked_large_body(void)
+{
+    std::string data;
+    for (int i = 0; data.size() < 5000; i++)
+        data += "{\"i\":" + std::to_string(i) + "},";
+    ChunkedPrint body(out, true);
+    size_t pos = 0, step = 1;
+    while (pos < data.size())
+    {
+        size_t n = min(step, data.size() - pos);
+        if (n == 1)
+            body.write((uint8_t)data[pos]);
+        else
+            body.write((const uint8_t *)data.data() + pos, n);
+        pos += n;
+        step = step * 3 % 700 + 1;
+    }
+    body.end();
+
+    std::string decoded;
+    size_t maxChunk;
+    TEST_ASSERT_TRUE(dechunk(out.text, decoded, maxChunk));
+    TEST_ASSERT_TRUE(decoded == data);
+    TEST_ASSERT_EQUAL(HTTP_CHUNK_BUFFER, maxChunk);
+    TEST_ASSERT_EQUAL(data.size(), body.total());
+}
+
+void test_unchunked_passthrough(void)
+{
+    // Client HTTP/1.0: body apa adanya, akhir body = koneksi ditutup
+    std::string data(1300, 'y');
+    ChunkedPrint body(out, false);
+    JsonWriter json(body);
+    json.beginObject().kv("d", data.c_str()).endObject();
+    body.end();
+    TEST_ASSERT_EQUAL_STRING(("{\"d\":\"" + data + "\"}").c_str(), out.text.c_str());
+}
+
+void test_json_through_chunked(void)
+{
+    ChunkedPrint body(out, true);
+    JsonWriter json(body);
+    json.beginObject().kv("ok", true).endObject();
+    body.end();
+    TEST_ASSERT_EQUAL_STRING("B\r\n{\"ok\":true}\r\n0\r\n\r\n", out.text.c_str());
+}
+
+// ---------------------------------------------------------
+// Benchmark host: respons /homeLoad dengan String += (cara lama)
+// vs JsonWriter + ChunkedPrint langsung ke socket
+// ---------------------------------------------------------
+static const char *taskModes[4] = {"Normal", "Counting", "Cycle Time", "Run Time"};
+static const long values[4] = {1, 2048, 13107, 65535};
+
+static size_t homeLoadString(Print &client)
+{
+    String nMode = "Ethernet", ssid = "plant-01", ip = "192.168.1.10", conn = "Connected";
+    String sInt = "10", pMode = "HTTP", endp = "http://collector.local:8080/ingest";
+    String res = "{";
+    res += "\"networkMode\":\"" + nMode + "\",";
+    res += "\"ssid\":\"" + ssid + "\",";
+    res += "\"ipAddress\":\"" + ip + "\",";
+    res += "\"macAddress\":\"02:00:00:00:00:01\",";
+    res += "\"connStatus\":\"" + conn + "\",";
+    res += "\"jobNumber\":\"JOB-001\",";
+    res += "\"sendInterval\":\"" + sInt + "\",";
+    res += "\"protocolMode\":\"" + pMode + "\",";
+    res += "\"endpoint\":\"" + endp + "\",";
+    res += "\"DI\":{";
+    res += "\"value\":[" + String(values[0]) + "," + String(values[1]) + "," + String(values[2]) + "," + String(values[3]) + "],";
+    res += "\"taskMode\":[\"" + String(taskModes[0]) + "\",\"" + taskModes[1] + "\",\"" + taskModes[2] + "\",\"" + taskModes[3] + "\"]";
+    res += "},";
+    res += "\"AI\":{";
+    res += "\"rawValue\":[" + String(values[0]) + "," + String(values[1]) + "," + String(values[2]) + "," + String(values[3]) + "],";
+    res += "\"scaledValue\":[" + String(values[0]) + "," + String(values[1]) + "," + String(values[2]) + "," + String(values[3]) + "]";
+    res += "},";
+    res += "\"enAI\":[1,1,1,1],";
+    res += "\"datetime\":\"2024-01-01 12:00:00\"";
+    res += "}";
+    return client.print(res);
+}
+
+static size_t homeLoadWriter(Print &client)
+{
+    ChunkedPrint body(client, true);
+    JsonWriter json(body);
+    json.beginObject();
+    json.kv("networkMode", "Ethernet").kv("ssid", "plant-01").kv("ipAddress", "192.168.1.10");
+    json.kv("macAddress", "02:00:00:00:00:01").kv("connStatus", "Connected").kv("jobNumber", "JOB-001");
+    json.kv("sendInterval", "10").kv("protocolMode", "HTTP").kv("endpoint", "http://collector.local:8080/ingest");
+    json.beginObject("DI");
+    json.beginArray("value");
+    for (int i = 0; i < 4; i++)
+        json.value(values[i]);
+    json.endArray();
+    json.beginArray("taskMode");
+    for (int i = 0; i < 4; i++)
+        json.value(taskModes[i]);
+    json.endArray();
+    json.endObject();
+    json.beginObject("AI");
+    json.beginArray("rawValue");
+    for (int i = 0; i < 4; i++)
+        json.value(values[i]);
+    json.endArray();
+    json.beginArray("scaledValue");
+    for (int i = 0; i < 4; i++)
+        json.value(values[i]);
+    json.endArray();
+    json.endObject();
+    json.beginArray("enAI");
+    for (int i = 0; i < 4; i++)
+        json.value(1L);
+    json.endArray();
+    json.kv("datetime", "2024-01-01 12:00:00");
+    json.endObject();
+    body.end();
+    return body.total();
+}
+
+void test_homeload_vs_string(void)
+{
+    // Isi JSON sama persis, hanya cara merakitnya yang beda
+    CapturePrint legacy;
+    homeLoadString(legacy);
+    homeLoadWriter(out);
+    std::string decoded;
+    size_t maxChunk;
+    TEST_ASSERT_TRUE(dechunk(out.text, decoded, maxChunk));
+    TEST_ASSERT_EQUAL_STRING(legacy.text.c_str(), decoded.c_str());
+
+    const uint32_t rounds = 20000;
+    CountPrint sink;
+    double sec[2];
+    uint32_t allocs[2];
+    for (int way = 0; way < 2; way++)
+    {
+        allocations = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++)
+            way ? homeLoadWriter(sink) : homeLoadString(sink);
+        sec[way] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocs[way] = allocations;
+    }
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "/homeLoad per respons (host): String %.2f us / %u alokasi, JsonWriter %.2f us / %u alokasi",
+             sec[0] / rounds * 1e6, allocs[0] / rounds, sec[1] / rounds * 1e6, allocs[1] / rounds);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(0, allocs[1]);
+    TEST_ASSERT_GREATER_THAN(0, allocs[0]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_nested_structure);
+    RUN_TEST(test_top_level_array);
+    RUN_TEST(test_string_escaping);
+    RUN_TEST(test_numbers);
+    RUN_TEST(test_kv_with_decimals);
+    RUN_TEST(test_deep_nesting);
+    RUN_TEST(test_chunked_small_body);
+    RUN_TEST(test_chunked_empty_body);
+    RUN_TEST(test_chunked_exact_buffer);
+    RUN_TEST(test_chunked_large_body);
+    RUN_TEST(test_unchunked_passthrough);
+    RUN_TEST(test_json_through_chunked);
+    RUN_TEST(test_homeload_vs_string);
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <mutex>
+#include <vector>
+#include "SimOptions.h"
+#include "ModbusPoller.h"
+#include "RegisterImage.h"
+
+// Slave palsu lewat hook ModbusMaster NativeSim: isi register bisa
+// dihitung ulang dari alamat, setiap request dicatat
+
+struct Request
+{
+    uint8_t slave;
+    uint8_t function;
+    uint16_t start;
+    uint16_t count;
+};
+
+static std::mutex logLock;
+static std::vector<Request> requestLog;
+
+static uint16_t slaveValue(uint8_t slave, uint8_t function, uint16_t address)
+{
+    if (function <= 2)
+        return (address % 3) == 0;
+    // Alamat 15: nilai negatif (-10) untuk cek decode signed
+    if (address == 15)
+        return 0xFFF6;
+    return slave * 1000 + function * 100 + address;
+}
+
+static void onRequest(uint8_t slave, uint8_t function, uint16_t address, uint16_t quantity)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    requestLog.push_back({slave, function, address, quantity});
+}
+
+static void addTag(ModbusConfig &cfg, uint8_t slave, uint8_t function, uint16_t reg,
+                   float multiplier = 1.0f, uint16_t offset = 0)
+{
+    ModbusTag &t = cfg.tags[cfg.tagCount++];
+    snprintf(t.name, sizeof(t.name), "T%u", cfg.tagCount);
+    t.slave = slave;
+    t.function = function;
+    t.reg = reg;
+    t.multiplier = multiplier;
+    t.offset = offset;
+}
+
+static ModbusConfig baseConfig()
+{
+    ModbusConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.baudrate = 115200;
+    strcpy(cfg.parity, "None");
+    cfg.stopBit = 1;
+    cfg.dataBit = 8;
+    cfg.scanRate = 0.1f;
+    return cfg;
+}
+
+static const ModbusBlock *findBlock(const ModbusPlan &plan, uint8_t slave, uint8_t function, uint16_t start)
+{
+    for (uint8_t i = 0; i < plan.blockCount; i++)
+    {
+        const ModbusBlock &b = plan.blocks[i];
+        if (b.slave == slave && b.function == function && b.start == start)
+            return &b;
+    }
+    return nullptr;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_plan_merges_nearby_registers(void)
+{
+    ModbusConfig cfg = baseConfig();
+    // Sengaja tidak urut
+    addTag(cfg, 1, 3, 15);
+    addTag(cfg, 1, 3, 10);
+    addTag(cfg, 1, 3, 11);
+    addTag(cfg, 1, 3, 10 + 6 + MODBUS_MAX_GAP + 1); // celah > MODBUS_MAX_GAP
+    static ModbusPlan plan;
+    ModbusPoller::buildPlan(cfg, plan);
+
+    TEST_ASSERT_EQUAL(2, plan.blockCount);
+    const ModbusBlock *b = findBlock(plan, 1, 3, 10);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(6, b->count); // 10..15
+    TEST_ASSERT_EQUAL(3, b->tagCount);
+    // Tag blok diurutkan menurut register
+    TEST_ASSERT_EQUAL(1, plan.order[b->firstTag]);
+    TEST_ASSERT_EQUAL(2, plan.order[b->firstTag + 1]);
+    TEST_ASSERT_EQUAL(0, plan.order[b->firstTag + 2]);
+    b = findBlock(plan, 1, 3, 25);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(1, b->count);
+}
+
+void test_plan_splits_by_slave_function_and_size(void)
+{
+    ModbusConfig cfg = baseConfig();
+    // Rantai register dalam MODBUS_MAX_GAP: bergabung sampai 32 register
+    for (uint16_t reg = 0; reg < MODBUS_MAX_BLOCK_REGS; reg += MODBUS_MAX_GAP)
+        addTag(cfg, 1, 3, reg);
+    addTag(cfg, 1, 3, MODBUS_MAX_BLOCK_REGS - 1);
+    addTag(cfg, 1, 3, MODBUS_MAX_BLOCK_REGS + 1); // dekat, tapi blok jadi > 32 register
+    addTag(cfg, 1, 4, 0);                         // function code lain
+    addTag(cfg, 2, 3, 0);                         // slave lain
+    addTag(cfg, 1, 1, 0);                         // coil: batas 128 bit
+    addTag(cfg, 1, 1, 7);
+    addTag(cfg, 1, 6, 0);                         // FC6 bukan read: dilewati
+    static ModbusPlan plan;
+    ModbusPoller::buildPlan(cfg, plan);
+
+    TEST_ASSERT_EQUAL(5, plan.blockCount);
+    TEST_ASSERT_EQUAL(MODBUS_MAX_BLOCK_REGS, findBlock(plan, 1, 3, 0)->count);
+    TEST_ASSERT_EQUAL(MODBUS_MAX_BLOCK_REGS / MODBUS_MAX_GAP + 1, findBlock(plan, 1, 3, 0)->tagCount);
+    TEST_ASSERT_NOT_NULL(findBlock(plan, 1, 3, MODBUS_MAX_BLOCK_REGS + 1));
+    TEST_ASSERT_NOT_NULL(findBlock(plan, 1, 4, 0));
+    TEST_ASSERT_NOT_NULL(findBlock(plan, 2, 3, 0));
+    TEST_ASSERT_EQUAL(8, findBlock(plan, 1, 1, 0)->count);
+    TEST_ASSERT_NULL(findBlock(plan, 1, 6, 0));
+
+    // Fase awal disebar dalam satu interval
+    for (uint8_t i = 0; i < plan.blockCount; i++)
+    {
+        TEST_ASSERT_EQUAL(MODBUS_MIN_INTERVAL_MS, plan.blocks[i].intervalMs);
+        TEST_ASSERT_LESS_THAN(MODBUS_MIN_INTERVAL_MS, plan.blocks[i].nextDueMs);
+    }
+}
+
+void test_serial_config(void)
+{
+    ModbusConfig cfg = baseConfig();
+    TEST_ASSERT_EQUAL(SERIAL_8N1, ModbusPoller::serialConfig(cfg));
+    strcpy(cfg.parity, "Even");
+    cfg.stopBit = 2;
+    TEST_ASSERT_EQUAL(SERIAL_8E2, ModbusPoller::serialConfig(cfg));
+    strcpy(cfg.parity, "Odd");
+    cfg.dataBit = 7;
+    cfg.stopBit = 1;
+    TEST_ASSERT_EQUAL(SERIAL_7O1, ModbusPoller::serialConfig(cfg));
+}
+
+// Poll sungguhan lewat task: request sesuai plan, nilai per tag benar
+void test_poll_decodes_tags(void)
+{
+    simOptions.modbusSlave[1] = true;
+    simOptions.modbusSlave[2] = true;
+    simOptions.modbusValue = slaveValue;
+    simOptions.modbusRequest = onRequest;
+
+    ModbusConfig cfg = baseConfig();
+    addTag(cfg, 1, 3, 12, 0.1f, 31); // offsetAddress -> register image
+    addTag(cfg, 1, 3, 15, 0.5f, 32); // signed: -10 * 0.5
+    addTag(cfg, 1, 3, 10);
+    addTag(cfg, 2, 4, 7, 2.0f);
+    addTag(cfg, 1, 2, 3);            // bit 1 (3 % 3 == 0)
+    addTag(cfg, 1, 2, 4);            // bit 0
+    addTag(cfg, 1, 2, 12);           // bit 1, menyambung celah ke bit 21
+    addTag(cfg, 1, 2, 21);           // bit 1, word kedua response
+    static ModbusPoller poller;
+    poller.configure(cfg);
+    TEST_ASSERT_TRUE(poller.begin());
+
+    // Tiga blok, sedikitnya dua siklus penuh
+    uint32_t start = millis();
+    while (poller.seq() < 6 && millis() - start < 5000)
+        delay(10);
+    TEST_ASSERT_GREATER_OR_EQUAL(6, poller.seq());
+    TEST_ASSERT_EQUAL(3, poller.blockCount());
+    TEST_ASSERT_EQUAL(cfg.tagCount, poller.tagCount());
+    TEST_ASSERT_EQUAL(0, poller.errors());
+
+    ModbusReading r;
+    TEST_ASSERT_TRUE(poller.reading(0, r));
+    TEST_ASSERT_EQUAL(1312, r.raw);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 131.2, r.value);
+    TEST_ASSERT_TRUE(poller.reading(1, r));
+    TEST_ASSERT_EQUAL(0xFFF6, r.raw);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, -5.0, r.value);
+    TEST_ASSERT_TRUE(poller.reading(2, r));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1310.0, r.value);
+    TEST_ASSERT_TRUE(poller.reading(3, r));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 2.0 * 2407, r.value);
+    TEST_ASSERT_TRUE(poller.reading(4, r));
+    TEST_ASSERT_EQUAL(1, r.raw);
+    TEST_ASSERT_TRUE(poller.reading(5, r));
+    TEST_ASSERT_EQUAL(0, r.raw);
+    TEST_ASSERT_TRUE(poller.reading(6, r));
+    TEST_ASSERT_EQUAL(1, r.raw);
+    TEST_ASSERT_TRUE(poller.reading(7, r));
+    TEST_ASSERT_EQUAL(1, r.raw);
+    TEST_ASSERT_FALSE(poller.reading(8, r)); // di luar config
+
+    // Gateway: nilai mentah di offsetAddress Modbus TCP
+    uint16_t image[2];
+    TEST_ASSERT_TRUE(registers.read(31, 2, image));
+    TEST_ASSERT_EQUAL(1312, image[0]);
+    TEST_ASSERT_EQUAL(0xFFF6, image[1]);
+
+    // Setiap request = satu blok gabungan, bukan per tag
+    std::lock_guard<std::mutex> guard(logLock);
+    TEST_ASSERT_GREATER_OR_EQUAL(6, requestLog.size());
+    for (const Request &q : requestLog)
+    {
+        bool known = (q.slave == 1 && q.function == 3 && q.start == 10 && q.count == 6) ||
+                     (q.slave == 2 && q.function == 4 && q.start == 7 && q.count == 1) ||
+                     (q.slave == 1 && q.function == 2 && q.start == 3 && q.count == 19);
+        TEST_ASSERT_TRUE_MESSAGE(known, "request di luar plan");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_plan_merges_nearby_registers);
+    RUN_TEST(test_plan_splits_by_slave_function_and_size);
+    RUN_TEST(test_serial_config);
+    RUN_TEST(test_poll_decodes_tags);
+    return UNITY_END();
+}
@@ -0,0 +1,350 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "SimOptions.h"
+#include "RegisterImage.h"
+#include "ModbusTcpServer.h"
+
+#define TEST_PORT 1502
+#define TEST_PORT_OFFSET 20000
+
+static ModbusTcpServer server; // unit id bawaan 1
+static uint8_t resp[MBTCP_FRAME_MAX];
+
+// ADU read FC 3/4: transaksi 0x1234, protocol 0, length 6
+static size_t readRequest(uint8_t *req, uint8_t unit, uint8_t fc, uint16_t start, uint16_t count)
+{
+    const uint8_t frame[] = {0x12, 0x34, 0, 0, 0, 6, unit, fc,
+                             (uint8_t)(start >> 8), (uint8_t)start, (uint8_t)(count >> 8), (uint8_t)count};
+    memcpy(req, frame, sizeof(frame));
+    return sizeof(frame);
+}
+
+static uint16_t word(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static void checkException(size_t n, uint8_t fc, uint8_t code)
+{
+    TEST_ASSERT_EQUAL(9, n);
+    TEST_ASSERT_EQUAL_HEX8(0x12, resp[0]); // transaksi dikembalikan
+    TEST_ASSERT_EQUAL_HEX8(0x34, resp[1]);
+    TEST_ASSERT_EQUAL(3, word(resp + 4));
+    TEST_ASSERT_EQUAL_HEX8(fc | 0x80, resp[7]);
+    TEST_ASSERT_EQUAL_HEX8(code, resp[8]);
+}
+
+void setUp(void)
+{
+    registers.beginWrite();
+    for (uint16_t i = 0; i < REG_IMAGE_SIZE; i++)
+        registers.set(i, 0);
+    registers.endWrite();
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_word_order(void)
+{
+    registers.beginWrite();
+    registers.set(REG_AI_X100, 0xBEEF);
+    registers.setU32(REG_UPTIME, 0x12345678);
+    registers.setFloat(REG_AI_VALUE, 1.5f); // 0x3FC00000
+    registers.set(REG_IMAGE_SIZE, 1);       // di luar image: diabaikan
+    registers.endWrite();
+
+    uint16_t out[REG_IMAGE_SIZE];
+    TEST_ASSERT_TRUE(registers.read(0, REG_IMAGE_SIZE, out));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, out[REG_AI_X100]);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, out[REG_UPTIME]); // word tinggi dulu
+    TEST_ASSERT_EQUAL_HEX16(0x5678, out[REG_UPTIME + 1]);
+    TEST_ASSERT_EQUAL_HEX16(0x3FC0, out[REG_AI_VALUE]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, out[REG_AI_VALUE + 1]);
+}
+
+void test_image_read_bounds(void)
+{
+    uint16_t out[2];
+    TEST_ASSERT_TRUE(registers.read(REG_IMAGE_SIZE - 2, 2, out));
+    TEST_ASSERT_FALSE(registers.read(REG_IMAGE_SIZE - 1, 2, out));
+    TEST_ASSERT_FALSE(registers.read(0xFFFF, 2, out)); // tidak overflow 16 bit
+}
+
+// Writer terus mengganti float32 yang kedua word-nya selalu berubah;
+// reader tidak boleh melihat word tinggi dan rendah dari update berbeda
+void test_seqlock_never_torn(void)
+{
+    // Isi awal juga harus konsisten (v = 0)
+    registers.beginWrite();
+    registers.setU32(REG_AI_VALUE, 0xFFFF);
+    registers.endWrite();
+
+    std::atomic<bool> stop(false);
+    std::thread writer([&stop]() {
+        for (uint32_t i = 0; !stop; i++)
+        {
+            uint16_t v = i & 0xFFFF;
+            registers.beginWrite();
+            registers.setU32(REG_AI_VALUE, ((uint32_t)v << 16) | (uint16_t)~v);
+            registers.set(REG_SEQ, v);
+            registers.endWrite();
+        }
+    });
+
+    uint32_t torn = 0;
+    for (uint32_t i = 0; i < 200000; i++)
+    {
+        uint16_t out[REG_SEQ + 1];
+        registers.read(0, REG_SEQ + 1, out);
+        if (out[REG_AI_VALUE + 1] != (uint16_t)~out[REG_AI_VALUE] || out[REG_SEQ] != out[REG_AI_VALUE])
+            torn++;
+    }
+    stop = true;
+    writer.join();
+    TEST_ASSERT_EQUAL(0, torn);
+}
+
+void test_read_holding_and_input(void)
+{
+    registers.beginWrite();
+    registers.set(REG_AI_RAW, 13107);
+    registers.set(REG_AI_RAW + 1, 65535);
+    registers.set(REG_AI_RAW + 2, 0x0102);
+    registers.endWrite();
+
+    uint8_t req[16];
+    const uint8_t fcs[] = {3, 4};
+    for (uint8_t fc : fcs)
+    {
+        size_t n = server.handleFrame(req, readRequest(req, 1, fc, REG_AI_RAW, 3), resp);
+        TEST_ASSERT_EQUAL(9 + 6, n);
+        TEST_ASSERT_EQUAL_HEX8(0x12, resp[0]);
+        TEST_ASSERT_EQUAL_HEX8(0x34, resp[1]);
+        TEST_ASSERT_EQUAL(0, word(resp + 2));
+        TEST_ASSERT_EQUAL(3 + 6, word(resp + 4)); // unit + fc + byte count + data
+        TEST_ASSERT_EQUAL(1, resp[6]);
+        TEST_ASSERT_EQUAL(fc, resp[7]);
+        TEST_ASSERT_EQUAL(6, resp[8]);
+        TEST_ASSERT_EQUAL(13107, word(resp + 9));
+        TEST_ASSERT_EQUAL(65535, word(resp + 11));
+        TEST_ASSERT_EQUAL_HEX16(0x0102, word(resp + 13));
+    }
+
+    // Batas spec: 125 register sekaligus
+    size_t n = server.handleFrame(req, readRequest(req, 1, 3, 0, MBTCP_MAX_READ), resp);
+    TEST_ASSERT_EQUAL(9 + MBTCP_MAX_READ * 2, n);
+    TEST_ASSERT_EQUAL(MBTCP_MAX_READ * 2, resp[8]);
+}
+
+void test_exceptions(void)
+{
+    uint8_t req[16];
+    uint32_t before = server.exceptions();
+
+    size_t len = readRequest(req, 1, 6, 0, 1); // write single register
+    checkException(server.handleFrame(req, len, resp), 6, 0x01);
+
+    len = readRequest(req, 1, 3, 0, 0);
+    checkException(server.handleFrame(req, len, resp), 3, 0x03);
+    len = readRequest(req, 1, 3, 0, MBTCP_MAX_READ + 1);
+    checkException(server.handleFrame(req, len, resp), 3, 0x03);
+    len = readRequest(req, 1, 4, 0, 1);
+    checkException(server.handleFrame(req, len - 1, resp), 4, 0x03); // PDU terpotong
+
+    len = readRequest(req, 1, 4, REG_IMAGE_SIZE - 1, 2);
+    checkException(server.handleFrame(req, len, resp), 4, 0x02);
+
+    TEST_ASSERT_EQUAL(before + 5, server.exceptions());
+}
+
+void test_unit_and_protocol_filter(void)
+{
+    uint8_t req[16];
+    uint32_t before = server.requests();
+
+    // Unit 0 dan 255 dijawab seperti unit sendiri
+    TEST_ASSERT_NOT_EQUAL(0, server.handleFrame(req, readRequest(req, 0, 3, 0, 1), resp));
+    TEST_ASSERT_NOT_EQUAL(0, server.handleFrame(req, readRequest(req, 0xFF, 3, 0, 1), resp));
+    // Unit lain / protocol id bukan Modbus / frame kependekan: diam
+    TEST_ASSERT_EQUAL(0, server.handleFrame(req, readRequest(req, 2, 3, 0, 1), resp));
+    size_t len = readRequest(req, 1, 3, 0, 1);
+    req[3] = 1;
+    TEST_ASSERT_EQUAL(0, server.handleFrame(req, len, resp));
+    TEST_ASSERT_EQUAL(0, server.handleFrame(req, 7, resp));
+
+    TEST_ASSERT_EQUAL(before + 2, server.requests());
+}
+
+// Lewat socket sungguhan: dua request dalam satu segmen TCP, dijawab berurutan
+void test_pipelined_over_tcp(void)
+{
+    simOptions.bindAddress = "127.0.0.1";
+    simOptions.portOffset = TEST_PORT_OFFSET;
+    simOptions.linkUp = true;
+    registers.beginWrite();
+    registers.set(REG_STATUS, 0x0F01);
+    registers.endWrite();
+    static ModbusTcpServer tcp;
+    tcp.begin(TEST_PORT, 7);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT + TEST_PORT_OFFSET);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    TEST_ASSERT_EQUAL(0, connect(fd, (sockaddr *)&addr, sizeof(addr)));
+
+    uint8_t req[24];
+    size_t len = readRequest(req, 7, 3, REG_STATUS, 1);
+    len += readRequest(req + len, 7, 6, 0, 1);
+    TEST_ASSERT_EQUAL(len, send(fd, req, len, 0));
+
+    uint8_t in[64];
+    size_t got = 0;
+    uint32_t start = millis();
+    while (got < 11 + 9 && millis() - start < 2000)
+    {
+        tcp.service();
+        ssize_t n = recv(fd, in + got, sizeof(in) - got, MSG_DONTWAIT);
+        if (n > 0)
+            got += n;
+        delay(1);
+    }
+    close(fd);
+
+    TEST_ASSERT_EQUAL(11 + 9, got);
+    TEST_ASSERT_EQUAL(1, tcp.activeClients());
+    TEST_ASSERT_EQUAL(3, in[7]);
+    TEST_ASSERT_EQUAL_HEX16(0x0F01, word(in + 9));
+    TEST_ASSERT_EQUAL_HEX8(0x86, in[11 + 7]);
+    TEST_ASSERT_EQUAL(2, tcp.requests());
+    TEST_ASSERT_EQUAL(1, tcp.exceptions());
+}
+
+// Socket master dengan batas waktu baca 2 s (test tidak pernah menggantung)
+static int connectMaster(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout = {2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port + TEST_PORT_OFFSET);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// MBTCP_MAX_CLIENTS master polling bersamaan (request -> tunggu respons),
+// server dilayani satu loop seperti task comms; master berikutnya ditolak
+void test_concurrent_masters_throughput(void)
+{
+    simOptions.bindAddress = "127.0.0.1";
+    simOptions.portOffset = TEST_PORT_OFFSET;
+    simOptions.linkUp = true;
+    registers.beginWrite();
+    for (uint16_t i = 0; i < REG_IMAGE_SIZE; i++)
+        registers.set(i, i * 3);
+    registers.endWrite();
+    static ModbusTcpServer tcp;
+    tcp.begin(TEST_PORT + 1, 1);
+
+    std::atomic<bool> stop(false);
+    std::thread comms([&stop]() {
+        while (!stop)
+            tcp.service();
+    });
+
+    const uint32_t perMaster = 2000;
+    std::atomic<uint32_t> bad(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> masters;
+    for (uint8_t m = 0; m < MBTCP_MAX_CLIENTS; m++)
+    {
+        masters.emplace_back([m, &bad, &go]() {
+            int fd = connectMaster(TEST_PORT + 1);
+            if (fd < 0)
+            {
+                bad += perMaster;
+                return;
+            }
+            while (!go)
+                delay(1);
+            for (uint32_t i = 0; i < perMaster; i++)
+            {
+                uint16_t first = (m * 17 + i) % (REG_IMAGE_SIZE - 10);
+                uint8_t req[12], in[9 + 20];
+                readRequest(req, 1, 3 + (i & 1), first, 10);
+                req[0] = m;
+                req[1] = (uint8_t)i;
+                send(fd, req, sizeof(req), 0);
+                size_t got = 0;
+                while (got < sizeof(in))
+                {
+                    ssize_t n = recv(fd, in + got, sizeof(in) - got, 0);
+                    if (n <= 0)
+                        break;
+                    got += n;
+                }
+                // Respons milik request ini (transaksi + isi register)
+                if (got != sizeof(in) || in[0] != m || in[1] != (uint8_t)i ||
+                    word(in + 9) != first * 3 || word(in + 27) != (first + 9) * 3)
+                    bad++;
+            }
+            close(fd);
+        });
+    }
+    // Semua slot sudah terisi: master tambahan ditutup server
+    uint32_t wait = millis();
+    while (tcp.activeClients() < MBTCP_MAX_CLIENTS && millis() - wait < 2000)
+        delay(1);
+    int extra = connectMaster(TEST_PORT + 1);
+    uint8_t byte;
+    ssize_t closed = extra < 0 ? -1 : recv(extra, &byte, 1, 0);
+    close(extra);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    go = true;
+    for (std::thread &t : masters)
+        t.join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stop = true;
+    comms.join();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%u master: %.0f request/s (host, loopback)", MBTCP_MAX_CLIENTS,
+             MBTCP_MAX_CLIENTS * perMaster / sec);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(0, closed);
+    TEST_ASSERT_EQUAL(0, bad.load());
+    TEST_ASSERT_EQUAL(MBTCP_MAX_CLIENTS * perMaster, tcp.requests());
+    TEST_ASSERT_EQUAL(1, tcp.rejected());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_image_word_order);
+    RUN_TEST(test_image_read_bounds);
+    RUN_TEST(test_seqlock_never_torn);
+    RUN_TEST(test_read_holding_and_input);
+    RUN_TEST(test_exceptions);
+    RUN_TEST(test_unit_and_protocol_filter);
+    RUN_TEST(test_pipelined_over_tcp);
+    RUN_TEST(test_concurrent_masters_throughput);
+    return UNITY_END();
+}
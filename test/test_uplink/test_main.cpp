@@ -0,0 +1,422 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "SimOptions.h"
+#include "DataLogger.h"
+#include "Uplink.h"
+
+#define SINK_PORT 18080
+#define BROKER_PORT 18830
+
+// Server HTTP palsu: setiap POST dicatat (header + body), dijawab 200
+struct Post
+{
+    std::string head;
+    std::string body;
+};
+
+static std::mutex sinkLock;
+static std::vector<Post> posts;
+static int sinkFd = -1;
+
+static void sinkLoop()
+{
+    for (;;)
+    {
+        int fd = accept(sinkFd, nullptr, nullptr);
+        if (fd < 0)
+            return;
+        std::string in;
+        char buf[1024];
+        size_t headEnd = std::string::npos, length = 0;
+        for (;;)
+        {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0)
+                break;
+            in.append(buf, n);
+            if (headEnd == std::string::npos && (headEnd = in.find("\r\n\r\n")) != std::string::npos)
+            {
+                size_t p = in.find("Content-Length: ");
+                length = p < headEnd ? strtoul(in.c_str() + p + 16, nullptr, 10) : 0;
+            }
+            if (headEnd != std::string::npos && in.size() >= headEnd + 4 + length)
+                break;
+        }
+        if (headEnd != std::string::npos)
+        {
+            std::lock_guard<std::mutex> guard(sinkLock);
+            posts.push_back({in.substr(0, headEnd), in.substr(headEnd + 4)});
+        }
+        const char *reply = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+        send(fd, reply, strlen(reply), 0);
+        close(fd);
+    }
+}
+
+static void startSink()
+{
+    sinkFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(sinkFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SINK_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    TEST_ASSERT_EQUAL(0, bind(sinkFd, (sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(sinkFd, 4));
+    std::thread(sinkLoop).detach();
+}
+
+// Record di payload: {"KodeSensor":"..","Value":..,"Time":..}
+struct Sent
+{
+    std::string name;
+    float value;
+    uint32_t time;
+};
+
+static bool parseBatch(const std::string &body, std::vector<Sent> &out)
+{
+    if (body.size() < 2 || body.front() != '[' || body.back() != ']')
+        return false;
+    size_t pos = 1;
+    while (pos < body.size() - 1)
+    {
+        char name[16];
+        float value;
+        unsigned time;
+        int used = 0;
+        if (sscanf(body.c_str() + pos, "{\"KodeSensor\":\"%15[^\"]\",\"Value\":%f,\"Time\":%u}%n",
+                   name, &value, &time, &used) != 3 || used == 0)
+            return false;
+        out.push_back({name, value, time});
+        pos += used;
+        if (body[pos] == ',')
+            pos++;
+    }
+    return true;
+}
+
+static NetworkConfig httpConfig()
+{
+    NetworkConfig net;
+    memset(&net, 0, sizeof(net));
+    strcpy(net.sendTrig, "Time/interval");
+    net.sendInterval = 1;
+    strcpy(net.protocolMode, "HTTP");
+    snprintf(net.endpoint, sizeof(net.endpoint), "http://127.0.0.1:%u/ingest", SINK_PORT);
+    strcpy(net.mqttUsername, "node");
+    strcpy(net.mqttPass, "secret");
+    net.loggerMode = true;
+    return net;
+}
+
+// LittleFS di direktori sementara + DataLogger
+static void startLogger()
+{
+    static char dir[] = "/tmp/uplink-test-XXXXXX";
+    static std::string root;
+    TEST_ASSERT_NOT_NULL(mkdtemp(dir));
+    root = std::string(dir) + "/fs";
+    simOptions.fsRoot = root.c_str();
+    simOptions.linkUp = true;
+    TEST_ASSERT_TRUE(LittleFS.begin(true));
+    TEST_ASSERT_TRUE(logger.begin());
+    logger.setEnabled(true);
+    startSink();
+}
+
+// Log satu detik baru (setelah detik terakhir yang ada di log)
+static uint32_t appendSecond(int records, float base)
+{
+    uint32_t t = logger.now();
+    while (logger.now() == t)
+        delay(10);
+    for (int i = 0; i < records; i++)
+        logger.append(i % LOG_CHANNELS, base + i);
+    return logger.now();
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_parse_endpoint(void)
+{
+    NetworkConfig net = httpConfig();
+    UplinkTarget t;
+    TEST_ASSERT_TRUE(Uplink::parseEndpoint(net, t));
+    TEST_ASSERT_EQUAL(UPLINK_HTTP, t.protocol);
+    TEST_ASSERT_EQUAL_STRING("127.0.0.1", t.host);
+    TEST_ASSERT_EQUAL(SINK_PORT, t.port);
+    TEST_ASSERT_EQUAL_STRING("/ingest", t.path);
+
+    // Port config dipakai jika URL tanpa port, lalu default skema
+    strcpy(net.endpoint, "collector.local");
+    net.port = 8081;
+    TEST_ASSERT_TRUE(Uplink::parseEndpoint(net, t));
+    TEST_ASSERT_EQUAL(8081, t.port);
+    TEST_ASSERT_EQUAL_STRING("/", t.path);
+    net.port = 0;
+    strcpy(net.protocolMode, "MQTT");
+    strcpy(net.endpoint, "mqtt://broker");
+    strcpy(net.pubTopic, "plant/1");
+    TEST_ASSERT_TRUE(Uplink::parseEndpoint(net, t));
+    TEST_ASSERT_EQUAL(UPLINK_MQTT, t.protocol);
+    TEST_ASSERT_EQUAL(1883, t.port);
+    TEST_ASSERT_EQUAL_STRING("plant/1", t.topic);
+
+    strcpy(net.endpoint, "mqtts://broker");
+    TEST_ASSERT_FALSE(Uplink::parseEndpoint(net, t));
+    strcpy(net.protocolMode, "HTTP");
+    strcpy(net.endpoint, "http://:80/x");
+    TEST_ASSERT_FALSE(Uplink::parseEndpoint(net, t));
+    strcpy(net.protocolMode, "FTP");
+    TEST_ASSERT_FALSE(Uplink::parseEndpoint(net, t));
+}
+
+// Backlog lebih besar dari satu payload: dikirim dalam beberapa batch,
+// dipotong di batas waktu, tanpa record hilang atau terkirim dua kali
+void test_backlog_split_into_batches(void)
+{
+    startLogger();
+    // Record sebelum uplink pertama kali jalan tidak ikut dikirim
+    logger.append(LOG_CH_AI, -1.0f);
+    uplink.begin();
+    uplink.configure(httpConfig());
+    TEST_ASSERT_TRUE(uplink.enabled());
+
+    // Tiga detik log, 64 record per detik (tag cepat): +- 190 record,
+    // lebih dari satu payload UPLINK_PAYLOAD_MAX
+    const int seconds = 3, perSecond = 64;
+    uint32_t t = 0;
+    for (int s = 0; s < seconds; s++)
+        t = appendSecond(perSecond, s * 1000);
+
+    uint32_t start = millis();
+    while (uplink.sentRecords() < seconds * perSecond && millis() - start < 10000)
+    {
+        uplink.service(LinkON);
+        delay(10);
+    }
+    uplink.service(LinkON);
+
+    std::lock_guard<std::mutex> guard(sinkLock);
+    TEST_ASSERT_GREATER_OR_EQUAL(2, posts.size());
+    TEST_ASSERT_EQUAL(posts.size(), uplink.sent());
+    TEST_ASSERT_EQUAL(0, uplink.failures());
+    TEST_ASSERT_EQUAL(seconds * perSecond, uplink.sentRecords());
+    TEST_ASSERT_EQUAL(t, uplink.cursor());
+
+    std::vector<Sent> all;
+    uint32_t previousLast = 0;
+    for (const Post &p : posts)
+    {
+        TEST_ASSERT_TRUE(p.head.compare(0, 20, "POST /ingest HTTP/1.") == 0);
+        TEST_ASSERT_TRUE(p.head.find("Content-Type: application/json") != std::string::npos);
+        TEST_ASSERT_TRUE(p.head.find("Authorization: Basic bm9kZTpzZWNyZXQ=") != std::string::npos);
+        TEST_ASSERT_LESS_OR_EQUAL(UPLINK_PAYLOAD_MAX, p.body.size());
+
+        std::vector<Sent> batch;
+        TEST_ASSERT_TRUE_MESSAGE(parseBatch(p.body, batch), p.body.c_str());
+        TEST_ASSERT_GREATER_THAN(0, batch.size());
+        // Satu detik tidak pernah terbelah antar batch
+        TEST_ASSERT_GREATER_THAN(previousLast, batch.front().time);
+        previousLast = batch.back().time;
+        all.insert(all.end(), batch.begin(), batch.end());
+    }
+
+    // Urutan dan isi sama persis dengan yang di-append
+    TEST_ASSERT_EQUAL(seconds * perSecond, all.size());
+    for (int k = 0; k < seconds * perSecond; k++)
+    {
+        int s = k / perSecond, i = k % perSecond;
+        char fallback[8];
+        TEST_ASSERT_EQUAL_STRING(DataLogger::channelName(i % LOG_CHANNELS, fallback, sizeof(fallback)),
+                                 all[k].name.c_str());
+        TEST_ASSERT_FLOAT_WITHIN(1e-3, s * 1000 + i, all[k].value);
+        TEST_ASSERT_EQUAL(all[s * perSecond].time, all[k].time);
+    }
+}
+
+// ---------------------------------------------------------
+// Broker MQTT 3.1.1 palsu: CONNECT -> CONNACK, PUBLISH QoS 1 -> PUBACK
+// ---------------------------------------------------------
+struct MqttPacket
+{
+    uint8_t type;
+    std::string body;
+};
+
+static std::vector<MqttPacket> brokerLog;
+static int brokerFd = -1;
+static std::atomic<int> brokerConnects(0);
+
+static bool readExact(int fd, void *buf, size_t len)
+{
+    size_t got = 0;
+    while (got < len)
+    {
+        ssize_t n = recv(fd, (uint8_t *)buf + got, len - got, 0);
+        if (n <= 0)
+            return false;
+        got += n;
+    }
+    return true;
+}
+
+static bool readPacket(int fd, MqttPacket &p)
+{
+    uint8_t c;
+    if (!readExact(fd, &p.type, 1))
+        return false;
+    uint32_t remaining = 0;
+    for (uint8_t shift = 0; shift < 28; shift += 7)
+    {
+        if (!readExact(fd, &c, 1))
+            return false;
+        remaining |= (uint32_t)(c & 0x7F) << shift;
+        if (!(c & 0x80))
+            break;
+    }
+    p.body.resize(remaining);
+    return remaining == 0 || readExact(fd, &p.body[0], remaining);
+}
+
+static void brokerLoop()
+{
+    for (;;)
+    {
+        int fd = accept(brokerFd, nullptr, nullptr);
+        if (fd < 0)
+            return;
+        brokerConnects++;
+        MqttPacket p;
+        while (readPacket(fd, p))
+        {
+            {
+                std::lock_guard<std::mutex> guard(sinkLock);
+                brokerLog.push_back(p);
+            }
+            if (p.type == 0x10)
+            {
+                const uint8_t connack[] = {0x20, 2, 0, 0};
+                send(fd, connack, sizeof(connack), 0);
+            }
+            else if ((p.type & 0xF0) == 0x30)
+            {
+                // Packet id setelah topic (QoS 1)
+                size_t at = 2 + (((uint8_t)p.body[0] << 8) | (uint8_t)p.body[1]);
+                const uint8_t puback[] = {0x40, 2, (uint8_t)p.body[at], (uint8_t)p.body[at + 1]};
+                send(fd, puback, sizeof(puback), 0);
+            }
+        }
+        close(fd);
+    }
+}
+
+static std::string mqttString(const std::string &body, size_t &at)
+{
+    size_t len = ((uint8_t)body[at] << 8) | (uint8_t)body[at + 1];
+    std::string s = body.substr(at + 2, len);
+    at += 2 + len;
+    return s;
+}
+
+// Batch lewat MQTT: satu CONNECT untuk beberapa PUBLISH, framing 3.1.1
+void test_mqtt_publish_framing(void)
+{
+    brokerFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(brokerFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(BROKER_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    TEST_ASSERT_EQUAL(0, bind(brokerFd, (sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(brokerFd, 4));
+    std::thread(brokerLoop).detach();
+
+    NetworkConfig net = httpConfig();
+    strcpy(net.protocolMode, "MQTT");
+    snprintf(net.endpoint, sizeof(net.endpoint), "mqtt://127.0.0.1:%u", BROKER_PORT);
+    strcpy(net.pubTopic, "plant/node1/data");
+    uplink.configure(net);
+    TEST_ASSERT_TRUE(uplink.enabled());
+
+    // Dua batch terpisah (interval 1 s), masing-masing > 127 byte: remaining
+    // length varint 2 byte
+    uint32_t sentBefore = uplink.sentRecords();
+    for (int batch = 0; batch < 2; batch++)
+    {
+        appendSecond(8, 100 * batch);
+        uint32_t start = millis();
+        while (uplink.sentRecords() < sentBefore + 8 * (batch + 1) && millis() - start < 5000)
+        {
+            uplink.service(LinkON);
+            delay(10);
+        }
+    }
+    TEST_ASSERT_EQUAL(sentBefore + 16, uplink.sentRecords());
+    TEST_ASSERT_EQUAL(1, brokerConnects.load());
+
+    std::lock_guard<std::mutex> guard(sinkLock);
+    TEST_ASSERT_EQUAL(3, brokerLog.size());
+
+    // CONNECT: "MQTT" level 4, clean session + username + password, keepalive 60
+    const std::string &c = brokerLog[0].body;
+    TEST_ASSERT_EQUAL_HEX8(0x10, brokerLog[0].type);
+    size_t at = 0;
+    std::string protocol = mqttString(c, at);
+    TEST_ASSERT_EQUAL_STRING("MQTT", protocol.c_str());
+    TEST_ASSERT_EQUAL(4, c[at]);
+    TEST_ASSERT_EQUAL_HEX8(0xC2, c[at + 1]);
+    TEST_ASSERT_EQUAL(UPLINK_MQTT_KEEPALIVE, ((uint8_t)c[at + 2] << 8) | (uint8_t)c[at + 3]);
+    at += 4;
+    std::string clientId = mqttString(c, at);
+    std::string username = mqttString(c, at);
+    std::string password = mqttString(c, at);
+    TEST_ASSERT_EQUAL_STRING("node-", clientId.substr(0, 5).c_str());
+    TEST_ASSERT_EQUAL_STRING("node", username.c_str());
+    TEST_ASSERT_EQUAL_STRING("secret", password.c_str());
+    TEST_ASSERT_EQUAL(c.size(), at);
+
+    // PUBLISH QoS 1: topic, packet id naik, payload = batch JSON utuh
+    for (int i = 1; i <= 2; i++)
+    {
+        const MqttPacket &p = brokerLog[i];
+        TEST_ASSERT_EQUAL_HEX8(0x32, p.type);
+        TEST_ASSERT_GREATER_THAN(127, p.body.size());
+        at = 0;
+        std::string topic = mqttString(p.body, at);
+        TEST_ASSERT_EQUAL_STRING("plant/node1/data", topic.c_str());
+        uint16_t id = ((uint8_t)p.body[at] << 8) | (uint8_t)p.body[at + 1];
+        TEST_ASSERT_EQUAL(i, id);
+        std::vector<Sent> batch;
+        TEST_ASSERT_TRUE(parseBatch(p.body.substr(at + 2), batch));
+        TEST_ASSERT_EQUAL(8, batch.size());
+        TEST_ASSERT_FLOAT_WITHIN(1e-3, 100 * (i - 1), batch[0].value);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_endpoint);
+    RUN_TEST(test_backlog_split_into_batches);
+    RUN_TEST(test_mqtt_publish_framing);
+    return UNITY_END();
+}
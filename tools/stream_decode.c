@@ -0,0 +1,262 @@
+/*
+ * Decoder stream sampel biner (console "stream raw|eng") untuk Linux.
+ *
+ *   cc -O2 -o stream_decode tools/stream_decode.c
+ *   ./stream_decode -c "stream eng" /dev/ttyUSB0 > samples.csv
+ *   ./stream_decode < capture.bin
+ *
+ * Frame (lihat src/SampleStream.h) diapit 0x00 dan di-encode COBS:
+ *   u8 type (1 = RAW int16, 2 = ENG int32 milli-unit), u8 channel,
+ *   u16 seq, u32 t0 (us), u32 t1 (us), u8 count, count x nilai,
+ *   u16 CRC-16/CCITT (0x1021, init 0xFFFF). Semua little-endian.
+ *
+ * Output CSV ke stdout: channel,t_us,value. Waktu sampel di tengah blok
+ * diinterpolasi linear antara t0 dan t1. Teks console yang lewat ditulis
+ * ke stderr; frame rusak dan lompatan seq dihitung dan dilaporkan saat
+ * selesai (EOF atau Ctrl-C).
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define HEADER_SIZE 13
+#define PACKET_MAX 1024
+
+static volatile sig_atomic_t stop;
+static unsigned long frames, crcErrors, lostFrames, textPackets;
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static uint16_t crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/* Paket tanpa delimiter -> data asli; -1 jika bukan COBS yang valid */
+static long cobsDecode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t i = 0, o = 0;
+    while (i < len)
+    {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len)
+            return -1;
+        for (uint8_t k = 1; k < code; k++)
+            out[o++] = in[i++];
+        if (code < 0xFF && i < len)
+            out[o++] = 0;
+    }
+    return (long)o;
+}
+
+static uint16_t u16(const uint8_t *p) { return p[0] | p[1] << 8; }
+static uint32_t u32(const uint8_t *p) { return u16(p) | (uint32_t)u16(p + 2) << 16; }
+
+static int printable(const uint8_t *p, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        if ((p[i] < 0x20 || p[i] > 0x7E) && p[i] != '\r' && p[i] != '\n' && p[i] != '\t')
+            return 0;
+    return 1;
+}
+
+static int decodeFrame(const uint8_t *f, size_t len)
+{
+    static int haveSeq;
+    static uint16_t lastSeq;
+
+    if (len < HEADER_SIZE + 2 || crc16(f, len - 2) != u16(f + len - 2))
+        return -1;
+    uint8_t type = f[0], channel = f[1], count = f[12];
+    size_t width = type == 1 ? 2 : type == 2 ? 4 : 0;
+    if (width == 0 || channel > 3 || len != HEADER_SIZE + count * width + 2)
+        return -1;
+
+    uint16_t seq = u16(f + 2);
+    if (haveSeq)
+        lostFrames += (uint16_t)(seq - lastSeq - 1);
+    haveSeq = 1;
+    lastSeq = seq;
+    frames++;
+
+    uint32_t t0 = u32(f + 4), t1 = u32(f + 8);
+    const uint8_t *v = f + HEADER_SIZE;
+    for (uint8_t i = 0; i < count; i++, v += width)
+    {
+        uint32_t t = count > 1 ? t0 + (uint32_t)((uint64_t)(t1 - t0) * i / (count - 1)) : t0;
+        if (type == 1)
+            printf("AI%u,%lu,%d\n", channel + 1, (unsigned long)t, (int16_t)u16(v));
+        else
+            printf("AI%u,%lu,%.3f\n", channel + 1, (unsigned long)t, (int32_t)u32(v) / 1000.0);
+    }
+    return 0;
+}
+
+static void handlePacket(const uint8_t *p, size_t len)
+{
+    uint8_t frame[PACKET_MAX];
+    if (len == 0)
+        return;
+    long n = cobsDecode(p, len, frame);
+    if (n > 0 && decodeFrame(frame, (size_t)n) == 0)
+        return;
+    /* Bukan frame: teks console, atau frame yang terpotong teks */
+    if (printable(p, len))
+    {
+        textPackets++;
+        fwrite(p, 1, len, stderr);
+    }
+    else
+        crcErrors++;
+}
+
+static int openPort(const char *path, speed_t baud)
+{
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0)
+        return -1;
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baud);
+        cfsetospeed(&tio, baud);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+        tcflush(fd, TCIFLUSH);
+    }
+    return fd;
+}
+
+static speed_t baudConstant(long baud)
+{
+    switch (baud)
+    {
+    case 57600:
+        return B57600;
+    case 230400:
+        return B230400;
+    case 460800:
+        return B460800;
+    case 921600:
+        return B921600;
+    default:
+        return B115200;
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-b baud] [-c command] [device]\n"
+                    "  device  tty firmware (default: stdin)\n"
+                    "  -b      115200 (default), 57600, 230400, 460800, 921600\n"
+                    "  -c      perintah console sebelum membaca, mis. \"stream eng 1,2\";\n"
+                    "          \"stream off\" dikirim saat keluar\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    long baud = 115200;
+    const char *command = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:c:h")) != -1)
+    {
+        if (opt == 'b')
+            baud = atol(optarg);
+        else if (opt == 'c')
+            command = optarg;
+        else
+        {
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    int fd = STDIN_FILENO;
+    if (optind < argc)
+    {
+        fd = openPort(argv[optind], baudConstant(baud));
+        if (fd < 0)
+        {
+            fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+            return 1;
+        }
+    }
+    if (command && fd != STDIN_FILENO)
+    {
+        dprintf(fd, "%s\n", command);
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal; /* tanpa SA_RESTART: read() terputus */
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    uint8_t buf[4096], packet[PACKET_MAX];
+    size_t plen = 0;
+    int overflow = 0;
+    while (!stop)
+    {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++)
+        {
+            if (buf[i] == 0)
+            {
+                if (overflow)
+                    crcErrors++;
+                else
+                    handlePacket(packet, plen);
+                plen = 0;
+                overflow = 0;
+            }
+            else if (plen < sizeof(packet))
+                packet[plen++] = buf[i];
+            else if (!overflow && printable(packet, plen))
+            {
+                /* Teks panjang (log boot): diteruskan per potongan */
+                fwrite(packet, 1, plen, stderr);
+                textPackets++;
+                packet[0] = buf[i];
+                plen = 1;
+            }
+            else
+                overflow = 1;
+        }
+    }
+    if (plen > 0 && !overflow && printable(packet, plen))
+        fwrite(packet, 1, plen, stderr);
+
+    if (command && fd != STDIN_FILENO)
+        dprintf(fd, "stream off\n");
+    fflush(stdout);
+    fprintf(stderr, "frames: %lu, lost (seq gap): %lu, corrupt: %lu, text: %lu\n",
+            frames, lostFrames, crcErrors, textPackets);
+    return 0;
+}